@@ -5,6 +5,7 @@
 #include "Materials/MaterialInstanceDynamic.h" // UMaterialInstanceDynamic
 #include "UObject/UObjectGlobals.h"            // LoadObject, NewObject
 
+#include <algorithm> // std::remove
 #include <string>
 
 // HACK: assuming you have no more than 10 unique material instances on a single static mesh
@@ -13,17 +14,38 @@
 // https://docs.unrealengine.com/4.26/en-US/API/Runtime/Engine/Components/UMeshComponent/SetMaterial/
 #define MAX_POSSIBLE_MATERIALS 10
 
-std::unordered_map<std::string, class ADReyeVRCustomActor *> ADReyeVRCustomActor::ActiveCustomActors = {};
+std::unordered_map<int32, class ADReyeVRCustomActor *> ADReyeVRCustomActor::ActiveCustomActors = {};
+std::unordered_map<std::string, ADReyeVRCustomActor::IdType> ADReyeVRCustomActor::ActiveIdsByName = {};
+std::unordered_map<std::string, std::vector<ADReyeVRCustomActor *>> ADReyeVRCustomActor::Pools = {};
+ADReyeVRCustomActor::IdType ADReyeVRCustomActor::NextId = 0;
 int ADReyeVRCustomActor::AllMeshCount = 0;
 
 ADReyeVRCustomActor *ADReyeVRCustomActor::CreateNew(const FString &SM_Path, const FString &Mat_Path, UWorld *World,
                                                     const FString &Name)
 {
     check(World != nullptr);
+    const std::string PoolKey = TCHAR_TO_UTF8(*FString::Printf(TEXT("%s|%s"), *SM_Path, *Mat_Path));
+
+    // reuse a released actor of the same type (no spawn, no new mesh/material)
+    auto Pool = Pools.find(PoolKey);
+    while (Pool != Pools.end() && !Pool->second.empty())
+    {
+        ADReyeVRCustomActor *Actor = Pool->second.back();
+        Pool->second.pop_back();
+        if (!IsValid(Actor) || Actor->GetWorld() != World)
+            continue;
+        Actor->bInPool = false;
+        Actor->MaterialParams = DReyeVR::CustomActorData::MaterialParamsStruct();
+        Actor->MaterialParams.MaterialPath = Mat_Path;
+        Actor->Initialize(Name);
+        return Actor;
+    }
+
     FActorSpawnParameters SpawnInfo;
     SpawnInfo.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
     ADReyeVRCustomActor *Actor =
         World->SpawnActor<ADReyeVRCustomActor>(FVector::ZeroVector, FRotator::ZeroRotator, SpawnInfo);
+    Actor->PoolKey = PoolKey;
     Actor->Initialize(Name);
 
     if (Actor->AssignSM(SM_Path, World))
@@ -35,6 +57,32 @@ ADReyeVRCustomActor *ADReyeVRCustomActor::CreateNew(const FString &SM_Path, cons
     return Actor;
 }
 
+ADReyeVRCustomActor *ADReyeVRCustomActor::FindActive(const FString &Name)
+{
+    auto Found = ActiveIdsByName.find(TCHAR_TO_UTF8(*Name));
+    if (Found == ActiveIdsByName.end())
+        return nullptr;
+    auto Actor = ActiveCustomActors.find(Found->second);
+    return (Actor != ActiveCustomActors.end()) ? Actor->second : nullptr;
+}
+
+void ADReyeVRCustomActor::ResetAll()
+{
+    ActiveCustomActors.clear();
+    ActiveIdsByName.clear();
+    Pools.clear();
+}
+
+void ADReyeVRCustomActor::Release()
+{
+    this->Deactivate();
+    if (!bInPool)
+    {
+        Pools[PoolKey].push_back(this);
+        bInPool = true;
+    }
+}
+
 ADReyeVRCustomActor::ADReyeVRCustomActor(const FObjectInitializer &ObjectInitializer) : Super(ObjectInitializer)
 {
     PrimaryActorTick.bCanEverTick = true;
@@ -87,6 +135,8 @@ void ADReyeVRCustomActor::AssignMat(const FString &MaterialPath)
     DynamicMat = UMaterialInstanceDynamic::Create(Material, this);
     MaterialParams.Apply(DynamicMat);           // apply the parameters to this dynamic material
     MaterialParams.MaterialPath = MaterialPath; // for now does not change over time
+    AppliedParams = MaterialParams;
+    bAppliedParamsValid = (DynamicMat != nullptr);
 
     if (DynamicMat != nullptr && ActorMesh != nullptr)
         for (int i = 0; i < MAX_POSSIBLE_MATERIALS; i++)
@@ -98,7 +148,9 @@ void ADReyeVRCustomActor::AssignMat(const FString &MaterialPath)
 void ADReyeVRCustomActor::Initialize(const FString &Name)
 {
     Internals.Name = Name;
-    ADReyeVRCustomActor::ActiveCustomActors[TCHAR_TO_UTF8(*Name)] = this;
+    Id = NextId++;
+    ADReyeVRCustomActor::ActiveCustomActors[Id] = this;
+    ADReyeVRCustomActor::ActiveIdsByName[TCHAR_TO_UTF8(*Name)] = Id;
 }
 
 void ADReyeVRCustomActor::BeginPlay()
@@ -109,15 +161,24 @@ void ADReyeVRCustomActor::BeginPlay()
 void ADReyeVRCustomActor::BeginDestroy()
 {
     this->Deactivate(); // remove from global static table
+    if (bInPool)
+    {
+        auto &Pool = Pools[PoolKey];
+        Pool.erase(std::remove(Pool.begin(), Pool.end(), this), Pool.end());
+        bInPool = false;
+    }
     Super::BeginDestroy();
 }
 
 void ADReyeVRCustomActor::Deactivate()
 {
-    const std::string s = TCHAR_TO_UTF8(*Internals.Name);
-    if (ADReyeVRCustomActor::ActiveCustomActors.find(s) != ADReyeVRCustomActor::ActiveCustomActors.end())
+    auto Active = ADReyeVRCustomActor::ActiveCustomActors.find(Id);
+    if (Active != ADReyeVRCustomActor::ActiveCustomActors.end() && Active->second == this)
     {
-        ADReyeVRCustomActor::ActiveCustomActors.erase(s);
+        ADReyeVRCustomActor::ActiveCustomActors.erase(Active);
+        auto ByName = ADReyeVRCustomActor::ActiveIdsByName.find(TCHAR_TO_UTF8(*Internals.Name));
+        if (ByName != ADReyeVRCustomActor::ActiveIdsByName.end() && ByName->second == Id)
+            ADReyeVRCustomActor::ActiveIdsByName.erase(ByName);
     }
     this->SetActorHiddenInGame(true);
     if (ActorMesh)
@@ -128,11 +189,13 @@ void ADReyeVRCustomActor::Deactivate()
 
 void ADReyeVRCustomActor::Activate()
 {
-    const std::string s = TCHAR_TO_UTF8(*Internals.Name);
-    if (ADReyeVRCustomActor::ActiveCustomActors.find(s) == ADReyeVRCustomActor::ActiveCustomActors.end())
-        ADReyeVRCustomActor::ActiveCustomActors[s] = this;
+    if (ADReyeVRCustomActor::ActiveCustomActors.find(Id) == ADReyeVRCustomActor::ActiveCustomActors.end())
+    {
+        ADReyeVRCustomActor::ActiveCustomActors[Id] = this;
+        ADReyeVRCustomActor::ActiveIdsByName[TCHAR_TO_UTF8(*Internals.Name)] = Id;
+    }
     else
-        ensure(ADReyeVRCustomActor::ActiveCustomActors[s] == this);
+        ensure(ADReyeVRCustomActor::ActiveCustomActors[Id] == this);
     this->SetActorHiddenInGame(false);
     if (ActorMesh)
         ActorMesh->SetVisibility(true);
@@ -144,6 +207,9 @@ void ADReyeVRCustomActor::Tick(float DeltaSeconds)
 {
     if (ADReyeVRSensor::bIsReplaying)
     {
+        if (!bInternalsChanged)
+            return; // the world state already shows the replayed internals
+        bInternalsChanged = false;
         // update world state with internals
         this->SetActorLocation(Internals.Location);
         this->SetActorRotation(Internals.Rotation);
@@ -164,13 +230,22 @@ void ADReyeVRCustomActor::Tick(float DeltaSeconds)
 
 void ADReyeVRCustomActor::UpdateMaterial()
 {
-    // update the materials according to the params
-    MaterialParams.Apply(DynamicMat);
+    // update the materials according to the params (only the ones that changed)
+    using Params = DReyeVR::CustomActorData::MaterialParamsStruct;
+    const uint8_t Mask = bAppliedParamsValid ? MaterialParams.DiffMask(AppliedParams) : Params::AllParamBits;
+    if (Mask == 0 || DynamicMat == nullptr)
+        return;
+    MaterialParams.Apply(DynamicMat, Mask);
+    AppliedParams = MaterialParams;
+    bAppliedParamsValid = true;
 }
 
 void ADReyeVRCustomActor::SetInternals(const DReyeVR::CustomActorData &InData)
 {
+    if (Internals == InData)
+        return;
     Internals = InData;
+    bInternalsChanged = true;
 }
 
 const DReyeVR::CustomActorData &ADReyeVRCustomActor::GetInternals() const
@@ -3,6 +3,7 @@
 #include "Carla/Sensor/DReyeVRData.h" // DReyeVR namespace
 #include "GameFramework/Actor.h"      // AActor
 
+#include <string>        // std::string
 #include <unordered_map> // std::unordered_map
 #include <utility>       // std::pair
 #include <vector>        // std::vector
@@ -26,10 +27,13 @@ class CARLA_API ADReyeVRCustomActor : public AActor // abstract class
     ADReyeVRCustomActor(const FObjectInitializer &ObjectInitializer);
     ~ADReyeVRCustomActor() = default;
 
-    /// factory function to create a new instance of a given type
+    /// factory function to create a new instance of a given type, reusing a released actor of the same type if any
     static ADReyeVRCustomActor *CreateNew(const FString &SM_Path, const FString &Mat_Path, UWorld *World,
                                           const FString &Name);
 
+    // deactivates this actor and hands it back for reuse by CreateNew, the caller must not use it anymore
+    void Release();
+
     virtual void Tick(float DeltaSeconds) override;
 
     void Activate();
@@ -55,7 +59,15 @@ class CARLA_API ADReyeVRCustomActor : public AActor // abstract class
 
     const DReyeVR::CustomActorData &GetInternals() const;
 
-    static std::unordered_map<std::string, class ADReyeVRCustomActor *> ActiveCustomActors;
+    using IdType = int32; // unique per CreateNew (a reused actor gets a new id)
+    IdType GetId() const
+    {
+        return Id;
+    }
+
+    static std::unordered_map<IdType, class ADReyeVRCustomActor *> ActiveCustomActors;
+    static ADReyeVRCustomActor *FindActive(const FString &Name); // nullptr if none is active with this name
+    static void ResetAll();                                      // forget all actors (ex. the world changed)
 
     inline class UStaticMeshComponent *GetMesh()
     {
@@ -75,7 +87,21 @@ class CARLA_API ADReyeVRCustomActor : public AActor // abstract class
 
     bool AssignSM(const FString &Path, UWorld *World);
 
+    IdType Id = INDEX_NONE;
+    static IdType NextId;
+    static std::unordered_map<std::string, IdType> ActiveIdsByName;
+
+    // released actors by mesh/material pair, see PoolKey
+    static std::unordered_map<std::string, std::vector<ADReyeVRCustomActor *>> Pools;
+    std::string PoolKey;
+    bool bInPool = false;
+
     class DReyeVR::CustomActorData Internals;
+    bool bInternalsChanged = true; // when replaying: internals not applied to the world yet
+
+    // the params last pushed to DynamicMat (only the parameters that changed since are pushed)
+    struct DReyeVR::CustomActorData::MaterialParamsStruct AppliedParams;
+    bool bAppliedParamsValid = false;
 
     UPROPERTY(EditAnywhere, Category = "Mesh")
     class UStaticMeshComponent *ActorMesh = nullptr;
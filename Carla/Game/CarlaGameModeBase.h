@@ -50,6 +50,11 @@ public:
     return Map;
   }
 
+  UCarlaSettingsDelegate *GetCarlaSettingsDelegate() const
+  {
+    return CarlaSettingsDelegate;
+  }
+
   const FString GetFullMapPath() const;
 
   // get path relative to Content folder
@@ -55,6 +55,12 @@ std::string ACarlaRecorder::ShowFileActorsBlocked(std::string Name, double MinTi
   return Query.QueryBlocked(Name, MinTime, MinDistance);
 }
 
+std::string ACarlaRecorder::ShowFileWindow(std::string Name, double TimeStart, double TimeEnd,
+    std::string PacketTypes)
+{
+  return Query.QueryWindow(Name, TimeStart, TimeEnd, PacketTypes);
+}
+
 std::string ACarlaRecorder::ReplayFile(std::string Name, double TimeStart, double Duration,
     uint32_t FollowId, bool ReplaySensors)
 {
@@ -62,6 +68,20 @@ std::string ACarlaRecorder::ReplayFile(std::string Name, double TimeStart, doubl
   return Replayer.ReplayFile(Name, TimeStart, Duration, FollowId, ReplaySensors);
 }
 
+std::string ACarlaRecorder::ReplayFrameRange(std::string Name, uint64_t FrameStart, uint64_t FrameEnd,
+    uint32_t FollowId, bool ReplaySensors)
+{
+  Stop();
+  return Replayer.ReplayFrameRange(Name, FrameStart, FrameEnd, FollowId, ReplaySensors);
+}
+
+std::string ACarlaRecorder::ReplayTimeRange(std::string Name, double TimeStart, double TimeEnd,
+    uint32_t FollowId, bool ReplaySensors)
+{
+  Stop();
+  return Replayer.ReplayTimeRange(Name, TimeStart, TimeEnd, FollowId, ReplaySensors);
+}
+
 void ACarlaRecorder::SetReplayerTimeFactor(double TimeFactor)
 {
   Replayer.SetTimeFactor(TimeFactor);
@@ -290,13 +310,51 @@ void ACarlaRecorder::AddDReyeVRData()
   // Add the latest instance of the DReyeVR snapshot to our data
   DReyeVRAggData.Add(DReyeVRDataRecorder<DReyeVR::AggregateData>(ADReyeVRSensor::Data));
 
+  // custom actors: a Spawn record when they appear, then only their changes, then a Despawn record
+  for (auto &Recorded : RecordedCustomActors)
+    Recorded.second.bSeen = false;
+  DReyeVR::CustomActorDelta Delta;
   for (auto &ActiveCAs : ADReyeVRCustomActor::ActiveCustomActors)
   {
     ADReyeVRCustomActor *CustomActor = ActiveCAs.second;
-    if (CustomActor != nullptr && CustomActor->IsActive() && CustomActor->GetShouldRecord())
+    if (CustomActor == nullptr || !CustomActor->IsActive() || !CustomActor->GetShouldRecord())
+      continue;
+    const DReyeVR::CustomActorData &Internals = CustomActor->GetInternals();
+    auto It = RecordedCustomActors.find(ActiveCAs.first);
+    if (It != RecordedCustomActors.end() && DReyeVR::CustomActorDelta::NeedsRespawn(It->second.Last, Internals))
     {
-      DReyeVRCustomActorData.Add(DReyeVRDataRecorder<DReyeVR::CustomActorData>(&(CustomActor->GetInternals())));
+      // ex. a pooled actor reused for another marker
+      Delta.MakeDespawn(It->second.RecordId);
+      DReyeVRCustomActorDeltas.Add(DReyeVRDataRecorder<DReyeVR::CustomActorDelta>(&Delta));
+      RecordedCustomActors.erase(It);
+      It = RecordedCustomActors.end();
     }
+    if (It == RecordedCustomActors.end())
+    {
+      Delta.MakeSpawn(NextCustomActorRecordId, Internals);
+      DReyeVRCustomActorDeltas.Add(DReyeVRDataRecorder<DReyeVR::CustomActorDelta>(&Delta));
+      RecordedCustomActors.insert({ActiveCAs.first, FRecordedCustomActor{NextCustomActorRecordId++, Internals, true}});
+    }
+    else
+    {
+      It->second.bSeen = true;
+      if (Delta.MakeUpdate(It->second.RecordId, It->second.Last, Internals))
+      {
+        DReyeVRCustomActorDeltas.Add(DReyeVRDataRecorder<DReyeVR::CustomActorDelta>(&Delta));
+        It->second.Last = Internals;
+      }
+    }
+  }
+  for (auto It = RecordedCustomActors.begin(); It != RecordedCustomActors.end();)
+  {
+    if (It->second.bSeen)
+    {
+      ++It;
+      continue;
+    }
+    Delta.MakeDespawn(It->second.RecordId);
+    DReyeVRCustomActorDeltas.Add(DReyeVRDataRecorder<DReyeVR::CustomActorDelta>(&Delta));
+    It = RecordedCustomActors.erase(It);
   }
 }
 
@@ -354,6 +412,14 @@ void ACarlaRecorder::AddWeather(const FWeatherParameters& WeatherParams)
   Weathers.Add(Weather);
 }
 
+void ACarlaRecorder::AddDReyeVRQualityChange(const DReyeVR::QualityChangeData &Change)
+{
+  if (Enabled)
+  {
+    DReyeVRQualityData.Add(DReyeVRDataRecorder<DReyeVR::QualityChangeData>(&Change));
+  }
+}
+
 std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool AdditionalData)
 {
   // stop replayer if any in course
@@ -366,6 +432,10 @@ std::string ACarlaRecorder::Start(std::string Name, FString MapName, bool Additi
   // reset collisions Id
   NextCollisionId = 0;
 
+  // every custom actor is described (Spawn) again in the new recording
+  RecordedCustomActors.clear();
+  NextCustomActorRecordId = 0;
+
   // get the final path + filename
   std::string Filename = GetRecorderFilename(Name);
 
@@ -431,8 +501,9 @@ void ACarlaRecorder::Clear(void)
   PhysicsControls.Clear();
   TrafficLightTimes.Clear();
   DReyeVRAggData.Clear();
-  DReyeVRCustomActorData.Clear();
+  DReyeVRCustomActorDeltas.Clear();
   DReyeVRConfigFileData.Clear();
+  DReyeVRQualityData.Clear();
   Weathers.Clear();
 }
 
@@ -473,8 +544,11 @@ void ACarlaRecorder::Write(double DeltaSeconds)
   // custom DReyeVR data
   DReyeVRAggData.Write(File);
 
-  // custom DReyeVR Actor data write
-  DReyeVRCustomActorData.Write(File);
+  // custom DReyeVR Actor changes (only on the frames something was spawned, changed or despawned)
+  if (DReyeVRCustomActorDeltas.Num() > 0)
+  {
+    DReyeVRCustomActorDeltas.Write(File);
+  }
 
   // only write this once (at the beginning)
   static bool bWroteConfigFile = false;
@@ -484,6 +558,12 @@ void ACarlaRecorder::Write(double DeltaSeconds)
     bWroteConfigFile = true;
   }
 
+  // adaptive quality changes (rare, so only written on the frames they happen)
+  if (DReyeVRQualityData.Num() > 0)
+  {
+    DReyeVRQualityData.Write(File);
+  }
+
   // weather state
   Weathers.Write(File);
 
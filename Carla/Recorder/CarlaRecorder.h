@@ -8,6 +8,7 @@
 
 // #include "GameFramework/Actor.h"
 #include <fstream>
+#include <unordered_map>
 
 #include "Carla/Actor/ActorDescription.h"
 
@@ -48,6 +49,8 @@ class ATrafficLightBase;
 #define DREYEVR_PACKET_ID 139
 #define DREYEVR_CUSTOM_ACTOR_PACKET_ID 140
 #define DREYEVR_CONFIG_FILE_PACKET_ID 141
+#define DREYEVR_QUALITY_PACKET_ID 142
+#define DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID 143
 
 enum class CarlaRecorderPacketId : uint8_t
 {
@@ -72,8 +75,10 @@ enum class CarlaRecorderPacketId : uint8_t
   Weather,
   // "We suggest to use id over 100 for user custom packets, because this list will keep growing in the future"
   DReyeVR = DREYEVR_PACKET_ID,                         // our custom DReyeVR packet (for raw sensor data)
-  DReyeVRCustomActor = DREYEVR_CUSTOM_ACTOR_PACKET_ID, // custom DReyeVR actors (not raw sensor data)
-  DReyeVRConfigFile = DREYEVR_CONFIG_FILE_PACKET_ID    // DReyeVR configuration files (parameters)
+  DReyeVRCustomActor = DREYEVR_CUSTOM_ACTOR_PACKET_ID, // custom DReyeVR actors, every frame (older recordings)
+  DReyeVRConfigFile = DREYEVR_CONFIG_FILE_PACKET_ID,   // DReyeVR configuration files (parameters)
+  DReyeVRQuality = DREYEVR_QUALITY_PACKET_ID,          // DReyeVR adaptive quality changes (only when they happen)
+  DReyeVRCustomActorDelta = DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID // custom DReyeVR actors spawn/update/despawn
 };
 
 /// Recorder for the simulation
@@ -138,6 +143,8 @@ public:
 
   void AddWeather(const FWeatherParameters& WeatherParams);
 
+  void AddDReyeVRQualityChange(const DReyeVR::QualityChangeData &Change);
+
   // set episode
   void SetEpisode(UCarlaEpisode *ThisEpisode)
   {
@@ -161,10 +168,15 @@ public:
   std::string ShowFileInfo(std::string Name, bool bShowAll = false);
   std::string ShowFileCollisions(std::string Name, char Type1, char Type2);
   std::string ShowFileActorsBlocked(std::string Name, double MinTime = 30, double MinDistance = 10);
+  std::string ShowFileWindow(std::string Name, double TimeStart, double TimeEnd, std::string PacketTypes = "");
 
   // replayer
   std::string ReplayFile(std::string Name, double TimeStart, double Duration,
       uint32_t FollowId, bool ReplaySensors);
+  std::string ReplayFrameRange(std::string Name, uint64_t FrameStart, uint64_t FrameEnd,
+      uint32_t FollowId, bool ReplaySensors);
+  std::string ReplayTimeRange(std::string Name, double TimeStart, double TimeEnd,
+      uint32_t FollowId, bool ReplaySensors);
   void SetReplayerTimeFactor(double TimeFactor);
   void SetReplayerIgnoreHero(bool IgnoreHero);
   void StopReplayer(bool KeepActors = false);
@@ -180,6 +192,16 @@ private:
 
   uint32_t NextCollisionId = 0;
 
+  // custom actors already described in this recording (by ADReyeVRCustomActor id), see AddDReyeVRData
+  struct FRecordedCustomActor
+  {
+    uint32_t RecordId;
+    DReyeVR::CustomActorData Last; // as of the last Spawn/Update record
+    bool bSeen;
+  };
+  std::unordered_map<int32, FRecordedCustomActor> RecordedCustomActors;
+  uint32_t NextCustomActorRecordId = 0;
+
   // files
   std::ofstream File;
 
@@ -206,8 +228,9 @@ private:
   CarlaRecorderTrafficLightTimes TrafficLightTimes;
   CarlaRecorderWeathers Weathers;
   DReyeVRDataRecorders<DReyeVR::AggregateData, DREYEVR_PACKET_ID> DReyeVRAggData;
-  DReyeVRDataRecorders<DReyeVR::CustomActorData, DREYEVR_CUSTOM_ACTOR_PACKET_ID> DReyeVRCustomActorData;
+  DReyeVRDataRecorders<DReyeVR::CustomActorDelta, DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID> DReyeVRCustomActorDeltas;
   DReyeVRDataRecorders<DReyeVR::ConfigFileData, DREYEVR_CONFIG_FILE_PACKET_ID> DReyeVRConfigFileData;
+  DReyeVRDataRecorders<DReyeVR::QualityChangeData, DREYEVR_QUALITY_PACKET_ID> DReyeVRQualityData;
 
   // replayer
   CarlaReplayer Replayer;
@@ -10,7 +10,8 @@
 #include "CarlaRecorderHelpers.h"
 
 // create a temporal buffer to convert from and to FString and bytes
-static std::vector<uint8_t> CarlaRecorderHelperBuffer;
+// (per thread, so recordings can be parsed concurrently by offline tools)
+static thread_local std::vector<uint8_t> CarlaRecorderHelperBuffer;
 
 // get the final path + filename
 std::string GetRecorderFilename(std::string Filename)
@@ -6,6 +6,7 @@
 
 #include "CarlaRecorderHelpers.h"
 
+#include <cstdlib>
 #include <ctime>
 #include <sstream>
 #include <string>
@@ -605,6 +606,27 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
             SkipPacket();
         break;
 
+        // DReyeVR custom actor changes (spawn/update/despawn)
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActorDelta):
+        if (bShowAll)
+        {
+            ReadValue<uint16_t>(File, Total);
+            if (Total > 0 && !bFramePrinted)
+            {
+                PrintFrame(Info);
+                bFramePrinted = true;
+            }
+            Info << " DReyeVR custom actor changes: " << Total << std::endl;
+            for (i = 0; i < Total; ++i)
+            {
+                DReyeVRCustomActorDeltaInstance.Read(File);
+                Info << DReyeVRCustomActorDeltaInstance.Print() << std::endl;
+            }
+        }
+        else
+            SkipPacket();
+        break;
+
         // DReyeVR data (ConfigFileData)
         case static_cast<char>(CarlaRecorderPacketId::DReyeVRConfigFile):
         if (bShowAll)
@@ -625,6 +647,24 @@ std::string CarlaRecorderQuery::QueryInfo(std::string Filename, bool bShowAll)
         else
             SkipPacket();
         break;
+
+        // DReyeVR adaptive quality changes (always shown, these are rare and matter for the analysis)
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRQuality):
+        {
+            ReadValue<uint16_t>(File, Total);
+            if (Total > 0 && !bFramePrinted)
+            {
+                PrintFrame(Info);
+                bFramePrinted = true;
+            }
+            Info << " DReyeVR quality changes: " << Total << std::endl;
+            for (i = 0; i < Total; ++i)
+            {
+                DReyeVRQualityDataInstance.Read(File);
+                Info << "  " << DReyeVRQualityDataInstance.Print() << std::endl;
+            }
+        }
+        break;
         // frame end
         case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
         // do nothing, it is empty
@@ -992,3 +1032,441 @@ std::string CarlaRecorderQuery::QueryBlocked(std::string Filename, double MinTim
 
   return Info.str();
 }
+
+// packet names accepted by QueryWindow (same names as CarlaRecorderPacketId)
+static const std::pair<const char *, CarlaRecorderPacketId> WindowPacketNames[] = {
+  {"EventAdd", CarlaRecorderPacketId::EventAdd},
+  {"EventDel", CarlaRecorderPacketId::EventDel},
+  {"EventParent", CarlaRecorderPacketId::EventParent},
+  {"Collision", CarlaRecorderPacketId::Collision},
+  {"Position", CarlaRecorderPacketId::Position},
+  {"State", CarlaRecorderPacketId::State},
+  {"AnimVehicle", CarlaRecorderPacketId::AnimVehicle},
+  {"AnimWalker", CarlaRecorderPacketId::AnimWalker},
+  {"VehicleLight", CarlaRecorderPacketId::VehicleLight},
+  {"SceneLight", CarlaRecorderPacketId::SceneLight},
+  {"Kinematics", CarlaRecorderPacketId::Kinematics},
+  {"BoundingBox", CarlaRecorderPacketId::BoundingBox},
+  {"PlatformTime", CarlaRecorderPacketId::PlatformTime},
+  {"PhysicsControl", CarlaRecorderPacketId::PhysicsControl},
+  {"TrafficLightTime", CarlaRecorderPacketId::TrafficLightTime},
+  {"TriggerVolume", CarlaRecorderPacketId::TriggerVolume},
+  {"Weather", CarlaRecorderPacketId::Weather},
+  {"DReyeVR", CarlaRecorderPacketId::DReyeVR},
+  {"DReyeVRCustomActor", CarlaRecorderPacketId::DReyeVRCustomActor},
+  {"DReyeVRConfigFile", CarlaRecorderPacketId::DReyeVRConfigFile},
+  {"DReyeVRQuality", CarlaRecorderPacketId::DReyeVRQuality},
+  {"DReyeVRCustomActorDelta", CarlaRecorderPacketId::DReyeVRCustomActorDelta},
+};
+
+static const char *WindowPacketName(char Id)
+{
+  for (const auto &Entry : WindowPacketNames)
+  {
+    if (static_cast<char>(Entry.second) == Id)
+      return Entry.first;
+  }
+  return "Unknown";
+}
+
+static std::string JsonEscape(const std::string &In)
+{
+  std::string Out;
+  Out.reserve(In.size());
+  for (char C : In)
+  {
+    switch (C)
+    {
+      case '"': Out += "\\\""; break;
+      case '\\': Out += "\\\\"; break;
+      case '\n': Out += "\\n"; break;
+      case '\r': Out += "\\r"; break;
+      case '\t': Out += "\\t"; break;
+      default: Out += C; break;
+    }
+  }
+  return Out;
+}
+
+static std::string JsonString(const FString &In)
+{
+  return "\"" + JsonEscape(TCHAR_TO_UTF8(*In)) + "\"";
+}
+
+template <typename VectorT>
+static std::string JsonVector(const VectorT &V)
+{
+  std::stringstream Out;
+  Out << "[" << V.X << "," << V.Y << "," << V.Z << "]";
+  return Out.str();
+}
+
+static std::string JsonRotator(const FRotator &R)
+{
+  std::stringstream Out;
+  Out << "[" << R.Pitch << "," << R.Yaw << "," << R.Roll << "]";
+  return Out.str();
+}
+
+bool CarlaRecorderQuery::ParsePacketTypes(const std::string &PacketTypes, std::unordered_set<char> &Out)
+{
+  Out.clear();
+  std::stringstream Stream(PacketTypes);
+  std::string Token;
+  while (std::getline(Stream, Token, ','))
+  {
+    // trim whitespace
+    Token.erase(0, Token.find_first_not_of(" \t"));
+    Token.erase(Token.find_last_not_of(" \t") + 1);
+    if (Token.empty())
+      continue;
+    bool bFound = false;
+    for (const auto &Entry : WindowPacketNames)
+    {
+      if (Token == Entry.first)
+      {
+        Out.insert(static_cast<char>(Entry.second));
+        bFound = true;
+        break;
+      }
+    }
+    // also accept the raw numeric packet id (a byte, no exceptions on overflow: UE4 builds without them)
+    if (!bFound && Token.find_first_not_of("0123456789") == std::string::npos)
+    {
+      const unsigned long Id = std::strtoul(Token.c_str(), nullptr, 10); // ULONG_MAX when out of range
+      if (Id > 255)
+        return false;
+      Out.insert(static_cast<char>(Id));
+      bFound = true;
+    }
+    if (!bFound)
+      return false;
+  }
+  return true;
+}
+
+std::string CarlaRecorderQuery::QueryWindow(std::string Filename, double TimeStart, double TimeEnd,
+    std::string PacketTypes)
+{
+  std::stringstream Info;
+  Info << std::setprecision(9);
+
+  std::unordered_set<char> Wanted;
+  if (!ParsePacketTypes(PacketTypes, Wanted))
+  {
+    Info << "{\"error\":\"unknown packet type in '" << JsonEscape(PacketTypes) << "'\"}";
+    return Info.str();
+  }
+  const bool bWantAll = Wanted.empty();
+
+  // get the final path + filename
+  std::string Filename2 = GetRecorderFilename(Filename);
+
+  // the index gets built (and cached in a sidecar) the first time a recording is queried
+  if (!FrameIndex.Load(Filename2))
+  {
+    Info << "{\"error\":\"unable to index " << JsonEscape(Filename2) << "\"}";
+    return Info.str();
+  }
+
+  File.open(Filename2, std::ios::binary);
+  if (!File.is_open())
+  {
+    Info << "{\"error\":\"file " << JsonEscape(Filename2) << " not found on server\"}";
+    return Info.str();
+  }
+
+  Info << "{\"file\":\"" << JsonEscape(Filename2) << "\",\"time_start\":" << TimeStart
+       << ",\"time_end\":" << TimeEnd << ",\"frames\":[";
+
+  // jump straight to the last frame that starts at or before the window
+  File.seekg(FrameIndex[FrameIndex.FindFrameAtTime(TimeStart)].Offset, std::ios::beg);
+
+  uint16_t i, Total;
+  bool bInWindow = false;
+  bool bFirstFrame = true;
+  bool bFirstPacket = true;
+  auto CloseFrame = [&]()
+  {
+    if (!bFirstPacket)
+      Info << "}}";
+  };
+
+  while (File)
+  {
+    if (!ReadHeader())
+      break;
+
+    if (Header.Id == static_cast<char>(CarlaRecorderPacketId::FrameStart))
+    {
+      Frame.Read(File);
+      CloseFrame();
+      bFirstPacket = true;
+      if (Frame.Elapsed > TimeEnd)
+        break; // past the window, done
+      bInWindow = (Frame.Elapsed >= TimeStart);
+      continue;
+    }
+
+    if (!bInWindow || (!bWantAll && Wanted.count(Header.Id) == 0) ||
+        Header.Id == static_cast<char>(CarlaRecorderPacketId::FrameEnd))
+    {
+      SkipPacket();
+      continue;
+    }
+
+    // first selected packet in this frame opens the frame object
+    if (bFirstPacket)
+    {
+      Info << (bFirstFrame ? "" : ",") << "{\"id\":" << Frame.Id << ",\"elapsed\":" << Frame.Elapsed
+           << ",\"packets\":{";
+      bFirstFrame = false;
+    }
+    Info << (bFirstPacket ? "" : ",") << "\"" << WindowPacketName(Header.Id) << "\":";
+    bFirstPacket = false;
+
+    const std::streampos PacketEnd = File.tellg() + static_cast<std::streamoff>(Header.Size);
+    switch (Header.Id)
+    {
+      case static_cast<char>(CarlaRecorderPacketId::EventAdd):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          EventAdd.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << EventAdd.DatabaseId << ",\"type\":"
+               << static_cast<int>(EventAdd.Type) << ",\"description\":" << JsonString(EventAdd.Description.Id)
+               << ",\"location\":" << JsonVector(EventAdd.Location) << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::EventDel):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          EventDel.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << EventDel.DatabaseId << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::EventParent):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          EventParent.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << EventParent.DatabaseId << ",\"parent\":"
+               << EventParent.DatabaseIdParent << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::Collision):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          Collision.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << Collision.Id << ",\"actor1\":" << Collision.DatabaseId1
+               << ",\"actor1_hero\":" << (Collision.IsActor1Hero ? "true" : "false") << ",\"actor2\":"
+               << Collision.DatabaseId2 << ",\"actor2_hero\":" << (Collision.IsActor2Hero ? "true" : "false")
+               << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::Position):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          Position.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << Position.DatabaseId << ",\"location\":"
+               << JsonVector(Position.Location) << ",\"rotation\":" << JsonVector(Position.Rotation) << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::State):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          StateTraffic.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << StateTraffic.DatabaseId << ",\"state\":"
+               << static_cast<int>(StateTraffic.State) << ",\"frozen\":" << (StateTraffic.IsFrozen ? "true" : "false")
+               << ",\"elapsed_time\":" << StateTraffic.ElapsedTime << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::AnimVehicle):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          Vehicle.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << Vehicle.DatabaseId << ",\"steering\":" << Vehicle.Steering
+               << ",\"throttle\":" << Vehicle.Throttle << ",\"brake\":" << Vehicle.Brake << ",\"handbrake\":"
+               << (Vehicle.bHandbrake ? "true" : "false") << ",\"gear\":" << Vehicle.Gear << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::AnimWalker):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          Walker.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << Walker.DatabaseId << ",\"speed\":" << Walker.Speed << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::Kinematics):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          Kinematics.Read(File);
+          Info << (i ? "," : "") << "{\"id\":" << Kinematics.DatabaseId << ",\"linear_velocity\":"
+               << JsonVector(Kinematics.LinearVelocity) << ",\"angular_velocity\":"
+               << JsonVector(Kinematics.AngularVelocity) << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::PlatformTime):
+        PlatformTime.Read(File);
+        Info << "{\"time\":" << PlatformTime.Time << "}";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::DReyeVR):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          DReyeVRAggDataInstance.Read(File);
+          const DReyeVR::AggregateData &Data = DReyeVRAggDataInstance.Data;
+          const DReyeVR::UserInputs &Inputs = Data.GetUserInputs();
+          Info << (i ? "," : "") << "{"
+               << "\"timestamp_carla\":" << Data.GetTimestampCarla()
+               << ",\"timestamp_device\":" << Data.GetTimestampDevice()
+               << ",\"frame_sequence\":" << Data.GetFrameSequence()
+               << ",\"gaze_dir\":" << JsonVector(Data.GetGazeDir())
+               << ",\"gaze_origin\":" << JsonVector(Data.GetGazeOrigin())
+               << ",\"gaze_valid\":" << (Data.GetGazeValidity() ? "true" : "false")
+               << ",\"gaze_vergence\":" << Data.GetGazeVergence()
+               << ",\"left_gaze_dir\":" << JsonVector(Data.GetGazeDir(DReyeVR::Gaze::LEFT))
+               << ",\"left_gaze_valid\":" << (Data.GetGazeValidity(DReyeVR::Gaze::LEFT) ? "true" : "false")
+               << ",\"right_gaze_dir\":" << JsonVector(Data.GetGazeDir(DReyeVR::Gaze::RIGHT))
+               << ",\"right_gaze_valid\":" << (Data.GetGazeValidity(DReyeVR::Gaze::RIGHT) ? "true" : "false")
+               << ",\"left_eye_openness\":" << Data.GetEyeOpenness(DReyeVR::Eye::LEFT)
+               << ",\"right_eye_openness\":" << Data.GetEyeOpenness(DReyeVR::Eye::RIGHT)
+               << ",\"left_pupil_diam\":" << Data.GetPupilDiameter(DReyeVR::Eye::LEFT)
+               << ",\"right_pupil_diam\":" << Data.GetPupilDiameter(DReyeVR::Eye::RIGHT)
+               << ",\"camera_location\":" << JsonVector(Data.GetCameraLocation())
+               << ",\"camera_rotation\":" << JsonRotator(Data.GetCameraRotation())
+               << ",\"vehicle_location\":" << JsonVector(Data.GetVehicleLocation())
+               << ",\"vehicle_rotation\":" << JsonRotator(Data.GetVehicleRotation())
+               << ",\"velocity\":" << Data.GetVehicleVelocity()
+               << ",\"focus_actor_name\":" << JsonString(Data.GetFocusActorName())
+               << ",\"focus_actor_pt\":" << JsonVector(Data.GetFocusActorPoint())
+               << ",\"focus_actor_dist\":" << Data.GetFocusActorDistance()
+               << ",\"throttle\":" << Inputs.Throttle
+               << ",\"steering\":" << Inputs.Steering
+               << ",\"brake\":" << Inputs.Brake
+               << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActor):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          DReyeVRCustomActorDataInstance.Read(File);
+          const DReyeVR::CustomActorData &Data = DReyeVRCustomActorDataInstance.Data;
+          Info << (i ? "," : "") << "{\"name\":" << JsonString(Data.Name)
+               << ",\"location\":" << JsonVector(Data.Location)
+               << ",\"rotation\":" << JsonRotator(Data.Rotation)
+               << ",\"scale3d\":" << JsonVector(Data.Scale3D)
+               << ",\"mesh_path\":" << JsonString(Data.MeshPath)
+               << ",\"other\":" << JsonString(Data.Other) << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActorDelta):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          DReyeVRCustomActorDeltaInstance.Read(File);
+          const DReyeVR::CustomActorDelta &Delta = DReyeVRCustomActorDeltaInstance.Data;
+          const DReyeVR::CustomActorData &Data = Delta.State;
+          static const char *EventNames[] = {"spawn", "update", "despawn"};
+          const bool bSpawn = (Delta.Type == DReyeVR::CustomActorDelta::Spawn);
+          Info << (i ? "," : "") << "{\"event\":\"" << EventNames[Delta.Type % 3] << "\",\"id\":" << Delta.Id;
+          if (bSpawn)
+            Info << ",\"name\":" << JsonString(Data.Name) << ",\"mesh_path\":" << JsonString(Data.MeshPath);
+          // only the fields this record carries
+          if (bSpawn || (Delta.Mask & DReyeVR::CustomActorDelta::LocationBit))
+            Info << ",\"location\":" << JsonVector(Data.Location);
+          if (bSpawn || (Delta.Mask & DReyeVR::CustomActorDelta::RotationBit))
+            Info << ",\"rotation\":" << JsonRotator(Data.Rotation);
+          if (bSpawn || (Delta.Mask & DReyeVR::CustomActorDelta::Scale3DBit))
+            Info << ",\"scale3d\":" << JsonVector(Data.Scale3D);
+          if (bSpawn || (Delta.Mask & DReyeVR::CustomActorDelta::OtherBit))
+            Info << ",\"other\":" << JsonString(Data.Other);
+          if (Delta.Type == DReyeVR::CustomActorDelta::Update)
+            Info << ",\"material_mask\":" << static_cast<int>(Delta.MaterialMask);
+          Info << "}";
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::DReyeVRConfigFile):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          DReyeVRConfigFileDataInstance.Read(File);
+          Info << (i ? "," : "") << JsonString(DReyeVRConfigFileDataInstance.Data.ToString());
+        }
+        Info << "]";
+        break;
+
+      case static_cast<char>(CarlaRecorderPacketId::DReyeVRQuality):
+        ReadValue<uint16_t>(File, Total);
+        Info << "[";
+        for (i = 0; i < Total; ++i)
+        {
+          DReyeVRQualityDataInstance.Read(File);
+          const DReyeVR::QualityChangeData &Data = DReyeVRQualityDataInstance.Data;
+          Info << (i ? "," : "") << "{\"level\":" << Data.Level << ",\"prev_level\":" << Data.PrevLevel
+               << ",\"frame_ms\":" << Data.FrameMs << ",\"name\":" << JsonString(Data.LevelName) << "}";
+        }
+        Info << "]";
+        break;
+
+      default:
+        // no structured form (yet), report that the packet was there
+        Info << "{\"size\":" << Header.Size << "}";
+        break;
+    }
+    // resynchronize on the packet boundary regardless of what was (or was not) read
+    File.seekg(PacketEnd, std::ios::beg);
+  }
+  CloseFrame();
+  Info << "]}";
+
+  File.close();
+
+  return Info.str();
+}
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <fstream>
+#include <unordered_set>
 
 #include "CarlaRecorderTraficLightTime.h"
 #include "CarlaRecorderPhysicsControl.h"
@@ -26,6 +27,7 @@
 #include "CarlaRecorderState.h"
 #include "CarlaRecorderWeather.h"
 #include "DReyeVRRecorder.h"
+#include "DReyeVRFrameIndex.h"
 
 class CarlaRecorderQuery
 {
@@ -46,6 +48,9 @@ public:
   std::string QueryCollisions(std::string Filename, char Category1 = 'a', char Category2 = 'a');
   // get info about blocked actors
   std::string QueryBlocked(std::string Filename, double MinTime = 30, double MinDistance = 10);
+  // get the packets of the given types (comma separated names or ids, empty for all) within
+  // [TimeStart, TimeEnd] as json, seeking straight to TimeStart with the frame index
+  std::string QueryWindow(std::string Filename, double TimeStart, double TimeEnd, std::string PacketTypes = "");
 
 private:
 
@@ -73,6 +78,10 @@ private:
   DReyeVRDataRecorder<DReyeVR::AggregateData> DReyeVRAggDataInstance;
   DReyeVRDataRecorder<DReyeVR::CustomActorData> DReyeVRCustomActorDataInstance;
   DReyeVRDataRecorder<DReyeVR::ConfigFileData> DReyeVRConfigFileDataInstance;
+  DReyeVRDataRecorder<DReyeVR::QualityChangeData> DReyeVRQualityDataInstance;
+  DReyeVRDataRecorder<DReyeVR::CustomActorDelta> DReyeVRCustomActorDeltaInstance;
+  // frame offsets of the last queried recording
+  DReyeVRFrameIndex FrameIndex;
 
   // read next header packet
   bool ReadHeader(void);
@@ -82,4 +91,7 @@ private:
 
   // read the start info structure and check the magic string
   bool CheckFileInfo(std::stringstream &Info);
+
+  // parse a comma separated list of packet names/ids, false if any is unknown
+  static bool ParsePacketTypes(const std::string &PacketTypes, std::unordered_set<char> &Out);
 };
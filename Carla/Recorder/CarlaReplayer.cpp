@@ -16,7 +16,11 @@
 #include <sstream>
 
 // structure to save replaying info when need to load a new map (static member by now)
-CarlaReplayer::PlayAfterLoadMap CarlaReplayer::Autoplay { false, "", "", 0.0, 0.0, 0, 1.0, false };
+CarlaReplayer::PlayAfterLoadMap CarlaReplayer::Autoplay { false, "", "", 0.0, 0.0, 0, 1.0, false, {} };
+
+// also used by SeekToFrame
+template<>
+void CarlaReplayer::ProcessDReyeVR<DReyeVR::CustomActorDelta>(double Per, double DeltaTime);
 
 void CarlaReplayer::Stop(bool bKeepActors)
 {
@@ -73,6 +77,8 @@ void CarlaReplayer::Rewind(void)
   Frame.DurationThis = 0.0f;
 
   MappedId.clear();
+  bCustomActorStatesChanged = !CustomActorStates.empty(); // so the actors replayed so far are deactivated
+  CustomActorStates.clear();
   IsHeroMap.clear();
 
   // read geneal Info
@@ -156,6 +162,10 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
     Stop();
   }
 
+  // only replay a frame range if requested through ReplayFrameRange
+  FrameRange = PendingFrameRange;
+  PendingFrameRange = FrameRangeStruct();
+
   // get the final path + filename
   std::string Filename2 = GetRecorderFilename(Filename);
 
@@ -194,6 +204,7 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
     Autoplay.FollowId = ThisFollowId;
     Autoplay.TimeFactor = TimeFactor;
     Autoplay.ReplaySensors = ReplaySensors;
+    Autoplay.FrameRange = FrameRange;
   }
 
   // get Total time of recorder
@@ -224,14 +235,125 @@ std::string CarlaReplayer::ReplayFile(std::string Filename, double TimeStart, do
   // if we don't need to load a new map, then start
   if (!Autoplay.Enabled)
   {
-    Helper.RemoveStaticProps();
+    StartReplay(Filename2, TimeStart);
+  }
+
+  return Info.str();
+}
+
+std::string CarlaReplayer::ReplayFrameRange(std::string Filename, uint64_t FrameStart, uint64_t FrameEnd,
+    uint32_t ThisFollowId, bool ReplaySensors)
+{
+  std::stringstream Info;
+  const std::string Filename2 = GetRecorderFilename(Filename);
+  if (!FrameIndex.Load(Filename2))
+  {
+    Info << "Unable to index the frames of " << Filename2 << std::endl;
+    return Info.str();
+  }
+  if (FrameEnd == 0 || FrameEnd > FrameIndex.Num())
+    FrameEnd = FrameIndex.Num();
+  if (FrameStart >= FrameEnd)
+  {
+    Info << "Empty frame range [" << FrameStart << ", " << FrameEnd << ") of " << FrameIndex.Num() << " frames"
+         << std::endl;
+    return Info.str();
+  }
+  PendingFrameRange.Start = FrameStart;
+  PendingFrameRange.End = FrameEnd;
+  Info << "Replaying frames [" << FrameStart << ", " << FrameEnd << ") of " << FrameIndex.Num() << std::endl;
+  Info << ReplayFile(Filename, FrameIndex[FrameStart].Elapsed, 0.0, ThisFollowId, ReplaySensors);
+  return Info.str();
+}
+
+std::string CarlaReplayer::ReplayTimeRange(std::string Filename, double TimeStart, double TimeEnd,
+    uint32_t ThisFollowId, bool ReplaySensors)
+{
+  if (!FrameIndex.Load(GetRecorderFilename(Filename)))
+  {
+    return "Unable to index the frames of " + Filename + "\n";
+  }
+  const uint64_t FrameStart = FrameIndex.FindFirstFrameFrom(TimeStart);
+  const uint64_t FrameEnd = (TimeEnd > 0.0) ? FrameIndex.FindFirstFrameFrom(TimeEnd) : FrameIndex.Num();
+  if (FrameStart >= FrameEnd)
+  {
+    return "No frames start within the given time range\n";
+  }
+  return ReplayFrameRange(Filename, FrameStart, FrameEnd, ThisFollowId, ReplaySensors);
+}
+
+void CarlaReplayer::StartReplay(const std::string &FullFilename, double TimeStart)
+{
+  Helper.RemoveStaticProps();
+  // (re)start synchronous replays from the beginning of their frames
+  FrameStartTimes.clear();
+  SyncCurrentFrameId = 0;
+  if (FrameRange.IsSet() && FrameIndex.Load(FullFilename) &&
+      FrameRange.Start < FrameIndex.Num())
+  {
+    // the frames themselves are processed (and captured) by ProcessFrameByFrame
+    SeekToFrame(FrameRange.Start);
+  }
+  else
+  {
+    FrameRange = FrameRangeStruct();
     // process all events until the time
     ProcessToTime(TimeStart, true);
-    // mark as enabled
-    Enabled = true;
   }
+  // mark as enabled
+  Enabled = true;
+}
 
-  return Info.str();
+void CarlaReplayer::SeekToFrame(uint64_t FrameIdx)
+{
+  // only the actor/weather events (and custom actor changes) of the earlier frames matter, their positions/states are
+  // overwritten by the first replayed frame anyway. So skip straight over every frame that has no such events
+  // (see DReyeVRFrameIndex)
+  for (uint64_t i = 0; i < FrameIdx; i++)
+  {
+    if (!FrameIndex[i].bHasEvents)
+      continue;
+    File.clear();
+    File.seekg(FrameIndex[i].Offset, std::ios::beg);
+    bool bFrameEnd = false;
+    while (!bFrameEnd && ReadHeader() && File)
+    {
+      switch (Header.Id)
+      {
+        case static_cast<char>(CarlaRecorderPacketId::FrameStart):
+          Frame.Read(File);
+          break;
+        case static_cast<char>(CarlaRecorderPacketId::EventAdd):
+          ProcessEventsAdd();
+          break;
+        case static_cast<char>(CarlaRecorderPacketId::EventDel):
+          ProcessEventsDel();
+          break;
+        case static_cast<char>(CarlaRecorderPacketId::EventParent):
+          ProcessEventsParent();
+          break;
+        case static_cast<char>(CarlaRecorderPacketId::Weather):
+          ProcessWeather();
+          break;
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActorDelta):
+          ProcessDReyeVR<DReyeVR::CustomActorDelta>(0.0, 0.0);
+          break;
+        case static_cast<char>(CarlaRecorderPacketId::FrameEnd):
+          bFrameEnd = true;
+          break;
+        default:
+          SkipPacket();
+          break;
+      }
+    }
+  }
+
+  // continue right at the start of the first frame of the range
+  File.clear();
+  File.seekg(FrameIndex[FrameIdx].Offset, std::ios::beg);
+  CurrentTime = (FrameIdx > 0) ? FrameIndex[FrameIdx - 1].Elapsed : 0.0;
+  Frame.Elapsed = -1.0f; // force reading the next frame header
+  Frame.DurationThis = 0.0f;
 }
 
 void CarlaReplayer::CheckPlayAfterMapLoaded(void)
@@ -286,13 +408,8 @@ void CarlaReplayer::CheckPlayAfterMapLoaded(void)
   // apply time factor
   TimeFactor = Autoplay.TimeFactor;
 
-  Helper.RemoveStaticProps();
-
-  // process all events until the time
-  ProcessToTime(TimeStart, true);
-
-  // mark as enabled
-  Enabled = true;
+  FrameRange = Autoplay.FrameRange;
+  StartReplay(Autoplay.Filename, TimeStart);
 }
 
 class ADReyeVRSensor *CarlaReplayer::GetEgoSensor()
@@ -343,9 +460,18 @@ void CarlaReplayer::ProcessDReyeVR<DReyeVR::ConfigFileData>(double Per, double D
   }
 }
 
+void CarlaReplayer::ReplayCustomActor(const DReyeVR::CustomActorData &Data, double Per)
+{
+  Helper.ProcessReplayerDReyeVR<DReyeVR::CustomActorData>(GetEgoSensor(), Data, Per);
+  const ADReyeVRCustomActor *Replayed = ADReyeVRCustomActor::FindActive(Data.Name);
+  if (Replayed != nullptr)
+    CustomActorsVisited.insert(Replayed->GetId()); // to track lifetime
+}
+
 template<>
 void CarlaReplayer::ProcessDReyeVR<DReyeVR::CustomActorData>(double Per, double DeltaTime)
 {
+  // recordings from before CustomActorDelta: every actor in every frame
   uint16_t Total;
   ReadValue<uint16_t>(File, Total); // read number of events
   CustomActorsVisited.clear();
@@ -353,14 +479,45 @@ void CarlaReplayer::ProcessDReyeVR<DReyeVR::CustomActorData>(double Per, double
   {
     struct DReyeVRDataRecorder<DReyeVR::CustomActorData> Instance;
     Instance.Read(File);
-    Helper.ProcessReplayerDReyeVR<DReyeVR::CustomActorData>(GetEgoSensor(), Instance.Data, Per);
-    auto Name = Instance.GetUniqueName();
-    CustomActorsVisited.insert(Name); // to track lifetime
+    ReplayCustomActor(Instance.Data, Per);
   }
+  DeactivateUnvisitedCustomActors();
+}
 
+template<>
+void CarlaReplayer::ProcessDReyeVR<DReyeVR::CustomActorDelta>(double Per, double DeltaTime)
+{
+  // only updates the reconstructed states, these are replayed once the frame is found (ReplayCustomActorStates)
+  uint16_t Total;
+  ReadValue<uint16_t>(File, Total); // read number of events
+  for (uint16_t i = 0; i < Total; ++i)
+  {
+    struct DReyeVRDataRecorder<DReyeVR::CustomActorDelta> Instance;
+    Instance.Read(File);
+    const DReyeVR::CustomActorDelta &Delta = Instance.Data;
+    if (Delta.Type == DReyeVR::CustomActorDelta::Despawn)
+      CustomActorStates.erase(Delta.Id);
+    else
+      Delta.ApplyTo(CustomActorStates[Delta.Id]);
+  }
+  bCustomActorStatesChanged = true;
+}
+
+void CarlaReplayer::ReplayCustomActorStates(double Per)
+{
+  if (!bCustomActorStatesChanged)
+    return;
+  CustomActorsVisited.clear();
+  for (const auto &State : CustomActorStates)
+    ReplayCustomActor(State.second, Per);
+  DeactivateUnvisitedCustomActors();
+  bCustomActorStatesChanged = false;
+}
+
+void CarlaReplayer::DeactivateUnvisitedCustomActors()
+{
   for (auto It = ADReyeVRCustomActor::ActiveCustomActors.begin(); It != ADReyeVRCustomActor::ActiveCustomActors.end();){
-    const std::string &ActiveActorName = It->first;
-    if (CustomActorsVisited.find(ActiveActorName) == CustomActorsVisited.end()) // currently alive actor who was not visited... time to disable
+    if (CustomActorsVisited.find(It->first) == CustomActorsVisited.end()) // currently alive actor who was not visited... time to disable
     {
       // now this has to be garbage collected
       auto Next = std::next(It, 1); // iterator following the last removed element
@@ -500,6 +657,11 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
           SkipPacket();
         break;
       
+      // DReyeVR custom actor changes (always read, the frames they are in might be skipped)
+      case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActorDelta):
+        ProcessDReyeVR<DReyeVR::CustomActorDelta>(Per, Time);
+        break;
+
       // DReyeVR config file data
       case static_cast<char>(CarlaRecorderPacketId::DReyeVRConfigFile):
         if (bFrameFound)
@@ -527,6 +689,7 @@ void CarlaReplayer::ProcessToTime(double Time, bool IsFirstTime)
   if (Enabled && bFrameFound)
   {
     UpdatePositions(Per, Time);
+    ReplayCustomActorStates(Per);
   }
 
   // save current time
@@ -845,7 +1008,7 @@ void CarlaReplayer::Tick(float Delta)
   // check if there are events to process (and unpaused)
   if (Enabled && !Paused)
   {
-    if (bReplaySync)
+    if (bReplaySync || FrameRange.IsSet()) // frame ranges are always replayed frame by frame
     {
       ProcessFrameByFrame();
     }
@@ -867,14 +1030,18 @@ void CarlaReplayer::ProcessFrameByFrame()
 
   // process to those times
   ensure(SyncCurrentFrameId < FrameStartTimes.size());
-  double LastTime = 0.f;
+  // the first frame continues from wherever the replay started (not necessarily the beginning of the recording)
+  double LastTime = CurrentTime;
   if (SyncCurrentFrameId > 0)
     LastTime = FrameStartTimes[SyncCurrentFrameId - 1];
   ProcessToTime(FrameStartTimes[SyncCurrentFrameId] - LastTime, (SyncCurrentFrameId == 0));
   if (GetEgoSensor()) // take screenshot of this frame
     GetEgoSensor()->TakeScreenshot();
   // progress to the next frame
-  if (SyncCurrentFrameId < FrameStartTimes.size() - 1)
+  const bool bEndOfRange = FrameRange.IsSet() && GetSyncFrameOrdinal() + 1 >= FrameRange.End;
+  if (bEndOfRange)
+    Stop(true); // no need to replay the rest of the recording just to destroy the actors
+  else if (SyncCurrentFrameId < FrameStartTimes.size() - 1)
     SyncCurrentFrameId++;
   else
     Stop();
@@ -23,6 +23,8 @@
 #include "CarlaRecorderState.h"
 #include "CarlaRecorderHelpers.h"
 #include "CarlaReplayerHelper.h"
+#include "DReyeVRFrameIndex.h"
+#include "Carla/Sensor/DReyeVRData.h"
 
 class UCarlaEpisode;
 
@@ -37,6 +39,17 @@ class CARLA_API CarlaReplayer
   #pragma pack(pop)
 
 public:
+  // DReyeVR: ordinal frames [Start, End) of a recording to replay frame by frame (unset if End <= Start)
+  struct FrameRangeStruct
+  {
+    uint64_t Start = 0;
+    uint64_t End = 0;
+    bool IsSet() const
+    {
+      return End > Start;
+    }
+  };
+
   struct PlayAfterLoadMap
   {
     bool Enabled;
@@ -47,6 +60,7 @@ public:
     uint32_t FollowId;
     double TimeFactor;
     bool ReplaySensors;
+    FrameRangeStruct FrameRange;
   };
 
   static PlayAfterLoadMap Autoplay;
@@ -57,6 +71,15 @@ public:
   std::string ReplayFile(std::string Filename, double TimeStart = 0.0f, double Duration = 0.0f,
       uint32_t FollowId = 0, bool ReplaySensors = false);
 
+  // DReyeVR: replay (synchronously, frame by frame) only the frames [FrameStart, FrameEnd) of a recording, where
+  // FrameEnd == 0 means until the end. The actor events of the earlier frames are replayed by seeking through the
+  // frame index, so several instances can each render a disjoint shard of one recording
+  std::string ReplayFrameRange(std::string Filename, uint64_t FrameStart, uint64_t FrameEnd,
+      uint32_t FollowId = 0, bool ReplaySensors = false);
+  // same for the frames starting in [TimeStart, TimeEnd), TimeEnd <= 0 means until the end
+  std::string ReplayTimeRange(std::string Filename, double TimeStart, double TimeEnd,
+      uint32_t FollowId = 0, bool ReplaySensors = false);
+
   // void Start(void);
   void Stop(bool KeepActors = false);
 
@@ -108,6 +131,28 @@ public:
   {
     bReplaySync = bSyncModeIn;
   }
+
+  // recorded frame/time that is currently being replayed (ex. for the frame capture index)
+  uint64_t GetCurrentFrameId() const
+  {
+    return Frame.Id;
+  }
+
+  double GetCurrentTime() const
+  {
+    return CurrentTime;
+  }
+
+  const FrameRangeStruct &GetFrameRange() const
+  {
+    return FrameRange;
+  }
+
+  // ordinal (within the recording) of the frame that is being replayed synchronously
+  uint64_t GetSyncFrameOrdinal() const
+  {
+    return FrameRange.Start + SyncCurrentFrameId;
+  }
   
 private:
 
@@ -170,7 +215,13 @@ private:
   // DReyeVR recordings
   template <typename T>
   void ProcessDReyeVR(double Per, double DeltaTime);
-  std::unordered_set<std::string> CustomActorsVisited = {};
+  std::unordered_set<int32> CustomActorsVisited = {}; // ADReyeVRCustomActor ids
+  // custom actor states reconstructed from the Spawn/Update/Despawn records (by record id), see CustomActorDelta
+  std::unordered_map<uint32_t, DReyeVR::CustomActorData> CustomActorStates;
+  bool bCustomActorStatesChanged = false; // since they were last replayed
+  void ReplayCustomActor(const DReyeVR::CustomActorData &Data, double Per);
+  void ReplayCustomActorStates(double Per);
+  void DeactivateUnvisitedCustomActors();
   class ADReyeVRSensor *GetEgoSensor(); // (safe) getter for EgoSensor
   TWeakObjectPtr<class ADReyeVRSensor> EgoSensor;
 
@@ -190,6 +241,13 @@ private:
   void GetFrameStartTimes();
   void ProcessFrameByFrame();
 
+  // frame ranges (sharded replay)
+  FrameRangeStruct FrameRange;
+  FrameRangeStruct PendingFrameRange; // for the next ReplayFile call
+  DReyeVRFrameIndex FrameIndex;
+  void StartReplay(const std::string &FullFilename, double TimeStart);
+  void SeekToFrame(uint64_t FrameIdx);
+
   // positions
   void UpdatePositions(double Per, double DeltaTime);
 
@@ -0,0 +1,191 @@
+#include "DReyeVRFrameIndex.h"
+#include "UnrealString.h"        // FString
+#include "CarlaRecorderHelpers.h" // ReadValue, ReadFString, WriteValue
+
+#include <algorithm>
+#include <ctime>
+
+namespace
+{
+const char FrameIndexMagic[] = "DREYEVR_FRAMEIDX";
+const uint16_t FrameIndexVersion = 3; // 3: bHasEvents also covers the custom actor delta packets
+// see CarlaRecorderPacketId
+const char FrameStartPacketId = 0;
+const char EventAddPacketId = 2;
+const char EventDelPacketId = 3;
+const char EventParentPacketId = 4;
+const char WeatherPacketId = 18;
+const char CustomActorDeltaPacketId = static_cast<char>(143); // DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID
+
+#pragma pack(push, 1)
+struct FrameIndexRecord
+{
+    uint64_t FrameId;
+    double Elapsed;
+    int64_t Offset;
+    uint8_t bHasEvents;
+};
+#pragma pack(pop)
+
+uint64_t GetFileSize(std::ifstream &InFile)
+{
+    const std::streampos Current = InFile.tellg();
+    InFile.seekg(0, std::ios::end);
+    const std::streampos End = InFile.tellg();
+    InFile.seekg(Current, std::ios::beg);
+    return static_cast<uint64_t>(End);
+}
+} // namespace
+
+void DReyeVRFrameIndex::Clear()
+{
+    Entries.clear();
+    IndexedFilename.clear();
+    IndexedSize = 0;
+}
+
+bool DReyeVRFrameIndex::Load(const std::string &Filename)
+{
+    std::ifstream InFile(Filename, std::ios::binary);
+    if (!InFile.is_open())
+    {
+        Clear();
+        return false;
+    }
+    const uint64_t RecordingSize = GetFileSize(InFile);
+
+    // already loaded (and recording unchanged)
+    if (Filename == IndexedFilename && RecordingSize == IndexedSize && !Entries.empty())
+        return true;
+
+    if (LoadSidecar(Filename, RecordingSize))
+    {
+        IndexedFilename = Filename;
+        return true;
+    }
+
+    if (!Build(InFile))
+        return false;
+    IndexedFilename = Filename;
+    Save(Filename); // best effort, the recording directory might be read-only
+    return true;
+}
+
+bool DReyeVRFrameIndex::Build(std::ifstream &InFile)
+{
+    Entries.clear();
+    InFile.clear();
+    IndexedSize = GetFileSize(InFile);
+    InFile.seekg(0, std::ios::beg);
+
+    // skip the recorder info (see CarlaRecorderInfo)
+    uint16_t Version;
+    FString Magic, Mapfile;
+    std::time_t Date;
+    ReadValue<uint16_t>(InFile, Version);
+    ReadFString(InFile, Magic);
+    ReadValue<std::time_t>(InFile, Date);
+    ReadFString(InFile, Mapfile);
+    if (!InFile || Magic != "CARLA_RECORDER")
+        return false;
+
+    // header-only walk over all the packets
+    char Id;
+    uint32_t Size;
+    while (InFile)
+    {
+        const std::streamoff PacketStart = InFile.tellg();
+        ReadValue<char>(InFile, Id);
+        ReadValue<uint32_t>(InFile, Size);
+        if (!InFile)
+            break;
+        if (Id == FrameStartPacketId)
+        {
+            uint64_t FrameId;
+            double DurationThis, Elapsed;
+            ReadValue<uint64_t>(InFile, FrameId);
+            ReadValue<double>(InFile, DurationThis);
+            ReadValue<double>(InFile, Elapsed);
+            if (!InFile)
+                break;
+            Entries.push_back({FrameId, Elapsed, PacketStart, false});
+            InFile.seekg(PacketStart + static_cast<std::streamoff>(sizeof(char) + sizeof(uint32_t) + Size));
+        }
+        else
+        {
+            // custom actor changes are only recorded once, so they cannot be skipped either
+            const bool bIsEvent = (Id == EventAddPacketId || Id == EventDelPacketId || Id == EventParentPacketId ||
+                                   Id == WeatherPacketId || Id == CustomActorDeltaPacketId);
+            if (bIsEvent && !Entries.empty())
+                Entries.back().bHasEvents = true;
+            InFile.seekg(Size, std::ios::cur);
+        }
+    }
+    InFile.clear();
+    return !Entries.empty();
+}
+
+bool DReyeVRFrameIndex::LoadSidecar(const std::string &Filename, uint64_t RecordingSize)
+{
+    std::ifstream InFile(GetSidecarFilename(Filename), std::ios::binary);
+    if (!InFile.is_open())
+        return false;
+    char Magic[sizeof(FrameIndexMagic)];
+    uint16_t Version;
+    uint64_t Size, Count;
+    InFile.read(Magic, sizeof(Magic));
+    ReadValue<uint16_t>(InFile, Version);
+    ReadValue<uint64_t>(InFile, Size);
+    ReadValue<uint64_t>(InFile, Count);
+    if (!InFile || std::string(Magic) != FrameIndexMagic || Version != FrameIndexVersion || Size != RecordingSize)
+        return false; // stale or foreign, rebuild
+    std::vector<FrameIndexRecord> Records(Count);
+    InFile.read(reinterpret_cast<char *>(Records.data()), Count * sizeof(FrameIndexRecord));
+    if (!InFile)
+        return false;
+    Entries.clear();
+    Entries.reserve(Count);
+    for (const FrameIndexRecord &R : Records)
+        Entries.push_back({R.FrameId, R.Elapsed, static_cast<std::streamoff>(R.Offset), R.bHasEvents != 0});
+    IndexedSize = RecordingSize;
+    return !Entries.empty();
+}
+
+bool DReyeVRFrameIndex::Save(const std::string &Filename) const
+{
+    std::ofstream OutFile(GetSidecarFilename(Filename), std::ios::binary | std::ios::trunc);
+    if (!OutFile.is_open())
+        return false;
+    OutFile.write(FrameIndexMagic, sizeof(FrameIndexMagic));
+    WriteValue<uint16_t>(OutFile, FrameIndexVersion);
+    WriteValue<uint64_t>(OutFile, IndexedSize);
+    WriteValue<uint64_t>(OutFile, Entries.size());
+    for (const DReyeVRFrameIndexEntry &E : Entries)
+        WriteValue<FrameIndexRecord>(OutFile, {E.FrameId, E.Elapsed, static_cast<int64_t>(E.Offset),
+                                               static_cast<uint8_t>(E.bHasEvents)});
+    return static_cast<bool>(OutFile);
+}
+
+size_t DReyeVRFrameIndex::FindFrameAtTime(double Time) const
+{
+    // first frame strictly after Time, then step back one
+    auto It = std::upper_bound(Entries.begin(), Entries.end(), Time,
+                               [](double T, const DReyeVRFrameIndexEntry &E) { return T < E.Elapsed; });
+    if (It == Entries.begin())
+        return 0;
+    return static_cast<size_t>(std::distance(Entries.begin(), It)) - 1;
+}
+
+size_t DReyeVRFrameIndex::FindFirstFrameFrom(double Time) const
+{
+    auto It = std::lower_bound(Entries.begin(), Entries.end(), Time,
+                               [](const DReyeVRFrameIndexEntry &E, double T) { return E.Elapsed < T; });
+    return static_cast<size_t>(std::distance(Entries.begin(), It));
+}
+
+size_t DReyeVRFrameIndex::FindFrameById(uint64_t FrameId) const
+{
+    auto It = std::lower_bound(Entries.begin(), Entries.end(), FrameId,
+                               [](const DReyeVRFrameIndexEntry &E, uint64_t Id) { return E.FrameId < Id; });
+    return static_cast<size_t>(std::distance(Entries.begin(), It));
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// index of every FrameStart packet in a recording (frame id, elapsed time, file offset) so that queries and
+// the replayer can seek directly to a point in time instead of walking every packet from the beginning.
+// The index is cached in a sidecar file next to the recording (<recording>.frameidx) and rebuilt with a
+// header-only scan whenever the sidecar is missing or stale (recording size changed)
+
+struct DReyeVRFrameIndexEntry
+{
+    uint64_t FrameId;
+    double Elapsed;        // seconds since the start of the recording
+    std::streamoff Offset; // file offset of the FrameStart packet header
+    bool bHasEvents;       // frame spawns/destroys/attaches actors, changes weather or custom actors (see SeekToFrame)
+};
+
+class DReyeVRFrameIndex
+{
+  public:
+    // load the index for this recording (Filename is the final path, see GetRecorderFilename)
+    bool Load(const std::string &Filename);
+    // scan the (already opened, positioned anywhere) recording to build the index from scratch
+    bool Build(std::ifstream &InFile);
+    // write the current index to the sidecar file for this recording
+    bool Save(const std::string &Filename) const;
+    void Clear();
+
+    // index of the last frame that starts at or before Time (0 if Time precedes the first frame)
+    size_t FindFrameAtTime(double Time) const;
+    // index of the first frame whose id is >= FrameId (Num() if none)
+    size_t FindFrameById(uint64_t FrameId) const;
+    // index of the first frame that starts at or after Time (Num() if none)
+    size_t FindFirstFrameFrom(double Time) const;
+
+    const DReyeVRFrameIndexEntry &operator[](size_t Idx) const
+    {
+        return Entries[Idx];
+    }
+    size_t Num() const
+    {
+        return Entries.size();
+    }
+    bool IsEmpty() const
+    {
+        return Entries.empty();
+    }
+    double GetTotalTime() const
+    {
+        return Entries.empty() ? 0.0 : Entries.back().Elapsed;
+    }
+    const std::string &GetFilename() const
+    {
+        return IndexedFilename;
+    }
+
+    static std::string GetSidecarFilename(const std::string &Filename)
+    {
+        return Filename + ".frameidx";
+    }
+
+  private:
+    bool LoadSidecar(const std::string &Filename, uint64_t RecordingSize);
+    std::vector<DReyeVRFrameIndexEntry> Entries;
+    std::string IndexedFilename;
+    uint64_t IndexedSize = 0; // size of the recording when the index was built
+};
@@ -49,6 +49,10 @@ template <typename T, uint8_t N> class DReyeVRDataRecorders
     {
         AllData.clear();
     }
+    size_t Num(void) const
+    {
+        return AllData.size();
+    }
     void Write(std::ofstream &OutFile)
     {
         // write the packet id
@@ -1,3 +1,4 @@
+#include <cstring> // std::memcmp
 #include <string>
 #include <unordered_map>
 
@@ -237,19 +238,56 @@ FString EyeTracker::ToString() const
 /// ------------:CONFIGFILEDATA:-------------- ///
 /// ========================================== ///
 
-void ConfigFileData::Set(const std::string &Contents)
+// written after the contents, so older recordings (without fingerprints) can still be read
+static constexpr char ConfigFingerprintsMagic[8] = {'D', 'R', 'C', 'F', 'G', 'F', 'P', '1'};
+
+void ConfigFileData::Set(const std::string &Contents, const SectionFingerprints &SectionHashes)
 {
     StringContents = FString(Contents.c_str());
+    Fingerprints = SectionHashes;
+}
+
+const ConfigFileData::SectionFingerprints &ConfigFileData::GetFingerprints() const
+{
+    return Fingerprints;
 }
 
 void ConfigFileData::Read(std::ifstream &InFile)
 {
     ReadFString(InFile, StringContents);
+    Fingerprints.clear();
+    // peek for the fingerprints, otherwise this is an older recording and the next packet follows
+    const std::streampos Pos = InFile.tellg();
+    char Magic[sizeof(ConfigFingerprintsMagic)] = {0};
+    InFile.read(Magic, sizeof(Magic));
+    if (!InFile || std::memcmp(Magic, ConfigFingerprintsMagic, sizeof(Magic)) != 0)
+    {
+        InFile.clear();
+        InFile.seekg(Pos);
+        return;
+    }
+    uint16_t Num;
+    ReadValue<uint16_t>(InFile, Num);
+    Fingerprints.resize(Num);
+    for (auto &Entry : Fingerprints)
+    {
+        FString Section;
+        ReadFString(InFile, Section);
+        Entry.first = TCHAR_TO_UTF8(*Section);
+        ReadValue<uint64_t>(InFile, Entry.second);
+    }
 }
 
 void ConfigFileData::Write(std::ofstream &OutFile) const
 {
     WriteFString(OutFile, StringContents);
+    OutFile.write(ConfigFingerprintsMagic, sizeof(ConfigFingerprintsMagic));
+    WriteValue<uint16_t>(OutFile, static_cast<uint16_t>(Fingerprints.size()));
+    for (const auto &Entry : Fingerprints)
+    {
+        WriteFString(OutFile, FString(Entry.first.c_str()));
+        WriteValue<uint64_t>(OutFile, Entry.second);
+    }
 }
 
 FString ConfigFileData::ToString() const
@@ -257,6 +295,31 @@ FString ConfigFileData::ToString() const
     return StringContents;
 }
 
+/// ========================================== ///
+/// -----------:QUALITYCHANGEDATA:------------ ///
+/// ========================================== ///
+
+void QualityChangeData::Read(std::ifstream &InFile)
+{
+    ReadValue<int32_t>(InFile, Level);
+    ReadValue<int32_t>(InFile, PrevLevel);
+    ReadValue<float>(InFile, FrameMs);
+    ReadFString(InFile, LevelName);
+}
+
+void QualityChangeData::Write(std::ofstream &OutFile) const
+{
+    WriteValue<int32_t>(OutFile, Level);
+    WriteValue<int32_t>(OutFile, PrevLevel);
+    WriteValue<float>(OutFile, FrameMs);
+    WriteFString(OutFile, LevelName);
+}
+
+FString QualityChangeData::ToString() const
+{
+    return FString::Printf(TEXT("Level:%d,PrevLevel:%d,FrameMs:%.3f,Name:%s"), Level, PrevLevel, FrameMs, *LevelName);
+}
+
 /// ========================================== ///
 /// -------------:AGGREGATEDATA:-------------- ///
 /// ========================================== ///
@@ -448,6 +511,11 @@ const DReyeVR::UserInputs &AggregateData::GetUserInputs() const
     return Inputs;
 }
 
+const DReyeVR::HapticControl &AggregateData::GetHapticControl() const
+{
+    return Haptic;
+}
+
 void AggregateData::UpdateCamera(const FVector &NewCameraLoc, const FRotator &NewCameraRot)
 {
     EgoVars.CameraLocation = NewCameraLoc;
@@ -477,6 +545,11 @@ void AggregateData::Update(int64_t NewTimestamp, const struct EyeTracker &NewEye
     Inputs = NewInputs;
 }
 
+void AggregateData::UpdateHaptic(const struct HapticControl &NewHaptic)
+{
+    Haptic = NewHaptic;
+}
+
 void AggregateData::Read(std::ifstream &InFile)
 {
     /// CAUTION: make sure the order of writes/reads is the same
@@ -512,7 +585,26 @@ FString AggregateData::ToString() const
 /// ------------:CUSTOMACTORDATA:------------- ///
 /// ========================================== ///
 
-void CustomActorData::MaterialParamsStruct::Apply(class UMaterialInstanceDynamic *DynamicMaterial) const
+uint8_t CustomActorData::MaterialParamsStruct::DiffMask(const MaterialParamsStruct &Other) const
+{
+    uint8_t Mask = 0;
+    Mask |= (Metallic != Other.Metallic) ? MetallicBit : 0;
+    Mask |= (Specular != Other.Specular) ? SpecularBit : 0;
+    Mask |= (Roughness != Other.Roughness) ? RoughnessBit : 0;
+    Mask |= (Anisotropy != Other.Anisotropy) ? AnisotropyBit : 0;
+    Mask |= (Opacity != Other.Opacity) ? OpacityBit : 0;
+    Mask |= (BaseColor != Other.BaseColor) ? BaseColorBit : 0;
+    Mask |= (Emissive != Other.Emissive) ? EmissiveBit : 0;
+    return Mask;
+}
+
+bool CustomActorData::MaterialParamsStruct::operator==(const MaterialParamsStruct &Other) const
+{
+    return DiffMask(Other) == 0 && MaterialPath == Other.MaterialPath;
+}
+
+void CustomActorData::MaterialParamsStruct::Apply(class UMaterialInstanceDynamic *DynamicMaterial,
+                                                  uint8_t Mask) const
 {
     /// PARAMS:
     // these are either scalar (float) or vector (FLinearColor) attributes baked into the texture as follows
@@ -531,16 +623,23 @@ void CustomActorData::MaterialParamsStruct::Apply(class UMaterialInstanceDynamic
     /// NOTE: Opacity only gets applied when the material is based on the TranslucentParamMaterial, all the other scalar
     // params only get applied in the opaque case.
 
-    // assign material params
+    // assign material params (each one is a separate update of the material's render resource, hence the Mask)
     if (DynamicMaterial != nullptr)
     {
-        DynamicMaterial->SetScalarParameterValue("Metallic", Metallic);
-        DynamicMaterial->SetScalarParameterValue("Specular", Specular);
-        DynamicMaterial->SetScalarParameterValue("Roughness", Roughness);
-        DynamicMaterial->SetScalarParameterValue("Anisotropy", Anisotropy);
-        DynamicMaterial->SetScalarParameterValue("Opacity", Opacity);
-        DynamicMaterial->SetVectorParameterValue("BaseColor", BaseColor);
-        DynamicMaterial->SetVectorParameterValue("Emissive", Emissive);
+        if (Mask & MetallicBit)
+            DynamicMaterial->SetScalarParameterValue("Metallic", Metallic);
+        if (Mask & SpecularBit)
+            DynamicMaterial->SetScalarParameterValue("Specular", Specular);
+        if (Mask & RoughnessBit)
+            DynamicMaterial->SetScalarParameterValue("Roughness", Roughness);
+        if (Mask & AnisotropyBit)
+            DynamicMaterial->SetScalarParameterValue("Anisotropy", Anisotropy);
+        if (Mask & OpacityBit)
+            DynamicMaterial->SetScalarParameterValue("Opacity", Opacity);
+        if (Mask & BaseColorBit)
+            DynamicMaterial->SetVectorParameterValue("BaseColor", BaseColor);
+        if (Mask & EmissiveBit)
+            DynamicMaterial->SetVectorParameterValue("Emissive", Emissive);
     }
 }
 
@@ -637,4 +736,182 @@ std::string CustomActorData::GetUniqueName() const
     return TCHAR_TO_UTF8(*Name);
 }
 
+bool CustomActorData::operator==(const CustomActorData &Other) const
+{
+    // cheapest comparisons first
+    return Location == Other.Location && Rotation == Other.Rotation && Scale3D == Other.Scale3D &&
+           MaterialParams == Other.MaterialParams && Name == Other.Name && MeshPath == Other.MeshPath &&
+           this->Other == Other.Other;
+}
+
+/// ========================================== ///
+/// -----------:CUSTOMACTORDELTA:------------- ///
+/// ========================================== ///
+
+bool CustomActorDelta::NeedsRespawn(const CustomActorData &Prev, const CustomActorData &Curr)
+{
+    return Prev.Name != Curr.Name || Prev.MeshPath != Curr.MeshPath ||
+           Prev.MaterialParams.MaterialPath != Curr.MaterialParams.MaterialPath;
+}
+
+void CustomActorDelta::MakeSpawn(uint32_t InId, const CustomActorData &Curr)
+{
+    Type = Spawn;
+    Id = InId;
+    Mask = 0;
+    MaterialMask = 0;
+    State = Curr;
+}
+
+bool CustomActorDelta::MakeUpdate(uint32_t InId, const CustomActorData &Prev, const CustomActorData &Curr)
+{
+    Type = Update;
+    Id = InId;
+    Mask = 0;
+    Mask |= (Prev.Location != Curr.Location) ? LocationBit : 0;
+    Mask |= (Prev.Rotation != Curr.Rotation) ? RotationBit : 0;
+    Mask |= (Prev.Scale3D != Curr.Scale3D) ? Scale3DBit : 0;
+    Mask |= (Prev.Other != Curr.Other) ? OtherBit : 0;
+    MaterialMask = Prev.MaterialParams.DiffMask(Curr.MaterialParams);
+    if (Mask == 0 && MaterialMask == 0)
+        return false;
+    State = Curr;
+    return true;
+}
+
+void CustomActorDelta::MakeDespawn(uint32_t InId)
+{
+    Type = Despawn;
+    Id = InId;
+    Mask = 0;
+    MaterialMask = 0;
+}
+
+void CustomActorDelta::ApplyTo(CustomActorData &Target) const
+{
+    if (Type == Spawn)
+    {
+        Target = State;
+        return;
+    }
+    if (Type != Update)
+        return;
+    if (Mask & LocationBit)
+        Target.Location = State.Location;
+    if (Mask & RotationBit)
+        Target.Rotation = State.Rotation;
+    if (Mask & Scale3DBit)
+        Target.Scale3D = State.Scale3D;
+    if (Mask & OtherBit)
+        Target.Other = State.Other;
+    using Params = CustomActorData::MaterialParamsStruct;
+    const Params &From = State.MaterialParams;
+    Params &To = Target.MaterialParams;
+    if (MaterialMask & Params::MetallicBit)
+        To.Metallic = From.Metallic;
+    if (MaterialMask & Params::SpecularBit)
+        To.Specular = From.Specular;
+    if (MaterialMask & Params::RoughnessBit)
+        To.Roughness = From.Roughness;
+    if (MaterialMask & Params::AnisotropyBit)
+        To.Anisotropy = From.Anisotropy;
+    if (MaterialMask & Params::OpacityBit)
+        To.Opacity = From.Opacity;
+    if (MaterialMask & Params::BaseColorBit)
+        To.BaseColor = From.BaseColor;
+    if (MaterialMask & Params::EmissiveBit)
+        To.Emissive = From.Emissive;
+}
+
+void CustomActorDelta::Read(std::ifstream &InFile)
+{
+    ReadValue<EventType>(InFile, Type);
+    ReadValue<uint32_t>(InFile, Id);
+    if (Type == Spawn)
+    {
+        State.Read(InFile);
+        return;
+    }
+    if (Type != Update)
+        return;
+    ReadValue<uint8_t>(InFile, Mask);
+    ReadValue<uint8_t>(InFile, MaterialMask);
+    if (Mask & LocationBit)
+        ReadFVector(InFile, State.Location);
+    if (Mask & RotationBit)
+        ReadFRotator(InFile, State.Rotation);
+    if (Mask & Scale3DBit)
+        ReadFVector(InFile, State.Scale3D);
+    if (Mask & OtherBit)
+        ReadFString(InFile, State.Other);
+    using Params = CustomActorData::MaterialParamsStruct;
+    Params &P = State.MaterialParams;
+    if (MaterialMask & Params::MetallicBit)
+        ReadValue<float>(InFile, P.Metallic);
+    if (MaterialMask & Params::SpecularBit)
+        ReadValue<float>(InFile, P.Specular);
+    if (MaterialMask & Params::RoughnessBit)
+        ReadValue<float>(InFile, P.Roughness);
+    if (MaterialMask & Params::AnisotropyBit)
+        ReadValue<float>(InFile, P.Anisotropy);
+    if (MaterialMask & Params::OpacityBit)
+        ReadValue<float>(InFile, P.Opacity);
+    if (MaterialMask & Params::BaseColorBit)
+        ReadFLinearColor(InFile, P.BaseColor);
+    if (MaterialMask & Params::EmissiveBit)
+        ReadFLinearColor(InFile, P.Emissive);
+}
+
+void CustomActorDelta::Write(std::ofstream &OutFile) const
+{
+    WriteValue<EventType>(OutFile, Type);
+    WriteValue<uint32_t>(OutFile, Id);
+    if (Type == Spawn)
+    {
+        State.Write(OutFile);
+        return;
+    }
+    if (Type != Update)
+        return;
+    WriteValue<uint8_t>(OutFile, Mask);
+    WriteValue<uint8_t>(OutFile, MaterialMask);
+    if (Mask & LocationBit)
+        WriteFVector(OutFile, State.Location);
+    if (Mask & RotationBit)
+        WriteFRotator(OutFile, State.Rotation);
+    if (Mask & Scale3DBit)
+        WriteFVector(OutFile, State.Scale3D);
+    if (Mask & OtherBit)
+        WriteFString(OutFile, State.Other);
+    using Params = CustomActorData::MaterialParamsStruct;
+    const Params &P = State.MaterialParams;
+    if (MaterialMask & Params::MetallicBit)
+        WriteValue<float>(OutFile, P.Metallic);
+    if (MaterialMask & Params::SpecularBit)
+        WriteValue<float>(OutFile, P.Specular);
+    if (MaterialMask & Params::RoughnessBit)
+        WriteValue<float>(OutFile, P.Roughness);
+    if (MaterialMask & Params::AnisotropyBit)
+        WriteValue<float>(OutFile, P.Anisotropy);
+    if (MaterialMask & Params::OpacityBit)
+        WriteValue<float>(OutFile, P.Opacity);
+    if (MaterialMask & Params::BaseColorBit)
+        WriteFLinearColor(OutFile, P.BaseColor);
+    if (MaterialMask & Params::EmissiveBit)
+        WriteFLinearColor(OutFile, P.Emissive);
+}
+
+FString CustomActorDelta::ToString() const
+{
+    switch (Type)
+    {
+    case Spawn:
+        return FString::Printf(TEXT("  [DReyeVR_CA]Spawn:%u,"), Id) + State.ToString();
+    case Update:
+        return FString::Printf(TEXT("  [DReyeVR_CA]Update:%u,Mask:%u,MaterialMask:%u,"), Id, Mask, MaterialMask);
+    default:
+        return FString::Printf(TEXT("  [DReyeVR_CA]Despawn:%u,"), Id);
+    }
+}
+
 }; // namespace DReyeVR
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>                               // std::pair
+#include <vector>
 
 namespace DReyeVR
 {
@@ -92,6 +94,18 @@ struct CARLA_API UserInputs : public DataSerializer
     FString ToString() const override;
 };
 
+// output of the haptic shared control (see DReyeVR/HapticSharedControl.h), streamed to clients but not recorded
+struct CARLA_API HapticControl
+{
+    bool bActive = false;              // a reference trajectory is loaded and the controller is running
+    float Torque = 0.f;                // tau_das
+    float Coefficient = 0.f;           // sigmoid(Cs * e(t)), suggested spring coefficient
+    float DesiredSteeringAngle = 0.f;  // theta_d, steering-wheel angle (deg)
+    float Error = 0.f;                 // e(t), distance to the trajectory (m)
+    float PredictedError = 0.f;        // eps(tp), signed distance of the previewed position (m)
+    FVector PredictedLocation = FVector::ZeroVector; // previewed position (m, world)
+};
+
 struct CARLA_API FocusInfo : public DataSerializer
 {
     // substitute for SRanipal FFocusInfo in SRanipal_Eyes_Enums.h
@@ -136,10 +150,31 @@ enum class Eye
 // all DReyeVR Config data (only used once at the start of each recording)
 class CARLA_API ConfigFileData : public DataSerializer
 {
+  public:
+    // (section, ConfigFile fingerprint), sorted by section (see ConfigFile::Fingerprints)
+    using SectionFingerprints = std::vector<std::pair<std::string, uint64_t>>;
+
   private:
-    FString StringContents; // all the config files, concatenated
+    FString StringContents;          // all the config files, concatenated
+    SectionFingerprints Fingerprints; // empty for recordings made before these were recorded
+  public:
+    void Set(const std::string &Contents, const SectionFingerprints &SectionHashes = {});
+    const SectionFingerprints &GetFingerprints() const;
+    void Read(std::ifstream &InFile) override;
+    void Write(std::ofstream &OutFile) const override;
+    FString ToString() const override;
+};
+
+// a change of the adaptive rendering quality (see DReyeVR/QualityGovernor.h), recorded whenever it happens so the
+// analysis can account for it
+class CARLA_API QualityChangeData : public DataSerializer
+{
   public:
-    void Set(const std::string &Contents);
+    int32_t Level = 0;     // new level (0 is full quality)
+    int32_t PrevLevel = 0; // level before the change
+    float FrameMs = 0.f;   // frame cost (percentile of a window of frames) that caused the change
+    FString LevelName;
+
     void Read(std::ifstream &InFile) override;
     void Write(std::ofstream &OutFile) const override;
     FString ToString() const override;
@@ -179,6 +214,7 @@ class CARLA_API AggregateData : public DataSerializer
     const FVector &GetFocusActorPoint() const;
     float GetFocusActorDistance() const;
     const DReyeVR::UserInputs &GetUserInputs() const;
+    const DReyeVR::HapticControl &GetHapticControl() const;
 
     ////////////////////:SETTERS://////////////////////
     void UpdateCamera(const FVector &NewCameraLoc, const FRotator &NewCameraRot);
@@ -186,6 +222,7 @@ class CARLA_API AggregateData : public DataSerializer
     void UpdateVehicle(const FVector &NewVehicleLoc, const FRotator &NewVehicleRot);
     void Update(int64_t NewTimestamp, const struct EyeTracker &NewEyeData, const struct EgoVariables &NewEgoVars,
                 const struct FocusInfo &NewFocus, const struct UserInputs &NewInputs);
+    void UpdateHaptic(const struct HapticControl &NewHaptic);
 
     ////////////////////:SERIALIZATION://////////////////////
     void Read(std::ifstream &InFile) override;
@@ -198,6 +235,7 @@ class CARLA_API AggregateData : public DataSerializer
     struct EgoVariables EgoVars;
     struct FocusInfo FocusData;
     struct UserInputs Inputs;
+    struct HapticControl Haptic; // not part of Read/Write (recordings stay compatible)
 };
 
 class CARLA_API CustomActorData : public DataSerializer
@@ -224,7 +262,22 @@ class CARLA_API CustomActorData : public DataSerializer
         // usually a scale factor like 500 is good to emit bright light on a sunny day
         FLinearColor Emissive = 500.f * FLinearColor::Red;
         FString MaterialPath;
-        void Apply(class UMaterialInstanceDynamic *Material) const;
+
+        // one bit per parameter, so only the parameters that changed are pushed to the material
+        enum ParamBits : uint8_t
+        {
+            MetallicBit = 1 << 0,
+            SpecularBit = 1 << 1,
+            RoughnessBit = 1 << 2,
+            AnisotropyBit = 1 << 3,
+            OpacityBit = 1 << 4,
+            BaseColorBit = 1 << 5,
+            EmissiveBit = 1 << 6,
+            AllParamBits = 0x7F,
+        };
+        uint8_t DiffMask(const MaterialParamsStruct &Other) const; // the parameters that differ (not MaterialPath)
+        bool operator==(const MaterialParamsStruct &Other) const;
+        void Apply(class UMaterialInstanceDynamic *Material, uint8_t Mask = AllParamBits) const;
 
         void Read(std::ifstream &InFile) override;
         void Write(std::ofstream &OutFile) const override;
@@ -240,6 +293,45 @@ class CARLA_API CustomActorData : public DataSerializer
     void Write(std::ofstream &OutFile) const override;
     FString ToString() const override;
     std::string GetUniqueName() const;
+    bool operator==(const CustomActorData &Other) const; // ex. an unchanged actor in consecutive replay frames
+};
+
+// change-only record of a custom actor: its full description when it appears (Spawn), then only the fields that
+// changed (Update), then its removal (Despawn). Id is assigned by the recorder and only valid within one recording
+class CARLA_API CustomActorDelta : public DataSerializer
+{
+  public:
+    enum EventType : uint8_t
+    {
+        Spawn = 0,
+        Update = 1,
+        Despawn = 2,
+    };
+    // fields carried by an Update, the material params have their own MaterialParamsStruct::ParamBits mask
+    enum FieldBits : uint8_t
+    {
+        LocationBit = 1 << 0,
+        RotationBit = 1 << 1,
+        Scale3DBit = 1 << 2,
+        OtherBit = 1 << 3,
+    };
+
+    EventType Type = Spawn;
+    uint32_t Id = 0;
+    uint8_t Mask = 0;         // FieldBits (Update only)
+    uint8_t MaterialMask = 0; // MaterialParamsStruct::ParamBits (Update only)
+    CustomActorData State;    // all of it for a Spawn, only the masked fields for an Update
+
+    // a change of name, mesh or material can only be described by a Despawn followed by a Spawn
+    static bool NeedsRespawn(const CustomActorData &Prev, const CustomActorData &Curr);
+    void MakeSpawn(uint32_t InId, const CustomActorData &Curr);
+    bool MakeUpdate(uint32_t InId, const CustomActorData &Prev, const CustomActorData &Curr); // false if unchanged
+    void MakeDespawn(uint32_t InId);
+    void ApplyTo(CustomActorData &Target) const; // Spawn replaces Target, Update overwrites the masked fields
+
+    void Read(std::ifstream &InFile) override;
+    void Write(std::ofstream &OutFile) const override;
+    FString ToString() const override;
 };
 
 }; // namespace DReyeVR
\ No newline at end of file
@@ -144,7 +144,15 @@ void ADReyeVRSensor::PostPhysTick(UWorld *W, ELevelTick TickType, float DeltaSec
                     Data->GetUserInputs().Steering,       // Vehicle input steering
                     Data->GetUserInputs().Brake,          // Vehicle input brake
                     Data->GetUserInputs().ToggledReverse, // Vehicle input gear (reverse, fwd)
-                    Data->GetUserInputs().HoldHandbrake   // Vehicle input handbrake
+                    Data->GetUserInputs().HoldHandbrake,  // Vehicle input handbrake
+                    // haptic shared control
+                    Data->GetHapticControl().bActive,                         // Controller running
+                    Data->GetHapticControl().Torque,                          // Torque (tau_das)
+                    Data->GetHapticControl().Coefficient,                     // Sigmoid(Cs * e(t))
+                    Data->GetHapticControl().DesiredSteeringAngle,            // theta_d (deg)
+                    Data->GetHapticControl().Error,                           // e(t) (m)
+                    Data->GetHapticControl().PredictedError,                  // eps(tp) (m)
+                    ToGeom(Data->GetHapticControl().PredictedLocation)        // Previewed position (m)
                 });
 }
 
@@ -246,7 +254,7 @@ class ADReyeVRSensor *ADReyeVRSensor::GetDReyeVRSensor(class UWorld *World) // s
         DReyeVR_LOG_WARN("Detected world change! Invalidating cached data");
         ADReyeVRSensor::sWorld = World;
         ADReyeVRSensor::DReyeVRSensorPtr = nullptr;
-        ADReyeVRCustomActor::ActiveCustomActors.clear();
+        ADReyeVRCustomActor::ResetAll();
     }
 
     if (ADReyeVRSensor::DReyeVRSensorPtr == nullptr) // if need to look for DReyeVR sensor in world
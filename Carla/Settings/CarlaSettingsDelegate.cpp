@@ -2,14 +2,18 @@
 #include "Carla/Settings/CarlaSettingsDelegate.h"
 
 #include "Carla/Settings/CarlaSettings.h"
+#include "Carla/Game/Tagger.h"
+#include "Carla/Vehicle/CarlaWheeledVehicle.h"
 
 #include "Async.h"
+#include "Containers/Ticker.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/DirectionalLight.h"
 #include "Engine/Engine.h"
 #include "Engine/LocalPlayer.h"
 #include "Engine/PostProcessVolume.h"
 #include "Engine/StaticMesh.h"
+#include "GameFramework/Character.h"
 #include "GameFramework/HUD.h"
 #include "InstancedFoliageActor.h"
 #include "Kismet/GameplayStatics.h"
@@ -18,6 +22,251 @@
 
 
 static constexpr float CARLA_SETTINGS_MAX_SCALE_SIZE = 50.0f;
+static constexpr int32 CARLA_SETTINGS_NUM_CULL_CATEGORIES = static_cast<int32>(ECullCategory::Count);
+
+static bool IsCullable(const AActor *actor)
+{
+  return actor != nullptr && IsValid(actor) && !actor->IsPendingKill() &&
+      !actor->IsA<AInstancedFoliageActor>() && // foliage culling is controlled
+                                               // per instance
+      !actor->IsA<ALandscape>() && // dont touch landscapes nor roads
+      !actor->ActorHasTag(UCarlaSettings::CARLA_ROAD_TAG) &&
+      !actor->ActorHasTag(UCarlaSettings::CARLA_SKY_TAG);
+}
+
+static ECullCategory GetCullCategory(const AActor *actor, const TArray<UPrimitiveComponent *> &components)
+{
+  if (actor->IsA<ACarlaWheeledVehicle>())
+  {
+    return ECullCategory::Vehicle;
+  }
+  if (actor->IsA<ACharacter>())
+  {
+    return ECullCategory::Walker;
+  }
+  for (const UPrimitiveComponent *component : components)
+  {
+    const crp::CityObjectLabel label = ATagger::GetTagOfTaggableComponent(*component);
+    if (label == crp::CityObjectLabel::Buildings || label == crp::CityObjectLabel::Walls ||
+        label == crp::CityObjectLabel::Bridge)
+    {
+      return ECullCategory::Building;
+    }
+  }
+  return ECullCategory::Prop;
+}
+
+static void ApplyDrawDistance(UPrimitiveComponent &component, const float max_draw_distance)
+{
+  if (component.LDMaxDrawDistance == max_draw_distance &&
+      component.bAllowCullDistanceVolume == (max_draw_distance > 0))
+  {
+    return; // SetCullDistance would still mark the render state dirty
+  }
+  component.SetCullDistance(max_draw_distance);
+  component.bAllowCullDistanceVolume = max_draw_distance > 0;
+}
+
+/// Registry of the cullable primitive components of a world, bucketed by
+/// category. Filled once per world (on the first draw distance change) and
+/// then kept up to date on every spawn and destroy, so a draw distance change
+/// only walks the components of the affected categories, a few per frame.
+class FCullableRegistry
+{
+public:
+
+  ~FCullableRegistry()
+  {
+    if (Ticker.IsValid())
+    {
+      FTicker::GetCoreTicker().RemoveTicker(Ticker);
+    }
+  }
+
+  bool IsBuiltFor(const UWorld *world) const
+  {
+    return World.Get() == world;
+  }
+
+  void Build(UWorld *world)
+  {
+    for (TArray<FCullable> &bucket : Buckets)
+    {
+      bucket.Reset();
+    }
+    Categories.Reset();
+    World = world;
+    TArray<AActor *> actors;
+    UGameplayStatics::GetAllActorsOfClass(world, AActor::StaticClass(), actors);
+    for (AActor *actor : actors)
+    {
+      Register(actor);
+    }
+  }
+
+  void Register(AActor *actor)
+  {
+    if (!IsCullable(actor) || Categories.Contains(actor))
+    {
+      return;
+    }
+    TArray<UPrimitiveComponent *> components;
+    actor->GetComponents(components, false);
+    if (components.Num() == 0)
+    {
+      return;
+    }
+    const int32 category = static_cast<int32>(GetCullCategory(actor, components));
+    const float scale = (actor->GetActorScale().GetMax() > CARLA_SETTINGS_MAX_SCALE_SIZE) ? 100.0f : 1.0f;
+    Categories.Add(actor, category);
+    TArray<FCullable> &bucket = Buckets[category];
+    for (UPrimitiveComponent *component : components)
+    {
+      if (IsValid(component))
+      {
+        bucket.Add(FCullable{component, actor, scale});
+        if (bDistancesSet)
+        {
+          ApplyDrawDistance(*component, Distances[category] * scale);
+        }
+      }
+    }
+  }
+
+  void Unregister(const AActor *actor)
+  {
+    int32 category;
+    if (!Categories.RemoveAndCopyValue(actor, category))
+    {
+      return;
+    }
+    TArray<FCullable> &bucket = Buckets[category];
+    // stable removal, so the entries before PendingIndex are still the ones
+    // already updated
+    const bool walking = category == FirstPendingCategory();
+    int32 write = 0;
+    for (int32 read = 0; read < bucket.Num(); ++read)
+    {
+      if (bucket[read].Owner == actor || !bucket[read].Component.IsValid())
+      {
+        if (walking && read < PendingIndex)
+        {
+          --PendingIndex;
+        }
+        continue;
+      }
+      if (write != read)
+      {
+        bucket[write] = bucket[read];
+      }
+      ++write;
+    }
+    bucket.SetNum(write, false);
+  }
+
+  void SetDistances(const TArray<float> &distances, const int32 components_per_frame)
+  {
+    ComponentsPerFrame = FMath::Max(components_per_frame, 1);
+    bool any_pending = false;
+    for (int32 category = 0; category < CARLA_SETTINGS_NUM_CULL_CATEGORIES; ++category)
+    {
+      if (!bDistancesSet || Distances[category] != distances[category])
+      {
+        Distances[category] = distances[category];
+        bPending[category] = true;
+      }
+      any_pending |= bPending[category];
+    }
+    bDistancesSet = true;
+    if (!any_pending)
+    {
+      return;
+    }
+    // start over, components already at the new distance are skipped cheaply
+    PendingIndex = 0;
+    if (!Ticker.IsValid())
+    {
+      Ticker = FTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FCullableRegistry::Tick));
+    }
+  }
+
+private:
+
+  struct FCullable
+  {
+    TWeakObjectPtr<UPrimitiveComponent> Component;
+    const AActor *Owner; // only compared, to drop the entries of a destroyed actor
+    float DistanceScale; // very large actors are culled much further away
+  };
+
+  int32 FirstPendingCategory() const
+  {
+    for (int32 category = 0; category < CARLA_SETTINGS_NUM_CULL_CATEGORIES; ++category)
+    {
+      if (bPending[category])
+      {
+        return category;
+      }
+    }
+    return INDEX_NONE;
+  }
+
+  /// Applies the pending draw distances, ComponentsPerFrame at a time. Returns
+  /// false (removing the ticker) once done.
+  bool Tick(float DeltaTime)
+  {
+    int32 budget = ComponentsPerFrame;
+    for (int32 category = FirstPendingCategory(); category != INDEX_NONE && budget > 0;
+         category = FirstPendingCategory())
+    {
+      TArray<FCullable> &bucket = Buckets[category];
+      while (PendingIndex < bucket.Num() && budget > 0)
+      {
+        UPrimitiveComponent *component = bucket[PendingIndex].Component.Get();
+        if (component == nullptr || component->IsPendingKill())
+        {
+          bucket.RemoveAtSwap(PendingIndex, 1, false); // destroyed with its level
+          continue;
+        }
+        ApplyDrawDistance(*component, Distances[category] * bucket[PendingIndex].DistanceScale);
+        ++PendingIndex;
+        --budget;
+      }
+      if (PendingIndex >= bucket.Num())
+      {
+        bPending[category] = false;
+        PendingIndex = 0;
+      }
+    }
+    if (FirstPendingCategory() != INDEX_NONE)
+    {
+      return true; // continue next frame
+    }
+    Ticker.Reset();
+    return false;
+  }
+
+  TWeakObjectPtr<UWorld> World;
+
+  TArray<FCullable> Buckets[CARLA_SETTINGS_NUM_CULL_CATEGORIES];
+
+  /// Category of every registered actor.
+  TMap<const AActor *, int32> Categories;
+
+  float Distances[CARLA_SETTINGS_NUM_CULL_CATEGORIES] = {};
+
+  bool bPending[CARLA_SETTINGS_NUM_CULL_CATEGORIES] = {};
+
+  /// Until the first change, components keep the draw distance of their asset.
+  bool bDistancesSet = false;
+
+  /// Next component to update of the first pending category.
+  int32 PendingIndex = 0;
+
+  int32 ComponentsPerFrame = 1;
+
+  FDelegateHandle Ticker;
+};
 
 /// quality settings configuration between runs
 EQualityLevel UCarlaSettingsDelegate::AppliedLowPostResetQualityLevel = EQualityLevel::Epic;
@@ -25,7 +274,8 @@ EQualityLevel UCarlaSettingsDelegate::AppliedLowPostResetQualityLevel = EQuality
 UCarlaSettingsDelegate::UCarlaSettingsDelegate()
   : ActorSpawnedDelegate(FOnActorSpawned::FDelegate::CreateUObject(
         this,
-        &UCarlaSettingsDelegate::OnActorSpawned)) {}
+        &UCarlaSettingsDelegate::OnActorSpawned)),
+    CullableRegistry(MakeShared<FCullableRegistry>()) {}
 
 void UCarlaSettingsDelegate::Reset()
 {
@@ -41,31 +291,23 @@ void UCarlaSettingsDelegate::RegisterSpawnHandler(UWorld *InWorld)
 void UCarlaSettingsDelegate::OnActorSpawned(AActor *InActor)
 {
   check(CarlaSettings != nullptr);
-  if (InActor != nullptr && IsValid(InActor) && !InActor->IsPendingKill() &&
-      !InActor->IsA<AInstancedFoliageActor>() && // foliage culling is
-                                                 // controlled per instance
-      !InActor->IsA<ALandscape>() && // dont touch landscapes nor roads
-      !InActor->ActorHasTag(UCarlaSettings::CARLA_ROAD_TAG) &&
-      !InActor->ActorHasTag(UCarlaSettings::CARLA_SKY_TAG))
+  if (!IsCullable(InActor))
   {
-    TArray<UPrimitiveComponent *> components;
-    InActor->GetComponents(components);
-    switch (CarlaSettings->GetQualityLevel())
-    {
-      case EQualityLevel::Low: {
-        // apply settings for this actor for the current quality level
-        float dist = CarlaSettings->LowStaticMeshMaxDrawDistance;
-        const float maxscale = InActor->GetActorScale().GetMax();
-        if (maxscale > CARLA_SETTINGS_MAX_SCALE_SIZE)
-        {
-          dist *= 100.0f;
-        }
-        SetActorComponentsDrawDistance(InActor, dist);
-        break;
-      }
-      default: break;
-    }
+    return;
   }
+  InActor->OnDestroyed.AddUniqueDynamic(this, &UCarlaSettingsDelegate::OnActorDestroyed);
+  // before the registry is built (on the first draw distance change) there is
+  // nothing to do, the actor will be found then
+  if (CullableRegistry->IsBuiltFor(InActor->GetWorld()))
+  {
+    // gets the current draw distance of its category
+    CullableRegistry->Register(InActor);
+  }
+}
+
+void UCarlaSettingsDelegate::OnActorDestroyed(AActor *InActor)
+{
+  CullableRegistry->Unregister(InActor);
 }
 
 void UCarlaSettingsDelegate::ApplyQualityLevelPostRestart()
@@ -93,10 +335,10 @@ void UCarlaSettingsDelegate::ApplyQualityLevelPostRestart()
       SetAllLights(InWorld, CarlaSettings->LowLightFadeDistance, false, true);
       // Set all the roads the low quality materials
       SetAllRoads(InWorld, CarlaSettings->LowRoadPieceMeshMaxDrawDistance, CarlaSettings->LowRoadMaterials);
-      // Set all actors with static meshes a max distance configured in the
-      // global settings for the low quality
-      // SetAllActorsDrawDistance(InWorld, CarlaSettings->LowStaticMeshMaxDrawDistance);
-      SetAllActorsDrawDistance(InWorld, 0); // full render distance
+      // Set all actors with static meshes a max distance configured per
+      // category (all 0 by default, full render distance)
+      SetCategoryDrawDistances(InWorld, {LowVehicleMaxDrawDistance, LowWalkerMaxDrawDistance,
+                                         LowPropMaxDrawDistance, LowBuildingMaxDrawDistance});
       // Disable all post process volumes
       SetPostProcessEffectsEnabled(InWorld, false);
       break;
@@ -287,65 +529,27 @@ void UCarlaSettingsDelegate::SetAllRoads(
   }); // ,DELAY_TIME_TO_SET_ALL_ROADS, false);
 }
 
-void UCarlaSettingsDelegate::SetActorComponentsDrawDistance(
-    AActor *actor,
-    const float max_draw_distance) const
+void UCarlaSettingsDelegate::SetAllActorsDrawDistance(UWorld *world, const float max_draw_distance) const
 {
-  if (!actor)
-  {
-    return;
-  }
-  TArray<UPrimitiveComponent *> components;
-  actor->GetComponents(components, false);
-  float dist = max_draw_distance;
-  const float maxscale = actor->GetActorScale().GetMax();
-  if (maxscale > CARLA_SETTINGS_MAX_SCALE_SIZE)
-  {
-    dist *= 100.0f;
-  }
-  for (int32 j = 0; j < components.Num(); j++)
-  {
-    UPrimitiveComponent *primitivecomponent = Cast<UPrimitiveComponent>(components[j]);
-    if (IsValid(primitivecomponent))
-    {
-      primitivecomponent->SetCullDistance(dist);
-      primitivecomponent->bAllowCullDistanceVolume = dist > 0;
-    }
-  }
+  TArray<float> distances;
+  distances.Init(max_draw_distance, CARLA_SETTINGS_NUM_CULL_CATEGORIES);
+  SetCategoryDrawDistances(world, distances);
 }
 
-void UCarlaSettingsDelegate::SetAllActorsDrawDistance(UWorld *world, const float max_draw_distance) const
+void UCarlaSettingsDelegate::SetCategoryDrawDistances(UWorld *world, const TArray<float> &distances) const
 {
-  /// @TODO: use semantics to grab all actors by type
-  /// (vehicles,ground,people,props) and set different distances configured in
-  /// the global properties
+  check(distances.Num() == CARLA_SETTINGS_NUM_CULL_CATEGORIES);
   if (!world || !IsValid(world) || world->IsPendingKill())
   {
     return;
   }
-  AsyncTask(ENamedThreads::GameThread, [=]() {
-    if (!world || !IsValid(world) || world->IsPendingKill())
-    {
-      return;
-    }
-    TArray<AActor *> actors;
-    // set the lower quality - max draw distance
-    UGameplayStatics::GetAllActorsOfClass(world, AActor::StaticClass(), actors);
-    for (int32 i = 0; i < actors.Num(); i++)
-    {
-      AActor *actor = actors[i];
-      if (!IsValid(actor) || actor->IsPendingKill() ||
-      actor->IsA<AInstancedFoliageActor>() ||   // foliage culling is controlled
-                                                // per instance
-      actor->IsA<ALandscape>() ||   // dont touch landscapes nor roads
-      actor->ActorHasTag(UCarlaSettings::CARLA_ROAD_TAG) ||
-      actor->ActorHasTag(UCarlaSettings::CARLA_SKY_TAG))
-      {
-        continue;
-      }
-      SetActorComponentsDrawDistance(actor, max_draw_distance);
-    }
-  });
+  if (!CullableRegistry->IsBuiltFor(world))
+  {
+    // once per world, from then on the spawn and destroy handlers keep it up
+    // to date
+    CullableRegistry->Build(world);
+  }
+  CullableRegistry->SetDistances(distances, DrawDistanceComponentsPerFrame);
 }
 
 void UCarlaSettingsDelegate::SetPostProcessEffectsEnabled(UWorld *world, const bool enabled) const
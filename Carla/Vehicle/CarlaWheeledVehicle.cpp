@@ -24,6 +24,7 @@
 #include "Carla/Util/EmptyActor.h"
 #include "Carla/Util/BoundingBoxCalculator.h"
 #include "Carla/Vehicle/CarlaWheeledVehicle.h"
+#include "Carla/Vehicle/CollisionEventBuffer.h"
 
 // =============================================================================
 // -- Constructor and destructor -----------------------------------------------
@@ -195,22 +196,12 @@ void ACarlaWheeledVehicle::Tick(float DeltaSeconds)
 // =============================================================================
 
 float ACarlaWheeledVehicle::Volume = 1.f; // static for all non-ego vehicles (use DReyeVRLevel::SetVolume)
+bool ACarlaWheeledVehicle::bEngineSounds = true;
 
 void ACarlaWheeledVehicle::ConstructSounds()
 {
   // add all sounds here
 
-  static ConstructorHelpers::FObjectFinder<USoundCue> EngineCueObj(
-    TEXT("SoundCue'/Game/DReyeVR/Sounds/EngineRev/EngineRev.EngineRev'"));
-  EngineRevSound = CreateDefaultSubobject<UAudioComponent>(FName("EngineRevSound"));
-  EngineRevSound->SetupAttachment(GetRootComponent());       // attach to self
-  EngineRevSound->bAutoActivate = true;                      // start playing on begin
-  EngineRevSound->SetSound(EngineCueObj.Object);             // using this sound
-  EngineRevSound->SetRelativeLocation(EngineLocnInVehicle);  // location of "engine" in vehicle (3D sound)
-  EngineRevSound->SetFloatParameter(FName("RPM"), 0.f);      // initially idle
-  EngineRevSound->bAutoDestroy = false;                      // No automatic destroy, persist along with vehicle
-  check(EngineRevSound != nullptr);
-
   static ConstructorHelpers::FObjectFinder<USoundCue> CarCrashCue(
     TEXT("SoundCue'/Game/DReyeVR/Sounds/Crash/CrashCue.CrashCue'"));
   CrashSound = CreateDefaultSubobject<UAudioComponent>(TEXT("CarCrash"));
@@ -224,28 +215,25 @@ void ACarlaWheeledVehicle::ConstructSounds()
 void ACarlaWheeledVehicle::TickSounds(float DeltaSeconds)
 {
   // Respect the global vehicle volume param
-  SetVolume(ACarlaWheeledVehicle::Volume);
-  
-  if (EngineRevSound)
-  {
-    if (!EngineRevSound->IsPlaying()) 
-    {
-      EngineRevSound->Play(); // turn on the engine sound if not already on 
-    }
-    float RPM = FMath::Clamp(GetVehicleMovementComponent()->GetEngineRotationSpeed(), 0.f, 5650.0f);
-    EngineRevSound->SetFloatParameter(FName("RPM"), RPM);
-  }
+  if (AppliedVolume != ACarlaWheeledVehicle::Volume)
+    SetVolume(ACarlaWheeledVehicle::Volume);
+  // the engine sound is not ticked here: only the closest/loudest vehicles get one (see AEgoVehicle::TickVehicleAudio)
   // add other sounds that need tick-level granularity here...
 }
 
 void ACarlaWheeledVehicle::SetVolume(const float VolumeIn)
 {
-  if (EngineRevSound)
-    EngineRevSound->SetVolumeMultiplier(VolumeIn);
+  AppliedVolume = VolumeIn;
   if (CrashSound)
     CrashSound->SetVolumeMultiplier(VolumeIn);
 }
 
+float ACarlaWheeledVehicle::GetEngineRPM() const
+{
+  const UWheeledVehicleMovementComponent *Movement = GetVehicleMovementComponent();
+  return Movement != nullptr ? FMath::Clamp(Movement->GetEngineRotationSpeed(), 0.f, 5650.0f) : 0.f;
+}
+
 // =============================================================================
 // -- Collision Functions ------------------------------------------------------
 // =============================================================================
@@ -260,45 +248,30 @@ void ACarlaWheeledVehicle::ConstructCollisionHandler()
   Bounds->OnComponentBeginOverlap.AddDynamic(this, &ACarlaWheeledVehicle::OnOverlapBegin);
 }
 
-bool ACarlaWheeledVehicle::EnableCollisionForActor(AActor *OtherActor)
-{
-  // define whether or not we should "collide" with these actors
-  // as opposed to actors such as the ground/grass
-  const FString OtherName = OtherActor->GetName().ToLower();
-  double Now = GetWorld()->GetTimeSeconds();
-  bool bIsAVehicle = OtherActor->IsA(ACarlaWheeledVehicle::StaticClass());
-  return (CollisionCooldownTime < Now &&        // respect collision audio cooldown
-          (bIsAVehicle ||                       // do collide with vehicles
-            OtherName.Contains("spline") ||      // do collide with carla "spline" (misc) objects
-            OtherName.Contains("streetlight") || // do collide with street lights
-            OtherName.Contains("curb")           // do collide with curb objects
-          ));
-}
-
 void ACarlaWheeledVehicle::OnOverlapBegin(UPrimitiveComponent *OverlappedComp, AActor *OtherActor,
                                           UPrimitiveComponent *OtherComp, int32 OtherBodyIndex, bool bFromSweep,
                                           const FHitResult &SweepResult)
 {
-  if (OtherActor == nullptr || OtherActor == this)
+  // handled once per frame (OnCollision), together with the other collisions
+  FCollisionEventBuffer::Get().Add(this, OtherActor);
+}
+
+void ACarlaWheeledVehicle::OnCollision(AActor *OtherActor, uint8 OtherClass)
+{
+  if (CollisionCooldownTime >= GetWorld()->GetTimeSeconds()) // respect collision audio cooldown
     return;
-  
-  // can be more flexible, such as having collisions with static props or people too
-  if (EnableCollisionForActor(OtherActor))
-  {
-    // emit the car collision sound at the midpoint between the vehicles' collision
-    /// TODO: would be ideal to use FHitPoint::ImpactPoint but there is a bug in UE4 where this is not initialized
-    // see: https://answers.unrealengine.com/questions/219744/component-overlap-hit-position-always-returns-000.html
-    FVector SoundEmitLocation = EngineLocnInVehicle;
-    bool bIsAVehicle = OtherActor->IsA(ACarlaWheeledVehicle::StaticClass());
-    if (bIsAVehicle) { // in the case where the other actor is a vehicle, do emit the sound at the location midpoint
-      SoundEmitLocation = (OtherActor->GetActorLocation() - this->GetActorLocation()) / 2.f;
-      SoundEmitLocation += 75.f * FVector::UpVector; // Make the sound emitted not at the ground (0.75m above ground)
-    }
-    if (CrashSound != nullptr) {
-      CrashSound->SetRelativeLocation(SoundEmitLocation);
-      CrashSound->Play();
-      CollisionCooldownTime = GetWorld()->GetTimeSeconds() + 0.5f; // have at least 0.5s of buffer between collision audio
-    }
+  // emit the car collision sound at the midpoint between the vehicles' collision
+  /// TODO: would be ideal to use FHitPoint::ImpactPoint but there is a bug in UE4 where this is not initialized
+  // see: https://answers.unrealengine.com/questions/219744/component-overlap-hit-position-always-returns-000.html
+  FVector SoundEmitLocation = EngineLocnInVehicle;
+  if (OtherClass & ECollisionClass::Vehicle) { // another vehicle: emit the sound at the location midpoint
+    SoundEmitLocation = (OtherActor->GetActorLocation() - this->GetActorLocation()) / 2.f;
+    SoundEmitLocation += 75.f * FVector::UpVector; // Make the sound emitted not at the ground (0.75m above ground)
+  }
+  if (CrashSound != nullptr) {
+    CrashSound->SetRelativeLocation(SoundEmitLocation);
+    CrashSound->Play();
+    CollisionCooldownTime = GetWorld()->GetTimeSeconds() + 0.5f; // have at least 0.5s of buffer between collision audio
   }
 }
 
@@ -252,7 +252,16 @@ public:
   }
 
   static float Volume;
+  static bool bEngineSounds; // engine sounds of all non-ego vehicles (turned off by the DReyeVR quality governor)
   virtual void SetVolume(const float VolumeIn);
+  // the engine sounds of non-ego vehicles are pooled by the EgoVehicle (DReyeVR/VehicleAudioLOD.h)
+  const FVector &GetEngineLocation() const
+  {
+    return EngineLocnInVehicle;
+  }
+  float GetEngineRPM() const;
+  // a collision that began this frame (see CollisionEventBuffer.h), plays the crash sound
+  virtual void OnCollision(AActor *OtherActor, uint8 OtherClass);
   void PlayCrashSound(const float DelayBeforePlay = 0.f) const;
   /// @}
   // ===========================================================================
@@ -273,14 +282,12 @@ protected:
   FVector EngineLocnInVehicle{180.f, 0.f, 70.f};
   // need to disable these for EgoVehicle to have our own Ego versions
   UPROPERTY(Category = "Audio", EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
-  class UAudioComponent *EngineRevSound = nullptr;  // driver feedback on throttle
-  UPROPERTY(Category = "Audio", EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
   class UAudioComponent *CrashSound = nullptr; // crashing with another actor
   double CollisionCooldownTime = 0.0;
+  float AppliedVolume = -1.f; // last SetVolume (the global Volume is only pushed to the components on change)
   // can add more sounds here... like a horn maybe?
   
-  // collisions (DReyeVR)
-  bool EnableCollisionForActor(AActor *OtherActor);
+  // collisions (DReyeVR), queued in the FCollisionEventBuffer
   void ConstructCollisionHandler(); // needs to be called in the constructor
   UFUNCTION()
   void OnOverlapBegin(UPrimitiveComponent *OverlappedComp, AActor *OtherActor, UPrimitiveComponent *OtherComp,
@@ -0,0 +1,97 @@
+#include "Carla/Vehicle/CollisionEventBuffer.h"
+
+#include "Carla.h"
+#include "Carla/Game/CarlaStatics.h"
+#include "Carla/Recorder/CarlaRecorder.h"
+#include "Carla/Vehicle/CarlaWheeledVehicle.h"
+#include "Engine/World.h" // FWorldDelegates
+
+FCollisionEventBuffer &FCollisionEventBuffer::Get()
+{
+  static FCollisionEventBuffer Buffer;
+  return Buffer;
+}
+
+FCollisionEventBuffer::FCollisionEventBuffer()
+{
+  FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &FCollisionEventBuffer::Dispatch);
+}
+
+uint8 FCollisionEventBuffer::Classify(AActor *Actor)
+{
+  if (const uint8 *Found = Classes.Find(Actor))
+    return *Found;
+  uint8 Class = ECollisionClass::None;
+  if (Actor->IsA(ACarlaWheeledVehicle::StaticClass()))
+  {
+    Class = ECollisionClass::Vehicle;
+  }
+  else
+  {
+    // as opposed to actors such as the ground/grass
+    const FString Name = Actor->GetName().ToLower();
+    if (Name.Contains("spline"))
+      Class |= ECollisionClass::Spline;
+    if (Name.Contains("streetlight"))
+      Class |= ECollisionClass::StreetLight;
+    if (Name.Contains("curb"))
+      Class |= ECollisionClass::Curb;
+  }
+  Classes.Add(Actor, Class);
+  return Class;
+}
+
+void FCollisionEventBuffer::Add(ACarlaWheeledVehicle *Vehicle, AActor *Other)
+{
+  if (Vehicle == nullptr || Other == nullptr || Other == Vehicle)
+    return;
+  const uint8 Class = Classify(Other);
+  if ((Class & ECollisionClass::Collidable) == 0)
+    return;
+  FCollisionEvent Event;
+  Event.Vehicle = Vehicle;
+  Event.Other = Other;
+  Event.OtherClass = Class;
+  Events.Add(Event);
+}
+
+void FCollisionEventBuffer::Dispatch(UWorld *World, ELevelTick TickType, float DeltaSeconds)
+{
+  if (Classes.Num() > PurgeAt)
+  {
+    for (auto It = Classes.CreateIterator(); It; ++It)
+      if (!It.Key().IsValid())
+        It.RemoveCurrent();
+    PurgeAt = FMath::Max(1024, 2 * Classes.Num());
+  }
+  if (Events.Num() == 0)
+    return;
+
+  ACarlaRecorder *Recorder = UCarlaStatics::GetRecorder(World);
+  TSet<TPair<AActor *, AActor *>> Recorded;
+  int32 Kept = 0;
+  for (int32 i = 0; i < Events.Num(); i++)
+  {
+    const FCollisionEvent Event = Events[i];
+    ACarlaWheeledVehicle *Vehicle = Event.Vehicle.Get();
+    AActor *Other = Event.Other.Get();
+    if (Vehicle == nullptr || Other == nullptr)
+      continue; // destroyed since
+    if (Vehicle->GetWorld() != World)
+    {
+      Events[Kept++] = Event; // waits for the tick of its own world
+      continue;
+    }
+    Vehicle->OnCollision(Other, Event.OtherClass);
+    if (Recorder != nullptr)
+    {
+      AActor *First = FMath::Min<AActor *>(Vehicle, Other);
+      AActor *Second = FMath::Max<AActor *>(Vehicle, Other);
+      bool bAlreadyRecorded = false;
+      Recorded.Add(TPair<AActor *, AActor *>(First, Second), &bAlreadyRecorded);
+      if (!bAlreadyRecorded)
+        Recorder->AddCollision(Vehicle, Other);
+    }
+  }
+  Events.SetNum(Kept, false);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h" // ELevelTick
+
+class ACarlaWheeledVehicle;
+
+// What an actor is to the vehicle collisions (DReyeVR crash sounds and recorded collisions), decided once per actor
+// from its class (or its name, for the static props of the maps) instead of on every overlap
+namespace ECollisionClass
+{
+  enum Type : uint8
+  {
+    None = 0,
+    Vehicle = 1 << 0,     // any ACarlaWheeledVehicle
+    Spline = 1 << 1,      // carla "spline" (misc) objects
+    StreetLight = 1 << 2, // street lights
+    Curb = 1 << 3,        // curb objects
+    Collidable = Vehicle | Spline | StreetLight | Curb,
+  };
+}
+
+struct FCollisionEvent
+{
+  TWeakObjectPtr<ACarlaWheeledVehicle> Vehicle; // whose bounds began to overlap
+  TWeakObjectPtr<AActor> Other;
+  uint8 OtherClass = ECollisionClass::None;
+};
+
+// The overlap callbacks of the vehicle bounds only queue a collision here. Once per frame (after the actors of the
+// world ticked) every queued collision is handed to its vehicle (ACarlaWheeledVehicle::OnCollision, the crash sound)
+// and, once per pair of actors (both vehicles of a crash report it), to ACarlaRecorder::AddCollision.
+class CARLA_API FCollisionEventBuffer
+{
+public:
+  static FCollisionEventBuffer &Get();
+
+  // the ECollisionClass bits of the actor (cached, the name is only looked at the first time)
+  uint8 Classify(AActor *Actor);
+
+  // from the overlap callbacks, drops actors that are not collidable
+  void Add(ACarlaWheeledVehicle *Vehicle, AActor *Other);
+
+  int32 NumPending() const
+  {
+    return Events.Num();
+  }
+
+private:
+  FCollisionEventBuffer();
+  void Dispatch(UWorld *World, ELevelTick TickType, float DeltaSeconds);
+
+  TArray<FCollisionEvent> Events;
+  TMap<TWeakObjectPtr<AActor>, uint8> Classes; // stale entries are dropped as it grows
+  int32 PurgeAt = 1024;
+};
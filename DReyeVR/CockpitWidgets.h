@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Carla/Actor/DReyeVRCustomActor.h" // ADReyeVRCustomActor
+#include "Components/TextRenderComponent.h" // UTextRenderComponent
+#include "CoreMinimal.h"                    // FString, FLinearColor
+#include "FrameBudgetProfiler.h"            // DREYEVR_PROFILE_COUNT
+
+// Retained cockpit widgets: each one remembers what it last pushed to its component and only touches the component
+// (which dirties its render state) when the displayed value actually changes. Every push is counted in the frame
+// profiler (Cockpit_TextUpdates, Cockpit_MaterialUpdates).
+
+class FCockpitText
+{
+  public:
+    void Bind(UTextRenderComponent *InText)
+    {
+        Text = InText;
+        bValid = false;
+    }
+
+    void Set(const FString &Value)
+    {
+        if (Text == nullptr || (bValid && !bIsInt && Value.Equals(Last, ESearchCase::CaseSensitive)))
+            return;
+        Push(Value);
+        bIsInt = false;
+    }
+
+    // compared as the integer (ex. quantized speed) so the string is only built when it changes
+    void SetInt(int Value)
+    {
+        if (Text == nullptr || (bValid && bIsInt && Value == LastInt))
+            return;
+        Push(FString::FromInt(Value));
+        LastInt = Value;
+        bIsInt = true;
+    }
+
+  private:
+    void Push(const FString &Value)
+    {
+        Text->SetText(FText::FromString(Value));
+        Last = Value;
+        bValid = true;
+        DREYEVR_PROFILE_COUNT(Cockpit_TextUpdates, 1);
+    }
+
+    UTextRenderComponent *Text = nullptr;
+    FString Last;
+    int LastInt = 0;
+    bool bIsInt = false;
+    bool bValid = false;
+};
+
+// a custom actor whose BaseColor and Emissive show a state (wheel buttons, autopilot indicator)
+class FCockpitLight
+{
+  public:
+    void Bind(ADReyeVRCustomActor *InActor)
+    {
+        Actor = InActor;
+        bValid = false;
+    }
+
+    void Set(const FLinearColor &BaseColor, const FLinearColor &Emissive)
+    {
+        if (Actor == nullptr || (bValid && BaseColor == LastBaseColor && Emissive == LastEmissive))
+            return;
+        Actor->MaterialParams.BaseColor = BaseColor;
+        Actor->MaterialParams.Emissive = Emissive;
+        Actor->UpdateMaterial();
+        LastBaseColor = BaseColor;
+        LastEmissive = Emissive;
+        bValid = true;
+        DREYEVR_PROFILE_COUNT(Cockpit_MaterialUpdates, 1);
+    }
+
+  private:
+    ADReyeVRCustomActor *Actor = nullptr;
+    FLinearColor LastBaseColor, LastEmissive;
+    bool bValid = false;
+};
@@ -0,0 +1,3 @@
+#include "ConfigFile.h"
+
+ConfigFile GeneralParams(FPaths::Combine(CarlaUE4Path, TEXT("Config/DReyeVRConfig.ini")));
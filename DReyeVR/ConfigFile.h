@@ -1,18 +1,125 @@
 #pragma once
-#include <fstream> // std::ifstream
-#include <istream> // std::istream
-#include <sstream> // std::istringstream
+#include "FileWatcher.h" // FileWatcher
+#include <algorithm>     // std::remove_if, std::any_of
+#include <fstream>       // std::ifstream
+#include <functional>    // std::function
+#include <istream>       // std::istream
+#include <memory>        // std::shared_ptr
+#include <mutex>         // std::mutex
+#include <sstream>       // std::istringstream
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 const static FString CarlaUE4Path = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir());
 
+namespace ConfigParse
+{
+// string -> value conversions for config entries (overloads rather than specializations so any compiler takes them)
+template <typename T> inline bool Decipher(const FString &Str, T &Out)
+{
+    // supports FVector, FVector2D, FLinearColor, FQuat, FRotator, and FTransform,
+    // basically any UE4 type that has a ::InitFromString method
+    if (Out.InitFromString(Str) == false)
+    {
+        LOG_ERROR("Unable to decipher \"%s\" to a type", *Str);
+        return false;
+    }
+    return true;
+}
+
+inline bool Decipher(const FString &Str, bool &Out)
+{
+    Out = Str.ToBool();
+    return true;
+}
+
+inline bool Decipher(const FString &Str, int &Out)
+{
+    Out = FCString::Atoi(*Str);
+    return true;
+}
+
+inline bool Decipher(const FString &Str, float &Out)
+{
+    Out = FCString::Atof(*Str);
+    return true;
+}
+
+inline bool Decipher(const FString &Str, double &Out)
+{
+    Out = FCString::Atod(*Str);
+    return true;
+}
+
+inline bool Decipher(const FString &Str, FString &Out)
+{
+    Out = Str;
+    return true;
+}
+
+inline bool Decipher(const FString &Str, FName &Out)
+{
+    Out = FName(*Str);
+    return true;
+}
+} // namespace ConfigParse
+
+// parsed value behind a ConfigHandle, updated when its ConfigFile is hot-reloaded
+struct ConfigHandleSlot
+{
+    virtual ~ConfigHandleSlot() = default;
+    virtual void Update(const FString *Str) = 0; // nullptr if the entry is missing (keeps the current value)
+    std::string Section, Variable;
+    bool bFound = false;
+};
+
+// Typed handle to a single config entry. The (section, variable) is resolved and parsed into T once, when the handle
+// is registered with ConfigFile::Register, so reading it is a plain load with no string conversions, map lookups, or
+// parsing. Register handles once (ex. in a constructor or as a function-local static) and keep them around.
+// Handles follow hot reloads of their ConfigFile (their value changes in ConfigFile::DispatchReloads).
+template <typename T> class ConfigHandle
+{
+  public:
+    ConfigHandle() = default; // unregistered
+
+    const T &Get() const
+    {
+        check(Slot != nullptr);
+        return Slot->Value;
+    }
+
+    const T &operator*() const
+    {
+        return Get();
+    }
+
+    bool IsFound() const // false if the entry was missing at registration (holding the default)
+    {
+        return Slot != nullptr && Slot->bFound;
+    }
+
+  private:
+    friend struct ConfigFile;
+    struct FSlot : public ConfigHandleSlot
+    {
+        T Value{}; // until found
+        void Update(const FString *Str) override
+        {
+            bFound = (Str != nullptr);
+            if (bFound)
+                ConfigParse::Decipher(*Str, Value);
+        }
+    };
+    std::shared_ptr<const FSlot> Slot;
+};
+
 struct ConfigFile
 {
     ConfigFile() = default; // empty constructor (no params yet)
     ConfigFile(const FString &Path, bool bVerbose = true) : FilePath(Path)
     {
-        /// TODO: add feature to "hot-reload" new params during runtime
         bSuccessfulUpdate = ReadFile(bVerbose); // ensures all the variables are updated upon construction
 
         // simple sanity check to ensure exporting and importing the same config file works as intended
@@ -21,6 +128,30 @@ struct ConfigFile
         ensureMsgf(bSanityCheck, TEXT("Sanity check for ConfigFile import/export failed!"));
     }
 
+    // copies share the (immutable) parsed table, but not the handles, subscriptions, or file watch of the original
+    ConfigFile(const ConfigFile &Other)
+        : FilePath(Other.FilePath), bSuccessfulUpdate(Other.bSuccessfulUpdate), Sections(Other.GetTable())
+    {
+    }
+
+    ConfigFile &operator=(const ConfigFile &Other)
+    {
+        if (this != &Other)
+        {
+            StopWatching();
+            Live = std::make_shared<FLiveState>(this);
+            FilePath = Other.FilePath;
+            bSuccessfulUpdate = Other.bSuccessfulUpdate;
+            std::atomic_store(&Sections, Other.GetTable());
+        }
+        return *this;
+    }
+
+    ~ConfigFile()
+    {
+        StopWatching();
+    }
+
     template <typename T> bool Get(const FString &Section, const FString &Variable, T &Value) const
     {
         const std::string SectionStdStr(TCHAR_TO_UTF8(*Section));
@@ -30,12 +161,85 @@ struct ConfigFile
 
     template <typename T> T Get(const FString &Section, const FString &Variable) const
     {
-        T Value;
+        T Value{}; // returned as is when the variable is missing
         /// TODO: implement exception when Get returns false?
         Get(Section, Variable, Value);
         return Value;
     }
 
+    // resolve and parse an entry once (missing entries are reported here and hold DefaultValue), see ConfigHandle
+    template <typename T>
+    ConfigHandle<T> Register(const FString &Section, const FString &Variable, const T &DefaultValue = T()) const
+    {
+        auto Slot = std::make_shared<typename ConfigHandle<T>::FSlot>();
+        Slot->Value = DefaultValue;
+        ParamString Param;
+        Slot->bFound = Find(TCHAR_TO_UTF8(*Section), TCHAR_TO_UTF8(*Variable), Param);
+        if (Slot->bFound)
+            ConfigParse::Decipher(Param.DataStr, Slot->Value);
+        Slot->Section = TCHAR_TO_UTF8(*Section);
+        Slot->Variable = TCHAR_TO_UTF8(*Variable);
+        {
+            std::lock_guard<std::mutex> Lock(Live->Mutex);
+            Live->Handles.push_back(Slot);
+        }
+        ConfigHandle<T> Handle;
+        Handle.Slot = std::move(Slot);
+        return Handle;
+    }
+
+    // Hot reloading: once something subscribes, the file is watched (FileWatcher) and re-parsed off the game thread
+    // whenever it is saved. The new table is then published, the handles updated, and the subscribers of any changed
+    // key called, all on the game thread in DispatchReloads (so subscribers can simply re-read their variables)
+    using ConfigKeys = std::vector<std::pair<FString, FString>>; // (section, variable), no variable: whole section
+    int Subscribe(const ConfigKeys &Keys, std::function<void()> OnChanged) const
+    {
+        int Id;
+        {
+            std::lock_guard<std::mutex> Lock(Live->Mutex);
+            FLiveState::FSubscription Sub;
+            Sub.Id = Id = Live->NextId++;
+            for (const auto &Key : Keys)
+                Sub.Keys.emplace_back(TCHAR_TO_UTF8(*Key.first), TCHAR_TO_UTF8(*Key.second));
+            Sub.OnChanged = std::move(OnChanged);
+            Live->Subscriptions.push_back(std::move(Sub));
+        }
+        StartWatching();
+        return Id;
+    }
+
+    void Unsubscribe(int Id) const
+    {
+        bool bNoneLeft;
+        {
+            std::lock_guard<std::mutex> Lock(Live->Mutex);
+            auto &Subs = Live->Subscriptions;
+            Subs.erase(std::remove_if(Subs.begin(), Subs.end(), [Id](const auto &S) { return S.Id == Id; }),
+                       Subs.end());
+            bNoneLeft = Subs.empty();
+        }
+        if (bNoneLeft)
+            StopWatching();
+    }
+
+    // publish the reloaded config files (call once per frame on the game thread)
+    static void DispatchReloads()
+    {
+        std::vector<std::weak_ptr<FLiveState>> Reloaded;
+        {
+            std::lock_guard<std::mutex> Lock(PendingReloads().Mutex);
+            if (PendingReloads().Files.empty())
+                return;
+            Reloaded.swap(PendingReloads().Files);
+        }
+        for (const auto &Weak : Reloaded)
+        {
+            std::shared_ptr<FLiveState> L = Weak.lock();
+            if (L != nullptr)
+                L->Owner->Publish();
+        }
+    }
+
     template <typename T>
     T GetConstrained(const FString &Section, const FString &Variable, const std::unordered_set<T> &Options,
                      const T &DefaultValue) const
@@ -60,6 +264,18 @@ struct ConfigFile
         return this->IsSubset(Other, bPrintWarning) && Other.IsSubset(*this, bPrintWarning);
     }
 
+    // canonical 64-bit hash of every section (independent of the order of its entries), computed when parsed.
+    // Equal fingerprints mean the sections are equal as far as IsSubset is concerned (values ignore case)
+    using SectionFingerprints = std::vector<std::pair<std::string, uint64_t>>; // sorted by section name
+    SectionFingerprints Fingerprints() const
+    {
+        SectionFingerprints Out;
+        for (const auto &SectionData : *GetTable())
+            Out.emplace_back(SectionData.first, SectionData.second.Fingerprint);
+        std::sort(Out.begin(), Out.end());
+        return Out;
+    }
+
     bool IsSubset(const ConfigFile &Other, bool bPrintWarning = false) const
     {
         // only checking that this is a perfect subset of Other
@@ -82,7 +298,7 @@ struct ConfigFile
             const bool bIsMissing = false;
         };
         std::vector<Comparison> Diff = {};
-        for (const auto &SectionData : Sections)
+        for (const auto &SectionData : *GetTable())
         {
             const std::string &SectionName = SectionData.first;
             const IniSection &Section = SectionData.second;
@@ -133,8 +349,13 @@ struct ConfigFile
         if (!Other.bIsValid())
             return;
         FilePath += ";" + Other.FilePath;
-        if (Other.Sections.size() > 0)
-            Sections.insert(Other.Sections.begin(), Other.Sections.end());
+        const auto OtherSections = Other.GetTable();
+        if (OtherSections->size() > 0)
+        {
+            auto Merged = std::make_shared<SectionTable>(*GetTable());
+            Merged->insert(OtherSections->begin(), OtherSections->end());
+            std::atomic_store(&Sections, std::shared_ptr<const SectionTable>(std::move(Merged)));
+        }
         bSuccessfulUpdate = true;
     }
 
@@ -150,7 +371,7 @@ struct ConfigFile
         oss << std::endl
             << "# This is an exported config file originally from \"" << TCHAR_TO_UTF8(*FilePath) << "\"" << std::endl
             << std::endl;
-        for (const auto &SectionData : Sections)
+        for (const auto &SectionData : *GetTable())
         {
             const std::string &SectionName = SectionData.first;
             const IniSection &Section = SectionData.second;
@@ -186,6 +407,18 @@ struct ConfigFile
     }
 
     bool Update(std::istream &InputStream) // reload the internally tracked table of params
+    {
+        auto Table = std::make_shared<SectionTable>();
+        if (!Parse(InputStream, *Table))
+            return false;
+        std::atomic_store(&Sections, std::shared_ptr<const SectionTable>(std::move(Table)));
+        return true;
+    }
+
+    struct IniSection;
+    using SectionTable = std::unordered_map<std::string, IniSection>;
+
+    static bool Parse(std::istream &InputStream, SectionTable &Sections)
     {
         /// performs a single pass over the config stream to collect all variables into Params
         std::string Line;
@@ -221,9 +454,36 @@ struct ConfigFile
                 }
             }
         }
+        for (auto &SectionData : Sections)
+            SectionData.second.Fingerprint = ComputeFingerprint(SectionData.first, SectionData.second);
         return true;
     }
 
+    static uint64_t ComputeFingerprint(const std::string &SectionName, const IniSection &Section)
+    {
+        // FNV-1a (stable across platforms/runs, unlike std::hash) of every "variable=value" (value lowercased),
+        // mixed and summed so the order of the entries does not matter
+        auto FNV1a = [](const std::string &Str, uint64_t Hash = 14695981039346656037ull) {
+            for (const char C : Str)
+                Hash = (Hash ^ static_cast<uint8_t>(C)) * 1099511628211ull;
+            return Hash;
+        };
+        auto Mix = [](uint64_t X) { // splitmix64 finalizer
+            X = (X ^ (X >> 30)) * 0xbf58476d1ce4e5b9ull;
+            X = (X ^ (X >> 27)) * 0x94d049bb133111ebull;
+            return X ^ (X >> 31);
+        };
+        uint64_t Sum = 0;
+        for (const auto &EntryData : Section.Entries)
+        {
+            std::string Value = TCHAR_TO_UTF8(*EntryData.second.DataStr);
+            for (char &C : Value)
+                C = (C >= 'A' && C <= 'Z') ? static_cast<char>(C - 'A' + 'a') : C;
+            Sum += Mix(FNV1a(EntryData.first + "=" + Value));
+        }
+        return Mix(FNV1a(SectionName) ^ Sum);
+    }
+
   private:
     struct ParamString
     {
@@ -237,40 +497,10 @@ struct ConfigFile
 
         template <typename T> inline T DecipherToType() const
         {
-            // supports FVector, FVector2D, FLinearColor, FQuat, and FRotator,
-            // basically any UE4 type that has a ::InitFromString method
             T Ret;
-            if (Ret.InitFromString(DataStr) == false)
-            {
-                LOG_ERROR("Unable to decipher \"%s\" to a type", *DataStr);
-            }
+            ConfigParse::Decipher(DataStr, Ret);
             return Ret;
         }
-
-        template <> inline bool DecipherToType<bool>() const
-        {
-            return DataStr.ToBool();
-        }
-
-        template <> inline int DecipherToType<int>() const
-        {
-            return FCString::Atoi(*DataStr);
-        }
-
-        template <> inline float DecipherToType<float>() const
-        {
-            return FCString::Atof(*DataStr);
-        }
-
-        template <> inline FString DecipherToType<FString>() const
-        {
-            return DataStr;
-        }
-
-        template <> inline FName DecipherToType<FName>() const
-        {
-            return FName(*DataStr);
-        }
         bool bHasQuotes = false;
     };
 
@@ -282,6 +512,7 @@ struct ConfigFile
 
         std::string SectionHeader;                            // typically what is contained in [Sections]
         std::unordered_map<std::string, ParamString> Entries; // everything else
+        uint64_t Fingerprint = 0;                             // ComputeFingerprint (once, when parsed)
     };
 
   private:
@@ -304,8 +535,9 @@ struct ConfigFile
 
     bool Find(const std::string &SectionName, const std::string &VariableName, ParamString &Out) const
     {
-        auto SectionIt = Sections.find(SectionName);
-        if (SectionIt == Sections.end())
+        const auto Table = GetTable();
+        auto SectionIt = Table->find(SectionName);
+        if (SectionIt == Table->end())
         {
             LOG_ERROR("No section in config file matches \"%s\"", *FString(SectionName.c_str()));
             return false;
@@ -325,10 +557,194 @@ struct ConfigFile
         return true; // found successfully!
     }
 
+    // the current table, which is swapped (never modified) on reload so it can be read from any thread
+    std::shared_ptr<const SectionTable> GetTable() const
+    {
+        return std::atomic_load(&Sections);
+    }
+
+    static const ParamString *Lookup(const SectionTable &Table, const std::string &Section, const std::string &Variable)
+    {
+        auto SectionIt = Table.find(Section);
+        if (SectionIt == Table.end())
+            return nullptr;
+        auto EntryIt = SectionIt->second.Entries.find(Variable);
+        return EntryIt == SectionIt->second.Entries.end() ? nullptr : &EntryIt->second;
+    }
+
+    struct ConfigChange
+    {
+        std::string Section, Variable;
+        FString OldValue, NewValue; // empty if added/removed
+    };
+
+    static std::vector<ConfigChange> Diff(const SectionTable &Old, const SectionTable &New)
+    {
+        std::vector<ConfigChange> Changes;
+        for (const auto &SectionData : New)
+        {
+            for (const auto &EntryData : SectionData.second.Entries)
+            {
+                const ParamString *OldValue = Lookup(Old, SectionData.first, EntryData.first);
+                if (OldValue == nullptr || !OldValue->DataStr.Equals(EntryData.second.DataStr))
+                    Changes.push_back({SectionData.first, EntryData.first, OldValue ? OldValue->DataStr : FString(),
+                                       EntryData.second.DataStr});
+            }
+        }
+        for (const auto &SectionData : Old)
+        {
+            for (const auto &EntryData : SectionData.second.Entries)
+            {
+                if (Lookup(New, SectionData.first, EntryData.first) == nullptr)
+                    Changes.push_back({SectionData.first, EntryData.first, EntryData.second.DataStr, FString()});
+            }
+        }
+        return Changes;
+    }
+
+    // everything that belongs to this very instance (not shared with copies)
+    struct FLiveState
+    {
+        explicit FLiveState(ConfigFile *Owner) : Owner(Owner)
+        {
+        }
+        struct FSubscription
+        {
+            int Id;
+            std::vector<std::pair<std::string, std::string>> Keys;
+            std::function<void()> OnChanged;
+        };
+        ConfigFile *const Owner;
+        std::mutex Mutex;
+        std::vector<std::weak_ptr<ConfigHandleSlot>> Handles;
+        std::vector<FSubscription> Subscriptions;
+        int NextId = 0;
+        int WatchId = -1;
+        std::shared_ptr<FileWatcher> Watcher;          // kept alive while watching
+        std::shared_ptr<const SectionTable> Pending;   // re-parsed table waiting for DispatchReloads
+        std::vector<ConfigChange> PendingChanges;      // Pending vs. the current table
+    };
+
+    struct FPendingReloads
+    {
+        std::mutex Mutex;
+        std::vector<std::weak_ptr<FLiveState>> Files;
+    };
+    static FPendingReloads &PendingReloads()
+    {
+        static FPendingReloads Instance;
+        return Instance;
+    }
+
+    void StartWatching() const
+    {
+        std::lock_guard<std::mutex> Lock(Live->Mutex);
+        if (Live->WatchId >= 0 || FilePath.IsEmpty() || FilePath.Contains(";"))
+            return; // already watching, or not (exactly) one file
+        const std::string Path = TCHAR_TO_UTF8(*FilePath);
+        std::weak_ptr<FLiveState> Weak = Live;
+        Live->Watcher = FileWatcher::Get();
+        Live->WatchId = Live->Watcher->Watch(Path, [Weak, Path]() { OnFileChanged(Weak, Path); });
+        if (Live->WatchId < 0)
+            LOG_ERROR("Unable to watch config file \"%s\" for changes", *FilePath);
+    }
+
+    void StopWatching() const
+    {
+        if (Live == nullptr)
+            return;
+        int WatchId;
+        std::shared_ptr<FileWatcher> Watcher;
+        {
+            std::lock_guard<std::mutex> Lock(Live->Mutex);
+            WatchId = Live->WatchId;
+            Watcher = std::move(Live->Watcher);
+            Live->WatchId = -1;
+        }
+        // not holding Live->Mutex, Unwatch waits for a running OnFileChanged
+        if (Watcher != nullptr && WatchId >= 0)
+            Watcher->Unwatch(WatchId);
+    }
+
+    static void OnFileChanged(const std::weak_ptr<FLiveState> &Weak, const std::string &Path)
+    {
+        // on the watcher thread: parse, diff, and queue for DispatchReloads
+        std::shared_ptr<FLiveState> L = Weak.lock();
+        if (L == nullptr)
+            return;
+        std::ifstream File(Path, std::ios::in);
+        auto Table = std::make_shared<SectionTable>();
+        if (!File || !Parse(File, *Table))
+        {
+            LOG_ERROR("Unable to reload config file \"%s\"", UTF8_TO_TCHAR(Path.c_str()));
+            return;
+        }
+        std::vector<ConfigChange> Changes = Diff(*L->Owner->GetTable(), *Table);
+        {
+            std::lock_guard<std::mutex> Lock(L->Mutex);
+            if (Changes.empty())
+            {
+                L->Pending = nullptr; // (back to) what is published
+                L->PendingChanges.clear();
+                return;
+            }
+            L->Pending = std::move(Table);
+            L->PendingChanges = std::move(Changes);
+        }
+        std::lock_guard<std::mutex> Lock(PendingReloads().Mutex);
+        PendingReloads().Files.push_back(Weak);
+    }
+
+    void Publish()
+    {
+        // on the game thread (DispatchReloads)
+        std::vector<std::function<void()>> Notify;
+        {
+            std::lock_guard<std::mutex> Lock(Live->Mutex);
+            if (Live->Pending == nullptr)
+                return;
+            const std::shared_ptr<const SectionTable> Table = std::move(Live->Pending);
+            const std::vector<ConfigChange> Changes = std::move(Live->PendingChanges);
+            Live->PendingChanges.clear();
+            std::atomic_store(&Sections, Table);
+            for (const ConfigChange &C : Changes)
+            {
+                LOG("Reloaded [%s] %s: \"%s\" -> \"%s\"", UTF8_TO_TCHAR(C.Section.c_str()),
+                    UTF8_TO_TCHAR(C.Variable.c_str()), *C.OldValue, *C.NewValue);
+            }
+
+            // re-parse the handles that are still around
+            auto &Handles = Live->Handles;
+            Handles.erase(std::remove_if(Handles.begin(), Handles.end(), [](const auto &W) { return W.expired(); }),
+                          Handles.end());
+            for (const auto &Weak : Handles)
+            {
+                std::shared_ptr<ConfigHandleSlot> Slot = Weak.lock();
+                const ParamString *Value = Lookup(*Table, Slot->Section, Slot->Variable);
+                Slot->Update(Value ? &Value->DataStr : nullptr);
+            }
+
+            for (const auto &Sub : Live->Subscriptions)
+            {
+                const bool bAffected = std::any_of(Changes.begin(), Changes.end(), [&Sub](const ConfigChange &C) {
+                    return std::any_of(Sub.Keys.begin(), Sub.Keys.end(), [&C](const auto &Key) {
+                        return Key.first == C.Section && (Key.second.empty() || Key.second == C.Variable);
+                    });
+                });
+                if (bAffected && Sub.OnChanged)
+                    Notify.push_back(Sub.OnChanged);
+            }
+        }
+        // without the lock, subscribers may read (or (un)subscribe) again
+        for (const auto &OnChanged : Notify)
+            OnChanged();
+    }
+
   private:
     FString FilePath; // const except for overwrite
     bool bSuccessfulUpdate = false;
-    std::unordered_map<std::string, IniSection> Sections;
+    std::shared_ptr<const SectionTable> Sections = std::make_shared<const SectionTable>();
+    std::shared_ptr<FLiveState> Live = std::make_shared<FLiveState>(this);
 };
 
-static ConfigFile GeneralParams(FPaths::Combine(CarlaUE4Path, TEXT("Config/DReyeVRConfig.ini")));
+extern ConfigFile GeneralParams; // Config/DReyeVRConfig.ini, shared by every translation unit (see ConfigFile.cpp)
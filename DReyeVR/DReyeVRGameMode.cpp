@@ -1,7 +1,8 @@
 #include "DReyeVRGameMode.h"
 #include "Carla/AI/AIControllerFactory.h"      // AAIControllerFactory
 #include "Carla/Actor/StaticMeshFactory.h"     // AStaticMeshFactory
-#include "Carla/Game/CarlaStatics.h"           // GetReplayer, GetEpisode
+#include "Carla/Game/CarlaStatics.h"           // GetReplayer, GetEpisode, GetRecorder
+#include "Carla/Recorder/CarlaRecorder.h"      // ACarlaRecorder
 #include "Carla/Recorder/CarlaReplayer.h"      // ACarlaReplayer
 #include "Carla/Sensor/DReyeVRSensor.h"        // ADReyeVRSensor
 #include "Carla/Sensor/SensorFactory.h"        // ASensorFactory
@@ -14,10 +15,16 @@
 #include "DReyeVRUtils.h"                      // FindDefnInRegistry
 #include "EgoVehicle.h"                        // AEgoVehicle
 #include "FlatHUD.h"                           // ADReyeVRHUD
+#include "FrameBudgetProfiler.h"               // FrameBudgetProfiler
 #include "HeadMountedDisplayFunctionLibrary.h" // IsHeadMountedDisplayAvailable
 #include "Kismet/GameplayStatics.h"            // GetPlayerController
+#include "Misc/FileHelper.h"                   // FFileHelper
 #include "UObject/UObjectIterator.h"           // TObjectInterator
 
+#include <unordered_set> // std::unordered_set
+
+bool ADReyeVRGameMode::bQuitAfterReplay = false;
+
 ADReyeVRGameMode::ADReyeVRGameMode(FObjectInitializer const &FO) : Super(FO)
 {
     // initialize stuff here
@@ -286,6 +293,11 @@ void ADReyeVRGameMode::Tick(float DeltaSeconds)
         SetupReplayer(); // once this is successfully run, it no longer gets executed
     }
 
+    TickQuitAfterReplay();
+
+    // publish config files that were edited (and re-parsed in the background) since the last frame
+    ConfigFile::DispatchReloads();
+
     DrawBBoxes();
 }
 
@@ -486,6 +498,94 @@ void ADReyeVRGameMode::SetupReplayer()
     }
 }
 
+void ADReyeVRGameMode::DReyeVRExtractWindow(FString Filename, float TimeStart, float TimeEnd, FString PacketTypes)
+{
+    auto *Recorder = UCarlaStatics::GetRecorder(GetWorld());
+    if (Recorder == nullptr)
+    {
+        LOG_ERROR("No recorder available to query \"%s\"", *Filename);
+        return;
+    }
+    const std::string Result = Recorder->ShowFileWindow(TCHAR_TO_UTF8(*Filename), TimeStart, TimeEnd,
+                                                        TCHAR_TO_UTF8(*PacketTypes));
+    const FString OutPath = FString(GetRecorderFilename(TCHAR_TO_UTF8(*Filename)).c_str()) +
+                            FString::Printf(TEXT(".%.3f-%.3f.json"), TimeStart, TimeEnd);
+    if (FFileHelper::SaveStringToFile(FString(UTF8_TO_TCHAR(Result.c_str())), *OutPath))
+    {
+        LOG("Extracted [%.3f, %.3f] of \"%s\" (%d bytes) to \"%s\"", TimeStart, TimeEnd, *Filename,
+            int(Result.size()), *OutPath);
+    }
+    else
+    {
+        LOG_ERROR("Unable to write extracted window to \"%s\"", *OutPath);
+    }
+}
+
+void ADReyeVRGameMode::DReyeVRReplayFrames(FString Filename, int32 FrameStart, int32 FrameEnd, bool bQuitWhenDone)
+{
+    auto *Recorder = UCarlaStatics::GetRecorder(GetWorld());
+    if (Recorder == nullptr || FrameStart < 0 || FrameEnd <= FrameStart)
+    {
+        LOG_ERROR("Unable to replay frames [%d, %d) of \"%s\"", FrameStart, FrameEnd, *Filename);
+        return;
+    }
+    bQuitAfterReplay = bQuitWhenDone;
+    const std::string Info =
+        Recorder->ReplayFrameRange(TCHAR_TO_UTF8(*Filename), uint64_t(FrameStart), uint64_t(FrameEnd), 0, false);
+    LOG("%s", UTF8_TO_TCHAR(Info.c_str()));
+}
+
+void ADReyeVRGameMode::DReyeVRReplayTimes(FString Filename, float TimeStart, float TimeEnd, bool bQuitWhenDone)
+{
+    auto *Recorder = UCarlaStatics::GetRecorder(GetWorld());
+    if (Recorder == nullptr)
+    {
+        LOG_ERROR("No recorder available to replay \"%s\"", *Filename);
+        return;
+    }
+    bQuitAfterReplay = bQuitWhenDone;
+    const std::string Info = Recorder->ReplayTimeRange(TCHAR_TO_UTF8(*Filename), TimeStart, TimeEnd, 0, false);
+    LOG("%s", UTF8_TO_TCHAR(Info.c_str()));
+}
+
+void ADReyeVRGameMode::DReyeVRProfileExport(FString Filename)
+{
+    if (Filename.IsEmpty())
+        Filename = TEXT("DReyeVRFrameBudget.csv");
+    if (FPaths::IsRelative(Filename))
+        Filename = FPaths::Combine(FPaths::ProjectSavedDir(), Filename);
+    Filename = FPaths::ConvertRelativePathToFull(Filename);
+    const FrameBudgetProfiler &Profiler = FrameBudgetProfiler::Get();
+    const std::string Path = TCHAR_TO_UTF8(*Filename);
+    const bool bSuccess = Filename.EndsWith(TEXT(".json"))
+                              ? Profiler.ExportJSON(Path, GeneralParams.Get<float>("Profiler", "BudgetMs"))
+                              : Profiler.ExportCSV(Path);
+    if (bSuccess)
+        LOG("Exported the frame budget of the last %d frames to \"%s\"", int(Profiler.NumFrames()), *Filename);
+    else
+        LOG_ERROR("Unable to export the frame budget to \"%s\"", *Filename);
+}
+
+void ADReyeVRGameMode::TickQuitAfterReplay()
+{
+    if (!bQuitAfterReplay)
+        return;
+    auto *Replayer = UCarlaStatics::GetReplayer(GetWorld());
+    if (Replayer == nullptr)
+        return;
+    if (Replayer->IsEnabled())
+    {
+        bReplayStarted = true;
+    }
+    else if (bReplayStarted)
+    {
+        // the (range) replay has finished
+        LOG("Replay finished, exiting");
+        bQuitAfterReplay = false;
+        FGenericPlatformMisc::RequestExit(false);
+    }
+}
+
 void ADReyeVRGameMode::DrawBBoxes()
 {
 #if 0
@@ -494,11 +594,13 @@ void ADReyeVRGameMode::DrawBBoxes()
     {
         UGameplayStatics::GetAllActorsOfClass(GetWorld(), ACarlaWheeledVehicle::StaticClass(), FoundActors);
     }
+    std::unordered_set<std::string> Visited;
     for (AActor *A : FoundActors)
     {
         std::string name = TCHAR_TO_UTF8(*A->GetName());
         if (A->GetName().Contains("DReyeVR"))
             continue; // skip drawing a bbox over the EgoVehicle
+        Visited.insert(name);
         if (BBoxes.find(name) == BBoxes.end())
         {
             BBoxes[name] = ADReyeVRCustomActor::CreateNew(SM_CUBE, MAT_TRANSLUCENT, GetWorld(), "BBox" + A->GetName());
@@ -529,28 +631,47 @@ void ADReyeVRGameMode::DrawBBoxes()
             // BBox->SetActorRotation(A->GetActorRotation());
         }
     }
+    // the boxes of destroyed vehicles are reused for the next ones
+    for (auto It = BBoxes.begin(); It != BBoxes.end();)
+    {
+        if (Visited.find(It->first) == Visited.end())
+        {
+            It->second->Release();
+            It = BBoxes.erase(It);
+        }
+        else
+            ++It;
+    }
 #endif
 }
 
 void ADReyeVRGameMode::ReplayCustomActor(const DReyeVR::CustomActorData &RecorderData, const double Per)
 {
     // first spawn the actor if not currently active
-    const std::string ActorName = TCHAR_TO_UTF8(*RecorderData.Name);
-    ADReyeVRCustomActor *A = nullptr;
-    if (ADReyeVRCustomActor::ActiveCustomActors.find(ActorName) == ADReyeVRCustomActor::ActiveCustomActors.end())
+    ADReyeVRCustomActor *A = ADReyeVRCustomActor::FindActive(RecorderData.Name);
+    if (A == nullptr)
     {
-        /// TODO: also track KnownNumMaterials?
-        A = ADReyeVRCustomActor::CreateNew(RecorderData.MeshPath, RecorderData.MaterialParams.MaterialPath, GetWorld(),
-                                           RecorderData.Name);
-    }
-    else
-    {
-        A = ADReyeVRCustomActor::ActiveCustomActors[ActorName];
+        // reuse the actor from an earlier appearance in the recording (deactivated by the replayer since)
+        const std::string ActorName = TCHAR_TO_UTF8(*RecorderData.Name);
+        auto Replayed = ReplayedCustomActors.find(ActorName);
+        if (Replayed != ReplayedCustomActors.end() && IsValid(Replayed->second))
+        {
+            A = Replayed->second;
+        }
+        else
+        {
+            /// TODO: also track KnownNumMaterials?
+            A = ADReyeVRCustomActor::CreateNew(RecorderData.MeshPath, RecorderData.MaterialParams.MaterialPath,
+                                               GetWorld(), RecorderData.Name);
+            ReplayedCustomActors[ActorName] = A;
+        }
     }
     // ensure the actor is currently active (spawned)
     // now that we know this actor exists, update its internals
     if (A != nullptr)
     {
+        if (A->IsActive() && A->GetInternals() == RecorderData)
+            return; // same as in its previous replayed frame
         A->SetInternals(RecorderData);
         A->Activate();
         A->Tick(Per); // update locations immediately
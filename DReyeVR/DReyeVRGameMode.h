@@ -52,6 +52,24 @@ class ADReyeVRGameMode : public ACarlaGameModeBase
     // Replayer
     void SetupReplayer();
 
+    // Recording queries, ex. (in the console) "DReyeVRExtractWindow exp.rec 10 20 DReyeVR,Collision"
+    // writes the matching packets as json next to the recording
+    UFUNCTION(Exec)
+    void DReyeVRExtractWindow(FString Filename, float TimeStart, float TimeEnd, FString PacketTypes);
+
+    // Synchronous replay of the frames [FrameStart, FrameEnd) (or the frames starting in [TimeStart, TimeEnd)) of a
+    // recording, ex. "DReyeVRReplayFrames exp.rec 1000 2000 1" to render one shard of it (see Tools/ReplayShards)
+    // bQuitWhenDone exits the simulator once the range has been replayed
+    UFUNCTION(Exec)
+    void DReyeVRReplayFrames(FString Filename, int32 FrameStart, int32 FrameEnd, bool bQuitWhenDone);
+    UFUNCTION(Exec)
+    void DReyeVRReplayTimes(FString Filename, float TimeStart, float TimeEnd, bool bQuitWhenDone);
+
+    // Writes the per-stage frame timings of the last frames, ex. "DReyeVRProfileExport budget.json" (or .csv),
+    // relative paths are in the project's Saved directory
+    UFUNCTION(Exec)
+    void DReyeVRProfileExport(FString Filename);
+
     // Meta world functions
     void SetVolume();
     FTransform GetSpawnPoint(int SpawnPointIndex = 0) const;
@@ -60,6 +78,8 @@ class ADReyeVRGameMode : public ACarlaGameModeBase
     void ReplayCustomActor(const DReyeVR::CustomActorData &RecorderData, const double Per);
     void DrawBBoxes();
     std::unordered_map<std::string, ADReyeVRCustomActor *> BBoxes;
+    // actors spawned by ReplayCustomActor (still there, inactive, when the recording has none of them for a while)
+    std::unordered_map<std::string, ADReyeVRCustomActor *> ReplayedCustomActors;
 
   private:
     // for handling inputs and possessions
@@ -67,6 +87,7 @@ class ADReyeVRGameMode : public ACarlaGameModeBase
     void SetupSpectator();
     bool SetupEgoVehicle();
     void SpawnEgoVehicle(const FTransform &SpawnPt);
+    void TickQuitAfterReplay();
 
     // TWeakObjectPtr's allow us to check if the underlying object is alive
     // in case it was destroyed by someone other than us (ex. garbage collection)
@@ -94,4 +115,6 @@ class ADReyeVRGameMode : public ACarlaGameModeBase
     bool bReplaySync = false;             // false allows for interpolation
     bool bUseCarlaSpectator = false;      // use the Carla spectator or spawn our own
     bool bRecorderInitiated = false;      // allows tick-wise checking for replayer/recorder
+    bool bReplayStarted = false;          // the replayer has been enabled since this game mode started
+    static bool bQuitAfterReplay;         // static to survive the map (re)load of the replay
 };
\ No newline at end of file
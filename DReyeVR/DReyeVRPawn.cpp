@@ -1,6 +1,8 @@
 #include "DReyeVRPawn.h"
 #include "DReyeVRUtils.h"                      // CreatePostProcessingEffect
 #include "EgoVehicle.h"                        // AEgoVehicle
+#include "EvdevWheelDevice.h"                  // EvdevWheelDevice
+#include "FrameBudgetProfiler.h"               // DREYEVR_PROFILE_STAGE
 #include "HeadMountedDisplayFunctionLibrary.h" // SetTrackingOrigin, GetWorldToMetersScale
 #include "HeadMountedDisplayTypes.h"           // ESpectatorScreenMode
 #include "Materials/MaterialInstanceDynamic.h" // UMaterialInstanceDynamic
@@ -49,10 +51,18 @@ void ADReyeVRPawn::ReadConfigVariables()
     GeneralParams.Get("EgoVehicleHUD", "EnableSpectatorScreen", bEnableSpectatorScreen);
 
     // wheel hardware
+    GeneralParams.Get("Hardware", "WheelBackend", WheelBackend);
+    GeneralParams.Get("Hardware", "EvdevDevice", EvdevDevice);
+    GeneralParams.Get("Hardware", "WheelReplayFile", WheelReplayFile);
+    GeneralParams.Get("Hardware", "WheelRecordFile", WheelRecordFile);
     GeneralParams.Get("Hardware", "DeviceIdx", WheelDeviceIdx);
     GeneralParams.Get("Hardware", "LogUpdates", bLogLogitechWheel);
     GeneralParams.Get("Hardware", "ForceFeedbackMagnitude", SaturationPercentage);
-    GeneralParams.Get("Hardware", "DeltaInputThreshold", LogiThresh);
+    float DeltaInputThreshold = 0.02f;
+    GeneralParams.Get("Hardware", "DeltaInputThreshold", DeltaInputThreshold);
+    Filter.SetThreshold(DeltaInputThreshold);
+    GeneralParams.Get("Hardware", "WheelThread", bWheelThread);
+    GeneralParams.Get("Hardware", "WheelThreadRateHz", WheelThreadRateHz);
 }
 
 void ADReyeVRPawn::ConstructCamera()
@@ -75,6 +85,23 @@ void ADReyeVRPawn::BeginPlay()
     World = GetWorld();
     ensure(World != nullptr);
     FirstPersonCam->RegisterComponentWithWorld(World);
+
+    // pick up edits to the config file while running
+    ConfigSubscription = GeneralParams.Subscribe(
+        {{"CameraParams", "FieldOfView"}, {"VehicleInputs", ""}, {"EgoVehicleHUD", ""}, {"Hardware", ""}}, [this]() {
+            const FString WheelSetup = WheelBackend + EvdevDevice + WheelReplayFile + WheelRecordFile;
+            ReadConfigVariables();
+            FirstPersonCam->SetFieldOfView(FieldOfView);
+            if (!WheelSetup.Equals(WheelBackend + EvdevDevice + WheelReplayFile + WheelRecordFile))
+                DestroyWheelDevice(false); // reopened with the new settings on the next tick
+        });
+}
+
+void ADReyeVRPawn::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    GeneralParams.Unsubscribe(ConfigSubscription);
+    ConfigSubscription = -1;
+    Super::EndPlay(EndPlayReason);
 }
 
 void ADReyeVRPawn::BeginPlayer(APlayerController *PlayerIn)
@@ -104,8 +131,7 @@ void ADReyeVRPawn::BeginDestroy()
 {
     Super::BeginDestroy();
 
-    if (bIsLogiConnected)
-        DestroyLogiWheel(false);
+    DestroyWheelDevice(false);
 
     LOG("DReyeVRPawn has been destroyed");
 }
@@ -115,13 +141,22 @@ void ADReyeVRPawn::Tick(float DeltaTime)
     Super::Tick(DeltaTime);
 
     // Tick SteamVR
-    TickSteamVR();
+    {
+        DREYEVR_PROFILE_STAGE(DReyeVRPawn_TickSteamVR);
+        TickSteamVR();
+    }
 
-    // Tick the logitech wheel
-    TickLogiWheel();
+    // Tick the steering wheel (hardware or replayed)
+    {
+        DREYEVR_PROFILE_STAGE(DReyeVRPawn_TickWheel);
+        TickWheelDevice();
+    }
 
     // Tick spectator screen
-    TickSpectatorScreen(DeltaTime);
+    {
+        DREYEVR_PROFILE_STAGE(DReyeVRPawn_TickSpectatorScreen);
+        TickSpectatorScreen(DeltaTime);
+    }
 }
 
 /// ========================================== ///
@@ -240,7 +275,7 @@ void ADReyeVRPawn::DrawSpectatorScreen()
         FVector2D ReticlePos;
         {
             // get where in the world the intersection occurs
-            const FVector HitPoint = EgoVehicle->GetSensor()->GetData()->GetFocusActorPoint();
+            const FVector HitPoint = EgoVehicle->GetSensor()->GetPredictedFocusPoint();
             bool bPlayerViewportRelative = true;
             UGameplayStatics::ProjectWorldToScreen(Player, HitPoint, ReticlePos, bPlayerViewportRelative);
         }
@@ -310,7 +345,7 @@ void ADReyeVRPawn::DrawFlatHUD(float DeltaSeconds)
     if (bDrawFlatReticle) // Draw reticle on flat-screen HUD
     {
         // get where in the world the intersection occurs
-        const FVector HitPoint = SensorData->GetFocusActorPoint();
+        const FVector HitPoint = EgoVehicle->GetSensor()->GetPredictedFocusPoint();
 
         const float Diameter = ReticleSize;
         const float Thickness = (ReticleSize / 2.f) / 10.f; // 10 % of radius
@@ -330,7 +365,7 @@ void ADReyeVRPawn::DrawFlatHUD(float DeltaSeconds)
         const FRotator &WorldRot = GetCamera()->GetComponentRotation();
         const FVector &GazeOrigin = SensorData->GetGazeOrigin();
         const FVector RayStart = WorldPos + WorldRot.RotateVector(GazeOrigin);
-        const FVector RayEnd = SensorData->GetFocusActorPoint();
+        const FVector RayEnd = EgoVehicle->GetSensor()->GetPredictedFocusPoint();
 
         // Draw line components in FlatHUD
         FlatHUD->DrawDynamicLine(RayStart, RayEnd, FColor::Red, 3.0f);
@@ -338,286 +373,270 @@ void ADReyeVRPawn::DrawFlatHUD(float DeltaSeconds)
 }
 
 /// ========================================== ///
-/// ---------------:LOGITECH:----------------- ///
+/// -----------------:WHEEL:------------------ ///
 /// ========================================== ///
 
-void ADReyeVRPawn::InitLogiWheel()
+void ADReyeVRPawn::InitWheelDevice()
 {
+    WheelInitTime = FPlatformTime::Seconds();
+    if (WheelBackend.Equals("None", ESearchCase::IgnoreCase))
+        return;
+    if (Wheel.IsValid() && !bIsWheelConnected)
+        DestroyWheelDevice(false); // unplugged, look for it again (stops the wheel-device thread before any SDK call)
+    FString WheelError;
+    if (WheelBackend.Equals("Logitech", ESearchCase::IgnoreCase))
+    {
 #if USE_LOGITECH_PLUGIN
-    LogiSteeringInitialize(false);
-    bIsLogiConnected = LogiIsConnected(WheelDeviceIdx); // get status of connected device
-    if (bIsLogiConnected)
+        LogiSteeringInitialize(false);
+        if (LogiIsConnected(WheelDeviceIdx)) // get status of connected device
+        {
+            const size_t n = 1000; // name shouldn't be more than 1000 chars right?
+            wchar_t *NameBuffer = (wchar_t *)malloc(n * sizeof(wchar_t));
+            if (LogiGetFriendlyProductName(WheelDeviceIdx, NameBuffer, n) == false)
+            {
+                LOG_WARN("Unable to get Logi friendly name!");
+                NameBuffer = L"Unknown";
+            }
+            std::wstring wNameStr(NameBuffer, n);
+            std::string NameStr(wNameStr.begin(), wNameStr.end());
+            FString LogiName(NameStr.c_str());
+            LOG("Found a Logitech device (%s) connected on input %d", *LogiName, WheelDeviceIdx);
+            free(NameBuffer); // no longer needed
+            if (!Wheel.IsValid())
+                Wheel = MakeUnique<LogitechWheelDevice>(WheelDeviceIdx, bLogLogitechWheel);
+        }
+        else
+        {
+            WheelError = FString::Printf(TEXT("Could not find Logitech device connected on input %d"), WheelDeviceIdx);
+        }
+#else
+        WheelError = "The Logitech wheel plugin is unavailable on this platform (see WheelBackend in the config)";
+#endif
+    }
+    else if (WheelBackend.Equals("Evdev", ESearchCase::IgnoreCase))
     {
-        const size_t n = 1000; // name shouldn't be more than 1000 chars right?
-        wchar_t *NameBuffer = (wchar_t *)malloc(n * sizeof(wchar_t));
-        if (LogiGetFriendlyProductName(WheelDeviceIdx, NameBuffer, n) == false)
+        if (!Wheel.IsValid())
         {
-            LOG_WARN("Unable to get Logi friendly name!");
-            NameBuffer = L"Unknown";
+            auto Evdev = MakeUnique<EvdevWheelDevice>(TCHAR_TO_UTF8(*EvdevDevice));
+            if (Evdev->IsConnected())
+            {
+                LOG("Found an input device (%s) at %s", UTF8_TO_TCHAR(Evdev->GetName().c_str()),
+                    UTF8_TO_TCHAR(Evdev->GetPath().c_str()));
+                Wheel = MoveTemp(Evdev);
+            }
+            else
+            {
+                const FString Device = EvdevDevice.IsEmpty() ? FString("joystick") : EvdevDevice;
+                WheelError = FString::Printf(TEXT("Could not find an evdev wheel (%s)"), *Device);
+            }
+        }
+    }
+    else if (WheelBackend.Equals("File", ESearchCase::IgnoreCase))
+    {
+        if (!Wheel.IsValid())
+        {
+            FString Path = WheelReplayFile;
+            if (FPaths::IsRelative(Path))
+                Path = FPaths::Combine(CarlaUE4Path, Path);
+            WheelLog Log;
+            if (Log.Load(TCHAR_TO_UTF8(*Path)))
+            {
+                LOG("Replaying %d wheel inputs from \"%s\"", int(Log.Inputs.size()), *Path);
+                auto Replay = MakeUnique<FileWheelDevice>(MoveTemp(Log));
+                WheelReplay = Replay.Get();
+                WheelReplayStartTime = (World != nullptr) ? World->GetTimeSeconds() : 0.f;
+                WheelReplay->SetTime(0.0); // follows the game time (see TickWheelDevice), not the wall clock
+                Wheel = MoveTemp(Replay);
+            }
+            else
+            {
+                WheelError = FString::Printf(TEXT("Unable to load the wheel log \"%s\""), *Path);
+            }
         }
-        std::wstring wNameStr(NameBuffer, n);
-        std::string NameStr(wNameStr.begin(), wNameStr.end());
-        FString LogiName(NameStr.c_str());
-        LOG("Found a Logitech device (%s) connected on input %d", *LogiName, WheelDeviceIdx);
-        free(NameBuffer); // no longer needed
     }
     else
     {
-        const FString LogiError = "Could not find Logitech device connected on input 0";
+        WheelError = FString::Printf(TEXT("Unknown WheelBackend \"%s\" (Logitech, Evdev, File or None)"),
+                                     *WheelBackend);
+    }
+
+    bIsWheelConnected = Wheel.IsValid() && Wheel->IsConnected();
+    if (!bIsWheelConnected)
+    {
         const bool PrintToLog = false; // kinda annoying when flooding the logs with warning messages
         const bool PrintToScreen = true;
         const float ScreenDurationSec = 20.f;
         const FLinearColor MsgColour = FLinearColor(1, 0, 0, 1); // RED
-        UKismetSystemLibrary::PrintString(World, LogiError, PrintToScreen, PrintToLog, MsgColour, ScreenDurationSec);
+        UKismetSystemLibrary::PrintString(World, WheelError, PrintToScreen, PrintToLog, MsgColour, ScreenDurationSec);
         if (PrintToLog)
-            LOG_ERROR("%s", *LogiError); // Error is RED
+            LOG_ERROR("%s", *WheelError); // Error is RED
+        return;
     }
-#endif
-}
 
-void ADReyeVRPawn::DestroyLogiWheel(bool DestroyModule)
-{
-#if USE_LOGITECH_PLUGIN
-    if (bIsLogiConnected)
+    if (!WheelRecordFile.IsEmpty() && !WheelRecorder.IsValid())
     {
-        // stop any forces on the wheel (we only use spring force feedback)
-        LogiStopSpringForce(WheelDeviceIdx);
-
-        if (DestroyModule) // only destroy the module at the end of the game (not ego life)
+        FString Path = WheelRecordFile;
+        if (FPaths::IsRelative(Path))
+            Path = FPaths::Combine(CarlaUE4Path, Path);
+        WheelRecorder = MakeUnique<RecordingWheelDevice>(*Wheel, TCHAR_TO_UTF8(*Path));
+        WheelRecordStartTime = (World != nullptr) ? World->GetTimeSeconds() : 0.f;
+        WheelRecorder->SetTime(0.0); // on the game time (see TickWheelDevice), the clock the File backend replays on
+        if (WheelRecorder->IsOpen())
+            LOG("Recording the wheel to \"%s\"", *Path);
+        else
         {
-            // shutdown the entire module (dangerous bc lingering pointers)
-            LogiSteeringShutdown();
+            LOG_ERROR("Unable to write the wheel log \"%s\"", *Path);
+            WheelRecorder = nullptr;
         }
     }
-#endif
+    if (bWheelThread && !WheelThread.IsValid())
+    {
+        WheelThreadParams Params;
+        Params.RateHz = WheelThreadRateHz;
+        WheelThread = MakeUnique<WheelDeviceThread>(*GetActiveWheel(), Params);
+        WheelThread->Start();
+        LOG("Polling the wheel at %.0f Hz on its own thread", WheelThreadRateHz);
+    }
 }
 
-void ADReyeVRPawn::TickLogiWheel()
+WheelDevice *ADReyeVRPawn::GetActiveWheel() const
 {
-    if (EgoVehicle == nullptr)
-        return;
-    // first try to initialize the Logi hardware if not currently active
-    if (!bIsLogiConnected)
+    return WheelRecorder.IsValid() ? static_cast<WheelDevice *>(WheelRecorder.Get()) : Wheel.Get();
+}
+
+void ADReyeVRPawn::DestroyWheelDevice(bool DestroyModule)
+{
+    if (WheelThread.IsValid())
+    {
+        WheelThread->Stop(); // before the device (or module) might go away, releases its forces
+        const std::string Summary = WheelThread->SummaryString();
+        LOG("%s", UTF8_TO_TCHAR(Summary.c_str()));
+        WheelThread = nullptr;
+    }
+    else if (bIsWheelConnected && Wheel.IsValid())
     {
-        InitLogiWheel();
+        // stop any forces on the wheel (we only use spring force feedback)
+        GetActiveWheel()->StopForces();
     }
+    WheelRecorder = nullptr; // closes the wheel log
+    WheelReplay = nullptr;
+    Wheel = nullptr;
+    bIsWheelConnected = false;
 #if USE_LOGITECH_PLUGIN
-    bIsLogiConnected = LogiIsConnected(WheelDeviceIdx); // get status of connected device
-    if (bIsLogiConnected && bOverrideInputsWithKbd == false)
+    if (DestroyModule && WheelBackend.Equals("Logitech", ESearchCase::IgnoreCase))
     {
-        // Taking logitech inputs for steering
-        LogitechWheelUpdate();
-
-        // Add Force Feedback to the hardware steering wheel when a LogitechWheel is used
-        ApplyForceFeedback();
+        // only destroy the module at the end of the game (not ego life)
+        // shutdown the entire module (dangerous bc lingering pointers)
+        LogiSteeringShutdown();
     }
-    bOverrideInputsWithKbd = false; // disable for the next tick (unless held, which will set to true)
 #endif
 }
 
-#if USE_LOGITECH_PLUGIN
-
-// const std::vector<FString> VarNames = {"rgdwPOV[0]", "rgdwPOV[1]", "rgdwPOV[2]", "rgdwPOV[3]"};
-const std::vector<FString> VarNames = {                                                    // 34 values
-    "lX",           "lY",           "lZ",         "lRz",           "lRy",           "lRz", // variable names
-    "rglSlider[0]", "rglSlider[1]", "rgdwPOV[0]", "rgbButtons[0]", "lVX",           "lVY",           "lVZ",
-    "lVRx",         "lVRy",         "lVRz",       "rglVSlider[0]", "rglVSlider[1]", "lAX",           "lAY",
-    "lAZ",          "lARx",         "lARy",       "lARz",          "rglASlider[0]", "rglASlider[1]", "lFX",
-    "lFY",          "lFZ",          "lFRx",       "lFRy",          "lFRz",          "rglFSlider[0]", "rglFSlider[1]"};
-/// NOTE: this is a debug function used to dump all the information we can regarding
-// the Logitech wheel hardware we used since the exact buttons were not documented in
-// the repo: https://github.com/HARPLab/LogitechWheelPlugin
-void ADReyeVRPawn::LogLogitechPluginStruct(const struct DIJOYSTATE2 *Now)
+void ADReyeVRPawn::TickWheelDevice()
 {
-    if (Old == nullptr)
-    {
-        Old = new struct DIJOYSTATE2;
-        (*Old) = (*Now); // assign to the new (current) dijoystate struct
-        return;          // initializing the Old struct ptr
-    }
-    const std::vector<int> NowVals = {
-        Now->lX, Now->lY, Now->lZ, Now->lRx, Now->lRy, Now->lRz, Now->rglSlider[0], Now->rglSlider[1],
-        // Converting unsigned int & unsigned char to int
-        int(Now->rgdwPOV[0]), int(Now->rgbButtons[0]), Now->lVX, Now->lVY, Now->lVZ, Now->lVRx, Now->lVRy, Now->lVRz,
-        Now->rglVSlider[0], Now->rglVSlider[1], Now->lAX, Now->lAY, Now->lAZ, Now->lARx, Now->lARy, Now->lARz,
-        Now->rglASlider[0], Now->rglASlider[1], Now->lFX, Now->lFY, Now->lFZ, Now->lFRx, Now->lFRy, Now->lFRz,
-        Now->rglFSlider[0], Now->rglFSlider[1]}; // 32 elements
-    // Getting the (34) values from the old struct
-    const std::vector<int> OldVals = {
-        Old->lX, Old->lY, Old->lZ, Old->lRx, Old->lRy, Old->lRz, Old->rglSlider[0], Old->rglSlider[1],
-        // Converting unsigned int & unsigned char to int
-        int(Old->rgdwPOV[0]), int(Old->rgbButtons[0]), Old->lVX, Old->lVY, Old->lVZ, Old->lVRx, Old->lVRy, Old->lVRz,
-        Old->rglVSlider[0], Old->rglVSlider[1], Old->lAX, Old->lAY, Old->lAZ, Old->lARx, Old->lARy, Old->lARz,
-        Old->rglASlider[0], Old->rglASlider[1], Old->lFX, Old->lFY, Old->lFZ, Old->lFRx, Old->lFRy, Old->lFRz,
-        Old->rglFSlider[0], Old->rglFSlider[1]};
-
-    check(NowVals.size() == OldVals.size() && NowVals.size() == VarNames.size());
-
-    // print any differences
-    bool isDiff = false;
-    for (size_t i = 0; i < NowVals.size(); i++)
-    {
-        if (NowVals[i] != OldVals[i])
-        {
-            if (!isDiff) // only gets triggered at MOST once
-            {
-                LOG("Logging joystick at t=%.3f", UGameplayStatics::GetRealTimeSeconds(World));
-                isDiff = true;
-            }
-            LOG("Triggered \"%s\" from %d to %d", *(VarNames[i]), OldVals[i], NowVals[i]);
-        }
+    if (EgoVehicle == nullptr)
+        return;
+    // first try to initialize the wheel if not currently active
+    // (only the wheel-device thread talks to the device while it runs, it reports the device unplugged)
+    bIsWheelConnected =
+        Wheel.IsValid() && (WheelThread.IsValid() ? WheelThread->IsDeviceConnected() : Wheel->IsConnected());
+    if (!bIsWheelConnected && (WheelInitTime < 0.0 || FPlatformTime::Seconds() - WheelInitTime > 1.0))
+    {
+        InitWheelDevice();
     }
-
-    // also check the 128 rgbButtons array
-    for (size_t i = 0; i < 127; i++)
+    if (WheelReplay != nullptr && World != nullptr)
+        WheelReplay->SetTime(World->GetTimeSeconds() - WheelReplayStartTime); // paused and dilated with the game
+    if (WheelRecorder.IsValid() && World != nullptr)
+        WheelRecorder->SetTime(World->GetTimeSeconds() - WheelRecordStartTime); // and recorded on the same clock
+    if (bIsWheelConnected && bOverrideInputsWithKbd == false)
     {
-        if (Old->rgbButtons[i] != Now->rgbButtons[i])
-        {
-            if (!isDiff) // only gets triggered at MOST once
-            {
-                LOG("Logging joystick at t=%.3f", UGameplayStatics::GetRealTimeSeconds(World));
-                isDiff = true;
-            }
-            LOG("Triggered \"rgbButtons[%d]\" from %d to %d", int(i), int(OldVals[i]), int(NowVals[i]));
-        }
+        // Taking wheel inputs for steering (the latest state of the wheel-device thread, else polled now)
+        WheelState State;
+        if (WheelThread.IsValid() ? WheelThread->GetLatest(State) : GetActiveWheel()->Read(State))
+            ApplyWheelState(State);
+
+        // Add Force Feedback to the steering wheel
+        const WheelForce Force = ComputeForceFeedback();
+        if (WheelThread.IsValid())
+            WheelThread->SetForce(Force); // sent to the wheel by the thread (only when it changes)
+        else
+            GetActiveWheel()->ApplyForce(Force);
     }
-
-    // assign the current joystate into the old one
-    (*Old) = (*Now);
+    bOverrideInputsWithKbd = false; // disable for the next tick (unless held, which will set to true)
 }
 
-void ADReyeVRPawn::LogitechWheelUpdate()
+void ADReyeVRPawn::ApplyWheelState(const WheelState &State)
 {
     check(EgoVehicle);
     ensure(bOverrideInputsWithKbd == false); // kbd inputs should be false
 
-    // only execute this in Windows, the Logitech plugin is incompatible with Linux
-    if (LogiUpdate() == false) // update the logitech wheel
-        LOG_WARN("Logitech wheel %d failed to update!", WheelDeviceIdx);
-    DIJOYSTATE2 *WheelState = LogiGetState(WheelDeviceIdx);
-    ensure(WheelState != nullptr);
-    if (bLogLogitechWheel)
-        LogLogitechPluginStruct(WheelState);
-    /// NOTE: obtained these from LogitechWheelInputDevice.cpp:~111
-    // -32768 to 32767. -32768 = all the way to the left. 32767 = all the way to the right.
-    const float WheelRotation = FMath::Clamp(float(WheelState->lX), -32767.0f, 32767.0f) / 32767.0f; // (-1, 1)
-    // -32768 to 32767. 32767 = pedal not pressed. -32768 = pedal fully pressed.
-    const float AccelerationPedal = fabs(((WheelState->lY - 32767.0f) / (65535.0f))); // (0, 1)
-    // -32768 to 32767. Higher value = less pressure on brake pedal
-    const float BrakePedal = fabs(((WheelState->lRz - 32767.0f) / (65535.0f))); // (0, 1)
-    // -1 = not pressed. 0 = Top. 0.25 = Right. 0.5 = Bottom. 0.75 = Left.
-    const float Dpad = fabs(((WheelState->rgdwPOV[0] - 32767.0f) / (65535.0f)));
-
-    // weird behaviour: "Pedals will output a value of 0.5 until the wheel/pedals receive any kind of input"
-    // as per https://github.com/HARPLab/LogitechWheelPlugin
-    if (bPedalsDefaulting)
-    {
-        // this bPedalsDefaulting flag is initially set to not send inputs when the pedals are "defaulting", once the
-        // pedals/wheel is used (pressed/turned) once then this flag is ignored (false) for the remainder of the game
-        if (!FMath::IsNearlyEqual(WheelRotation, 0.f, LogiThresh) ||      // wheel is not at 0 (rest)
-            !FMath::IsNearlyEqual(AccelerationPedal, 0.5f, LogiThresh) || // accel pedal is pressed
-            !FMath::IsNearlyEqual(BrakePedal, 0.5f, LogiThresh))          // brake pedal is pressed
-        {
-            bPedalsDefaulting = false;
-        }
-    }
-    else
+    /// NOTE: normalized by the WheelDevice: steering (-1, 1), pedals (0, 1)
+    const WheelActions Actions = Filter.Update(State, EgoVehicle->GetAutopilotStatus());
+    if (Actions.bDriverInputs)
     {
         /// NOTE: directly calling the EgoVehicle functions
-        if (EgoVehicle->GetAutopilotStatus() &&
-            (FMath::IsNearlyEqual(WheelRotation, WheelRotationLast, LogiThresh) &&
-             FMath::IsNearlyEqual(AccelerationPedal, AccelerationPedalLast, LogiThresh) &&
-             FMath::IsNearlyEqual(BrakePedal, BrakePedalLast, LogiThresh)))
-        {
-            // let the autopilot drive if the user is not putting significant inputs
-            // ie. if their inputs are close enough to what was previously input
-            /// TODO: this system might break down if the autopilot is putting in sufficiently
-            ///       strong inputs, since the autopilot controls might might inadvertently
-            ///       be considered as human-input controls which amplifies the input and
-            ///       causes a positive cycle loop (which would be better avoided)
-        }
-        else
-        {
-            // driver has issued sufficient input to warrant manual takeover (disables autopilot)
-            EgoVehicle->SetAutopilot(false);
-            EgoVehicle->AddSteering(WheelRotation);
-            EgoVehicle->AddThrottle(AccelerationPedal);
-            EgoVehicle->AddBrake(BrakePedal);
-        }
+        // driver has issued sufficient input to warrant manual takeover (disables autopilot)
+        EgoVehicle->SetAutopilot(false);
+        EgoVehicle->AddSteering(Actions.Steering);
+        EgoVehicle->AddThrottle(Actions.Throttle);
+        EgoVehicle->AddBrake(Actions.Brake);
     }
-    // save the last values for the wheel & pedals
-    WheelRotationLast = WheelRotation;
-    AccelerationPedalLast = AccelerationPedal;
-    BrakePedalLast = BrakePedal;
-
-    ManageButtonPresses(*WheelState);
+    ManageButtonPresses(Actions);
 }
 
-void ADReyeVRPawn::ManageButtonPresses(const DIJOYSTATE2 &WheelState)
+void ADReyeVRPawn::ManageButtonPresses(const WheelActions &Actions)
 {
-    const bool bABXY_A = static_cast<bool>(WheelState.rgbButtons[0]);
-    const bool bABXY_B = static_cast<bool>(WheelState.rgbButtons[2]);
-    const bool bABXY_X = static_cast<bool>(WheelState.rgbButtons[1]);
-    const bool bABXY_Y = static_cast<bool>(WheelState.rgbButtons[3]);
-
-    if (bABXY_A || bABXY_B || bABXY_X || bABXY_Y)
+    if (Actions.Reverse())
         EgoVehicle->PressReverse();
     else
         EgoVehicle->ReleaseReverse();
 
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_A, bABXY_A);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_B, bABXY_B);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_X, bABXY_X);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_Y, bABXY_Y);
-
-    bool bTurnSignalR = static_cast<bool>(WheelState.rgbButtons[4]);
-    bool bTurnSignalL = static_cast<bool>(WheelState.rgbButtons[5]);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_A, Actions.bABXY_A);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_B, Actions.bABXY_B);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_X, Actions.bABXY_X);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_ABXY_Y, Actions.bABXY_Y);
 
-    if (bTurnSignalR)
+    if (Actions.bTurnSignalR)
         EgoVehicle->PressTurnSignalR();
     else
         EgoVehicle->ReleaseTurnSignalR();
 
-    if (bTurnSignalL)
+    if (Actions.bTurnSignalL)
         EgoVehicle->PressTurnSignalL();
     else
         EgoVehicle->ReleaseTurnSignalL();
 
-    // if (WheelState.rgbButtons[23]) // big red button on right side of g923
-
-    const bool bDPad_Up = (WheelState.rgdwPOV[0] == 0);
-    const bool bDPad_Right = (WheelState.rgdwPOV[0] == 9000);
-    const bool bDPad_Down = (WheelState.rgdwPOV[0] == 18000);
-    const bool bDPad_Left = (WheelState.rgdwPOV[0] == 27000);
-    const bool bPositive = static_cast<bool>(WheelState.rgbButtons[19]);
-    const bool bNegative = static_cast<bool>(WheelState.rgbButtons[20]);
-
-    EgoVehicle->CameraPositionAdjust(bDPad_Up, bDPad_Right, bDPad_Down, bDPad_Left, bPositive, bNegative);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Up, bDPad_Up);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Right, bDPad_Right);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Left, bDPad_Left);
-    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Down, bDPad_Down);
+    EgoVehicle->CameraPositionAdjust(Actions.bDPad_Up, Actions.bDPad_Right, Actions.bDPad_Down, Actions.bDPad_Left,
+                                     Actions.bPositive, Actions.bNegative);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Up, Actions.bDPad_Up);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Right, Actions.bDPad_Right);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Left, Actions.bDPad_Left);
+    EgoVehicle->UpdateWheelButton(EgoVehicle->Button_DPad_Down, Actions.bDPad_Down);
 }
 
-void ADReyeVRPawn::ApplyForceFeedback() const
+WheelForce ADReyeVRPawn::ComputeForceFeedback() const
 {
     check(EgoVehicle);
 
-    // only execute this in Windows, the Logitech plugin is incompatible with Linux
     // const float Speed = EgoVehicle->GetVelocity().Size(); // get magnitude of self (AActor's) velocity
-    /// TODO: move outside this function (in tick()) to avoid redundancy
-    if (bIsLogiConnected && LogiHasForceFeedback(WheelDeviceIdx))
+    WheelForce Force;
+    Force.bSpring = bIsWheelConnected; // devices without force feedback ignore it
+    // actuate the wheel to match the autopilot steering
+    float RawWheel = EgoVehicle->GetWheelSteerAngle(EVehicleWheelLocation::Front_Wheel);
+    // "Specifies the center of the spring force effect"
+    Force.OffsetPercentage = static_cast<int>(RawWheel * 0.5f);
+    Force.SaturationPercentage = SaturationPercentage;
+    // "Slope of the effect strength increase relative to deflection from Offset"
+    Force.CoefficientPercentage = 100;
+    const AEgoSensor *Sensor = EgoVehicle->GetSensor();
+    if (Sensor != nullptr && Sensor->GetData()->GetHapticControl().bActive)
     {
-        // actuate the logi wheel to match the autopilot steering
-        float RawWheel = EgoVehicle->GetWheelSteerAngle(EVehicleWheelLocation::Front_Wheel);
-        // "Specifies the center of the spring force effect"
-        const int OffsetPercentage = static_cast<int>(RawWheel * 0.5f);
-        const int CoeffPercentage = 100; // "Slope of the effect strength increase relative to deflection from Offset"
-        LogiPlaySpringForce(WheelDeviceIdx, OffsetPercentage, SaturationPercentage, CoeffPercentage);
-    }
-    else
-    {
-        LogiStopSpringForce(WheelDeviceIdx);
+        // haptic shared control: pull the wheel towards the desired steering angle (percent of half the range)
+        const DReyeVR::HapticControl &Haptic = Sensor->GetData()->GetHapticControl();
+        const float HalfRange = EgoVehicle->HapticWheelRangeDeg / 2.f;
+        const float Offset = FMath::Clamp(Haptic.DesiredSteeringAngle / HalfRange, -1.f, 1.f);
+        Force.OffsetPercentage = static_cast<int>(Offset * 100.f);
+        Force.CoefficientPercentage = static_cast<int>(FMath::Clamp(Haptic.Coefficient, 0.f, 1.f) * 100.f);
     }
     /// NOTE: there are other kinds of forces as described in the LogitechWheelPlugin API:
     // https://github.com/HARPLab/LogitechWheelPlugin/blob/master/LogitechWheelPlugin/Source/LogitechWheelPlugin/Private/LogitechBWheelInputDevice.cpp
@@ -630,8 +649,8 @@ void ADReyeVRPawn::ApplyForceFeedback() const
         3 = Side Collision		8 = Surface Effect
         4 = Frontal Collision	9 = Car Airborne
     */
+    return Force;
 }
-#endif
 
 /// ========================================== ///
 /// --------------:INPUTRELAY:---------------- ///
@@ -2,17 +2,11 @@
 
 #include "Camera/CameraComponent.h" // UCameraComponent
 #include "Engine/Scene.h"           // FPostProcessSettings
+#include "FileWheelDevice.h"        // FileWheelDevice, RecordingWheelDevice
 #include "GameFramework/Pawn.h"     // CreatePlayerInputComponent
-
-#ifndef _WIN32
-// can only use LogitechWheel plugin on Windows! :(
-#undef USE_LOGITECH_PLUGIN
-#define USE_LOGITECH_PLUGIN false
-#endif
-
-#if USE_LOGITECH_PLUGIN
-#include "LogitechSteeringWheelLib.h" // LogitechWheel plugin for hardware integration & force feedback
-#endif
+#include "LogitechWheelDevice.h"    // LogitechWheelDevice, USE_LOGITECH_PLUGIN
+#include "WheelDeviceThread.h"      // WheelDeviceThread
+#include "WheelInputFilter.h"       // WheelInputFilter
 
 #include "DReyeVRPawn.generated.h"
 
@@ -52,15 +46,17 @@ class ADReyeVRPawn : public APawn
         return FirstPersonCam;
     }
 
-    bool GetIsLogiConnected() const
+    bool GetIsWheelConnected() const
     {
-        return bIsLogiConnected;
+        return bIsWheelConnected;
     }
 
   protected:
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void BeginDestroy() override;
     void ReadConfigVariables();
+    int ConfigSubscription = -1; // GeneralParams.Subscribe (hot reload)
 
     class UWorld *World = nullptr;
     class AEgoVehicle *EgoVehicle = nullptr;
@@ -113,34 +109,39 @@ class ADReyeVRPawn : public APawn
     void SetBrakeKbd(const float in);
     void SetSteeringKbd(const float in);
     void SetThrottleKbd(const float in);
-    // most of the time, the participant will use the logi for inputs, but if needed the experimenter
+    // most of the time, the participant will use the wheel for inputs, but if needed the experimenter
     // can use the keyboard to reposition/takeover without input conflict
-    bool bOverrideInputsWithKbd = true; // keyboard > logi priority for inputs
+    bool bOverrideInputsWithKbd = true; // keyboard > wheel priority for inputs
 
     void SetupEgoVehicleInputComponent(UInputComponent *PlayerInputComponent, AEgoVehicle *EV);
     UInputComponent *InputComponent = nullptr;
     APlayerController *Player = nullptr;
 
-    ////////////////:LOGI:////////////////
-    void InitLogiWheel();
-    void TickLogiWheel();
-    void DestroyLogiWheel(bool DestroyModule);
+    ////////////////:WHEEL:////////////////
+    void InitWheelDevice();
+    void TickWheelDevice();
+    void DestroyWheelDevice(bool DestroyModule);
+    void ApplyWheelState(const WheelState &State);         // takeover of the autopilot and vehicle inputs
+    void ManageButtonPresses(const WheelActions &Actions); // for managing button presses
+    WheelForce ComputeForceFeedback() const;               // spring force towards the vehicle's steering
+    WheelDevice *GetActiveWheel() const;                   // the device, or the recorder around it
+    FString WheelBackend = "Logitech"; // Logitech (Windows), Evdev (Linux), File (replay of a wheel log) or None
+    FString EvdevDevice = "";          // /dev/input/event* path, empty for the first joystick
+    FString WheelReplayFile = "";      // wheel log replayed by the File backend
+    FString WheelRecordFile = "";      // wheel log written from whichever backend is active (empty: off)
     bool bLogLogitechWheel = false;
-    float LogiThresh = 0.02f;      // threshold for change needed to overtake AI controls
+    WheelInputFilter Filter;       // pedal defaulting, autopilot takeover (DeltaInputThreshold) and button mapping
     int SaturationPercentage = 30; // "Level of saturation... comparable to a magnitude"
     int WheelDeviceIdx = 0;        // usually leaving as 0 is fine, only use 1 if 0 is taken
-#if USE_LOGITECH_PLUGIN
-    struct DIJOYSTATE2 *Old = nullptr; // global "old" struct for the last state
-    void LogLogitechPluginStruct(const struct DIJOYSTATE2 *Now);
-    void LogitechWheelUpdate();                              // for logitech wheel integration
-    void ManageButtonPresses(const DIJOYSTATE2 &WheelState); // for managing button presses
-    void ApplyForceFeedback() const;                         // for logitech wheel integration
-    float WheelRotationLast, AccelerationPedalLast, BrakePedalLast;
-#endif
-    bool bIsLogiConnected = false; // check if Logi device is connected (on BeginPlay)
-    bool bIsHMDConnected = false;  // checks for HMD connection on BeginPlay
-    // default logi plugin behaviour is to set things to 0.5 for some reason
-    // "Pedals will output a value of 0.5 until the wheel/pedals receive any kind of input."
-    // https://github.com/HARPLab/LogitechWheelPlugin
-    bool bPedalsDefaulting = true;
+    bool bWheelThread = true;      // poll the wheel and apply its forces on a dedicated thread (WheelDeviceThread)
+    float WheelThreadRateHz = 500.f;
+    double WheelInitTime = -1.0; // last (re)connection attempt, retried once a second
+    TUniquePtr<WheelDevice> Wheel = nullptr;
+    FileWheelDevice *WheelReplay = nullptr; // Wheel when replaying a wheel log (File backend)
+    float WheelReplayStartTime = 0.f;       // world time the wheel log started replaying at
+    float WheelRecordStartTime = 0.f;       // world time the wheel log started recording at
+    TUniquePtr<RecordingWheelDevice> WheelRecorder = nullptr; // wraps Wheel when WheelRecordFile is set
+    TUniquePtr<WheelDeviceThread> WheelThread = nullptr;      // null when polling once per frame
+    bool bIsWheelConnected = false; // check if a wheel device is connected (on BeginPlay)
+    bool bIsHMDConnected = false;   // checks for HMD connection on BeginPlay
 };
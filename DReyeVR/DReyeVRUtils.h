@@ -344,27 +344,36 @@ static size_t GetNumberOfShaders()
 static FPostProcessSettings CreatePostProcessingParams(const std::vector<FSensorShader> &Shaders)
 {
     // modifying from here: https://docs.unrealengine.com/4.27/en-US/API/Runtime/Engine/Engine/FPostProcessSettings/
+    // resolved once, this runs for every shader of every captured frame
+    static const auto VignetteIntensity = GeneralParams.Register<float>("CameraParams", "VignetteIntensity");
+    static const auto ScreenPercentage = GeneralParams.Register<float>("CameraParams", "ScreenPercentage");
+    static const auto BloomIntensity = GeneralParams.Register<float>("CameraParams", "BloomIntensity");
+    static const auto SceneFringeIntensity = GeneralParams.Register<float>("CameraParams", "SceneFringeIntensity");
+    static const auto LensFlareIntensity = GeneralParams.Register<float>("CameraParams", "LensFlareIntensity");
+    static const auto GrainIntensity = GeneralParams.Register<float>("CameraParams", "GrainIntensity");
+    static const auto MotionBlurIntensity = GeneralParams.Register<float>("CameraParams", "MotionBlurIntensity");
+
     FPostProcessSettings PP;
     PP.bOverride_VignetteIntensity = true;
-    PP.VignetteIntensity = GeneralParams.Get<float>("CameraParams", "VignetteIntensity");
+    PP.VignetteIntensity = VignetteIntensity.Get();
 
     PP.bOverride_ScreenPercentage = true;
-    PP.ScreenPercentage = GeneralParams.Get<float>("CameraParams", "ScreenPercentage");
+    PP.ScreenPercentage = ScreenPercentage.Get();
 
     PP.bOverride_BloomIntensity = true;
-    PP.BloomIntensity = GeneralParams.Get<float>("CameraParams", "BloomIntensity");
+    PP.BloomIntensity = BloomIntensity.Get();
 
     PP.bOverride_SceneFringeIntensity = true;
-    PP.SceneFringeIntensity = GeneralParams.Get<float>("CameraParams", "SceneFringeIntensity");
+    PP.SceneFringeIntensity = SceneFringeIntensity.Get();
 
     PP.bOverride_LensFlareIntensity = true;
-    PP.LensFlareIntensity = GeneralParams.Get<float>("CameraParams", "LensFlareIntensity");
+    PP.LensFlareIntensity = LensFlareIntensity.Get();
 
     PP.bOverride_GrainIntensity = true;
-    PP.GrainIntensity = GeneralParams.Get<float>("CameraParams", "GrainIntensity");
+    PP.GrainIntensity = GrainIntensity.Get();
 
     PP.bOverride_MotionBlurAmount = true;
-    PP.MotionBlurAmount = GeneralParams.Get<float>("CameraParams", "MotionBlurIntensity");
+    PP.MotionBlurAmount = MotionBlurIntensity.Get();
 
     // append shaders to this postprocess effect
     for (const FSensorShader &ShaderInfo : Shaders)
@@ -1,12 +1,17 @@
 #include "EgoSensor.h"
 
-#include "Carla/Game/CarlaStatics.h"    // GetCurrentEpisode
-#include "DReyeVRUtils.h"               // GeneralParams.Get, ComputeClosestToRayIntersection
-#include "EgoVehicle.h"                 // AEgoVehicle
-#include "Kismet/GameplayStatics.h"     // UGameplayStatics::ProjectWorldToScreen
-#include "Kismet/KismetMathLibrary.h"   // Sin, Cos, Normalize
-#include "Misc/DateTime.h"              // FDateTime
-#include "UObject/UObjectBaseUtility.h" // GetName
+#include "Carla/Game/CarlaStatics.h"      // GetCurrentEpisode, GetReplayer
+#include "Carla/Recorder/CarlaReplayer.h" // CarlaReplayer
+#include "DReyeVRUtils.h"                 // GeneralParams.Get, ComputeClosestToRayIntersection
+#include "EgoVehicle.h"                   // AEgoVehicle
+#include "IImageWrapper.h"                // IImageWrapper
+#include "IImageWrapperModule.h"          // IImageWrapperModule
+#include "Kismet/GameplayStatics.h"       // UGameplayStatics::ProjectWorldToScreen
+#include "Kismet/KismetMathLibrary.h"     // Sin, Cos, Normalize
+#include "Misc/DateTime.h"                // FDateTime
+#include "RHIGPUReadback.h"               // FRHIGPUTextureReadback
+#include "RenderingThread.h"              // ENQUEUE_RENDER_COMMAND, FlushRenderingCommands
+#include "UObject/UObjectBaseUtility.h"   // GetName
 
 #if USE_SRANIPAL_PLUGIN
 #include "SRanipal_API.h" // SRanipal_GetVersion
@@ -17,6 +22,9 @@
 #include "VRSBlueprintFunctionLibrary.h" // VRS
 #endif
 
+#include <algorithm> // std::lower_bound
+#include <atomic>
+#include <deque>
 #include <string>
 
 #ifndef NO_DREYEVR_EXCEPTIONS
@@ -47,6 +55,15 @@ void AEgoSensor::ReadConfigVariables()
     GeneralParams.Get("EgoSensor", "MaxTraceLenM", MaxTraceLenM);
     GeneralParams.Get("EgoSensor", "DrawDebugFocusTrace", bDrawDebugFocusTrace);
 
+    // extrapolation of the gaze to the display time
+    GeneralParams.Get("GazePrediction", "Enabled", bPredictGaze);
+    GeneralParams.Get("GazePrediction", "LatencyMs", GazePredParams.LatencyMs);
+    GeneralParams.Get("GazePrediction", "PositionGain", GazePredParams.PositionGain);
+    GeneralParams.Get("GazePrediction", "VelocityGain", GazePredParams.VelocityGain);
+    GeneralParams.Get("GazePrediction", "SaccadeDegPerSec", GazePredParams.SaccadeDegPerSec);
+    GeneralParams.Get("GazePrediction", "MaxExtrapolationDeg", GazePredParams.MaxExtrapolationDeg);
+    GeneralParams.Get("GazePrediction", "MaxGapMs", GazePredParams.MaxGapMs);
+
     // variables corresponding to the action of screencapture during replay
     GeneralParams.Get("Replayer", "RecordAllShaders", bRecordAllShaders);
     GeneralParams.Get("Replayer", "RecordAllPoses", bRecordAllPoses);
@@ -57,6 +74,12 @@ void AEgoSensor::ReadConfigVariables()
     GeneralParams.Get("Replayer", "FrameHeight", FrameCapHeight);
     GeneralParams.Get("Replayer", "FrameDir", FrameCapLocation);
     GeneralParams.Get("Replayer", "FrameName", FrameCapFilename);
+    GeneralParams.Get("Replayer", "AsyncFrameCapture", bAsyncFrameCapture);
+    GeneralParams.Get("Replayer", "FrameWriterThreads", FrameWriterThreads);
+    GeneralParams.Get("Replayer", "FrameWriterMaxMB", FrameWriterMaxMB);
+    GeneralParams.Get("Replayer", "FrameReadbackLatency", FrameReadbackLatency);
+    GeneralParams.Get("Replayer", "FrameSink", FrameSinkFormat);
+    GeneralParams.Get("Replayer", "FrameStreamFPS", FrameStreamFPS);
 
 #if USE_FOVEATED_RENDER
     // foveated rendering variables
@@ -75,6 +98,8 @@ void AEgoSensor::BeginPlay()
     // Initialize the eye tracker hardware
     InitEyeTracker();
 
+    InitGazePredictor();
+
 #if USE_FOVEATED_RENDER
     // Initialize VRS plugin (using our VRS fork!)
     UVariableRateShadingFunctionLibrary::EnableVRS(bEnableFovRender);
@@ -82,17 +107,66 @@ void AEgoSensor::BeginPlay()
     LOG("Initialized Variable Rate Shading (VRS) plugin");
 #endif
 
+    // pick up edits to the config file while running
+    ConfigSubscription = GeneralParams.Subscribe(
+        {{"EgoSensor", ""}, {"Replayer", ""}, {"VariableRateShading", ""}, {"GazePrediction", ""}},
+        [this]() { OnConfigReloaded(); });
+
     LOG("Initialized DReyeVR EgoSensor");
 }
 
-void AEgoSensor::BeginDestroy()
+void AEgoSensor::OnConfigReloaded()
 {
-    Super::BeginDestroy();
+    const int OldWidth = FrameCapWidth;
+    const int OldHeight = FrameCapHeight;
+    ReadConfigVariables();
+    TrackConfigFile(); // fingerprints of the new config
+    InitGazePredictor();
+    if (FrameCapWidth != OldWidth || FrameCapHeight != OldHeight)
+    {
+        if (!bCreatedDirectory && CaptureRenderTarget != nullptr)
+        {
+            CaptureRenderTarget->InitCustomFormat(FrameCapWidth, FrameCapHeight, PF_B8G8R8A8,
+                                                  bFrameCapForceLinearGamma);
+        }
+        else
+        {
+            LOG_WARN("Frame capture already started, the new frame size (%dx%d) applies to the next replay",
+                     FrameCapWidth, FrameCapHeight);
+        }
+    }
+#if USE_FOVEATED_RENDER
+    UVariableRateShadingFunctionLibrary::EnableVRS(bEnableFovRender);
+    UVariableRateShadingFunctionLibrary::EnableEyeTracking(bUseEyeTrackingVRS);
+#endif
+}
 
-    if (RecordingCF != nullptr)
+void AEgoSensor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    GeneralParams.Unsubscribe(ConfigSubscription);
+    ConfigSubscription = -1;
+    if (bPredictGaze && GazePred.NumSamples() > 0)
     {
-        delete RecordingCF;
+        const std::string Summary = GazePred.SummaryString();
+        LOG("%s", UTF8_TO_TCHAR(Summary.c_str()));
     }
+    if (FrameWriter.IsValid())
+    {
+        // make sure every captured frame makes it to disk before the replay is torn down
+        PollFrameReadbacks(true);
+        FrameWriter->Flush();
+        LogFrameWriterStats();
+        FrameSink->SetBudget(nullptr);
+        FrameWriter.Reset();
+        FrameReadbacks.Reset();
+        FrameSink.Reset(); // closes the streams and their indices
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
+void AEgoSensor::BeginDestroy()
+{
+    Super::BeginDestroy();
 
     DestroyEyeTracker();
 
@@ -105,9 +179,10 @@ void AEgoSensor::ManualTick(float DeltaSeconds)
     {
         const float Timestamp = int64_t(1000.f * UGameplayStatics::GetRealTimeSeconds(World));
         /// TODO: query the eye tracker hardware asynchronously (not limited to UE4 tick)
-        TickEyeTracker();   // query the eye-tracker hardware for current data
-        ComputeFocusInfo(); // compute gaze focus data
-        ComputeEgoVars();   // get all necessary ego-vehicle data
+        TickEyeTracker();    // query the eye-tracker hardware for current data
+        TickGazePredictor(); // extrapolate the new gaze sample to the display time
+        ComputeFocusInfo();  // compute gaze focus data
+        ComputeEgoVars();    // get all necessary ego-vehicle data
 
         // Update the internal sensor data that gets handed off to Carla (for recording/replaying/PythonAPI)
         const auto &Inputs = Vehicle.IsValid() ? Vehicle.Get()->GetVehicleInputs() : DReyeVR::UserInputs{};
@@ -119,6 +194,7 @@ void AEgoSensor::ManualTick(float DeltaSeconds)
         );
         TickFoveatedRender();
     }
+    PollFrameReadbacks(); // hand finished frame capture readbacks to the writer threads
     TickCount++;
 }
 
@@ -244,6 +320,56 @@ void AEgoSensor::TickEyeTracker()
     // FPlatformProcess::Sleep(0.00833f); // use in async thread to get 120hz
 }
 
+void AEgoSensor::InitGazePredictor()
+{
+    GazePred.SetParams(GazePredParams);
+    PredictedGazeDir = EyeSensorData.Combined.GazeDir;
+    if (bPredictGaze)
+        LOG("Predicting the gaze %.1f ms ahead (saccades above %.0f deg/s)", GazePredParams.LatencyMs,
+            GazePredParams.SaccadeDegPerSec);
+}
+
+void AEgoSensor::TickGazePredictor()
+{
+    const auto &Combined = EyeSensorData.Combined;
+    if (!bPredictGaze)
+    {
+        PredictedGazeDir = Combined.GazeDir;
+        return;
+    }
+    const FVector &Raw = Combined.GazeDir;
+    const GazeDirection &Predicted = GazePred.Update(
+        {static_cast<double>(EyeSensorData.TimestampDevice), {Raw.X, Raw.Y, Raw.Z}, Combined.GazeValid});
+    // an invalid sample keeps its (meaningless) direction, same as everything else reading the raw gaze
+    PredictedGazeDir = Combined.GazeValid ? FVector(Predicted.X, Predicted.Y, Predicted.Z) : Raw;
+}
+
+bool AEgoSensor::IsPredictingGaze() const
+{
+    return bPredictGaze && !ADReyeVRSensor::bIsReplaying; // the recordings hold the sampled gaze only
+}
+
+const FVector &AEgoSensor::GetRawGazeDir() const
+{
+    return GetData()->GetGazeDir();
+}
+
+const FVector &AEgoSensor::GetPredictedGazeDir() const
+{
+    return IsPredictingGaze() ? PredictedGazeDir : GetRawGazeDir();
+}
+
+FVector AEgoSensor::GetPredictedFocusPoint() const
+{
+    const DReyeVR::AggregateData *Data = GetData();
+    if (!IsPredictingGaze())
+        return Data->GetFocusActorPoint();
+    const FRotator &WorldRot = Data->GetCameraRotationAbs();
+    const FVector GazeOrigin = Data->GetCameraLocationAbs() + WorldRot.RotateVector(Data->GetGazeOrigin());
+    const float Depth = FVector::Dist(GazeOrigin, Data->GetFocusActorPoint());
+    return GazeOrigin + Depth * WorldRot.RotateVector(PredictedGazeDir).GetSafeNormal();
+}
+
 void AEgoSensor::ComputeDummyEyeData()
 {
     // Function to make "dummy" eye data where the eye gaze just looks around in a CCW circle.
@@ -380,18 +506,29 @@ void AEgoSensor::SetEgoVehicle(class AEgoVehicle *NewEgoVehicle)
     Vehicle = NewEgoVehicle;
     check(Vehicle.IsValid());
 
+    TrackConfigFile();
+
+    // saved from some previous request to compare, but failed bc no EgoVehicle
+    if (bPendingConfigComparison)
+    {
+        UpdateData(PendingRecordedConfig, 0.f);
+    }
+}
+
+void AEgoSensor::TrackConfigFile()
+{
     // Also check that the ConfigFileData variable can be written to with Vehicle params
     check(ConfigFile); // this is a static variable created in the parent (ADReyeVRSensor)
+    if (!Vehicle.IsValid())
+        return;
 
     // track both the VehicleParams and GeneralParams
+    struct ConfigFile LiveConfig;
+    LiveConfig.Insert(Vehicle.Get()->GetVehicleParams());
+    LiveConfig.Insert(GeneralParams);
+    LiveFingerprints = LiveConfig.Fingerprints(); // hashed once here, not on every comparison
     const auto ConfigFileStr = Vehicle.Get()->GetVehicleParams().Export() + GeneralParams.Export();
-    ConfigFile->Set(ConfigFileStr); // track this config file once
-
-    // saved from some previous request to compare, but failed bc no EgoVehicle
-    if (RecordingCF != nullptr)
-    {
-        UpdateData(*RecordingCF, 0.f);
-    }
+    ConfigFile->Set(ConfigFileStr, LiveFingerprints); // track this config file once
 }
 
 void AEgoSensor::ComputeEgoVars()
@@ -418,6 +555,43 @@ void AEgoSensor::ComputeEgoVars()
 /// ---------------:FRAMECAP:----------------- ///
 /// ========================================== ///
 
+// GPU readbacks of the frame capture that have been enqueued but not collected yet
+struct FFrameReadbackQueue
+{
+    struct FPending
+    {
+        TUniquePtr<FRHIGPUTextureReadback> Readback;
+        FramePixelBuffer Buffer; // everything but the pixels until the readback is collected
+        uint64 SubmitFrame;      // GFrameCounter when the copy was enqueued
+    };
+    std::deque<FPending> Pending; // only touched on the render thread
+    std::atomic<int32> Num{0};    // Pending.size(), readable from the game thread
+};
+
+static bool EncodeFrameBuffer(IImageWrapperModule &ImageWrapperModule, const bool bJPG, FrameStreamSink &Sink,
+                              FramePixelBuffer &Buffer)
+{
+    // runs on a FrameWriterPool thread
+    if (!Sink.NeedsImageEncoder() || Buffer.Pixels.empty())
+        return Sink.Append(Buffer); // y4m/raw conversion, or advancing the stream past a dropped frame
+
+    // same output as SaveFrameToDisk (incl. overwriting the alpha channel)
+    for (size_t i = 3; i < Buffer.Pixels.size(); i += 4)
+        Buffer.Pixels[i] = 255;
+    const bool bUseJPG = bJPG || Sink.GetFormat() == EFrameSinkFormat::MJPEG;
+    TSharedPtr<IImageWrapper> ImageWrapper =
+        ImageWrapperModule.CreateImageWrapper(bUseJPG ? EImageFormat::JPEG : EImageFormat::PNG);
+    std::vector<uint8_t> Payload;
+    if (ImageWrapper.IsValid() && ImageWrapper->SetRaw(Buffer.Pixels.data(), Buffer.Pixels.size(), Buffer.Width,
+                                                       Buffer.Height, ERGBFormat::BGRA, 8))
+    {
+        const TArray64<uint8> &Compressed = ImageWrapper->GetCompressed((int32)EImageCompressionQuality::Default);
+        Payload.assign(Compressed.GetData(), Compressed.GetData() + Compressed.Num());
+    }
+    const bool bEncoded = !Payload.empty(); // an empty payload still advances the stream
+    return Sink.Append(Buffer, std::move(Payload)) && bEncoded;
+}
+
 void AEgoSensor::ConstructFrameCapture()
 {
     if (bCaptureFrameData)
@@ -470,6 +644,15 @@ void AEgoSensor::InitFrameCapture()
         FrameCapLocation = FPaths::ConvertRelativePathToFull(FPaths::ProjectDir() + FrameCapLocation);
         // The returned string has the following format: yyyy.mm.dd-hh.mm.ss
         FString DirName = FDateTime::Now().ToString(); // timestamp directory
+        CarlaReplayer *Replayer = UCarlaStatics::GetReplayer(GetWorld());
+        if (Replayer != nullptr && Replayer->GetFrameRange().IsSet())
+        {
+            // replaying a shard of the recording, number the frames by their position in the whole recording
+            const auto &Range = Replayer->GetFrameRange();
+            ScreenshotCount = Range.Start;
+            DirName += FString::Printf(TEXT("_frames%llu-%llu"), static_cast<unsigned long long>(Range.Start),
+                                       static_cast<unsigned long long>(Range.End));
+        }
         FrameCapLocation = FPaths::Combine(FrameCapLocation, DirName);
 
         // create directory if not present
@@ -486,7 +669,150 @@ void AEgoSensor::InitFrameCapture()
 #endif
         }
         bCreatedDirectory = true;
+
+        if (bAsyncFrameCapture)
+        {
+            // the module must be loaded on the game thread, the writer threads only create image wrappers from it
+            IImageWrapperModule *ImageWrapperModule =
+                &FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+            EFrameSinkFormat Format = EFrameSinkFormat::Files;
+            if (!ParseFrameSinkFormat(TCHAR_TO_UTF8(*FrameSinkFormat), Format))
+                LOG_WARN("Unknown FrameSink \"%s\" (Files, MJPEG, Y4M, Raw), writing individual files",
+                         *FrameSinkFormat);
+            FrameSink = MakeUnique<FrameStreamSink>(TCHAR_TO_UTF8(*FrameCapLocation), Format, FrameStreamFPS,
+                                                    ScreenshotCount);
+            FrameStreamSink *Sink = FrameSink.Get(); // outlives the writer pool (see EndPlay)
+            const bool bJPG = bFileFormatJPG;
+            FrameWriter = MakeUnique<FrameWriterPool>(
+                [ImageWrapperModule, bJPG, Sink](FramePixelBuffer &Buffer) {
+                    return EncodeFrameBuffer(*ImageWrapperModule, bJPG, *Sink, Buffer);
+                },
+                FMath::Max(FrameWriterThreads, 1), static_cast<size_t>(FMath::Max(FrameWriterMaxMB, 1)) << 20);
+            FrameSink->SetBudget(FrameWriter.Get());
+            FrameReadbacks = MakeShared<FFrameReadbackQueue, ESPMode::ThreadSafe>();
+            LOG("Using asynchronous frame capture to %s (%d writer threads, %d MB budget)",
+                UTF8_TO_TCHAR(Format == EFrameSinkFormat::Files ? "files" : FrameSinkExtension(Format)),
+                FrameWriterThreads, FrameWriterMaxMB);
+        }
+        else if (!FrameSinkFormat.Equals("Files", ESearchCase::IgnoreCase))
+        {
+            LOG_WARN("FrameSink \"%s\" requires AsyncFrameCapture, writing individual files", *FrameSinkFormat);
+        }
+    }
+}
+
+void AEgoSensor::EnqueueFrameReadback(const FString &FilePath, const FString &StreamName, const uint64 RecordingFrame,
+                                      const double RecordingTime)
+{
+    check(FrameWriter.IsValid() && FrameReadbacks.IsValid());
+    FTextureRenderTargetResource *RTResource = CaptureRenderTarget->GameThread_GetRenderTargetResource();
+    if (RTResource == nullptr)
+    {
+        LOG_ERROR("Missing render target!");
+        return;
     }
+
+    FramePixelBuffer Buffer; // pixels get filled in once the readback is collected
+    Buffer.Width = CaptureRenderTarget->GetSurfaceWidth();
+    Buffer.Height = CaptureRenderTarget->GetSurfaceHeight();
+    Buffer.FrameIdx = ScreenshotCount;
+    Buffer.Filename = TCHAR_TO_UTF8(*FilePath);
+    Buffer.Stream = TCHAR_TO_UTF8(*StreamName);
+    Buffer.RecordingFrame = RecordingFrame;
+    Buffer.RecordingTime = RecordingTime;
+
+    // bound the in-flight memory: collect whatever readbacks are outstanding before waiting on the writers
+    const size_t Bytes = 4 * static_cast<size_t>(Buffer.Width) * Buffer.Height;
+    if (!FrameWriter->TryReserve(Bytes))
+    {
+        PollFrameReadbacks(true);
+        FrameWriter->Reserve(Bytes);
+    }
+
+    // the copy is ordered after the CaptureScene render commands, so the render target can be reused right away
+    TSharedPtr<FFrameReadbackQueue, ESPMode::ThreadSafe> Queue = FrameReadbacks;
+    const uint64 SubmitFrame = GFrameCounter;
+    Queue->Num++;
+    ENQUEUE_RENDER_COMMAND(DReyeVREnqueueFrameReadback)
+    ([Queue, RTResource, SubmitFrame, Buffer = MoveTemp(Buffer)](FRHICommandListImmediate &RHICmdList) mutable {
+        FFrameReadbackQueue::FPending Pending;
+        Pending.Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("DReyeVRFrameReadback"));
+        Pending.Readback->EnqueueCopy(RHICmdList, RTResource->GetRenderTargetTexture());
+        Pending.Buffer = MoveTemp(Buffer);
+        Pending.SubmitFrame = SubmitFrame;
+        Queue->Pending.push_back(MoveTemp(Pending));
+    });
+}
+
+void AEgoSensor::PollFrameReadbacks(const bool bWaitForAll)
+{
+    if (!FrameWriter.IsValid() || !FrameReadbacks.IsValid() || (!bWaitForAll && FrameReadbacks->Num == 0))
+        return;
+
+    TSharedPtr<FFrameReadbackQueue, ESPMode::ThreadSafe> Queue = FrameReadbacks;
+    FrameWriterPool *Writer = FrameWriter.Get();
+    const uint64 CollectFrame = GFrameCounter - static_cast<uint64>(FMath::Max(FrameReadbackLatency, 0));
+    const int MaxAttempts = 2000; // ~2s of waiting for the GPU when flushing
+    for (int Attempt = 0; Attempt < MaxAttempts; Attempt++)
+    {
+        const bool bDiscard = bWaitForAll && (Attempt == MaxAttempts - 1);
+        ENQUEUE_RENDER_COMMAND(DReyeVRCollectFrameReadbacks)
+        ([Queue, Writer, CollectFrame, bWaitForAll, bDiscard](FRHICommandListImmediate &RHICmdList) {
+            // readbacks complete in submission order, so stop at the first one that is not done yet
+            while (!Queue->Pending.empty())
+            {
+                FFrameReadbackQueue::FPending &Front = Queue->Pending.front();
+                FramePixelBuffer &Buffer = Front.Buffer;
+                const size_t RowBytes = 4 * static_cast<size_t>(Buffer.Width);
+                const bool bDue = bWaitForAll || Front.SubmitFrame <= CollectFrame;
+                if (!bDue || (!bDiscard && !Front.Readback->IsReady()))
+                    break;
+                void *Data = nullptr;
+                int32 RowPitchInPixels = 0;
+                if (Front.Readback->IsReady())
+                    Front.Readback->LockTexture(RHICmdList, Data, RowPitchInPixels);
+                const uint8 *Src = static_cast<const uint8 *>(Data);
+                if (Src != nullptr)
+                {
+                    // strip the row padding of the staging texture
+                    Buffer.Pixels.resize(RowBytes * Buffer.Height);
+                    for (uint32_t y = 0; y < Buffer.Height; y++)
+                        FMemory::Memcpy(Buffer.Pixels.data() + y * RowBytes,
+                                        Src + y * 4 * static_cast<size_t>(RowPitchInPixels), RowBytes);
+                    Front.Readback->Unlock();
+                    Writer->Submit(MoveTemp(Buffer));
+                }
+                else
+                {
+                    LOG_ERROR("Dropping frame capture readback for \"%s\"", UTF8_TO_TCHAR(Buffer.Filename.c_str()));
+                    Writer->Release(RowBytes * Buffer.Height);
+                    Buffer.Pixels.clear();
+                    Writer->Submit(MoveTemp(Buffer)); // no pixels, but its stream still has to move past it
+                }
+                Queue->Pending.pop_front();
+                Queue->Num--;
+            }
+        });
+        if (!bWaitForAll)
+            break;
+        FlushRenderingCommands();
+        if (Queue->Num == 0)
+            break;
+        FPlatformProcess::Sleep(0.001f);
+    }
+}
+
+void AEgoSensor::LogFrameWriterStats() const
+{
+    if (!FrameWriter.IsValid())
+        return;
+    const FrameWriterStats Stats = FrameWriter->GetStats();
+    const float MB = 1.f / (1 << 20);
+    LOG("Frame capture: %d readbacks pending, %d queued (peak %d), %d encoding, %.1f/%.1f MB in flight (peak %.1f), "
+        "%llu written, %llu failed, %llu stalls",
+        FrameReadbacks.IsValid() ? FrameReadbacks->Num.load() : 0, int(Stats.QueueDepth), int(Stats.PeakQueueDepth),
+        int(Stats.Encoding), Stats.InFlightBytes * MB, FrameWriter->GetMaxInFlightBytes() * MB,
+        Stats.PeakInFlightBytes * MB, Stats.Written, Stats.Failed, Stats.Stalls);
 }
 
 void AEgoSensor::TakeScreenshot()
@@ -505,6 +831,14 @@ void AEgoSensor::TakeScreenshot()
     // capture the screenshot to the directory
     if (bCaptureFrameData && FrameCap && Vehicle.IsValid())
     {
+        // which recorded frame is being captured (for the capture index)
+        uint64 RecordingFrame = 0;
+        double RecordingTime = 0.0;
+        if (CarlaReplayer *Replayer = UCarlaStatics::GetReplayer(World))
+        {
+            RecordingFrame = Replayer->GetCurrentFrameId();
+            RecordingTime = Replayer->GetCurrentTime();
+        }
         for (int i = 0; i < GetNumberOfShaders(); i++)
         {
             // apply the postprocessing effect
@@ -516,16 +850,22 @@ void AEgoSensor::TakeScreenshot()
                 Vehicle.Get()->SetCameraRootPose(j);
 
                 // using 5 digits to reach frame 99999 ~ 30m (assuming ~50fps frame capture)
-                // suffix is denoted as _s(hader)X_p(ose)Y_Z.png where X is the shader idx, Y is the pose idx, Z is tick
-                const FString Suffix = FString::Printf(TEXT("_s%d_p%d_%05d.png"), i, j, ScreenshotCount);
+                // suffix is denoted as _s(hader)X_p(ose)Y_Z.jpg (.png without FileFormatJPG) where X is the shader idx,
+                // Y is the pose idx, Z is tick
+                const FString StreamName = FrameCapFilename + FString::Printf(TEXT("_s%d_p%d"), i, j);
+                const FString Suffix = FString::Printf(TEXT("_%05d.%s"), int(ScreenshotCount),
+                                                       bFileFormatJPG ? TEXT("jpg") : TEXT("png"));
                 // apply the camera view (position & orientation)
                 FMinimalViewInfo DesiredView;
                 Vehicle.Get()->GetCamera()->GetCameraView(0, DesiredView);
                 FrameCap->SetCameraView(DesiredView); // move camera to the camera view
                 // capture the scene and save the screenshot to disk
                 FrameCap->CaptureScene(); // also available: CaptureSceneDeferred()
-                SaveFrameToDisk(*CaptureRenderTarget, FPaths::Combine(FrameCapLocation, FrameCapFilename + Suffix),
-                                bFileFormatJPG);
+                const FString FilePath = FPaths::Combine(FrameCapLocation, StreamName + Suffix);
+                if (FrameWriter.IsValid()) // collected a few ticks later (see PollFrameReadbacks)
+                    EnqueueFrameReadback(FilePath, StreamName, RecordingFrame, RecordingTime);
+                else
+                    SaveFrameToDisk(*CaptureRenderTarget, FilePath, bFileFormatJPG);
                 if (!bRecordAllPoses)
                 {
                     // exit after the first camera pose (seated)
@@ -541,6 +881,8 @@ void AEgoSensor::TakeScreenshot()
             }
         }
         ScreenshotCount++; // progress to next frame
+        if (FrameWriter.IsValid() && ScreenshotCount % 100 == 0)
+            LogFrameWriterStats(); // report the queue depth every so often
     }
 }
 
@@ -559,14 +901,17 @@ void AEgoSensor::ConvertToEyeTrackerSpace(FVector &inVec) const
 void AEgoSensor::TickFoveatedRender()
 {
 #if USE_FOVEATED_RENDER
+    // both eyes turn with the predicted combined gaze
+    const FQuat Ahead =
+        FQuat::FindBetweenNormals(GetRawGazeDir().GetSafeNormal(), GetPredictedGazeDir().GetSafeNormal());
     FEyeTrackerStereoGazeData F;
     F.LeftEyeOrigin = GetData()->GetGazeOrigin(DReyeVR::Gaze::LEFT);
-    F.LeftEyeDirection = GetData()->GetGazeDir(DReyeVR::Gaze::LEFT);
+    F.LeftEyeDirection = Ahead.RotateVector(GetData()->GetGazeDir(DReyeVR::Gaze::LEFT));
     ConvertToEyeTrackerSpace(F.LeftEyeDirection);
     F.RightEyeOrigin = GetData()->GetGazeOrigin(DReyeVR::Gaze::RIGHT);
-    F.RightEyeDirection = GetData()->GetGazeDir(DReyeVR::Gaze::RIGHT);
+    F.RightEyeDirection = Ahead.RotateVector(GetData()->GetGazeDir(DReyeVR::Gaze::RIGHT));
     ConvertToEyeTrackerSpace(F.RightEyeDirection);
-    F.FixationPoint = GetData()->GetFocusActorPoint();
+    F.FixationPoint = GetPredictedFocusPoint();
     F.ConfidenceValue = 0.99f;
     UVariableRateShadingFunctionLibrary::UpdateStereoGazeDataToFoveatedRendering(F);
 #endif
@@ -583,11 +928,28 @@ void AEgoSensor::UpdateData(const DReyeVR::ConfigFileData &RecordedParams, const
     if (!Vehicle.IsValid())
     {
         // LOG_WARN("Unable to compare ConfigFile bc EgoVehicle is invalid!");
-        RecordingCF = new DReyeVR::ConfigFileData();
-        (*RecordingCF) = RecordedParams; // save these params for later (ex. SetEgoVehicle)
+        PendingRecordedConfig = RecordedParams; // save these params for later (ex. SetEgoVehicle)
+        bPendingConfigComparison = true;
+        return;
+    }
+    bPendingConfigComparison = false;
+
+    // every live section must match its recorded fingerprint (the recording can have sections that we dont)
+    const auto &RecordedFingerprints = RecordedParams.GetFingerprints();
+    bool bFingerprintsMatch = !RecordedFingerprints.empty(); // empty for older recordings
+    for (const auto &Live : LiveFingerprints)
+    {
+        const auto It = std::lower_bound(RecordedFingerprints.begin(), RecordedFingerprints.end(), Live,
+                                         [](const auto &A, const auto &B) { return A.first < B.first; });
+        bFingerprintsMatch &= (It != RecordedFingerprints.end() && *It == Live);
+    }
+    if (bFingerprintsMatch)
+    {
+        LOG("Config file comparison successful!");
         return;
     }
-    // compare the incoming (recording) ConfigFile with our current (live) one
+
+    // fall back to the per-key diff to report what differs
     const std::string RecordingExport = TCHAR_TO_UTF8(*RecordedParams.ToString());
     const struct ConfigFile Recorded = ConfigFile::Import(RecordingExport);
 
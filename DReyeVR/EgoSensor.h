@@ -3,6 +3,9 @@
 #include "Carla/Sensor/DReyeVRData.h"           // DReyeVR namespace
 #include "Carla/Sensor/DReyeVRSensor.h"         // ADReyeVRSensor
 #include "Components/SceneCaptureComponent2D.h" // USceneCaptureComponent2D
+#include "FrameStreamSink.h"                    // FrameStreamSink
+#include "FrameWriterPool.h"                    // FrameWriterPool
+#include "GazePredictor.h"                      // GazePredictor
 #include <chrono>                               // timing threads
 #include <cstdint>
 
@@ -45,8 +48,15 @@ class CARLAUE4_API AEgoSensor : public ADReyeVRSensor
     void TakeScreenshot() override;
     bool ComputeGazeTrace(FHitResult &Hit, const ECollisionChannel TraceChannel, float TraceRadius = 0.f) const;
 
+    // combined gaze (camera space) as sampled, and extrapolated to when it is displayed (see GazePredictor.h),
+    // the predicted ones are the sampled ones when the prediction is off or while replaying
+    const FVector &GetRawGazeDir() const;
+    const FVector &GetPredictedGazeDir() const;
+    FVector GetPredictedFocusPoint() const; // world space, along the predicted gaze at the depth of the focus hit
+
   protected:
     void BeginPlay();
+    void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     void BeginDestroy();
 
     class UWorld *World; // to get info about the world: time, frames, etc.
@@ -54,6 +64,8 @@ class CARLAUE4_API AEgoSensor : public ADReyeVRSensor
   private:
     int64_t TickCount = 0; // how many ticks have been executed
     void ReadConfigVariables();
+    void OnConfigReloaded();     // hot reload of the general config
+    int ConfigSubscription = -1; // GeneralParams.Subscribe
 
   private: // eye tracker
     void InitEyeTracker();
@@ -75,11 +87,23 @@ class CARLAUE4_API AEgoSensor : public ADReyeVRSensor
     struct DReyeVR::FocusInfo FocusInfoData;                            // data from the focus computed from eye gaze
     std::chrono::time_point<std::chrono::system_clock> ChronoStartTime; // std::chrono time at BeginPlay
 
+  private: // gaze prediction
+    void InitGazePredictor();
+    void TickGazePredictor();
+    bool IsPredictingGaze() const;
+    bool bPredictGaze = true;
+    GazePredictorParams GazePredParams;
+    GazePredictor GazePred;
+    FVector PredictedGazeDir = FVector::ForwardVector;
+
   private: // ego=vehicle variables
     void ComputeEgoVars();
     TWeakObjectPtr<class AEgoVehicle> Vehicle; // the DReyeVR EgoVehicle
     struct DReyeVR::EgoVariables EgoVars;      // data from vehicle that is getting tracked
-    DReyeVR::ConfigFileData *RecordingCF = nullptr;
+    void TrackConfigFile(); // what gets recorded (and compared against when replaying)
+    DReyeVR::ConfigFileData::SectionFingerprints LiveFingerprints;
+    DReyeVR::ConfigFileData PendingRecordedConfig; // received before the EgoVehicle was set
+    bool bPendingConfigComparison = false;
 
   private: // frame capture
     size_t ScreenshotCount = 0;
@@ -97,6 +121,20 @@ class CARLAUE4_API AEgoSensor : public ADReyeVRSensor
     bool bCreatedDirectory = false;
     bool bFileFormatJPG = true;
     bool bFrameCapForceLinearGamma = true;
+    // asynchronous frame capture: GPU readbacks are collected a few frames later and encoded on worker threads
+    void EnqueueFrameReadback(const FString &FilePath, const FString &StreamName, const uint64 RecordingFrame,
+                              const double RecordingTime);
+    void PollFrameReadbacks(const bool bWaitForAll = false);
+    void LogFrameWriterStats() const;
+    TSharedPtr<struct FFrameReadbackQueue, ESPMode::ThreadSafe> FrameReadbacks; // shared with the render thread
+    TUniquePtr<FrameWriterPool> FrameWriter;
+    TUniquePtr<FrameStreamSink> FrameSink; // individual files or one container per shader/pose stream
+    FString FrameSinkFormat = "Files";
+    int FrameStreamFPS = 30; // nominal frame rate written to the y4m header
+    bool bAsyncFrameCapture = true;
+    int FrameWriterThreads = 4;
+    int FrameWriterMaxMB = 512; // bound on all in-flight pixel buffers (pending readbacks + encode queue)
+    int FrameReadbackLatency = 2; // frames to wait before collecting a readback
 
   private: // foveated rendering
     void TickFoveatedRender();
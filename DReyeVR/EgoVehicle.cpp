@@ -1,16 +1,25 @@
 #include "EgoVehicle.h"
 #include "Carla/Actor/ActorAttribute.h"             // FActorAttribute
 #include "Carla/Actor/ActorRegistry.h"              // Register
-#include "Carla/Game/CarlaStatics.h"                // GetCurrentEpisode
+#include "Carla/Game/CarlaGameModeBase.h"           // GetCarlaSettingsDelegate
+#include "Carla/Game/CarlaStatics.h"                // GetCurrentEpisode, GetRecorder
+#include "Carla/Recorder/CarlaRecorder.h"           // ACarlaRecorder
 #include "Carla/Vehicle/CarlaWheeledVehicleState.h" // ECarlaWheeledVehicleState
+#include "Components/SkinnedMeshComponent.h"        // USkinnedMeshComponent
+#include "Components/StaticMeshComponent.h"         // UStaticMeshComponent
 #include "DReyeVRPawn.h"                            // ADReyeVRPawn
 #include "DrawDebugHelpers.h"                       // Debug Line/Sphere
 #include "Engine/EngineTypes.h"                     // EBlendMode
 #include "Engine/World.h"                           // GetWorld
+#include "EngineUtils.h"                            // TActorIterator
+#include "FrameBudgetProfiler.h"                    // DREYEVR_PROFILE_STAGE
 #include "GameFramework/Actor.h"                    // Destroy
+#include "GameFramework/Character.h"                // ACharacter
 #include "Kismet/KismetSystemLibrary.h"             // PrintString, QuitGame
 #include "Math/Rotator.h"                           // RotateVector, Clamp
 #include "Math/UnrealMathUtility.h"                 // Clamp
+#include "RHI.h"                                    // RHIGetGPUFrameCycles
+#include "RenderCore.h"                             // GGameThreadTime
 
 #include <algorithm>
 
@@ -81,6 +90,10 @@ void AEgoVehicle::ReadConfigVariables()
     InitMirrorParams("Right", RightMirrorParams);
     // rear mirror chassis
     VehicleParams.Get("Mirrors", "RearMirrorChassisTransform", RearMirrorChassisTransform);
+    GeneralParams.Get("MirrorScheduler", "Enabled", bGazeScheduledMirrors);
+    GeneralParams.Get("MirrorScheduler", "AttendAngleDeg", MirrorSchedParams.AttendAngleDeg);
+    GeneralParams.Get("MirrorScheduler", "HoldSeconds", MirrorSchedParams.HoldSeconds);
+    GeneralParams.Get("MirrorScheduler", "PeripheralScale", MirrorSchedParams.PeripheralScale);
     // steering wheel
     VehicleParams.Get("SteeringWheel", "MaxSteerAngleDeg", MaxSteerAngleDeg);
     VehicleParams.Get("SteeringWheel", "SteeringScale", SteeringAnimScale);
@@ -92,6 +105,47 @@ void AEgoVehicle::ReadConfigVariables()
     GeneralParams.Get("VehicleInputs", "ScaleBrakeInput", ScaleBrakeInput);
     // replay
     GeneralParams.Get("Replayer", "CameraFollowHMD", bCameraFollowHMD);
+    // profiling
+    GeneralParams.Get("Profiler", "Enabled", bProfileFrameBudget);
+    GeneralParams.Get("Profiler", "NumFrames", ProfilerNumFrames);
+    GeneralParams.Get("Profiler", "BudgetMs", FrameBudgetMs);
+    // adaptive quality
+    GeneralParams.Get("CameraParams", "ScreenPercentage", CameraScreenPercentage);
+    GeneralParams.Get("QualityGovernor", "Enabled", bQualityGovernor);
+    GeneralParams.Get("QualityGovernor", "TargetMs", GovernorParams.TargetMs);
+    GeneralParams.Get("QualityGovernor", "WindowFrames", GovernorParams.WindowFrames);
+    GeneralParams.Get("QualityGovernor", "Percentile", GovernorParams.Percentile);
+    GeneralParams.Get("QualityGovernor", "UpgradeBelow", GovernorParams.UpgradeBelow);
+    GeneralParams.Get("QualityGovernor", "UpgradeWindows", GovernorParams.UpgradeWindows);
+    GeneralParams.Get("QualityGovernor", "CooldownWindows", GovernorParams.CooldownWindows);
+    // haptic shared control
+    GeneralParams.Get("HapticSharedControl", "Enabled", bHapticControl);
+    GeneralParams.Get("HapticSharedControl", "Cs", HapticParams.Cs);
+    GeneralParams.Get("HapticSharedControl", "Kc", HapticParams.Kc);
+    GeneralParams.Get("HapticSharedControl", "T", HapticParams.T);
+    GeneralParams.Get("HapticSharedControl", "FirstOrderModel", HapticParams.bFirstOrderModel);
+    GeneralParams.Get("HapticSharedControl", "PreviewDistance", HapticParams.PreviewDistance);
+    GeneralParams.Get("HapticSharedControl", "Wheelbase", HapticParams.Wheelbase);
+    GeneralParams.Get("HapticSharedControl", "CenterOfMassRatio", HapticParams.CenterOfMassRatio);
+    GeneralParams.Get("HapticSharedControl", "WheelRangeDeg", HapticWheelRangeDeg);
+    GeneralParams.Get("HapticSharedControl", "TrajectoryFile", HapticTrajectoryFile);
+    // non-ego engine sounds
+    GeneralParams.Get("VehicleAudio", "MaxVoices", VehicleAudioParams.MaxVoices);
+    GeneralParams.Get("VehicleAudio", "MaxDistance", VehicleAudioParams.MaxDistance);
+    GeneralParams.Get("VehicleAudio", "UpdateRateHz", VehicleAudioParams.UpdateRateHz);
+    GeneralParams.Get("VehicleAudio", "Hysteresis", VehicleAudioParams.Hysteresis);
+    // gaze-contingent level of detail
+    GeneralParams.Get("GazeLOD", "Enabled", bGazeLOD);
+    GeneralParams.Get("GazeLOD", "FovealDeg", GazeLODConfig.FovealDeg);
+    GeneralParams.Get("GazeLOD", "NearPeripheryDeg", GazeLODConfig.NearPeripheryDeg);
+    GeneralParams.Get("GazeLOD", "MaxDistance", GazeLODConfig.MaxDistance);
+    GeneralParams.Get("GazeLOD", "UpdateRateHz", GazeLODConfig.UpdateRateHz);
+    GeneralParams.Get("GazeLOD", "HysteresisDeg", GazeLODConfig.HysteresisDeg);
+    GeneralParams.Get("GazeLOD", "HysteresisDistance", GazeLODConfig.HysteresisDistance);
+    GeneralParams.Get("GazeLOD", "NearPeripheryMinLOD", GazeLODConfig.NearPeripheryMinLOD);
+    GeneralParams.Get("GazeLOD", "FarPeripheryMinLOD", GazeLODConfig.FarPeripheryMinLOD);
+    GeneralParams.Get("GazeLOD", "NearPeripheryCullScale", GazeLODConfig.NearPeripheryCullScale);
+    GeneralParams.Get("GazeLOD", "FarPeripheryCullScale", GazeLODConfig.FarPeripheryCullScale);
 }
 
 void AEgoVehicle::BeginPlay()
@@ -114,11 +168,81 @@ void AEgoVehicle::BeginPlay()
 
     BeginThirdPersonCameraInit();
 
+    SpeedometerWidget.Bind(Speedometer);
+    TurnSignalsWidget.Bind(TurnSignals);
+    GearShifterWidget.Bind(GearShifter);
+
+    FrameBudgetProfiler::Get().Resize(ProfilerNumFrames);
+    FrameBudgetProfiler::Get().SetEnabled(bProfileFrameBudget);
+
+    InitMirrorScheduler();
+
+    InitQualityGovernor();
+
+    InitHapticControl();
+
+    InitVehicleAudio();
+
+    InitGazeLOD();
+
+    // pick up edits to the config file while running
+    ConfigSubscription = GeneralParams.Subscribe(
+        {{"EgoVehicle", ""},
+         {"VehicleInputs", ""},
+         {"Replayer", "CameraFollowHMD"},
+         {"HapticSharedControl", ""},
+         {"VehicleAudio", ""},
+         {"GazeLOD", ""},
+         {"MirrorScheduler", ""},
+         {"QualityGovernor", ""}},
+        [this]() {
+            ReadConfigVariables();
+            InitMirrorScheduler();
+            UpdateMirrorResolution();
+            InitQualityGovernor();
+            InitHapticControl();
+            InitVehicleAudio();
+            InitGazeLOD();
+        });
+
     LOG("Initialized DReyeVR EgoVehicle");
 }
 
 void AEgoVehicle::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+    GeneralParams.Unsubscribe(ConfigSubscription);
+    ConfigSubscription = -1;
+
+    // the engine sound switch is global to all vehicles, leave it on for whatever comes next
+    ACarlaWheeledVehicle::bEngineSounds = true;
+
+    if (MirrorSched.IsValid())
+    {
+        const std::string Summary = MirrorSched->SummaryString();
+        LOG("%s", UTF8_TO_TCHAR(Summary.c_str()));
+    }
+
+    const std::string AudioSummary = VehicleAudio.SummaryString();
+    LOG("%s", UTF8_TO_TCHAR(AudioSummary.c_str()));
+    for (UAudioComponent *Voice : VehicleAudioPool)
+        if (Voice != nullptr)
+            Voice->DestroyComponent(); // might be attached to another vehicle
+    VehicleAudioPool.Empty();
+    VehicleAudioTargets.Empty();
+
+    if (bGazeLOD)
+    {
+        const std::string Summary = GazeLODPolicy.SummaryString();
+        LOG("%s", UTF8_TO_TCHAR(Summary.c_str()));
+    }
+    ReleaseGazeLOD();
+
+    if (bProfileFrameBudget && FrameBudgetProfiler::Get().NumFrames() > 0)
+    {
+        const std::string Summary = FrameBudgetProfiler::Get().SummaryString(FrameBudgetMs);
+        LOG("%s", UTF8_TO_TCHAR(Summary.c_str()));
+    }
+
     // https://docs.unrealengine.com/4.27/en-US/API/Runtime/Engine/Engine/EEndPlayReason__Type/
     if (EndPlayReason == EEndPlayReason::Destroyed)
     {
@@ -153,29 +277,224 @@ void AEgoVehicle::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
 
+    // every stage below (and the DReyeVRPawn's) is timed into this frame
+    FrameBudgetProfiler::Get().BeginFrame(GFrameCounter, DeltaSeconds * 1000.0);
+
     // Get the current data from the AEgoSensor and use it
-    UpdateSensor(DeltaSeconds);
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_UpdateSensor);
+        UpdateSensor(DeltaSeconds);
+    }
+
+    // Render the mirrors the driver is not looking at with fewer pixels
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickMirrors);
+        TickMirrors(DeltaSeconds);
+    }
+
+    // Assistive steering torque towards the reference trajectory
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickHapticControl);
+        TickHapticControl();
+    }
+
+    // Engine sounds of the closest/loudest non-ego vehicles
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickVehicleAudio);
+        TickVehicleAudio(DeltaSeconds);
+    }
+
+    // Coarser meshes and shorter cull distances away from where the driver looks
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickGazeLOD);
+        TickGazeLOD(DeltaSeconds);
+    }
 
     // Update the positions based off replay data
-    ReplayTick();
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_ReplayTick);
+        ReplayTick();
+    }
 
     // Draw debug lines on editor
-    DebugLines();
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_DebugLines);
+        DebugLines();
+    }
 
     // Render EgoVehicle dashboard
-    UpdateDash();
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_UpdateDash);
+        UpdateDash();
+    }
 
     // Update the steering wheel to be responsive to user input
-    TickSteeringWheel(DeltaSeconds);
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickSteeringWheel);
+        TickSteeringWheel(DeltaSeconds);
+    }
 
     // Ensure appropriate autopilot functionality is accessible from EgoVehicle
-    TickAutopilot();
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickAutopilot);
+        TickAutopilot();
+    }
 
     // Update the world level
-    TickGame(DeltaSeconds);
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickGame);
+        TickGame(DeltaSeconds);
+    }
 
     // Tick vehicle controls
-    TickVehicleInputs();
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickVehicleInputs);
+        TickVehicleInputs();
+    }
+
+    // Trade rendering quality for frame time when over budget
+    {
+        DREYEVR_PROFILE_STAGE(EgoVehicle_TickQualityGovernor);
+        TickQualityGovernor();
+    }
+}
+
+/// ========================================== ///
+/// -----------:HAPTICSHAREDCONTROL:---------- ///
+/// ========================================== ///
+
+void AEgoVehicle::InitHapticControl()
+{
+    Haptic.SetParams(HapticParams);
+    if (HapticTrajectoryFile.Equals(LoadedTrajectoryFile))
+        return;
+    LoadedTrajectoryFile = HapticTrajectoryFile;
+    std::vector<double> Xs, Ys;
+    if (!HapticTrajectoryFile.IsEmpty())
+    {
+        FString Path = HapticTrajectoryFile;
+        if (FPaths::IsRelative(Path))
+            Path = FPaths::Combine(CarlaUE4Path, Path);
+        if (HapticSharedControl::LoadTrajectory(TCHAR_TO_UTF8(*Path), Xs, Ys))
+            LOG("Loaded %d trajectory points for haptic shared control from \"%s\"", int(Xs.size()), *Path);
+        else
+            LOG_ERROR("Unable to load the haptic shared control trajectory \"%s\"", *Path);
+    }
+    Haptic.SetTrajectory(Xs, Ys);
+}
+
+void AEgoVehicle::TickHapticControl()
+{
+    if (!EgoSensor.IsValid())
+        return;
+    DReyeVR::HapticControl Result;
+    // nothing to assist with during replays (the recorded inputs are played back)
+    if (bHapticControl && Haptic.NumTrajectoryPoints() > 0 && !EgoSensor.Get()->IsReplaying())
+    {
+        HapticControlInput In;
+        const FVector Location = GetActorLocation() / 100.f; // cm -> m
+        In.X = Location.X;
+        In.Y = Location.Y;
+        In.YawDeg = GetActorRotation().Yaw;
+        In.SteerFLDeg = GetWheelSteerAngle(EVehicleWheelLocation::FL_Wheel);
+        In.SteerFRDeg = GetWheelSteerAngle(EVehicleWheelLocation::FR_Wheel);
+        In.SteeringWheelDeg = GetVehicleControl().Steer * HapticWheelRangeDeg / 2.f;
+        In.Speed = GetVehicleForwardSpeed() / 100.f; // cm/s -> m/s (negative when reversing)
+        const HapticControlOutput Out = Haptic.Compute(In);
+
+        Result.bActive = true;
+        Result.Torque = Out.Torque;
+        Result.Coefficient = Out.Coefficient;
+        Result.DesiredSteeringAngle = Out.DesiredSteeringWheelDeg;
+        Result.Error = Out.Error;
+        Result.PredictedError = Out.PredictedError;
+        Result.PredictedLocation = FVector(Out.PredictedX, Out.PredictedY, Location.Z);
+    }
+    EgoSensor.Get()->GetData()->UpdateHaptic(Result);
+}
+
+/// ========================================== ///
+/// -------------:QUALITYGOVERNOR:------------ ///
+/// ========================================== ///
+
+void AEgoVehicle::InitQualityGovernor()
+{
+    // back to full quality before starting over (or stopping)
+    if (Governor.IsValid() && Governor->GetLevel() != 0)
+        ApplyQualityLevel(QualityLevel());
+    Governor = nullptr;
+    if (bQualityGovernor)
+    {
+        Governor = MakeUnique<QualityGovernor>(GovernorParams);
+        LOG("Quality governor targeting %.2f ms with %d levels", GovernorParams.TargetMs, Governor->NumLevels());
+    }
+}
+
+void AEgoVehicle::TickQualityGovernor()
+{
+    // replays should render what was recorded, so the quality is left alone then
+    if (!Governor.IsValid() || (EgoSensor.IsValid() && EgoSensor.Get()->IsReplaying()))
+        return;
+
+    // these are the previous frame's times (the current one is still in flight)
+    const float GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+    const float GPUMs = FPlatformTime::ToMilliseconds(RHIGetGPUFrameCycles());
+    const int PrevLevel = Governor->GetLevel();
+    if (!Governor->Update(GameThreadMs, GPUMs))
+        return;
+
+    const QualityLevel &Level = Governor->GetSettings();
+    ApplyQualityLevel(Level);
+    LOG("Quality level %d -> %d (\"%s\") at %.2f ms", PrevLevel, Governor->GetLevel(), UTF8_TO_TCHAR(Level.Name.c_str()),
+        Governor->GetLastWindowMs());
+
+    // record every change so the analysis knows which frames were rendered at reduced quality
+    ACarlaRecorder *Recorder = UCarlaStatics::GetRecorder(World);
+    if (Recorder != nullptr && Recorder->IsEnabled())
+    {
+        DReyeVR::QualityChangeData Change;
+        Change.Level = Governor->GetLevel();
+        Change.PrevLevel = PrevLevel;
+        Change.FrameMs = Governor->GetLastWindowMs();
+        Change.LevelName = FString(UTF8_TO_TCHAR(Level.Name.c_str()));
+        Recorder->AddDReyeVRQualityChange(Change);
+    }
+}
+
+void AEgoVehicle::ApplyQualityLevel(const QualityLevel &Level)
+{
+    auto ApplyMirror = [](const struct MirrorParams &Params, class UPlanarReflectionComponent *Reflection,
+                          bool bReflect) {
+        if (Reflection != nullptr)
+            Reflection->SetVisibility(Params.Enabled && bReflect);
+    };
+    ApplyMirror(RearMirrorParams, RearReflection, Level.bRearMirrorReflection);
+    ApplyMirror(LeftMirrorParams, LeftReflection, Level.bSideMirrorReflections);
+    ApplyMirror(RightMirrorParams, RightReflection, Level.bSideMirrorReflections);
+    MirrorQualityScale = Level.MirrorScreenPercentageScale;
+    UpdateMirrorResolution();
+
+    // NOTE: switching the camera shader rebuilds the post-process settings from the config (full resolution)
+    if (Pawn != nullptr && Pawn->GetCamera() != nullptr)
+    {
+        FPostProcessSettings &PP = Pawn->GetCamera()->PostProcessSettings;
+        PP.bOverride_ScreenPercentage = true;
+        PP.ScreenPercentage = CameraScreenPercentage * Level.CameraScreenPercentageScale;
+    }
+
+    // per category draw distances, applied over the next frames by the settings delegate; the buildings are left
+    // alone since they would pop in and out of the skyline
+    ACarlaGameModeBase *GameMode = UCarlaStatics::GetGameMode(World);
+    UCarlaSettingsDelegate *Settings = (GameMode != nullptr) ? GameMode->GetCarlaSettingsDelegate() : nullptr;
+    if (Settings != nullptr)
+    {
+        TArray<float> Distances;
+        Distances.Init(Level.DrawDistance * 100.f, static_cast<int32>(ECullCategory::Count)); // m to cm
+        Distances[static_cast<int32>(ECullCategory::Building)] = 0.f;
+        Settings->SetCategoryDrawDistances(World, Distances);
+    }
+
+    ACarlaWheeledVehicle::bEngineSounds = Level.bNonEgoSounds;
 }
 
 /// ========================================== ///
@@ -564,6 +883,72 @@ void AEgoVehicle::ConstructMirrors()
     }
 }
 
+void AEgoVehicle::InitMirrorScheduler()
+{
+    if (MirrorSched.IsValid())
+    {
+        const std::string Summary = MirrorSched->SummaryString();
+        LOG("%s", UTF8_TO_TCHAR(Summary.c_str()));
+    }
+    MirrorSched = nullptr;
+    RearMirrorIdx = LeftMirrorIdx = RightMirrorIdx = -1;
+    if (!bGazeScheduledMirrors)
+        return;
+    MirrorSched = MakeUnique<MirrorScheduler>(MirrorSchedParams);
+    // only the enabled mirrors are scheduled (and counted)
+    if (RearMirrorParams.Enabled)
+        RearMirrorIdx = MirrorSched->AddMirror(TCHAR_TO_UTF8(*RearMirrorParams.Name));
+    if (LeftMirrorParams.Enabled)
+        LeftMirrorIdx = MirrorSched->AddMirror(TCHAR_TO_UTF8(*LeftMirrorParams.Name));
+    if (RightMirrorParams.Enabled)
+        RightMirrorIdx = MirrorSched->AddMirror(TCHAR_TO_UTF8(*RightMirrorParams.Name));
+}
+
+void AEgoVehicle::TickMirrors(float DeltaSeconds)
+{
+    if (!MirrorSched.IsValid() || MirrorSched->NumMirrors() == 0 || !EgoSensor.IsValid())
+        return;
+
+    const DReyeVR::AggregateData *Data = EgoSensor.Get()->GetData();
+    const FRotator &WorldRot = Data->GetCameraRotationAbs();
+    const FVector &EyePos = Data->GetCameraLocationAbs();
+    // fall back to the head direction without a valid gaze (ex. no eye tracker)
+    const FVector Gaze =
+        (Data->GetGazeValidity() ? WorldRot.RotateVector(Data->GetGazeDir()) : WorldRot.Vector()).GetSafeNormal();
+
+    // angles in the same order the mirrors were added in InitMirrorScheduler
+    std::vector<float> Angles;
+    auto AddAngle = [&](int Idx, const class UStaticMeshComponent *MirrorSM,
+                        const class UPlanarReflectionComponent *Reflection) {
+        if (Idx < 0)
+            return;
+        MirrorSched->SetRendered(Idx, Reflection != nullptr && Reflection->IsVisible());
+        const FVector ToMirror = (MirrorSM->GetComponentLocation() - EyePos).GetSafeNormal();
+        const float CosAngle = FMath::Clamp(FVector::DotProduct(Gaze, ToMirror), -1.f, 1.f);
+        Angles.push_back(FMath::RadiansToDegrees(FMath::Acos(CosAngle)));
+    };
+    AddAngle(RearMirrorIdx, RearMirrorSM, RearReflection);
+    AddAngle(LeftMirrorIdx, LeftMirrorSM, LeftReflection);
+    AddAngle(RightMirrorIdx, RightMirrorSM, RightReflection);
+
+    if (MirrorSched->Update(DeltaSeconds, Angles))
+        UpdateMirrorResolution();
+}
+
+void AEgoVehicle::UpdateMirrorResolution()
+{
+    auto SetResolution = [this](const struct MirrorParams &Params, class UPlanarReflectionComponent *Reflection,
+                                int Idx) {
+        if (Reflection == nullptr)
+            return;
+        const float GazeScale = MirrorSched.IsValid() ? MirrorSched->GetScale(Idx) : 1.f;
+        Reflection->ScreenPercentage = Params.ScreenPercentage * MirrorQualityScale * GazeScale;
+    };
+    SetResolution(RearMirrorParams, RearReflection, RearMirrorIdx);
+    SetResolution(LeftMirrorParams, LeftReflection, LeftMirrorIdx);
+    SetResolution(RightMirrorParams, RightReflection, RightMirrorIdx);
+}
+
 /// ========================================== ///
 /// ----------------:SOUNDS:------------------ ///
 /// ========================================== ///
@@ -594,11 +979,6 @@ void AEgoVehicle::ConstructEgoSounds()
 
     // Initialize ego-centric audio components
     {
-        if (EngineRevSound != nullptr)
-        {
-            EngineRevSound->DestroyComponent(); // from the parent class (default sound)
-            EngineRevSound = nullptr;
-        }
         EgoEngineRevSound = CreateEgoObject<UAudioComponent>("EgoEngineRevSound");
         FindSound<USoundCue>("Sound", "DefaultEngineRev", EgoEngineRevSound);
         EgoEngineRevSound->SetupAttachment(GetRootComponent()); // attach to self
@@ -610,6 +990,14 @@ void AEgoVehicle::ConstructEgoSounds()
         check(EgoEngineRevSound != nullptr);
     }
 
+    {
+        // the same sound for the non-ego vehicles, played by the pool of TickVehicleAudio
+        const FString PathStr = GeneralParams.Get<FString>("Sound", "DefaultEngineRev");
+        ConstructorHelpers::FObjectFinder<USoundBase> FoundSound(*PathStr);
+        if (FoundSound.Succeeded())
+            NonEgoEngineSound = FoundSound.Object;
+    }
+
     {
         if (CrashSound != nullptr)
         {
@@ -671,19 +1059,245 @@ void AEgoVehicle::SetVolume(const float VolumeIn)
 void AEgoVehicle::TickSounds(float DeltaSeconds)
 {
     // Respect the global vehicle volume param
-    SetVolume(ACarlaWheeledVehicle::Volume);
+    if (AppliedVolume != ACarlaWheeledVehicle::Volume)
+        SetVolume(ACarlaWheeledVehicle::Volume);
 
     if (EgoEngineRevSound)
     {
         if (!EgoEngineRevSound->IsPlaying())
             EgoEngineRevSound->Play(); // turn on the engine sound if not already on
-        float RPM = FMath::Clamp(GetVehicleMovementComponent()->GetEngineRotationSpeed(), 0.f, 5650.0f);
-        EgoEngineRevSound->SetFloatParameter(FName("RPM"), RPM);
+        EgoEngineRevSound->SetFloatParameter(FName("RPM"), GetEngineRPM());
     }
 
     // add other sounds that need tick-level granularity here...
 }
 
+void AEgoVehicle::InitVehicleAudio()
+{
+    VehicleAudio.SetParams(VehicleAudioParams);
+    const int NumVoices = VehicleAudio.GetVoices().size();
+    while (VehicleAudioPool.Num() > NumVoices)
+    {
+        if (VehicleAudioPool.Last() != nullptr)
+            VehicleAudioPool.Last()->DestroyComponent();
+        VehicleAudioPool.Pop();
+    }
+    while (VehicleAudioPool.Num() < NumVoices)
+    {
+        const FName Name(*FString::Printf(TEXT("NonEgoEngineSound%d"), VehicleAudioPool.Num()));
+        UAudioComponent *Voice = NewObject<UAudioComponent>(this, Name);
+        Voice->bAutoActivate = false;
+        Voice->bAutoDestroy = false;
+        Voice->SetSound(NonEgoEngineSound);
+        Voice->SetVolumeMultiplier(ACarlaWheeledVehicle::Volume);
+        Voice->RegisterComponent();
+        VehicleAudioPool.Add(Voice);
+    }
+    VehicleAudioTargets.SetNum(NumVoices);
+    VehicleAudioVolume = ACarlaWheeledVehicle::Volume;
+    LOG("Non-ego engine sounds: %d voices within %.0f m at %.0f Hz", NumVoices, VehicleAudioParams.MaxDistance,
+        VehicleAudioParams.UpdateRateHz);
+}
+
+void AEgoVehicle::TickVehicleAudio(float DeltaSeconds)
+{
+    if (World == nullptr || VehicleAudioPool.Num() == 0)
+        return;
+    if (VehicleAudioVolume != ACarlaWheeledVehicle::Volume)
+    {
+        VehicleAudioVolume = ACarlaWheeledVehicle::Volume;
+        for (UAudioComponent *Voice : VehicleAudioPool)
+            Voice->SetVolumeMultiplier(VehicleAudioVolume);
+    }
+    if (!VehicleAudio.ShouldUpdate(DeltaSeconds))
+        return;
+
+    // every non-ego vehicle, by its distance to the listener (the driver's head)
+    const FVector Listener = GetCamera()->GetComponentLocation();
+    std::vector<VehicleAudioSource> Sources;
+    TMap<uint32, ACarlaWheeledVehicle *> Vehicles;
+    if (ACarlaWheeledVehicle::bEngineSounds)
+    {
+        for (TActorIterator<ACarlaWheeledVehicle> It(World); It; ++It)
+        {
+            ACarlaWheeledVehicle *Vehicle = *It;
+            if (Vehicle == this || Vehicle->IsPendingKill())
+                continue;
+            VehicleAudioSource Source;
+            Source.Id = Vehicle->GetUniqueID();
+            Source.Distance = FVector::Dist(Listener, Vehicle->GetActorLocation()) / 100.f; // cm -> m
+            Source.Loudness = 0.5f + 0.5f * Vehicle->GetEngineRPM() / 5650.f; // idling engines are heard too
+            Sources.push_back(Source);
+            Vehicles.Add(Source.Id, Vehicle);
+        }
+    }
+    const std::vector<uint32_t> &Voices = VehicleAudio.Update(Sources);
+
+    // move the voices whose vehicle changed, and update the RPM of the rest
+    for (int i = 0; i < VehicleAudioPool.Num(); i++)
+    {
+        UAudioComponent *Voice = VehicleAudioPool[i];
+        ACarlaWheeledVehicle *const *Found = Vehicles.Find(Voices[i]);
+        ACarlaWheeledVehicle *Vehicle = (Found != nullptr) ? *Found : nullptr;
+        // a destroyed vehicle frees its slot and leaves a stale target: the voice must not loop on where it was
+        const bool bTargetGone = VehicleAudioTargets[i].IsStale();
+        if (VehicleAudio.SlotChanged(i) || bTargetGone || Vehicle != VehicleAudioTargets[i].Get())
+        {
+            Voice->Stop();
+            Voice->DetachFromComponent(FDetachmentTransformRules::KeepRelativeTransform);
+            VehicleAudioTargets[i] = Vehicle;
+            if (Vehicle == nullptr)
+                continue;
+            Voice->AttachToComponent(Vehicle->GetRootComponent(), FAttachmentTransformRules::KeepRelativeTransform);
+            Voice->SetRelativeLocation(Vehicle->GetEngineLocation()); // 3D sound from the "engine"
+            Voice->SetFloatParameter(FName("RPM"), Vehicle->GetEngineRPM());
+            Voice->Play();
+        }
+        else if (Vehicle != nullptr)
+        {
+            Voice->SetFloatParameter(FName("RPM"), Vehicle->GetEngineRPM());
+        }
+    }
+}
+
+void AEgoVehicle::InitGazeLOD()
+{
+    ReleaseGazeLOD(); // the buckets start over with the new params
+    GazeLODPolicy.SetParams(GazeLODConfig);
+    if (bGazeLOD)
+        LOG("Gaze LOD: min LOD %d/%d beyond %.0f/%.0f degrees of the gaze, within %.0f m at %.0f Hz",
+            GazeLODConfig.NearPeripheryMinLOD, GazeLODConfig.FarPeripheryMinLOD, GazeLODConfig.FovealDeg,
+            GazeLODConfig.NearPeripheryDeg, GazeLODConfig.MaxDistance, GazeLODConfig.UpdateRateHz);
+}
+
+void AEgoVehicle::TickGazeLOD(float DeltaSeconds)
+{
+    if (!bGazeLOD || World == nullptr || !EgoSensor.IsValid() || !GazeLODPolicy.ShouldUpdate(DeltaSeconds))
+        return;
+
+    const DReyeVR::AggregateData *Data = EgoSensor.Get()->GetData();
+    const FRotator &WorldRot = Data->GetCameraRotationAbs();
+    const FVector Eye = Data->GetCameraLocationAbs() + WorldRot.RotateVector(Data->GetGazeOrigin());
+    // fall back to the head direction without a valid gaze (ex. no eye tracker)
+    const FVector Gaze = Data->GetGazeValidity() ? WorldRot.RotateVector(Data->GetGazeDir()) : WorldRot.Vector();
+    auto ToMeters = [](const FVector &V) { return GazeVector{V.X / 100.f, V.Y / 100.f, V.Z / 100.f}; };
+
+    // destroyed actors are forgotten, the policy releases their ids (nothing to restore) in this update
+    for (auto It = GazeLODIds.CreateIterator(); It; ++It)
+    {
+        if (It.Key().IsStale())
+            It.RemoveCurrent();
+    }
+
+    // the other vehicles and the walkers, by the bounds of their root component (no need to walk the components)
+    std::vector<GazeLODActor> Actors;
+    TMap<uint32, AActor *> ById;
+    auto AddActor = [&](AActor *Actor) {
+        if (Actor == this || Actor->IsPendingKill() || Actor->GetRootComponent() == nullptr)
+            return;
+        const FBoxSphereBounds &Bounds = Actor->GetRootComponent()->Bounds;
+        GazeLODActor A;
+        uint32 &Id = GazeLODIds.FindOrAdd(Actor);
+        if (Id == 0)
+            Id = NextGazeLODId++;
+        A.Id = Id;
+        A.Location = ToMeters(Bounds.Origin);
+        A.BoundsRadius = Bounds.SphereRadius / 100.f; // cm -> m
+        Actors.push_back(A);
+        ById.Add(A.Id, Actor);
+    };
+    for (TActorIterator<ACarlaWheeledVehicle> It(World); It; ++It)
+        AddActor(*It);
+    for (TActorIterator<ACharacter> It(World); It; ++It)
+        AddActor(*It);
+
+    // only the actors whose bucket changed are touched
+    for (const GazeLODChange &Change : GazeLODPolicy.Update(ToMeters(Eye), ToMeters(Gaze), Actors))
+    {
+        if (Change.Bucket == GazeBucket::Released)
+        {
+            FGazeLODTarget Target;
+            if (GazeLODTargets.RemoveAndCopyValue(Change.Id, Target))
+                ApplyGazeLOD(Target, Change.Bucket);
+            continue;
+        }
+        FGazeLODTarget &Target = GazeLODTargets.FindOrAdd(Change.Id);
+        Target.Actor = ById.FindRef(Change.Id);
+        ApplyGazeLOD(Target, Change.Bucket);
+    }
+}
+
+void AEgoVehicle::ApplyGazeLOD(FGazeLODTarget &Target, GazeBucket Bucket)
+{
+    AActor *Actor = Target.Actor.Get();
+    if (Actor == nullptr)
+        return; // destroyed, nothing to restore
+    if (Target.Components.Num() == 0)
+    {
+        TInlineComponentArray<UPrimitiveComponent *> Components(Actor);
+        for (UPrimitiveComponent *Component : Components)
+        {
+            FGazeLODComponent Managed{Component, Component->LDMaxDrawDistance, Component->LDMaxDrawDistance, false, 0};
+            if (const UStaticMeshComponent *SM = Cast<UStaticMeshComponent>(Component))
+            {
+                Managed.bBaseOverrideMinLOD = SM->bOverrideMinLOD;
+                Managed.BaseMinLOD = SM->MinLOD;
+            }
+            else if (const USkinnedMeshComponent *SK = Cast<USkinnedMeshComponent>(Component))
+            {
+                Managed.bBaseOverrideMinLOD = SK->bOverrideMinLod;
+                Managed.BaseMinLOD = SK->MinLodModel;
+            }
+            Target.Components.Add(Managed);
+        }
+    }
+    const int MinLOD = GazeLODPolicy.GetMinLOD(Bucket);
+    const float CullScale = GazeLODPolicy.GetCullScale(Bucket);
+    for (FGazeLODComponent &Managed : Target.Components)
+    {
+        UPrimitiveComponent *Component = Managed.Component.Get();
+        if (Component == nullptr)
+            continue;
+        // the finest LOD the mesh may pick by screen size, never finer than its own override (released: its own)
+        const bool bOverride = (MinLOD > 0) || Managed.bBaseOverrideMinLOD;
+        const int32 LOD =
+            (MinLOD > 0) ? FMath::Max(MinLOD, Managed.bBaseOverrideMinLOD ? Managed.BaseMinLOD : 0) : Managed.BaseMinLOD;
+        if (UStaticMeshComponent *SM = Cast<UStaticMeshComponent>(Component))
+        {
+            SM->bOverrideMinLOD = bOverride;
+            SM->MinLOD = LOD;
+            SM->MarkRenderStateDirty();
+        }
+        else if (USkinnedMeshComponent *SK = Cast<USkinnedMeshComponent>(Component))
+        {
+            SK->bOverrideMinLod = bOverride;
+            SK->SetMinLOD(LOD);
+        }
+        // a cull distance other than the last one applied here was set since (ex. the per category draw distances
+        // of UCarlaSettingsDelegate), it is the one to scale and to restore
+        const float Current = Component->LDMaxDrawDistance;
+        if (Current != Managed.AppliedCull)
+        {
+            Managed.BaseCull = Current;
+            Managed.AppliedCull = Current;
+        }
+        // components without a cull distance (0) are never culled by it, shortening theirs would pop them
+        const float Cull = (Managed.BaseCull > 0.f) ? CullScale * Managed.BaseCull : Managed.BaseCull;
+        if (Current != Cull)
+        {
+            Component->SetCullDistance(Cull);
+            Managed.AppliedCull = Cull;
+        }
+    }
+}
+
+void AEgoVehicle::ReleaseGazeLOD()
+{
+    for (auto &IdAndTarget : GazeLODTargets)
+        ApplyGazeLOD(IdAndTarget.Value, GazeBucket::Released);
+    GazeLODTargets.Empty();
+}
+
 void AEgoVehicle::ConstructEgoCollisionHandler()
 {
     // using Carla's GetVehicleBoundingBox function
@@ -693,30 +1307,24 @@ void AEgoVehicle::ConstructEgoCollisionHandler()
         Bounds->SetGenerateOverlapEvents(true);
         Bounds->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
         Bounds->SetCollisionProfileName(TEXT("DReyeVRTrigger"));
-        Bounds->OnComponentBeginOverlap.AddDynamic(this, &AEgoVehicle::OnEgoOverlapBegin);
+        // the overlaps are already queued by ACarlaWheeledVehicle::OnOverlapBegin (bound by its constructor), and
+        // handed to our OnCollision once per frame
     }
 }
 
-void AEgoVehicle::OnEgoOverlapBegin(UPrimitiveComponent *OverlappedComp, AActor *OtherActor,
-                                    UPrimitiveComponent *OtherComp, int32 OtherBodyIndex, bool bFromSweep,
-                                    const FHitResult &SweepResult)
+void AEgoVehicle::OnCollision(AActor *OtherActor, uint8 OtherClass)
 {
-    if (OtherActor == nullptr || OtherActor == this)
+    if (CollisionCooldownTime >= GetWorld()->GetTimeSeconds()) // respect collision audio cooldown
         return;
-
-    // can be more flexible, such as having collisions with static props or people too
-    if (EnableCollisionForActor(OtherActor))
+    // move the sound 1m in the direction of the collision
+    FVector SoundEmitLocation = 100.f * (this->GetActorLocation() - OtherActor->GetActorLocation()).GetSafeNormal();
+    SoundEmitLocation.Z = 75.f; // Make the sound emitted not at the ground (75cm off ground)
+    if (EgoCrashSound != nullptr)
     {
-        // move the sound 1m in the direction of the collision
-        FVector SoundEmitLocation = 100.f * (this->GetActorLocation() - OtherActor->GetActorLocation()).GetSafeNormal();
-        SoundEmitLocation.Z = 75.f; // Make the sound emitted not at the ground (75cm off ground)
-        if (EgoCrashSound != nullptr)
-        {
-            EgoCrashSound->SetRelativeLocation(SoundEmitLocation);
-            EgoCrashSound->Play(0.f);
-            // have at least 0.5s of buffer between collision audio
-            CollisionCooldownTime = GetWorld()->GetTimeSeconds() + 0.5f;
-        }
+        EgoCrashSound->SetRelativeLocation(SoundEmitLocation);
+        EgoCrashSound->Play(0.f);
+        // have at least 0.5s of buffer between collision audio
+        CollisionCooldownTime = GetWorld()->GetTimeSeconds() + 0.5f;
     }
 }
 
@@ -808,13 +1416,10 @@ void AEgoVehicle::UpdateDash()
         XPH = GetVehicleForwardSpeed() * SpeedometerScale; // FwdSpeed is in cm/s
     }
 
-    if (Speedometer != nullptr)
-    {
-        const FString Data = FString::FromInt(int(FMath::RoundHalfFromZero(XPH)));
-        Speedometer->SetText(FText::FromString(Data));
-    }
+    // quantized to what is displayed, so the text only changes when the shown number does
+    SpeedometerWidget.SetInt(int(FMath::RoundHalfFromZero(XPH)));
 
-    if (bEnableTurnSignalAction && TurnSignals != nullptr)
+    if (bEnableTurnSignalAction)
     {
         // Draw the signals
         float Now = GetWorld()->GetTimeSeconds();
@@ -828,14 +1433,11 @@ void AEgoVehicle::UpdateDash()
             else if (Now < LeftSignalTimeToDie)
                 TurnSignalStr = "<<<";
         }
-        TurnSignals->SetText(FText::FromString(TurnSignalStr));
+        TurnSignalsWidget.Set(TurnSignalStr);
     }
 
-    if (GearShifter != nullptr)
-    {
-        // Draw the gear shifter
-        GearShifter->SetText(bReverse ? FText::FromString("R") : FText::FromString("D"));
-    }
+    // Draw the gear shifter
+    GearShifterWidget.Set(bReverse ? TEXT("R") : TEXT("D"));
 }
 
 /// ========================================== ///
@@ -867,9 +1469,8 @@ void AEgoVehicle::InitAutopilotIndicator()
     AutopilotIndicator->Activate();
     AutopilotIndicator->SetActorScale3D(AutopilotIndicatorSize * FVector::OneVector);
     AutopilotIndicator->AttachToComponent(SteeringWheel, FAttachmentTransformRules::KeepRelativeTransform);
-    AutopilotIndicator->MaterialParams.BaseColor = ButtonNeutralCol; // close to off
-    AutopilotIndicator->MaterialParams.Emissive = ButtonNeutralCol;  // close to off
-    AutopilotIndicator->UpdateMaterial();
+    AutopilotIndicatorWidget.Bind(AutopilotIndicator);
+    AutopilotIndicatorWidget.Set(ButtonNeutralCol, ButtonNeutralCol); // close to off
     AutopilotIndicator->SetActorTickEnabled(false);      // don't tick these actors (for performance)
     AutopilotIndicator->SetActorRecordEnabled(false);    // don't need to record these actors either
     AutopilotIndicator->GetMesh()->SetCastShadow(false); // don't want shadows (looks weird)
@@ -927,9 +1528,9 @@ void AEgoVehicle::InitWheelButtons()
         Button->Activate();
         Button->SetActorScale3D(0.015f * FVector::OneVector);
         Button->AttachToComponent(SteeringWheel, FAttachmentTransformRules::KeepRelativeTransform);
-        Button->MaterialParams.BaseColor = ButtonNeutralCol;
-        Button->MaterialParams.Emissive = ButtonNeutralCol;
-        Button->UpdateMaterial();
+        FCockpitLight &Widget = WheelButtonWidgets.Add(Button);
+        Widget.Bind(Button);
+        Widget.Set(ButtonNeutralCol, ButtonNeutralCol);
         Button->SetActorTickEnabled(false);      // don't tick these actors (for performance)
         Button->SetActorRecordEnabled(false);    // don't need to record these actors either
         Button->GetMesh()->SetCastShadow(false); // don't want shadows (looks weird)
@@ -939,22 +1540,18 @@ void AEgoVehicle::InitWheelButtons()
 
 void AEgoVehicle::UpdateWheelButton(ADReyeVRCustomActor *Button, bool bEnabled)
 {
-    if (Button == nullptr)
+    FCockpitLight *Widget = WheelButtonWidgets.Find(Button);
+    if (Widget == nullptr)
         return;
-    Button->MaterialParams.BaseColor = bEnabled ? ButtonPressedCol : ButtonNeutralCol;
-    Button->MaterialParams.Emissive = bEnabled ? ButtonPressedCol : ButtonNeutralCol;
-    Button->UpdateMaterial();
+    const FLinearColor &Col = bEnabled ? ButtonPressedCol : ButtonNeutralCol;
+    Widget->Set(Col, Col);
 }
 
 void AEgoVehicle::TickAutopilotIndicator(bool bAutopilotEnabled)
 {
-    if (AutopilotIndicator == nullptr)
-        return;
     const FLinearColor On = FLinearColor(0.537, 0.812, 0.941);         // baby blue
     const FLinearColor Off = 0.1f * FLinearColor(0.537, 0.812, 0.941); // baby blue (off)
-    AutopilotIndicator->MaterialParams.BaseColor = bAutopilotEnabled ? On : Off;
-    AutopilotIndicator->MaterialParams.Emissive = 500.f * (bAutopilotEnabled ? On : Off);
-    AutopilotIndicator->UpdateMaterial();
+    AutopilotIndicatorWidget.Set(bAutopilotEnabled ? On : Off, 500.f * (bAutopilotEnabled ? On : Off));
 }
 
 void AEgoVehicle::DestroySteeringWheel()
@@ -969,6 +1566,7 @@ void AEgoVehicle::DestroySteeringWheel()
             Button->Destroy();
         }
     }
+    WheelButtonWidgets.Empty();
 }
 
 void AEgoVehicle::TickSteeringWheel(const float DeltaTime)
@@ -981,7 +1579,7 @@ void AEgoVehicle::TickSteeringWheel(const float DeltaTime)
         InitAutopilotIndicator();
     const FRotator CurrentRotation = SteeringWheel->GetRelativeRotation();
     FRotator NewRotation = CurrentRotation;
-    if (Pawn && Pawn->GetIsLogiConnected() && !GetAutopilotStatus())
+    if (Pawn && Pawn->GetIsWheelConnected() && !GetAutopilotStatus())
     {
         // make the virtual wheel rotation follow the physical steering wheel
         const float RawSteering = GetVehicleInputs().Steering; // this is scaled in SetSteering
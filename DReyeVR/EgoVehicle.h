@@ -6,6 +6,7 @@
 #include "Carla/Sensor/DReyeVRData.h"                 // DReyeVR namespace
 #include "Carla/Vehicle/CarlaWheeledVehicle.h"        // ACarlaWheeledVehicle
 #include "Carla/Vehicle/WheeledVehicleAIController.h" // AWheeledVehicleAIController
+#include "CockpitWidgets.h"                           // FCockpitText, FCockpitLight
 #include "Components/AudioComponent.h"                // UAudioComponent
 #include "Components/InputComponent.h"                // InputComponent
 #include "Components/PlanarReflectionComponent.h"     // Planar Reflection
@@ -15,7 +16,12 @@
 #include "DReyeVRUtils.h"                             // GeneralParams.Get
 #include "EgoSensor.h"                                // AEgoSensor
 #include "FlatHUD.h"                                  // ADReyeVRHUD
+#include "GazeLOD.h"                                  // GazeLOD
+#include "HapticSharedControl.h"                      // HapticSharedControl
 #include "ImageUtils.h"                               // CreateTexture2D
+#include "MirrorScheduler.h"                          // MirrorScheduler
+#include "QualityGovernor.h"                          // QualityGovernor
+#include "VehicleAudioLOD.h"                          // VehicleAudioLOD
 #include "WheeledVehicle.h"                           // VehicleMovementComponent
 #include <stdio.h>
 #include <vector>
@@ -37,6 +43,7 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
     AEgoVehicle(const FObjectInitializer &ObjectInitializer);
 
     void ReadConfigVariables();
+    int ConfigSubscription = -1; // GeneralParams.Subscribe (hot reload)
 
     virtual void Tick(float DeltaTime) override; // called automatically
 
@@ -144,6 +151,15 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
     UPROPERTY(Category = Mirrors, EditAnywhere, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
     class UStaticMeshComponent *RearMirrorChassisSM;
     FTransform RearMirrorChassisTransform;
+    // gaze-contingent mirror resolution (see MirrorScheduler.h)
+    void InitMirrorScheduler();
+    void TickMirrors(float DeltaSeconds);
+    void UpdateMirrorResolution();
+    bool bGazeScheduledMirrors = true;
+    MirrorSchedulerParams MirrorSchedParams;
+    TUniquePtr<MirrorScheduler> MirrorSched = nullptr;
+    int RearMirrorIdx = -1, LeftMirrorIdx = -1, RightMirrorIdx = -1; // in MirrorSched (-1 if disabled)
+    float MirrorQualityScale = 1.f;                                    // set by the quality governor
 
   private: // AI controller
     class AWheeledVehicleAIController *AI_Player = nullptr;
@@ -218,9 +234,7 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
 
     // manually overriding these from ACarlaWheeledVehicle
     void ConstructEgoCollisionHandler(); // needs to be called in the constructor
-    UFUNCTION()
-    void OnEgoOverlapBegin(UPrimitiveComponent *OverlappedComp, AActor *OtherActor, UPrimitiveComponent *OtherComp,
-                           int32 OtherBodyIndex, bool bFromSweep, const FHitResult &SweepResult);
+    virtual void OnCollision(AActor *OtherActor, uint8 OtherClass) override;
 
   private: // gamemode/level
     void TickGame(float DeltaSeconds);
@@ -237,6 +251,7 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
     UPROPERTY(Category = "Dash", EditDefaultsOnly, BlueprintReadWrite, meta = (AllowPrivateAccess = "true"))
     class UTextRenderComponent *GearShifter;
     void UpdateDash();
+    FCockpitText SpeedometerWidget, TurnSignalsWidget, GearShifterWidget; // only push text when it changes
     float SpeedometerScale = CmPerSecondToXPerHour(true); // scale from CM/s to MPH or KPH (default MPH)
 
   private: // steering wheel
@@ -255,15 +270,79 @@ class CARLAUE4_API AEgoVehicle : public ACarlaWheeledVehicle
     class ADReyeVRCustomActor *Button_ABXY_A, *Button_ABXY_B, *Button_ABXY_X, *Button_ABXY_Y;
     class ADReyeVRCustomActor *Button_DPad_Up, *Button_DPad_Down, *Button_DPad_Left, *Button_DPad_Right;
     bool bInitializedButtons = false;
+    TMap<const ADReyeVRCustomActor *, FCockpitLight> WheelButtonWidgets; // only push materials when they change
     const FLinearColor ButtonNeutralCol = 0.2f * FLinearColor::White;
     const FLinearColor ButtonPressedCol = 1.5f * FLinearColor::White;
     // wheel face autopilot indicator
     void InitAutopilotIndicator();
     void TickAutopilotIndicator(bool);
     class ADReyeVRCustomActor *AutopilotIndicator;
+    FCockpitLight AutopilotIndicatorWidget;
     bool bInitializedAutopilotIndicator = false;
 
   private: // other
     void DebugLines() const;
     bool bDrawDebugEditor = false;
+
+  private: // frame budget profiler (see FrameBudgetProfiler.h)
+    bool bProfileFrameBudget = true;
+    int ProfilerNumFrames = 1024;
+    float FrameBudgetMs = 11.1f; // 90 Hz
+
+  private: // adaptive quality (see QualityGovernor.h)
+    void InitQualityGovernor();
+    void TickQualityGovernor();
+    void ApplyQualityLevel(const QualityLevel &Level);
+    bool bQualityGovernor = false;
+    QualityGovernorParams GovernorParams;
+    TUniquePtr<QualityGovernor> Governor = nullptr;
+    float CameraScreenPercentage = 100.f; // CameraParams ScreenPercentage at full quality
+
+  private: // haptic shared control (see HapticSharedControl.h)
+    void InitHapticControl();
+    void TickHapticControl();
+    bool bHapticControl = false;
+    HapticControlParams HapticParams;
+    HapticSharedControl Haptic;
+    float HapticWheelRangeDeg = 900.f; // lock-to-lock rotation of the steering wheel
+    FString HapticTrajectoryFile;
+    FString LoadedTrajectoryFile; // the trajectory is only reloaded when the file changes
+
+  private: // engine sounds of the non-ego vehicles (see VehicleAudioLOD.h)
+    void InitVehicleAudio();
+    void TickVehicleAudio(float DeltaSeconds);
+    VehicleAudioLODParams VehicleAudioParams;
+    VehicleAudioLOD VehicleAudio;
+    UPROPERTY()
+    class USoundBase *NonEgoEngineSound = nullptr; // DefaultEngineRev
+    UPROPERTY()
+    TArray<class UAudioComponent *> VehicleAudioPool; // one per voice, attached to the vehicle it plays
+    TArray<TWeakObjectPtr<ACarlaWheeledVehicle>> VehicleAudioTargets; // per voice
+    float VehicleAudioVolume = -1.f; // ACarlaWheeledVehicle::Volume last applied to the pool
+
+  private: // mesh LOD and cull distance of the actors by their angle from the gaze (see GazeLOD.h)
+    void InitGazeLOD();
+    void TickGazeLOD(float DeltaSeconds);
+    struct FGazeLODComponent
+    {
+        TWeakObjectPtr<class UPrimitiveComponent> Component;
+        float BaseCull;    // its own cull distance (cm), the one restored on release
+        float AppliedCull; // the one set by ApplyGazeLOD
+        bool bBaseOverrideMinLOD; // its own min LOD override, restored on release
+        int32 BaseMinLOD;
+    };
+    struct FGazeLODTarget
+    {
+        TWeakObjectPtr<AActor> Actor;
+        TArray<FGazeLODComponent> Components; // gathered on the first change
+    };
+    void ApplyGazeLOD(FGazeLODTarget &Target, GazeBucket Bucket);
+    void ReleaseGazeLOD(); // every managed actor back to its own settings
+    bool bGazeLOD = false;
+    GazeLODParams GazeLODConfig;
+    GazeLOD GazeLODPolicy;
+    TMap<uint32, FGazeLODTarget> GazeLODTargets; // by GazeLODIds
+    // ids of the actors for GazeLODPolicy, never reused (unlike AActor::GetUniqueID once an actor is collected)
+    TMap<TWeakObjectPtr<AActor>, uint32> GazeLODIds;
+    uint32 NextGazeLODId = 1;
 };
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "EvdevWheelDevice.h"
+
+#include <algorithm>
+
+#ifdef __linux__
+#include <cerrno>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/input.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+int EvdevWheelDevice::ButtonIndex(int KeyCode)
+{
+    // same as hid-input: the first 16 buttons are BTN_JOYSTICK.., the rest BTN_TRIGGER_HAPPY..
+    constexpr int Joystick = 0x120, TriggerHappy = 0x2c0;
+    if (KeyCode >= Joystick && KeyCode < Joystick + 16)
+        return KeyCode - Joystick;
+    if (KeyCode >= TriggerHappy && KeyCode < TriggerHappy + 40)
+        return 16 + KeyCode - TriggerHappy;
+    return -1;
+}
+
+uint32_t EvdevWheelDevice::HatToPOV(int X, int Y)
+{
+    // hundredths of degrees clockwise from up (Y is -1 for up), as DirectInput reports it
+    static const uint32_t POV[3][3] = {
+        {31500, 27000, 22500}, // left: up-left, left, down-left
+        {0, 0xFFFFFFFF, 18000}, // center: up, released, down
+        {4500, 9000, 13500},   // right: up-right, right, down-right
+    };
+    return POV[std::max(-1, std::min(1, X)) + 1][std::max(-1, std::min(1, Y)) + 1];
+}
+
+#ifdef __linux__
+
+EvdevWheelDevice::EvdevWheelDevice(const std::string &DevicePath, const EvdevAxes &AxesIn) : Axes(AxesIn)
+{
+    if (!DevicePath.empty())
+    {
+        Open(DevicePath);
+        return;
+    }
+    const std::string ById = "/dev/input/by-id/";
+    if (DIR *Dir = opendir(ById.c_str()))
+    {
+        while (const dirent *Entry = readdir(Dir))
+        {
+            const std::string File = Entry->d_name;
+            const std::string Suffix = "-event-joystick";
+            if (File.size() > Suffix.size() && File.compare(File.size() - Suffix.size(), Suffix.size(), Suffix) == 0 &&
+                Open(ById + File))
+                break;
+        }
+        closedir(Dir);
+    }
+}
+
+EvdevWheelDevice::~EvdevWheelDevice()
+{
+    Close();
+}
+
+bool EvdevWheelDevice::Open(const std::string &DevicePath)
+{
+    Fd = open(DevicePath.c_str(), O_RDWR | O_NONBLOCK); // writing is needed for force feedback
+    if (Fd < 0)
+        Fd = open(DevicePath.c_str(), O_RDONLY | O_NONBLOCK);
+    if (Fd < 0)
+        return false;
+    Path = DevicePath;
+    char NameBuf[256] = "Unknown";
+    ioctl(Fd, EVIOCGNAME(sizeof(NameBuf)), NameBuf);
+    Name = NameBuf;
+    for (int Code : {Axes.Steering, Axes.Throttle, Axes.Brake})
+    {
+        input_absinfo Info{};
+        if (Code >= 0 && Code < NumAbs && ioctl(Fd, EVIOCGABS(Code), &Info) == 0)
+        {
+            AbsMin[Code] = Info.minimum;
+            AbsMax[Code] = Info.maximum;
+            // start from the current position
+            if (Code == Axes.Steering)
+                State.Steering = Normalize(Code, Info.value, true);
+            else if (Code == Axes.Throttle)
+                State.Throttle = Normalize(Code, Info.value, false);
+            else
+                State.Brake = Normalize(Code, Info.value, false);
+        }
+    }
+    unsigned long FFBits[(FF_CNT + 8 * sizeof(unsigned long) - 1) / (8 * sizeof(unsigned long))] = {};
+    if (ioctl(Fd, EVIOCGBIT(EV_FF, sizeof(FFBits)), FFBits) >= 0)
+    {
+        const size_t Bits = 8 * sizeof(unsigned long);
+        bHasSpring = (FFBits[FF_SPRING / Bits] >> (FF_SPRING % Bits)) & 1ul;
+    }
+    return true;
+}
+
+void EvdevWheelDevice::Close()
+{
+    if (Fd < 0)
+        return;
+    StopForces();
+    if (EffectId >= 0)
+        ioctl(Fd, EVIOCRMFF, EffectId);
+    close(Fd.exchange(-1, std::memory_order_acq_rel));
+    EffectId = -1;
+}
+
+float EvdevWheelDevice::Normalize(int Code, int Value, bool bCentered) const
+{
+    const int Min = AbsMin[Code], Max = AbsMax[Code];
+    if (Max <= Min)
+        return 0.f;
+    const float T = std::max(0.f, std::min(1.f, float(Value - Min) / float(Max - Min))); // (0, 1)
+    if (bCentered)
+        return 2.f * T - 1.f; // (-1, 1)
+    return Axes.bPedalsInverted ? 1.f - T : T;
+}
+
+bool EvdevWheelDevice::Read(WheelState &Out)
+{
+    if (Fd < 0)
+        return false;
+    input_event Events[64];
+    while (true)
+    {
+        const ssize_t Bytes = read(Fd, Events, sizeof(Events));
+        if (Bytes < 0)
+        {
+            if (errno == EAGAIN || errno == EINTR)
+                break;
+            Close(); // unplugged (ENODEV)
+            return false;
+        }
+        const size_t N = size_t(Bytes) / sizeof(input_event);
+        for (size_t i = 0; i < N; i++)
+        {
+            const input_event &E = Events[i];
+            if (E.type == EV_ABS && E.code < NumAbs)
+            {
+                if (E.code == Axes.Steering)
+                    State.Steering = Normalize(E.code, E.value, true);
+                else if (E.code == Axes.Throttle)
+                    State.Throttle = Normalize(E.code, E.value, false);
+                else if (E.code == Axes.Brake)
+                    State.Brake = Normalize(E.code, E.value, false);
+                else if (E.code == ABS_HAT0X)
+                    HatX = E.value;
+                else if (E.code == ABS_HAT0Y)
+                    HatY = E.value;
+            }
+            else if (E.type == EV_KEY)
+            {
+                State.SetButton(ButtonIndex(E.code), E.value != 0);
+            }
+        }
+        if (N < sizeof(Events) / sizeof(input_event))
+            break;
+    }
+    State.POV = HatToPOV(HatX, HatY);
+    Out = State;
+    return true;
+}
+
+void EvdevWheelDevice::ApplyForce(const WheelForce &Force)
+{
+    if (Fd < 0 || !bHasSpring)
+        return;
+    if (!Force.bSpring)
+    {
+        StopForces();
+        return;
+    }
+    ff_effect Effect{};
+    Effect.type = FF_SPRING;
+    Effect.id = EffectId; // -1 uploads a new effect, else updates it
+    auto Clamp = [](int Percentage) { return std::max(-100, std::min(100, Percentage)); };
+    const uint16_t Saturation = static_cast<uint16_t>(0xFFFF * std::max(0, Clamp(Force.SaturationPercentage)) / 100);
+    const int16_t Coefficient = static_cast<int16_t>(0x7FFF * Clamp(Force.CoefficientPercentage) / 100);
+    const int16_t Center = static_cast<int16_t>(0x7FFF * Clamp(Force.OffsetPercentage) / 100);
+    for (ff_condition_effect &C : Effect.u.condition) // both axes (the wheel only uses the first)
+    {
+        C.right_saturation = C.left_saturation = Saturation;
+        C.right_coeff = C.left_coeff = Coefficient;
+        C.center = Center;
+    }
+    if (ioctl(Fd, EVIOCSFF, &Effect) < 0)
+        return;
+    EffectId = Effect.id;
+    if (!bPlaying)
+    {
+        input_event Play{};
+        Play.type = EV_FF;
+        Play.code = static_cast<uint16_t>(EffectId);
+        Play.value = 1;
+        bPlaying = (write(Fd, &Play, sizeof(Play)) == sizeof(Play));
+    }
+}
+
+void EvdevWheelDevice::StopForces()
+{
+    if (Fd < 0 || EffectId < 0 || !bPlaying)
+        return;
+    input_event Stop{};
+    Stop.type = EV_FF;
+    Stop.code = static_cast<uint16_t>(EffectId);
+    Stop.value = 0;
+    if (write(Fd, &Stop, sizeof(Stop)) == sizeof(Stop))
+        bPlaying = false;
+}
+
+#else // evdev is Linux only, the device is never connected elsewhere
+
+EvdevWheelDevice::EvdevWheelDevice(const std::string &, const EvdevAxes &AxesIn) : Axes(AxesIn)
+{
+}
+
+EvdevWheelDevice::~EvdevWheelDevice()
+{
+}
+
+bool EvdevWheelDevice::Read(WheelState &)
+{
+    return false;
+}
+
+void EvdevWheelDevice::ApplyForce(const WheelForce &)
+{
+}
+
+void EvdevWheelDevice::StopForces()
+{
+}
+
+#endif
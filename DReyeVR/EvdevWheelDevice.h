@@ -0,0 +1,65 @@
+#pragma once
+
+#include "WheelDevice.h" // WheelDevice
+
+#include <atomic>
+#include <string>
+
+// WheelDevice of a Linux input event device (/dev/input/event*, evdev), for wheels the Logitech plugin does not
+// support (it is Windows only). Buttons keep the joystick order of the kernel (BTN_JOYSTICK.., BTN_TRIGGER_HAPPY..)
+// which matches the DirectInput button indices, the hat becomes the POV, and the spring force is an FF_SPRING effect
+// (if the device supports it).
+
+struct EvdevAxes
+{
+    // ABS_* codes (the defaults are the Logitech G29/G923 with the hid-logitech driver)
+    int Steering = 0x00; // ABS_X
+    int Throttle = 0x02; // ABS_Z
+    int Brake = 0x05;    // ABS_RZ
+    bool bPedalsInverted = true; // pedals report their maximum when released
+};
+
+class EvdevWheelDevice : public WheelDevice
+{
+  public:
+    // an empty Path picks the first joystick of /dev/input/by-id
+    explicit EvdevWheelDevice(const std::string &Path = "", const EvdevAxes &Axes = EvdevAxes());
+    ~EvdevWheelDevice() override;
+
+    bool IsConnected() const override // any thread, the wheel-device thread closes the device when unplugged
+    {
+        return Fd.load(std::memory_order_acquire) >= 0;
+    }
+    bool Read(WheelState &Out) override; // applies every pending event (never blocks)
+    void ApplyForce(const WheelForce &Force) override;
+    void StopForces() override;
+
+    const std::string &GetPath() const
+    {
+        return Path;
+    }
+    const std::string &GetName() const
+    {
+        return Name;
+    }
+
+    // mapping of the kernel codes (-1 for codes that are not a wheel button)
+    static int ButtonIndex(int KeyCode);
+    static uint32_t HatToPOV(int HatX, int HatY);
+
+  private:
+    bool Open(const std::string &DevicePath);
+    void Close();
+    float Normalize(int Code, int Value, bool bCentered) const;
+
+    std::atomic<int> Fd{-1}; // closed by the thread reading the device, checked by IsConnected from any other
+    std::string Path, Name;
+    EvdevAxes Axes;
+    static constexpr int NumAbs = 0x40; // ABS_CNT
+    int AbsMin[NumAbs] = {}, AbsMax[NumAbs] = {};
+    int HatX = 0, HatY = 0;
+    WheelState State;
+    bool bHasSpring = false;
+    int EffectId = -1;
+    bool bPlaying = false;
+};
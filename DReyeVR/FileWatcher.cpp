@@ -0,0 +1,228 @@
+#include "FileWatcher.h"
+
+#include <chrono>
+#include <sys/stat.h> // stat
+#include <vector>
+
+#if defined(__linux__)
+#include <poll.h>        // poll
+#include <sys/inotify.h> // inotify_init1, inotify_add_watch
+#include <unistd.h>      // read, close
+#endif
+
+namespace
+{
+long long NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+bool StatFile(const std::string &Path, long long &MTime, long long &Size)
+{
+#ifdef _WIN32
+    struct _stat64 Info;
+    if (_stat64(Path.c_str(), &Info) != 0)
+        return false;
+#else
+    struct stat Info;
+    if (stat(Path.c_str(), &Info) != 0)
+        return false;
+#endif
+    MTime = static_cast<long long>(Info.st_mtime);
+    Size = static_cast<long long>(Info.st_size);
+    return true;
+}
+} // namespace
+
+FileWatcher::FileWatcher(int DebounceMs, int PollMs) : DebounceMs(DebounceMs), PollMs(PollMs)
+{
+}
+
+FileWatcher::~FileWatcher()
+{
+    Stop();
+}
+
+std::shared_ptr<FileWatcher> FileWatcher::Get()
+{
+    static std::shared_ptr<FileWatcher> Instance = std::make_shared<FileWatcher>();
+    return Instance;
+}
+
+size_t FileWatcher::NumWatched() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Watches.size();
+}
+
+int FileWatcher::Watch(const std::string &Path, Callback OnChanged)
+{
+    std::lock_guard<std::mutex> Lifecycle(LifecycleMutex);
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Start();
+    FWatch W;
+    W.Path = Path;
+    const size_t Slash = Path.find_last_of("/\\");
+    W.Directory = Slash == std::string::npos ? "." : Path.substr(0, Slash);
+    W.Name = Slash == std::string::npos ? Path : Path.substr(Slash + 1);
+    W.OnChanged = std::move(OnChanged);
+    StatFile(Path, W.MTime, W.Size);
+#if defined(__linux__)
+    if (InotifyFd >= 0)
+    {
+        // one watch descriptor per directory (inotify returns the same one for every file in it)
+        W.DirectoryWatch = inotify_add_watch(InotifyFd, W.Directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (W.DirectoryWatch < 0)
+            return -1;
+    }
+#endif
+    const int Id = NextId++;
+    Watches.emplace(Id, std::move(W));
+    return Id;
+}
+
+void FileWatcher::Unwatch(int Id)
+{
+    std::lock_guard<std::mutex> Lifecycle(LifecycleMutex);
+    bool bEmpty = false;
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        auto It = Watches.find(Id);
+        if (It == Watches.end())
+            return;
+#if defined(__linux__)
+        const int DirectoryWatch = It->second.DirectoryWatch;
+        Watches.erase(It);
+        bool bDirectoryInUse = false;
+        for (const auto &Other : Watches)
+            bDirectoryInUse |= (Other.second.DirectoryWatch == DirectoryWatch);
+        if (!bDirectoryInUse && InotifyFd >= 0 && DirectoryWatch >= 0)
+            inotify_rm_watch(InotifyFd, DirectoryWatch);
+#else
+        Watches.erase(It);
+#endif
+        bEmpty = Watches.empty();
+    }
+    {
+        // wait for a callback that might be running right now
+        std::lock_guard<std::recursive_mutex> Wait(CallbackMutex);
+    }
+    if (bEmpty && std::this_thread::get_id() != Thread.get_id())
+        Stop();
+}
+
+void FileWatcher::Start()
+{
+    // requires Mutex
+    if (Thread.joinable())
+        return;
+#if defined(__linux__)
+    InotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    bStopping = false;
+    Thread = std::thread(&FileWatcher::Run, this);
+}
+
+void FileWatcher::Stop()
+{
+    bStopping = true;
+    if (Thread.joinable())
+        Thread.join();
+#if defined(__linux__)
+    if (InotifyFd >= 0)
+        close(InotifyFd);
+    InotifyFd = -1;
+#endif
+}
+
+void FileWatcher::CheckForChanges(long long Now)
+{
+    // requires Mutex
+#if defined(__linux__)
+    if (InotifyFd >= 0)
+    {
+        alignas(inotify_event) char Buffer[4096];
+        ssize_t Len;
+        while ((Len = read(InotifyFd, Buffer, sizeof(Buffer))) > 0)
+        {
+            for (char *Ptr = Buffer; Ptr < Buffer + Len;)
+            {
+                const inotify_event *Event = reinterpret_cast<const inotify_event *>(Ptr);
+                for (auto &Entry : Watches)
+                {
+                    FWatch &W = Entry.second;
+                    if (W.DirectoryWatch == Event->wd && Event->len > 0 && W.Name == Event->name)
+                        W.DueMs = Now + DebounceMs; // restarts the debounce on every event
+                }
+                Ptr += sizeof(inotify_event) + Event->len;
+            }
+        }
+        return;
+    }
+#endif
+    // polling
+    for (auto &Entry : Watches)
+    {
+        FWatch &W = Entry.second;
+        long long MTime = 0, Size = -1;
+        if (StatFile(W.Path, MTime, Size) && (MTime != W.MTime || Size != W.Size))
+        {
+            W.MTime = MTime;
+            W.Size = Size;
+            W.DueMs = Now + DebounceMs;
+        }
+    }
+}
+
+void FileWatcher::Run()
+{
+    long long LastPollMs = 0;
+    while (!bStopping)
+    {
+#if defined(__linux__)
+        if (InotifyFd >= 0)
+        {
+            pollfd Fd{InotifyFd, POLLIN, 0};
+            poll(&Fd, 1, 50); // short timeout to notice bStopping and due callbacks
+        }
+        else
+#endif
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+
+        std::vector<std::pair<int, Callback>> Due;
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            const long long Now = NowMs();
+            if (InotifyFd >= 0 || Now - LastPollMs >= PollMs)
+            {
+                CheckForChanges(Now);
+                LastPollMs = Now;
+            }
+            for (auto &Entry : Watches)
+            {
+                FWatch &W = Entry.second;
+                if (W.DueMs >= 0 && Now >= W.DueMs)
+                {
+                    W.DueMs = -1;
+                    Due.emplace_back(Entry.first, W.OnChanged);
+                }
+            }
+        }
+
+        std::lock_guard<std::recursive_mutex> Running(CallbackMutex);
+        for (auto &Entry : Due)
+        {
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                if (Watches.find(Entry.first) == Watches.end())
+                    continue; // unwatched in the meantime
+            }
+            if (Entry.second)
+                Entry.second();
+        }
+    }
+}
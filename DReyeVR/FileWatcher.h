@@ -0,0 +1,60 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+// Calls back (on its own thread) when a watched file was written, ex. to hot-reload config files.
+// Uses inotify on Linux (watching the file's directory, so editors that save by renaming a temporary file are caught)
+// and polls the modification time/size elsewhere. Bursts of events are coalesced so a save triggers one callback.
+// The thread only runs while something is watched.
+
+class FileWatcher
+{
+  public:
+    using Callback = std::function<void()>;
+
+    explicit FileWatcher(int DebounceMs = 100, int PollMs = 500);
+    ~FileWatcher(); // stops the thread
+
+    int Watch(const std::string &Path, Callback OnChanged); // returns an id for Unwatch (< 0 on failure)
+    void Unwatch(int Id);                                    // the callback is not running anymore once this returns
+
+    size_t NumWatched() const;
+
+    // process-wide instance
+    static std::shared_ptr<FileWatcher> Get();
+
+  private:
+    struct FWatch
+    {
+        std::string Path;
+        std::string Directory;
+        std::string Name; // file name within Directory
+        Callback OnChanged;
+        int DirectoryWatch = -1; // inotify watch descriptor
+        long long MTime = 0;     // last seen modification time (polling)
+        long long Size = -1;     // last seen size (polling)
+        long long DueMs = -1;    // when to call back (after debouncing), < 0 if nothing pending
+    };
+
+    void Start(); // requires Mutex
+    void Stop();
+    void Run();
+    void CheckForChanges(long long NowMs); // requires Mutex
+
+    const int DebounceMs;
+    const int PollMs;
+    std::mutex LifecycleMutex; // serializes Watch/Unwatch (starting and stopping the thread)
+    mutable std::mutex Mutex;  // Watches
+    std::recursive_mutex CallbackMutex; // held while callbacks run, so Unwatch can wait for them
+    std::unordered_map<int, FWatch> Watches;
+    int NextId = 0;
+    int InotifyFd = -1;
+    std::thread Thread;
+    std::atomic<bool> bStopping{false};
+};
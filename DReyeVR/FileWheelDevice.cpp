@@ -0,0 +1,243 @@
+#include "FileWheelDevice.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+bool WheelLog::Load(const std::string &Path)
+{
+    std::ifstream In(Path);
+    if (!In)
+        return false;
+    Inputs.clear();
+    Forces.clear();
+    std::string Line;
+    while (std::getline(In, Line))
+    {
+        Line = Line.substr(0, Line.find('#'));
+        std::replace(Line.begin(), Line.end(), ',', ' ');
+        std::istringstream Fields(Line);
+        std::string Kind;
+        if (!(Fields >> Kind))
+            continue;
+        if (Kind == "I")
+        {
+            WheelLogInput R;
+            uint32_t POV;
+            uint64_t Lo, Hi;
+            if (Fields >> R.TimeS >> R.State.Steering >> R.State.Throttle >> R.State.Brake >> POV >> Lo >> Hi)
+            {
+                R.State.POV = POV;
+                R.State.Buttons[0] = Lo;
+                R.State.Buttons[1] = Hi;
+                Inputs.push_back(R);
+            }
+        }
+        else if (Kind == "F")
+        {
+            WheelLogForce R;
+            int bSpring;
+            if (Fields >> R.TimeS >> bSpring >> R.Force.OffsetPercentage >> R.Force.SaturationPercentage >>
+                R.Force.CoefficientPercentage)
+            {
+                R.Force.bSpring = (bSpring != 0);
+                Forces.push_back(R);
+            }
+        }
+    }
+    std::stable_sort(Inputs.begin(), Inputs.end(),
+                     [](const WheelLogInput &A, const WheelLogInput &B) { return A.TimeS < B.TimeS; });
+    return !Inputs.empty();
+}
+
+std::string WheelLog::FormatInput(double TimeS, const WheelState &State)
+{
+    char Buf[160];
+    std::snprintf(Buf, sizeof(Buf), "I,%.6f,%.6f,%.6f,%.6f,%" PRIu32 ",%" PRIu64 ",%" PRIu64, TimeS, State.Steering,
+                  State.Throttle, State.Brake, State.POV, State.Buttons[0], State.Buttons[1]);
+    return Buf;
+}
+
+std::string WheelLog::FormatForce(double TimeS, const WheelForce &Force)
+{
+    char Buf[96];
+    std::snprintf(Buf, sizeof(Buf), "F,%.6f,%d,%d,%d,%d", TimeS, Force.bSpring ? 1 : 0, Force.OffsetPercentage,
+                  Force.SaturationPercentage, Force.CoefficientPercentage);
+    return Buf;
+}
+
+FileWheelDevice::FileWheelDevice(WheelLog LogIn, bool bLoopIn) : Log(std::move(LogIn)), bLoop(bLoopIn)
+{
+}
+
+bool FileWheelDevice::IsConnected() const
+{
+    return !Log.Inputs.empty();
+}
+
+double FileWheelDevice::ReplayTime() const
+{
+    if (bManualTime)
+        return ManualTimeS;
+    if (!bStarted)
+        return 0.0;
+    return std::chrono::duration<double>(Clock::now() - Start).count();
+}
+
+bool FileWheelDevice::Read(WheelState &Out)
+{
+    if (Log.Inputs.empty())
+        return false;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!bStarted)
+    {
+        Start = Clock::now();
+        bStarted = true;
+    }
+    double T = ReplayTime() + Log.Inputs.front().TimeS; // the log starts at its first record
+    const double Duration = Log.Inputs.back().TimeS - Log.Inputs.front().TimeS;
+    if (bLoop && Duration > 0.0)
+        T = Log.Inputs.front().TimeS + std::fmod(T - Log.Inputs.front().TimeS, Duration);
+
+    // last record at or before T (the cursor only moves backwards when looping)
+    if (Cursor >= Log.Inputs.size() || Log.Inputs[Cursor].TimeS > T)
+        Cursor = 0;
+    while (Cursor + 1 < Log.Inputs.size() && Log.Inputs[Cursor + 1].TimeS <= T)
+        Cursor++;
+    Out = Log.Inputs[Cursor].State;
+
+    if (Cursor != LastReadCursor)
+    {
+        const bool bChanged =
+            (LastReadCursor >= Log.Inputs.size()) || !Log.Inputs[LastReadCursor].State.SameInputs(Out);
+        LastReadCursor = Cursor;
+        if (bChanged && !bAwaitingForce)
+        {
+            bAwaitingForce = true;
+            ChangeRead = Clock::now();
+        }
+    }
+    return true;
+}
+
+void FileWheelDevice::ApplyForce(const WheelForce &Force)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Applied.push_back(WheelLogForce{ReplayTime(), Force});
+    if (bAwaitingForce)
+    {
+        LatenciesMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - ChangeRead).count());
+        bAwaitingForce = false;
+    }
+}
+
+void FileWheelDevice::StopForces()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Applied.push_back(WheelLogForce{ReplayTime(), WheelForce()});
+}
+
+void FileWheelDevice::SetTime(double TimeS)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bManualTime = true;
+    ManualTimeS = TimeS;
+}
+
+double FileWheelDevice::GetTime() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return ReplayTime();
+}
+
+bool FileWheelDevice::Finished() const
+{
+    if (bLoop || Log.Inputs.empty())
+        return false;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return ReplayTime() + Log.Inputs.front().TimeS > Log.Inputs.back().TimeS;
+}
+
+std::vector<WheelLogForce> FileWheelDevice::GetAppliedForces() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Applied;
+}
+
+size_t FileWheelDevice::NumLatencySamples() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return LatenciesMs.size();
+}
+
+double FileWheelDevice::MeanLatencyMs() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    double Sum = 0.0;
+    for (double L : LatenciesMs)
+        Sum += L;
+    return LatenciesMs.empty() ? 0.0 : Sum / LatenciesMs.size();
+}
+
+double FileWheelDevice::MaxLatencyMs() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return LatenciesMs.empty() ? 0.0 : *std::max_element(LatenciesMs.begin(), LatenciesMs.end());
+}
+
+RecordingWheelDevice::RecordingWheelDevice(WheelDevice &InnerIn, const std::string &Path)
+    : Inner(InnerIn), File(Path), Start(std::chrono::steady_clock::now())
+{
+    if (File)
+        File << "# DReyeVR wheel log (see FileWheelDevice.h)" << std::endl;
+}
+
+bool RecordingWheelDevice::IsOpen() const
+{
+    return File.is_open() && File.good();
+}
+
+void RecordingWheelDevice::SetTime(double TimeS)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bManualTime = true;
+    ManualTimeS = TimeS;
+}
+
+double RecordingWheelDevice::Now() const
+{
+    if (bManualTime)
+        return ManualTimeS;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - Start).count();
+}
+
+bool RecordingWheelDevice::Read(WheelState &Out)
+{
+    if (!Inner.Read(Out))
+        return false;
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!bWroteInput || !LastWritten.SameInputs(Out)) // the replay holds the last record, repeats are redundant
+    {
+        File << WheelLog::FormatInput(Now(), Out) << '\n';
+        LastWritten = Out;
+        bWroteInput = true;
+    }
+    return true;
+}
+
+void RecordingWheelDevice::ApplyForce(const WheelForce &Force)
+{
+    Inner.ApplyForce(Force);
+    std::lock_guard<std::mutex> Lock(Mutex);
+    File << WheelLog::FormatForce(Now(), Force) << '\n';
+}
+
+void RecordingWheelDevice::StopForces()
+{
+    Inner.StopForces();
+    std::lock_guard<std::mutex> Lock(Mutex);
+    File << WheelLog::FormatForce(Now(), WheelForce()) << '\n';
+    File.flush();
+}
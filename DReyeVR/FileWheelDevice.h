@@ -0,0 +1,115 @@
+#pragma once
+
+#include "WheelDevice.h" // WheelDevice
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Wheel logs: one record per line, '#' starts a comment
+//   I,<time_s>,<steering>,<throttle>,<brake>,<pov>,<buttons 0-63>,<buttons 64-127>   a wheel state that was read
+//   F,<time_s>,<spring 0/1>,<offset %>,<saturation %>,<coefficient %>               a force that was applied
+// written by RecordingWheelDevice (around any other device) and replayed by FileWheelDevice, so the input path
+// (takeover, buttons, force feedback) can be run headlessly and deterministically.
+
+struct WheelLogInput
+{
+    double TimeS = 0.0;
+    WheelState State;
+};
+
+struct WheelLogForce
+{
+    double TimeS = 0.0;
+    WheelForce Force;
+};
+
+struct WheelLog
+{
+    std::vector<WheelLogInput> Inputs; // sorted by time
+    std::vector<WheelLogForce> Forces;
+
+    bool Load(const std::string &Path); // false if unreadable or without any input record
+    static std::string FormatInput(double TimeS, const WheelState &State);
+    static std::string FormatForce(double TimeS, const WheelForce &Force);
+};
+
+// replays the inputs of a wheel log and collects the forces it is given
+class FileWheelDevice : public WheelDevice
+{
+  public:
+    explicit FileWheelDevice(WheelLog Log, bool bLoop = false);
+
+    bool IsConnected() const override;
+    bool Read(WheelState &Out) override; // the last input at or before the replay time
+    void ApplyForce(const WheelForce &Force) override;
+    void StopForces() override;
+
+    // the replay time (same clock as the log was recorded with), set by ADReyeVRPawn from the game time; without any
+    // SetTime it falls back to the wall clock since the first Read
+    void SetTime(double TimeS);
+    double GetTime() const;
+    bool Finished() const; // past the last input (never when looping)
+
+    std::vector<WheelLogForce> GetAppliedForces() const; // with the replay time they were applied at
+    const WheelLog &GetLog() const
+    {
+        return Log;
+    }
+
+    // input-to-actuation latency: from the Read that first returned a changed input to the next force (wall clock)
+    size_t NumLatencySamples() const;
+    double MeanLatencyMs() const;
+    double MaxLatencyMs() const;
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    double ReplayTime() const; // with Mutex held
+
+    const WheelLog Log;
+    const bool bLoop;
+    mutable std::mutex Mutex;
+    bool bManualTime = false;
+    double ManualTimeS = 0.0;
+    bool bStarted = false;
+    Clock::time_point Start;
+    size_t Cursor = 0;          // input record of the replay time
+    size_t LastReadCursor = ~size_t(0);
+    bool bAwaitingForce = false; // a changed input was read, no force since
+    Clock::time_point ChangeRead;
+    std::vector<WheelLogForce> Applied;
+    std::vector<double> LatenciesMs;
+};
+
+// writes every changed state read from (and force applied to) another device into a wheel log, timestamped with the
+// time of SetTime (ADReyeVRPawn: the game time, as FileWheelDevice replays it) or the wall clock since construction
+class RecordingWheelDevice : public WheelDevice
+{
+  public:
+    RecordingWheelDevice(WheelDevice &Inner, const std::string &Path);
+
+    bool IsOpen() const;
+    bool IsConnected() const override
+    {
+        return Inner.IsConnected();
+    }
+    bool Read(WheelState &Out) override;
+    void ApplyForce(const WheelForce &Force) override;
+    void StopForces() override;
+
+    void SetTime(double TimeS); // any thread
+
+  private:
+    double Now() const; // with Mutex held
+
+    WheelDevice &Inner;
+    std::mutex Mutex;
+    std::ofstream File;
+    WheelState LastWritten;
+    bool bWroteInput = false;
+    bool bManualTime = false;
+    double ManualTimeS = 0.0;
+    const std::chrono::steady_clock::time_point Start;
+};
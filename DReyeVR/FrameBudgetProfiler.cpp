@@ -0,0 +1,265 @@
+#include "FrameBudgetProfiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace
+{
+double Percentile(std::vector<float> &Values, double P)
+{
+    // nearest rank
+    if (Values.empty())
+        return 0.0;
+    const size_t Rank = static_cast<size_t>(std::ceil(P * Values.size()));
+    const size_t Idx = std::min(Values.size() - 1, Rank > 0 ? Rank - 1 : 0);
+    std::nth_element(Values.begin(), Values.begin() + Idx, Values.end());
+    return Values[Idx];
+}
+
+FrameBudgetProfiler::StageSummary Summarize(const std::string &Name, std::vector<float> &Values, double BudgetMs)
+{
+    FrameBudgetProfiler::StageSummary S;
+    S.Name = Name;
+    if (Values.empty())
+        return S;
+    double Sum = 0;
+    for (const float V : Values)
+    {
+        Sum += V;
+        S.Max = std::max(S.Max, static_cast<double>(V));
+        S.OverBudget += (BudgetMs > 0 && V > BudgetMs);
+    }
+    S.Mean = Sum / Values.size();
+    S.P50 = Percentile(Values, 0.50);
+    S.P95 = Percentile(Values, 0.95);
+    S.P99 = Percentile(Values, 0.99);
+    return S;
+}
+} // namespace
+
+FrameBudgetProfiler::FrameBudgetProfiler(size_t NumFrames)
+{
+    Resize(NumFrames);
+}
+
+FrameBudgetProfiler &FrameBudgetProfiler::Get()
+{
+    static FrameBudgetProfiler Instance;
+    return Instance;
+}
+
+int FrameBudgetProfiler::RegisterStage(const std::string &Name)
+{
+    const auto It = std::find(Stages.begin(), Stages.end(), Name);
+    if (It != Stages.end())
+        return static_cast<int>(It - Stages.begin());
+    if (Stages.size() >= MaxStages)
+        return -1;
+    Stages.push_back(Name);
+    return static_cast<int>(Stages.size()) - 1;
+}
+
+int FrameBudgetProfiler::RegisterCounter(const std::string &Name)
+{
+    const auto It = std::find(Counters.begin(), Counters.end(), Name);
+    if (It != Counters.end())
+        return static_cast<int>(It - Counters.begin());
+    if (Counters.size() >= MaxCounters)
+        return -1;
+    Counters.push_back(Name);
+    return static_cast<int>(Counters.size()) - 1;
+}
+
+void FrameBudgetProfiler::SetEnabled(bool bEnable)
+{
+    bEnabled = bEnable;
+}
+
+void FrameBudgetProfiler::Resize(size_t NumFrames)
+{
+    Capacity = std::max<size_t>(NumFrames, 1);
+    Samples.assign(Capacity * MaxStages, 0.f);
+    Counts.assign(Capacity * MaxCounters, 0);
+    FrameIds.assign(Capacity, 0);
+    FrameTimes.assign(Capacity, 0.f);
+    Clear();
+}
+
+void FrameBudgetProfiler::Clear()
+{
+    Head = 0;
+    Count = 0;
+}
+
+void FrameBudgetProfiler::BeginFrame(uint64_t FrameId, double FrameMs)
+{
+    if (!bEnabled)
+        return;
+    Head = (Count == 0) ? 0 : (Head + 1) % Capacity;
+    Count = std::min(Count + 1, Capacity);
+    std::fill_n(Samples.begin() + Head * MaxStages, MaxStages, 0.f);
+    std::fill_n(Counts.begin() + Head * MaxCounters, MaxCounters, 0);
+    FrameIds[Head] = FrameId;
+    FrameTimes[Head] = static_cast<float>(FrameMs);
+}
+
+void FrameBudgetProfiler::AddTime(int Stage, double Ms)
+{
+    if (!bEnabled || Count == 0 || Stage < 0 || Stage >= MaxStages)
+        return;
+    Samples[Head * MaxStages + Stage] += static_cast<float>(Ms);
+}
+
+void FrameBudgetProfiler::AddCount(int Counter, uint32_t N)
+{
+    if (!bEnabled || Count == 0 || Counter < 0 || Counter >= MaxCounters)
+        return;
+    Counts[Head * MaxCounters + Counter] += N;
+}
+
+size_t FrameBudgetProfiler::Row(size_t i) const
+{
+    return (Head + Capacity + 1 - Count + i) % Capacity;
+}
+
+std::vector<FrameBudgetProfiler::StageSummary> FrameBudgetProfiler::Summarize(double BudgetMs) const
+{
+    std::vector<StageSummary> Out;
+    std::vector<float> Values(Count), Totals(Count, 0.f);
+    for (size_t s = 0; s < Stages.size(); s++)
+    {
+        for (size_t i = 0; i < Count; i++)
+        {
+            Values[i] = Samples[Row(i) * MaxStages + s];
+            Totals[i] += Values[i];
+        }
+        Out.push_back(::Summarize(Stages[s], Values, 0.0));
+    }
+    Out.push_back(::Summarize("Total", Totals, BudgetMs));
+    for (size_t i = 0; i < Count; i++)
+        Values[i] = FrameTimes[Row(i)];
+    Out.push_back(::Summarize("Frame", Values, BudgetMs));
+    return Out;
+}
+
+std::vector<FrameBudgetProfiler::StageSummary> FrameBudgetProfiler::SummarizeCounters() const
+{
+    std::vector<StageSummary> Out;
+    std::vector<float> Values(Count);
+    for (size_t c = 0; c < Counters.size(); c++)
+    {
+        for (size_t i = 0; i < Count; i++)
+            Values[i] = static_cast<float>(Counts[Row(i) * MaxCounters + c]);
+        Out.push_back(::Summarize(Counters[c], Values, 0.0));
+    }
+    return Out;
+}
+
+std::string FrameBudgetProfiler::SummaryString(double BudgetMs) const
+{
+    std::ostringstream oss;
+    char Line[256];
+    std::snprintf(Line, sizeof(Line), "frame budget over %zu frames (budget %.2f ms):\n", Count, BudgetMs);
+    oss << Line;
+    std::snprintf(Line, sizeof(Line), "%-32s %8s %8s %8s %8s %8s %6s\n", "stage", "mean", "p50", "p95", "p99", "max",
+                  "over");
+    oss << Line;
+    for (const StageSummary &S : Summarize(BudgetMs))
+    {
+        std::snprintf(Line, sizeof(Line), "%-32s %8.3f %8.3f %8.3f %8.3f %8.3f %6zu\n", S.Name.c_str(), S.Mean, S.P50,
+                      S.P95, S.P99, S.Max, S.OverBudget);
+        oss << Line;
+    }
+    if (!Counters.empty())
+    {
+        std::snprintf(Line, sizeof(Line), "%-32s %8s %8s %8s %8s %8s\n", "counter (per frame)", "mean", "p50", "p95",
+                      "p99", "max");
+        oss << Line;
+    }
+    for (const StageSummary &S : SummarizeCounters())
+    {
+        std::snprintf(Line, sizeof(Line), "%-32s %8.3f %8.0f %8.0f %8.0f %8.0f\n", S.Name.c_str(), S.Mean, S.P50, S.P95,
+                      S.P99, S.Max);
+        oss << Line;
+    }
+    return oss.str();
+}
+
+bool FrameBudgetProfiler::ExportCSV(const std::string &Path) const
+{
+    std::ofstream Out(Path, std::ios::out | std::ios::trunc);
+    if (!Out)
+        return false;
+    Out << "frame,frame_ms";
+    for (const std::string &Name : Stages)
+        Out << "," << Name;
+    Out << ",total_ms";
+    for (const std::string &Name : Counters)
+        Out << "," << Name;
+    Out << "\n";
+    for (size_t i = 0; i < Count; i++)
+    {
+        const size_t R = Row(i);
+        Out << FrameIds[R] << "," << FrameTimes[R];
+        float Total = 0.f;
+        for (size_t s = 0; s < Stages.size(); s++)
+        {
+            Out << "," << Samples[R * MaxStages + s];
+            Total += Samples[R * MaxStages + s];
+        }
+        Out << "," << Total;
+        for (size_t c = 0; c < Counters.size(); c++)
+            Out << "," << Counts[R * MaxCounters + c];
+        Out << "\n";
+    }
+    return static_cast<bool>(Out);
+}
+
+bool FrameBudgetProfiler::ExportJSON(const std::string &Path, double BudgetMs) const
+{
+    std::ofstream Out(Path, std::ios::out | std::ios::trunc);
+    if (!Out)
+        return false;
+    Out << "{\"budget_ms\": " << BudgetMs << ", \"stages\": [";
+    for (size_t s = 0; s < Stages.size(); s++)
+        Out << (s ? ", " : "") << "\"" << Stages[s] << "\"";
+    Out << "], \"counters\": [";
+    for (size_t c = 0; c < Counters.size(); c++)
+        Out << (c ? ", " : "") << "\"" << Counters[c] << "\"";
+    Out << "],\n \"summary\": [";
+    bool bFirst = true;
+    for (const StageSummary &S : Summarize(BudgetMs))
+    {
+        Out << (bFirst ? "" : ",") << "\n  {\"name\": \"" << S.Name << "\", \"mean\": " << S.Mean
+            << ", \"p50\": " << S.P50 << ", \"p95\": " << S.P95 << ", \"p99\": " << S.P99 << ", \"max\": " << S.Max
+            << ", \"over_budget\": " << S.OverBudget << "}";
+        bFirst = false;
+    }
+    Out << "],\n \"counter_summary\": [";
+    bFirst = true;
+    for (const StageSummary &S : SummarizeCounters())
+    {
+        Out << (bFirst ? "" : ",") << "\n  {\"name\": \"" << S.Name << "\", \"mean\": " << S.Mean
+            << ", \"p50\": " << S.P50 << ", \"p95\": " << S.P95 << ", \"p99\": " << S.P99 << ", \"max\": " << S.Max
+            << "}";
+        bFirst = false;
+    }
+    Out << "],\n \"frames\": [";
+    for (size_t i = 0; i < Count; i++)
+    {
+        const size_t R = Row(i);
+        Out << (i ? "," : "") << "\n  {\"frame\": " << FrameIds[R] << ", \"frame_ms\": " << FrameTimes[R]
+            << ", \"stages_ms\": [";
+        for (size_t s = 0; s < Stages.size(); s++)
+            Out << (s ? ", " : "") << Samples[R * MaxStages + s];
+        Out << "], \"counts\": [";
+        for (size_t c = 0; c < Counters.size(); c++)
+            Out << (c ? ", " : "") << Counts[R * MaxCounters + c];
+        Out << "]}";
+    }
+    Out << "]}\n";
+    return static_cast<bool>(Out);
+}
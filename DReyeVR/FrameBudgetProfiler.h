@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Always-on per-frame timings of the stages of the ego tick (EgoVehicle, DReyeVRPawn, ...), kept in a fixed ring of
+// the last N frames so it is cheap enough to leave enabled in packaged builds. Each stage also opens an Unreal
+// Insights scope (TRACE_CPUPROFILER_EVENT_SCOPE) for detailed captures. Per-frame counters (ex. render state updates)
+// are kept next to the timings. Only used from the game thread.
+
+#if __has_include("ProfilingDebugging/CpuProfilerTrace.h")
+#include "ProfilingDebugging/CpuProfilerTrace.h" // TRACE_CPUPROFILER_EVENT_SCOPE
+#endif
+#ifndef TRACE_CPUPROFILER_EVENT_SCOPE
+#define TRACE_CPUPROFILER_EVENT_SCOPE(Name) // standalone (no Unreal)
+#endif
+
+// time the rest of the enclosing scope as the stage "Name", ex. DREYEVR_PROFILE_STAGE(EgoVehicle_UpdateSensor);
+#define DREYEVR_PROFILE_STAGE(Name)                                                                                    \
+    TRACE_CPUPROFILER_EVENT_SCOPE(Name);                                                                               \
+    static const int DReyeVRStage_##Name = FrameBudgetProfiler::Get().RegisterStage(#Name);                            \
+    const FrameBudgetProfiler::Scope DReyeVRStageScope_##Name(FrameBudgetProfiler::Get(), DReyeVRStage_##Name)
+
+// add N to the counter "Name" of this frame, ex. DREYEVR_PROFILE_COUNT(Cockpit_TextUpdates, 1);
+#define DREYEVR_PROFILE_COUNT(Name, N)                                                                                 \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        static const int DReyeVRCounter_##Name = FrameBudgetProfiler::Get().RegisterCounter(#Name);                    \
+        FrameBudgetProfiler::Get().AddCount(DReyeVRCounter_##Name, N);                                                 \
+    } while (0)
+
+class FrameBudgetProfiler
+{
+  public:
+    static constexpr int MaxStages = 32;
+    static constexpr int MaxCounters = 16;
+
+    explicit FrameBudgetProfiler(size_t NumFrames = 1024);
+
+    // process-wide instance (what DREYEVR_PROFILE_STAGE records into)
+    static FrameBudgetProfiler &Get();
+
+    int RegisterStage(const std::string &Name);   // index of the stage (same name, same index), < 0 if full
+    int RegisterCounter(const std::string &Name); // same for counters
+    void SetEnabled(bool bEnabled);
+    void Resize(size_t NumFrames); // clears the ring
+    void Clear();
+
+    // start a new row in the ring (once per frame, before any stage of that frame)
+    void BeginFrame(uint64_t FrameId, double FrameMs);
+    void AddTime(int Stage, double Ms); // accumulates if a stage runs more than once per frame
+    void AddCount(int Counter, uint32_t N = 1);
+
+    class Scope
+    {
+      public:
+        Scope(FrameBudgetProfiler &Profiler, int Stage)
+            : Profiler(Profiler), Stage(Stage), Start(std::chrono::steady_clock::now())
+        {
+        }
+        ~Scope()
+        {
+            const std::chrono::duration<double, std::milli> Elapsed = std::chrono::steady_clock::now() - Start;
+            Profiler.AddTime(Stage, Elapsed.count());
+        }
+
+      private:
+        FrameBudgetProfiler &Profiler;
+        const int Stage;
+        const std::chrono::steady_clock::time_point Start;
+    };
+
+    struct StageSummary
+    {
+        std::string Name; // "Total" is the sum of all stages, "Frame" the frame time passed to BeginFrame
+        double Mean = 0, P50 = 0, P95 = 0, P99 = 0, Max = 0; // milliseconds (per frame for counters)
+        size_t OverBudget = 0; // frames above the budget (Total and Frame only)
+    };
+    std::vector<StageSummary> Summarize(double BudgetMs) const; // over the frames in the ring
+    std::vector<StageSummary> SummarizeCounters() const;
+    std::string SummaryString(double BudgetMs) const;            // human readable table (for the log)
+    size_t NumFrames() const
+    {
+        return Count;
+    }
+
+    // one row per frame (oldest first) with a column per stage (and per counter)
+    bool ExportCSV(const std::string &Path) const;
+    bool ExportJSON(const std::string &Path, double BudgetMs) const; // includes the summary
+
+  private:
+    size_t Row(size_t i) const; // ring index of the i'th oldest frame
+
+    std::vector<std::string> Stages;
+    std::vector<float> Samples;      // [frame][MaxStages] ms
+    std::vector<std::string> Counters;
+    std::vector<uint32_t> Counts;    // [frame][MaxCounters]
+    std::vector<uint64_t> FrameIds;  // [frame]
+    std::vector<float> FrameTimes;   // [frame] ms
+    size_t Capacity;
+    size_t Head = 0;  // row of the current frame
+    size_t Count = 0; // rows in use
+    bool bEnabled = true;
+};
@@ -0,0 +1,255 @@
+#include "FrameStreamSink.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+
+namespace
+{
+FramePixelBuffer MetaOf(const FramePixelBuffer &Frame)
+{
+    // everything but the (large) pixel array
+    FramePixelBuffer Meta;
+    Meta.Width = Frame.Width;
+    Meta.Height = Frame.Height;
+    Meta.FrameIdx = Frame.FrameIdx;
+    Meta.Filename = Frame.Filename;
+    Meta.Stream = Frame.Stream;
+    Meta.RecordingFrame = Frame.RecordingFrame;
+    Meta.RecordingTime = Frame.RecordingTime;
+    return Meta;
+}
+
+std::string BaseName(const std::string &Path)
+{
+    const size_t Slash = Path.find_last_of("/\\");
+    return Slash == std::string::npos ? Path : Path.substr(Slash + 1);
+}
+
+const char Y4MFrameHeader[] = "FRAME\n";
+} // namespace
+
+bool ParseFrameSinkFormat(const std::string &Name, EFrameSinkFormat &Format)
+{
+    std::string Lower = Name;
+    std::transform(Lower.begin(), Lower.end(), Lower.begin(), [](unsigned char C) { return std::tolower(C); });
+    if (Lower == "files")
+        Format = EFrameSinkFormat::Files;
+    else if (Lower == "mjpeg")
+        Format = EFrameSinkFormat::MJPEG;
+    else if (Lower == "y4m")
+        Format = EFrameSinkFormat::Y4M;
+    else if (Lower == "raw")
+        Format = EFrameSinkFormat::Raw;
+    else
+        return false;
+    return true;
+}
+
+const char *FrameSinkExtension(EFrameSinkFormat Format)
+{
+    switch (Format)
+    {
+    case EFrameSinkFormat::MJPEG:
+        return "mjpeg";
+    case EFrameSinkFormat::Y4M:
+        return "y4m";
+    case EFrameSinkFormat::Raw:
+        return "raw";
+    default:
+        return "";
+    }
+}
+
+FrameStreamSink::FrameStreamSink(const std::string &Directory, EFrameSinkFormat Format, int FramesPerSecond,
+                                 uint64_t FirstFrameIdx)
+    : Directory(Directory), Format(Format), FramesPerSecond(std::max(FramesPerSecond, 1)), FirstFrameIdx(FirstFrameIdx)
+{
+}
+
+FrameStreamSink::~FrameStreamSink()
+{
+    Close();
+}
+
+std::string FrameStreamSink::GetIndexFilename(const std::string &Directory, const std::string &Stream)
+{
+    return Directory + "/" + Stream + ".index.csv";
+}
+
+const char *FrameStreamSink::IndexHeader()
+{
+    return "frame,recording_frame,recording_time,file,offset,bytes,width,height";
+}
+
+void FrameStreamSink::ConvertToYUV444(const FramePixelBuffer &Frame, std::vector<uint8_t> &Out)
+{
+    const size_t NumPixels = static_cast<size_t>(Frame.Width) * Frame.Height;
+    Out.resize(3 * NumPixels);
+    uint8_t *Y = Out.data();
+    uint8_t *U = Y + NumPixels;
+    uint8_t *V = U + NumPixels;
+    const uint8_t *Src = Frame.Pixels.data();
+    for (size_t i = 0; i < NumPixels; i++, Src += 4)
+    {
+        // integer BT.601 (limited range), Src is BGRA
+        const int B = Src[0], G = Src[1], R = Src[2];
+        Y[i] = static_cast<uint8_t>(((66 * R + 129 * G + 25 * B + 128) >> 8) + 16);
+        U[i] = static_cast<uint8_t>(((-38 * R - 74 * G + 112 * B + 128) >> 8) + 128);
+        V[i] = static_cast<uint8_t>(((112 * R - 94 * G - 18 * B + 128) >> 8) + 128);
+    }
+}
+
+FrameStreamSink::FStream &FrameStreamSink::GetStream(const std::string &Name)
+{
+    std::lock_guard<std::mutex> Lock(StreamsMutex);
+    std::unique_ptr<FStream> &Stream = Streams[Name];
+    if (Stream == nullptr)
+    {
+        Stream = std::make_unique<FStream>();
+        Stream->Name = Name;
+        Stream->NextFrameIdx = FirstFrameIdx;
+    }
+    return *Stream;
+}
+
+bool FrameStreamSink::Append(const FramePixelBuffer &Frame, std::vector<uint8_t> &&Payload)
+{
+    return Enqueue(Frame, std::move(Payload));
+}
+
+bool FrameStreamSink::Append(FramePixelBuffer &Frame)
+{
+    std::vector<uint8_t> Payload;
+    if (!Frame.Pixels.empty()) // otherwise a dropped frame, which still has to advance the stream
+    {
+        if (Frame.Pixels.size() < 4 * static_cast<size_t>(Frame.Width) * Frame.Height)
+            Frame.Pixels.clear(); // malformed, skip it
+        else if (Format == EFrameSinkFormat::Y4M)
+            ConvertToYUV444(Frame, Payload);
+        else if (Format == EFrameSinkFormat::Raw)
+            Payload = std::move(Frame.Pixels);
+        else
+            return false; // needs an image encoder, see Append(Frame, Payload)
+    }
+    const bool bHasPixels = !Payload.empty();
+    return Enqueue(Frame, std::move(Payload)) && bHasPixels;
+}
+
+bool FrameStreamSink::Enqueue(const FramePixelBuffer &Frame, std::vector<uint8_t> &&Payload)
+{
+    FStream &Stream = GetStream(Frame.Stream.empty() ? "frames" : Frame.Stream);
+    std::lock_guard<std::mutex> Lock(Stream.Mutex);
+    if (Frame.FrameIdx < Stream.NextFrameIdx || Stream.OutOfOrder.count(Frame.FrameIdx) > 0)
+        return false; // duplicate, or arrived after the stream was drained past it
+    FPendingFrame &Pending = Stream.OutOfOrder[Frame.FrameIdx];
+    Pending = FPendingFrame{MetaOf(Frame), std::move(Payload)};
+    if (Frame.FrameIdx != Stream.NextFrameIdx)
+    {
+        // waits in memory for an earlier frame, past the reservation the writer pool gives back after this returns
+        Pending.bHeld = (Budget != nullptr);
+        if (Pending.bHeld)
+            Budget->Hold(Pending.Payload.size());
+        return true;
+    }
+    DrainInOrder(Stream, false);
+    return true;
+}
+
+void FrameStreamSink::DrainInOrder(FStream &Stream, bool bIgnoreGaps)
+{
+    // requires Stream.Mutex
+    while (!Stream.OutOfOrder.empty())
+    {
+        auto It = Stream.OutOfOrder.begin();
+        if (It->first != Stream.NextFrameIdx && !bIgnoreGaps)
+            break; // still waiting for an earlier frame
+        if (!It->second.Payload.empty())
+            WriteFrame(Stream, It->second.Meta, It->second.Payload);
+        Stream.NextFrameIdx = It->first + 1;
+        if (It->second.bHeld && Budget != nullptr)
+            Budget->Release(It->second.Payload.size());
+        Stream.OutOfOrder.erase(It);
+    }
+}
+
+bool FrameStreamSink::OpenStream(FStream &Stream, const FramePixelBuffer &First)
+{
+    Stream.bOpen = true;
+    Stream.Width = First.Width;
+    Stream.Height = First.Height;
+    Stream.Index.open(GetIndexFilename(Directory, Stream.Name), std::ios::trunc);
+    Stream.Index << IndexHeader() << "\n";
+    if (Format == EFrameSinkFormat::Files)
+        return Stream.Index.good();
+
+    Stream.Container.open(Directory + "/" + Stream.Name + "." + FrameSinkExtension(Format),
+                          std::ios::binary | std::ios::trunc);
+    if (Format == EFrameSinkFormat::Y4M)
+    {
+        // the whole stream has the dimensions of its first frame
+        char Header[128];
+        const int Len = std::snprintf(Header, sizeof(Header), "YUV4MPEG2 W%u H%u F%d:1 Ip A1:1 C444\n", First.Width,
+                                      First.Height, FramesPerSecond);
+        Stream.Container.write(Header, Len);
+        Stream.Offset = static_cast<uint64_t>(Len);
+    }
+    return Stream.Index.good() && Stream.Container.good();
+}
+
+bool FrameStreamSink::WriteFrame(FStream &Stream, const FramePixelBuffer &Meta, const std::vector<uint8_t> &Payload)
+{
+    // requires Stream.Mutex
+    if (!Stream.bOpen && !OpenStream(Stream, Meta))
+        return false;
+
+    std::string File;
+    uint64_t Offset = 0;
+    if (Format == EFrameSinkFormat::Files)
+    {
+        std::ofstream Image(Meta.Filename, std::ios::binary | std::ios::trunc);
+        Image.write(reinterpret_cast<const char *>(Payload.data()), Payload.size());
+        if (!Image)
+            return false;
+        File = BaseName(Meta.Filename);
+    }
+    else
+    {
+        if (Format == EFrameSinkFormat::Y4M)
+        {
+            if (Meta.Width != Stream.Width || Meta.Height != Stream.Height)
+                return false; // the dimensions cannot change within a y4m stream
+            Stream.Container.write(Y4MFrameHeader, sizeof(Y4MFrameHeader) - 1);
+            Stream.Offset += sizeof(Y4MFrameHeader) - 1;
+        }
+        Offset = Stream.Offset;
+        Stream.Container.write(reinterpret_cast<const char *>(Payload.data()), Payload.size());
+        if (!Stream.Container)
+            return false;
+        Stream.Offset += Payload.size();
+        File = Stream.Name + "." + FrameSinkExtension(Format);
+    }
+
+    char Row[512];
+    std::snprintf(Row, sizeof(Row), "%llu,%llu,%.6f,%s,%llu,%zu,%u,%u\n",
+                  static_cast<unsigned long long>(Meta.FrameIdx), static_cast<unsigned long long>(Meta.RecordingFrame),
+                  Meta.RecordingTime, File.c_str(), static_cast<unsigned long long>(Offset), Payload.size(),
+                  Meta.Width, Meta.Height);
+    Stream.Index << Row;
+    return static_cast<bool>(Stream.Index);
+}
+
+void FrameStreamSink::Close()
+{
+    std::lock_guard<std::mutex> Lock(StreamsMutex);
+    for (auto &Entry : Streams)
+    {
+        FStream &Stream = *Entry.second;
+        std::lock_guard<std::mutex> StreamLock(Stream.Mutex);
+        DrainInOrder(Stream, true);
+        if (Stream.Container.is_open())
+            Stream.Container.close();
+        if (Stream.Index.is_open())
+            Stream.Index.close();
+    }
+}
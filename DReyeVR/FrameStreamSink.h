@@ -0,0 +1,105 @@
+#pragma once
+
+#include "FrameWriterPool.h" // FramePixelBuffer
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Destination of the replay frame capture. Instead of one file per shader/pose/frame, the container formats append
+// every frame of a shader/pose stream (FramePixelBuffer::Stream) to a single file:
+//  - MJPEG: concatenated JPEG images (ffmpeg -f mjpeg -i <stream>.mjpeg ...)
+//  - Y4M:   uncompressed YUV4MPEG2 (4:4:4, BT.601 limited range), playable/encodable by most video tools
+//  - Raw:   tightly packed 8-bit BGRA frames
+// Every stream also gets a <stream>.index.csv mapping each captured frame to the replayed recording frame/time and its
+// location (file, byte offset, size). Files mode keeps the individual images but still writes the index.
+// Append is called from the FrameWriterPool threads so frames of a stream can finish out of order; they are buffered
+// and written in FrameIdx order (frames that could not be captured are passed with no pixels and skipped).
+
+enum class EFrameSinkFormat
+{
+    Files,
+    MJPEG,
+    Y4M,
+    Raw,
+};
+
+bool ParseFrameSinkFormat(const std::string &Name, EFrameSinkFormat &Format); // case-insensitive
+const char *FrameSinkExtension(EFrameSinkFormat Format);                     // container extension (no dot)
+
+class FrameStreamSink
+{
+  public:
+    // FirstFrameIdx is the FrameIdx every stream starts at (ex. the first frame of a replayed frame range)
+    FrameStreamSink(const std::string &Directory, EFrameSinkFormat Format, int FramesPerSecond = 30,
+                    uint64_t FirstFrameIdx = 0);
+    ~FrameStreamSink(); // writes any buffered frames and closes all streams
+
+    // append a frame whose Payload is already in the stream's format (JPEG for MJPEG, PNG/JPG for Files)
+    bool Append(const FramePixelBuffer &Frame, std::vector<uint8_t> &&Payload);
+    // append a frame, converting its BGRA pixels in place (Y4M and Raw only, the image formats need an encoder)
+    bool Append(FramePixelBuffer &Frame);
+    // write out everything that is buffered (even with gaps) and close all streams
+    void Close();
+
+    // frames buffered out of order count against the in-flight budget of this pool (FrameWriterPool::Hold) until
+    // they are written; set before the first Append, and reset (nullptr) before the pool is destroyed
+    void SetBudget(FrameWriterPool *Pool)
+    {
+        Budget = Pool;
+    }
+
+    EFrameSinkFormat GetFormat() const
+    {
+        return Format;
+    }
+    bool NeedsImageEncoder() const
+    {
+        return Format == EFrameSinkFormat::Files || Format == EFrameSinkFormat::MJPEG;
+    }
+
+    static std::string GetIndexFilename(const std::string &Directory, const std::string &Stream);
+    static const char *IndexHeader();
+    // BGRA -> planar Y, U, V (4:4:4)
+    static void ConvertToYUV444(const FramePixelBuffer &Frame, std::vector<uint8_t> &Out);
+
+  private:
+    struct FPendingFrame
+    {
+        FramePixelBuffer Meta; // no pixels
+        std::vector<uint8_t> Payload;
+        bool bHeld = false; // Payload counted against Budget
+    };
+    struct FStream
+    {
+        std::mutex Mutex;
+        std::string Name;
+        std::ofstream Container; // unused in Files mode
+        std::ofstream Index;
+        uint64_t Offset = 0;
+        uint64_t NextFrameIdx = 0;
+        uint32_t Width = 0; // of the first frame
+        uint32_t Height = 0;
+        std::map<uint64_t, FPendingFrame> OutOfOrder; // keyed by FrameIdx
+        bool bOpen = false;
+    };
+
+    FStream &GetStream(const std::string &Name);
+    bool Enqueue(const FramePixelBuffer &Frame, std::vector<uint8_t> &&Payload);
+    bool OpenStream(FStream &Stream, const FramePixelBuffer &First);
+    bool WriteFrame(FStream &Stream, const FramePixelBuffer &Meta, const std::vector<uint8_t> &Payload);
+    void DrainInOrder(FStream &Stream, bool bIgnoreGaps);
+
+    const std::string Directory;
+    const EFrameSinkFormat Format;
+    const int FramesPerSecond;
+    const uint64_t FirstFrameIdx;
+    FrameWriterPool *Budget = nullptr;
+    std::mutex StreamsMutex;
+    std::unordered_map<std::string, std::unique_ptr<FStream>> Streams;
+};
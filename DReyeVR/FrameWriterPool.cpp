@@ -0,0 +1,145 @@
+#include "FrameWriterPool.h"
+
+#include <algorithm>
+#include <fstream>
+
+FrameWriterPool::FrameWriterPool(EncodeFunction Encoder, size_t NumWorkers, size_t MaxInFlightBytes)
+    : Encoder(std::move(Encoder)), MaxInFlightBytes(MaxInFlightBytes)
+{
+    NumWorkers = std::max<size_t>(NumWorkers, 1);
+    Workers.reserve(NumWorkers);
+    for (size_t i = 0; i < NumWorkers; i++)
+        Workers.emplace_back(&FrameWriterPool::WorkerLoop, this);
+}
+
+FrameWriterPool::~FrameWriterPool()
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        bStopping = true;
+    }
+    WorkAvailable.notify_all();
+    for (std::thread &Worker : Workers)
+        Worker.join();
+}
+
+bool FrameWriterPool::HasBudget(size_t Bytes) const
+{
+    // a single buffer larger than the whole budget is still let through once nothing else is in flight
+    return Stats.InFlightBytes == 0 || Stats.InFlightBytes + Bytes <= MaxInFlightBytes;
+}
+
+void FrameWriterPool::Reserve(size_t Bytes)
+{
+    std::unique_lock<std::mutex> Lock(Mutex);
+    if (!HasBudget(Bytes))
+    {
+        Stats.Stalls++;
+        BudgetFreed.wait(Lock, [&] { return HasBudget(Bytes); });
+    }
+    Stats.InFlightBytes += Bytes;
+    Stats.PeakInFlightBytes = std::max(Stats.PeakInFlightBytes, Stats.InFlightBytes);
+}
+
+bool FrameWriterPool::TryReserve(size_t Bytes)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    if (!HasBudget(Bytes))
+        return false;
+    Stats.InFlightBytes += Bytes;
+    Stats.PeakInFlightBytes = std::max(Stats.PeakInFlightBytes, Stats.InFlightBytes);
+    return true;
+}
+
+void FrameWriterPool::Hold(size_t Bytes)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Stats.InFlightBytes += Bytes;
+    Stats.PeakInFlightBytes = std::max(Stats.PeakInFlightBytes, Stats.InFlightBytes);
+}
+
+void FrameWriterPool::Release(size_t Bytes)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Stats.InFlightBytes -= std::min(Bytes, Stats.InFlightBytes);
+    }
+    BudgetFreed.notify_all();
+}
+
+void FrameWriterPool::Submit(FramePixelBuffer &&Buffer)
+{
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Queue.push_back(std::move(Buffer));
+        Stats.QueueDepth = Queue.size();
+        Stats.PeakQueueDepth = std::max(Stats.PeakQueueDepth, Stats.QueueDepth);
+    }
+    WorkAvailable.notify_one();
+}
+
+void FrameWriterPool::Flush()
+{
+    std::unique_lock<std::mutex> Lock(Mutex);
+    BudgetFreed.wait(Lock, [&] { return Queue.empty() && Stats.Encoding == 0; });
+}
+
+FrameWriterStats FrameWriterPool::GetStats() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Stats;
+}
+
+void FrameWriterPool::WorkerLoop()
+{
+    while (true)
+    {
+        FramePixelBuffer Buffer;
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            WorkAvailable.wait(Lock, [&] { return bStopping || !Queue.empty(); });
+            if (Queue.empty()) // only when stopping, and all the queued work is done
+                return;
+            Buffer = std::move(Queue.front());
+            Queue.pop_front();
+            Stats.QueueDepth = Queue.size();
+            Stats.Encoding++;
+        }
+
+        const size_t Bytes = Buffer.Bytes();
+        const bool bSuccess = Encoder ? Encoder(Buffer) : false;
+
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Stats.Encoding--;
+            Stats.InFlightBytes -= std::min(Bytes, Stats.InFlightBytes);
+            (bSuccess ? Stats.Written : Stats.Failed)++;
+        }
+        BudgetFreed.notify_all();
+    }
+}
+
+bool FrameWriterPool::WritePPM(FramePixelBuffer &Buffer)
+{
+    const size_t NumPixels = static_cast<size_t>(Buffer.Width) * Buffer.Height;
+    if (Buffer.Pixels.size() < 4 * NumPixels)
+        return false;
+    std::ofstream Out(Buffer.Filename, std::ios::binary | std::ios::trunc);
+    if (!Out.is_open())
+        return false;
+    Out << "P6\n" << Buffer.Width << " " << Buffer.Height << "\n255\n";
+    // BGRA -> RGB, one row at a time
+    std::vector<uint8_t> Row(3 * static_cast<size_t>(Buffer.Width));
+    for (uint32_t y = 0; y < Buffer.Height; y++)
+    {
+        const uint8_t *Src = Buffer.Pixels.data() + 4 * static_cast<size_t>(y) * Buffer.Width;
+        for (uint32_t x = 0; x < Buffer.Width; x++)
+        {
+            Row[3 * x + 0] = Src[4 * x + 2];
+            Row[3 * x + 1] = Src[4 * x + 1];
+            Row[3 * x + 2] = Src[4 * x + 0];
+        }
+        Out.write(reinterpret_cast<const char *>(Row.data()), Row.size());
+    }
+    return static_cast<bool>(Out);
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// CPU half of the asynchronous frame capture: pixel buffers produced by the GPU readbacks are handed to a small pool
+// of worker threads that encode and write them, so the game thread never waits on compression or file IO.
+// Every buffer that is in flight (reserved for a pending GPU readback, queued, or being encoded) counts against a
+// byte budget, and Reserve blocks once that budget is exhausted so a slow disk throttles the capture instead of
+// growing memory without bound.
+
+struct FramePixelBuffer
+{
+    std::vector<uint8_t> Pixels; // tightly packed rows, 8-bit BGRA
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint64_t FrameIdx = 0; // screenshot index this buffer belongs to
+    std::string Filename;  // destination file (utf-8), for the individual image files
+    std::string Stream;    // shader/pose stream this frame belongs to (see FrameStreamSink)
+    uint64_t RecordingFrame = 0; // id of the replayed recording frame
+    double RecordingTime = 0.0;  // elapsed time of the replayed recording frame (seconds)
+
+    size_t Bytes() const
+    {
+        return Pixels.size();
+    }
+};
+
+struct FrameWriterStats
+{
+    size_t QueueDepth = 0;        // buffers waiting for a worker
+    size_t Encoding = 0;          // buffers currently being encoded/written
+    size_t InFlightBytes = 0;     // reserved + queued + encoding + held
+    size_t PeakQueueDepth = 0;    // max QueueDepth so far
+    size_t PeakInFlightBytes = 0; // max InFlightBytes so far
+    uint64_t Written = 0;         // successfully encoded buffers
+    uint64_t Failed = 0;          // buffers the encoder rejected
+    uint64_t Stalls = 0;          // Reserve calls that had to wait for budget
+};
+
+class FrameWriterPool
+{
+  public:
+    // the encoder runs on the worker threads and may modify the buffer in place (ex. to fix up the alpha channel)
+    using EncodeFunction = std::function<bool(FramePixelBuffer &)>;
+
+    FrameWriterPool(EncodeFunction Encoder, size_t NumWorkers, size_t MaxInFlightBytes);
+    ~FrameWriterPool(); // writes everything still queued, then joins the workers
+
+    // claim Bytes of the in-flight budget, every reservation must be followed by Submit or Release
+    void Reserve(size_t Bytes);    // blocks while the budget is exhausted
+    bool TryReserve(size_t Bytes); // never blocks
+    void Release(size_t Bytes);    // give back a reservation that will not be submitted (ex. failed readback)
+    // count bytes that stay in memory after their encode (ex. frames a FrameStreamSink buffers out of order) against
+    // the budget, never blocks, give them back with Release
+    void Hold(size_t Bytes);
+
+    // queue a buffer for encoding, consumes a reservation of Buffer.Bytes()
+    void Submit(FramePixelBuffer &&Buffer);
+
+    // block until every submitted buffer has been encoded
+    void Flush();
+
+    FrameWriterStats GetStats() const;
+    size_t GetMaxInFlightBytes() const
+    {
+        return MaxInFlightBytes;
+    }
+
+    // minimal encoder writing binary PPM (P6), useful for testing and for lossless dumps without any engine
+    static bool WritePPM(FramePixelBuffer &Buffer);
+
+  private:
+    void WorkerLoop();
+    bool HasBudget(size_t Bytes) const; // requires Mutex
+
+    EncodeFunction Encoder;
+    const size_t MaxInFlightBytes;
+    std::vector<std::thread> Workers;
+    std::deque<FramePixelBuffer> Queue;
+    mutable std::mutex Mutex;
+    std::condition_variable WorkAvailable; // workers wait on this
+    std::condition_variable BudgetFreed;   // Reserve and Flush wait on this
+    FrameWriterStats Stats;
+    bool bStopping = false;
+};
@@ -0,0 +1,162 @@
+#include "GazeLOD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static constexpr float RadToDeg = 57.2957795f;
+
+GazeLOD::GazeLOD(const GazeLODParams &ParamsIn)
+{
+    SetParams(ParamsIn);
+}
+
+void GazeLOD::SetParams(const GazeLODParams &NewParams)
+{
+    Params = NewParams;
+    Params.FovealDeg = std::max(0.f, Params.FovealDeg);
+    Params.NearPeripheryDeg = std::max(Params.FovealDeg, Params.NearPeripheryDeg);
+    Params.HysteresisDeg = std::max(0.f, Params.HysteresisDeg);
+    Params.HysteresisDistance = std::max(0.f, Params.HysteresisDistance);
+    Params.NearPeripheryMinLOD = std::max(0, Params.NearPeripheryMinLOD);
+    Params.FarPeripheryMinLOD = std::max(0, Params.FarPeripheryMinLOD);
+    Params.NearPeripheryCullScale = std::max(0.f, Params.NearPeripheryCullScale);
+    Params.FarPeripheryCullScale = std::max(0.f, Params.FarPeripheryCullScale);
+    Buckets.clear();
+    SinceUpdate = 1e9f;
+}
+
+bool GazeLOD::ShouldUpdate(float DeltaSeconds)
+{
+    SinceUpdate += DeltaSeconds;
+    if (Params.UpdateRateHz > 0.f && SinceUpdate < 1.f / Params.UpdateRateHz)
+        return false;
+    SinceUpdate = 0.f;
+    return true;
+}
+
+float GazeLOD::AngleTo(const GazeVector &Origin, const GazeVector &UnitDirection, const GazeVector &Center,
+                       float Radius)
+{
+    const float X = Center.X - Origin.X, Y = Center.Y - Origin.Y, Z = Center.Z - Origin.Z;
+    const float Dist = std::sqrt(X * X + Y * Y + Z * Z);
+    if (Dist <= Radius || Dist <= 0.f)
+        return 0.f; // the eye is inside the bounds
+    const float Cos = (X * UnitDirection.X + Y * UnitDirection.Y + Z * UnitDirection.Z) / Dist;
+    const float Angle = std::acos(std::min(1.f, std::max(-1.f, Cos)));
+    const float AngularRadius = std::asin(std::max(0.f, Radius) / Dist);
+    return std::max(0.f, Angle - AngularRadius) * RadToDeg;
+}
+
+GazeBucket GazeLOD::Classify(float AngleDeg, GazeBucket Previous) const
+{
+    // an edge at or beyond the previous bucket is only crossed outwards with the hysteresis
+    const float Edges[2] = {Params.FovealDeg, Params.NearPeripheryDeg};
+    int Bucket = 0;
+    for (int e = 0; e < 2; e++)
+    {
+        const bool bOutwards = Previous != GazeBucket::Released && e >= static_cast<int>(Previous);
+        if (AngleDeg > Edges[e] + (bOutwards ? Params.HysteresisDeg : 0.f))
+            Bucket = e + 1;
+    }
+    return static_cast<GazeBucket>(Bucket);
+}
+
+const std::vector<GazeLODChange> &GazeLOD::Update(const GazeVector &Origin, const GazeVector &Direction,
+                                                  const std::vector<GazeLODActor> &Actors)
+{
+    Updates++;
+    Pending.clear();
+
+    GazeVector Unit = Direction;
+    const float Len = std::sqrt(Unit.X * Unit.X + Unit.Y * Unit.Y + Unit.Z * Unit.Z);
+    if (Len > 0.f)
+        Unit = {Unit.X / Len, Unit.Y / Len, Unit.Z / Len};
+    else
+        Unit = {1.f, 0.f, 0.f}; // no gaze at all, looking straight ahead is the best guess
+
+    std::unordered_map<uint32_t, GazeBucket> Next;
+    Next.reserve(Actors.size());
+    const float MaxDistSq = Params.MaxDistance * Params.MaxDistance;
+    const float KeepDist = Params.MaxDistance + Params.HysteresisDistance;
+    const float KeepDistSq = KeepDist * KeepDist; // for the actors already managed, so none flickers at the edge
+    for (const GazeLODActor &A : Actors)
+    {
+        if (A.Id == 0)
+            continue;
+        const auto Prev = Buckets.find(A.Id);
+        const GazeBucket Previous = (Prev != Buckets.end()) ? Prev->second : GazeBucket::Released;
+        const float X = A.Location.X - Origin.X, Y = A.Location.Y - Origin.Y, Z = A.Location.Z - Origin.Z;
+        if (X * X + Y * Y + Z * Z > (Previous == GazeBucket::Released ? MaxDistSq : KeepDistSq))
+            continue;
+        ActorsSeen++;
+        const GazeBucket Bucket = Classify(AngleTo(Origin, Unit, A.Location, A.BoundsRadius), Previous);
+        Next[A.Id] = Bucket;
+        if (Bucket != Previous)
+            Pending.push_back({A.Id, Bucket});
+    }
+    // actors that left (too far or gone) go back to their own settings
+    for (const auto &IdAndBucket : Buckets)
+    {
+        if (Next.find(IdAndBucket.first) == Next.end())
+            Pending.push_back({IdAndBucket.first, GazeBucket::Released});
+    }
+    Buckets.swap(Next);
+    Changes += Pending.size();
+    return Pending;
+}
+
+GazeBucket GazeLOD::GetBucket(uint32_t Id) const
+{
+    const auto Found = Buckets.find(Id);
+    return (Found != Buckets.end()) ? Found->second : GazeBucket::Released;
+}
+
+int GazeLOD::NumInBucket(GazeBucket Bucket) const
+{
+    return static_cast<int>(std::count_if(Buckets.begin(), Buckets.end(),
+                                          [Bucket](const std::pair<const uint32_t, GazeBucket> &IdAndBucket) {
+                                              return IdAndBucket.second == Bucket;
+                                          }));
+}
+
+int GazeLOD::GetMinLOD(GazeBucket Bucket) const
+{
+    switch (Bucket)
+    {
+    case GazeBucket::NearPeriphery:
+        return Params.NearPeripheryMinLOD;
+    case GazeBucket::FarPeriphery:
+        return Params.FarPeripheryMinLOD;
+    default:
+        return 0;
+    }
+}
+
+float GazeLOD::GetCullScale(GazeBucket Bucket) const
+{
+    switch (Bucket)
+    {
+    case GazeBucket::NearPeriphery:
+        return Params.NearPeripheryCullScale;
+    case GazeBucket::FarPeriphery:
+        return Params.FarPeripheryCullScale;
+    default:
+        return 1.f;
+    }
+}
+
+double GazeLOD::MeanActors() const
+{
+    return Updates == 0 ? 0.0 : static_cast<double>(ActorsSeen) / Updates;
+}
+
+std::string GazeLOD::SummaryString() const
+{
+    char Line[192];
+    std::snprintf(Line, sizeof(Line), "gaze LOD: %d foveal, %d near and %d far periphery actors, %llu bucket changes "
+                  "in %llu updates (%.1f actors per update)", NumInBucket(GazeBucket::Foveal),
+                  NumInBucket(GazeBucket::NearPeriphery), NumInBucket(GazeBucket::FarPeriphery),
+                  static_cast<unsigned long long>(Changes), static_cast<unsigned long long>(Updates), MeanActors());
+    return Line;
+}
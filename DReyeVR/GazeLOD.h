@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Sorts the actors within MaxDistance of the driver into angular buckets around the gaze ray (foveal, near and far
+// periphery), re-evaluated UpdateRateHz times a second, so the periphery can be drawn with coarser mesh LODs and
+// shorter cull distances. The angle is measured to the edge of the actor's bounding sphere, an actor only moves to an
+// outer bucket once HysteresisDeg past the edge (and back in right away), a managed actor is only released once
+// HysteresisDistance beyond MaxDistance, and only the changes are reported so the components are touched once per
+// change.
+
+enum class GazeBucket : uint8_t
+{
+    Foveal = 0,
+    NearPeriphery,
+    FarPeriphery,
+    Released, // no longer managed (too far, or gone): back to its own LOD and cull distance
+};
+
+struct GazeLODParams
+{
+    float FovealDeg = 10.f;               // edge of the foveal bucket, from the gaze ray
+    float NearPeripheryDeg = 30.f;        // edge of the near periphery, the far periphery is everything beyond
+    float MaxDistance = 150.f;            // (m) actors further away are left alone
+    float UpdateRateHz = 10.f;            // of the bucketing
+    float HysteresisDeg = 3.f;            // past an edge before moving outwards
+    float HysteresisDistance = 10.f;      // (m) beyond MaxDistance before a managed actor is released
+    int NearPeripheryMinLOD = 1;          // finest mesh LOD drawn in the near periphery (0: any)
+    int FarPeripheryMinLOD = 2;           // and in the far periphery
+    float NearPeripheryCullScale = 1.f;   // of the cull distance in the near periphery
+    float FarPeripheryCullScale = 0.75f;  // and in the far periphery
+};
+
+struct GazeVector
+{
+    float X = 0.f;
+    float Y = 0.f;
+    float Z = 0.f;
+};
+
+struct GazeLODActor
+{
+    uint32_t Id = 0;          // nonzero, unique among the actors of one update
+    GazeVector Location;      // (m) world space, same frame as the gaze
+    float BoundsRadius = 0.f; // (m)
+};
+
+struct GazeLODChange
+{
+    uint32_t Id;
+    GazeBucket Bucket;
+};
+
+class GazeLOD
+{
+  public:
+    explicit GazeLOD(const GazeLODParams &Params = GazeLODParams());
+
+    void SetParams(const GazeLODParams &NewParams); // forgets the buckets, every actor is reported again
+    const GazeLODParams &GetParams() const
+    {
+        return Params;
+    }
+
+    // true when the next update is due (UpdateRateHz), given the time since the last frame
+    bool ShouldUpdate(float DeltaSeconds);
+
+    // bucket every actor by its angle from the gaze ray (Origin in m, Direction need not be normalized) and return
+    // the actors whose bucket changed since the last update, including the Released ones
+    const std::vector<GazeLODChange> &Update(const GazeVector &Origin, const GazeVector &Direction,
+                                             const std::vector<GazeLODActor> &Actors);
+
+    GazeBucket GetBucket(uint32_t Id) const; // Released if not managed
+    int NumInBucket(GazeBucket Bucket) const;
+
+    int GetMinLOD(GazeBucket Bucket) const;     // 0: the mesh picks its LOD by screen size as usual
+    float GetCullScale(GazeBucket Bucket) const; // 1: unchanged
+
+    // degrees between the ray and the closest point of the sphere, 0 when the ray passes through it
+    static float AngleTo(const GazeVector &Origin, const GazeVector &UnitDirection, const GazeVector &Center,
+                         float Radius);
+
+    uint64_t NumUpdates() const
+    {
+        return Updates;
+    }
+    uint64_t NumChanges() const // bucket changes reported (component updates)
+    {
+        return Changes;
+    }
+    double MeanActors() const; // actors considered per update
+    std::string SummaryString() const;
+
+  private:
+    GazeBucket Classify(float AngleDeg, GazeBucket Previous) const;
+
+    GazeLODParams Params;
+    std::unordered_map<uint32_t, GazeBucket> Buckets; // of the managed actors
+    std::vector<GazeLODChange> Pending;
+    float SinceUpdate = 1e9f; // seconds
+    uint64_t Updates = 0;
+    uint64_t Changes = 0;
+    uint64_t ActorsSeen = 0;
+};
@@ -0,0 +1,192 @@
+#include "GazePredictor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+static constexpr float RadToDeg = 57.2957795f;
+
+static float WrapDeg(float Deg) // to [-180, 180)
+{
+    return Deg - 360.f * std::floor((Deg + 180.f) / 360.f);
+}
+
+static void ToAngles(const GazeDirection &Dir, float &Yaw, float &Pitch)
+{
+    Yaw = std::atan2(Dir.Y, Dir.X) * RadToDeg;
+    Pitch = std::atan2(Dir.Z, std::sqrt(Dir.X * Dir.X + Dir.Y * Dir.Y)) * RadToDeg;
+}
+
+static GazeDirection FromAngles(float Yaw, float Pitch)
+{
+    const float CosPitch = std::cos(Pitch / RadToDeg);
+    return {CosPitch * std::cos(Yaw / RadToDeg), CosPitch * std::sin(Yaw / RadToDeg), std::sin(Pitch / RadToDeg)};
+}
+
+GazePredictor::GazePredictor(const GazePredictorParams &ParamsIn)
+{
+    SetParams(ParamsIn);
+}
+
+void GazePredictor::SetParams(const GazePredictorParams &NewParams)
+{
+    Params = NewParams;
+    Params.LatencyMs = std::max(0.f, Params.LatencyMs);
+    Params.PositionGain = std::min(1.f, std::max(0.f, Params.PositionGain));
+    Params.VelocityGain = std::min(1.f, std::max(0.f, Params.VelocityGain));
+    Params.MaxExtrapolationDeg = std::max(0.f, Params.MaxExtrapolationDeg);
+    bHasState = false;
+    bInSaccade = false;
+}
+
+void GazePredictor::Restart(float NewYaw, float NewPitch, double TimeMs)
+{
+    bHasState = true;
+    LastTimeMs = TimeMs;
+    RawYaw = Yaw = NewYaw;
+    RawPitch = Pitch = NewPitch;
+    YawRate = PitchRate = 0.f;
+    Predicted = FromAngles(NewYaw, NewPitch);
+}
+
+const GazeDirection &GazePredictor::Update(const GazeSample &Sample)
+{
+    Samples++;
+    const GazeDirection &D = Sample.Dir;
+    if (!Sample.bValid || (D.X == 0.f && D.Y == 0.f && D.Z == 0.f))
+    {
+        bHasState = false; // blink or lost track, the eye can be anywhere afterwards
+        bInSaccade = false;
+        return Predicted;
+    }
+    float SampleYaw, SamplePitch;
+    ToAngles(D, SampleYaw, SamplePitch);
+
+    const double Dt = Sample.TimeMs - LastTimeMs;
+    if (!bHasState || Dt < 0.0 || Dt > Params.MaxGapMs)
+    {
+        bInSaccade = false;
+        Restart(SampleYaw, SamplePitch, Sample.TimeMs);
+        return Predicted;
+    }
+    if (Dt == 0.0)
+        return Predicted; // the tracker has nothing new
+
+    // saccade detection on the raw sample to sample speed (the filter would smear it)
+    const float StepYaw = WrapDeg(SampleYaw - RawYaw) * std::cos(SamplePitch / RadToDeg);
+    const float StepPitch = SamplePitch - RawPitch;
+    const float SpeedDegPerSec = std::sqrt(StepYaw * StepYaw + StepPitch * StepPitch) / static_cast<float>(Dt) * 1000.f;
+    if (SpeedDegPerSec > Params.SaccadeDegPerSec)
+    {
+        if (!bInSaccade)
+            Saccades++;
+        bInSaccade = true;
+        Restart(SampleYaw, SamplePitch, Sample.TimeMs); // fixate from wherever it lands
+        return Predicted;
+    }
+    bInSaccade = false;
+    RawYaw = SampleYaw;
+    RawPitch = SamplePitch;
+    LastTimeMs = Sample.TimeMs;
+
+    // alpha-beta filter of each angle
+    const float T = static_cast<float>(Dt);
+    const float ExpectedYaw = Yaw + YawRate * T;
+    const float ExpectedPitch = Pitch + PitchRate * T;
+    const float ResidualYaw = WrapDeg(SampleYaw - ExpectedYaw);
+    const float ResidualPitch = SamplePitch - ExpectedPitch;
+    Yaw = WrapDeg(ExpectedYaw + Params.PositionGain * ResidualYaw);
+    Pitch = ExpectedPitch + Params.PositionGain * ResidualPitch;
+    YawRate += Params.VelocityGain * ResidualYaw / T;
+    PitchRate += Params.VelocityGain * ResidualPitch / T;
+
+    // and extrapolate along the velocity
+    float AheadYaw = YawRate * Params.LatencyMs;
+    float AheadPitch = PitchRate * Params.LatencyMs;
+    const float Ahead = std::sqrt(AheadYaw * AheadYaw + AheadPitch * AheadPitch);
+    if (Ahead > Params.MaxExtrapolationDeg)
+    {
+        AheadYaw *= Params.MaxExtrapolationDeg / Ahead;
+        AheadPitch *= Params.MaxExtrapolationDeg / Ahead;
+    }
+    Predicted = FromAngles(Yaw + AheadYaw, std::min(89.f, std::max(-89.f, Pitch + AheadPitch)));
+    Extrapolated++;
+    return Predicted;
+}
+
+float GazePredictor::AngleBetween(const GazeDirection &A, const GazeDirection &B)
+{
+    const float LenA = std::sqrt(A.X * A.X + A.Y * A.Y + A.Z * A.Z);
+    const float LenB = std::sqrt(B.X * B.X + B.Y * B.Y + B.Z * B.Z);
+    if (LenA <= 0.f || LenB <= 0.f)
+        return 0.f;
+    const float Cos = (A.X * B.X + A.Y * B.Y + A.Z * B.Z) / (LenA * LenB);
+    return std::acos(std::min(1.f, std::max(-1.f, Cos))) * RadToDeg;
+}
+
+std::string GazePredictor::SummaryString() const
+{
+    char Line[160];
+    std::snprintf(Line, sizeof(Line), "gaze prediction: %llu of %llu samples extrapolated by %.1f ms, %llu saccades",
+                  static_cast<unsigned long long>(Extrapolated), static_cast<unsigned long long>(Samples),
+                  Params.LatencyMs, static_cast<unsigned long long>(Saccades));
+    return Line;
+}
+
+static void MeanAndP95(std::vector<double> &Errors, double &Mean, double &P95)
+{
+    if (Errors.empty())
+        return;
+    double Sum = 0.0;
+    for (double E : Errors)
+        Sum += E;
+    Mean = Sum / Errors.size();
+    const size_t Idx = static_cast<size_t>(std::ceil(0.95 * Errors.size())) - 1;
+    std::nth_element(Errors.begin(), Errors.begin() + Idx, Errors.end());
+    P95 = Errors[Idx];
+}
+
+GazePredictionError EvaluateGazePrediction(const std::vector<GazeSample> &Recorded, GazePredictorParams Params,
+                                           float LatencyMs)
+{
+    LatencyMs = std::max(0.f, LatencyMs);
+    Params.LatencyMs = LatencyMs;
+    GazePredictor Predictor(Params);
+    std::vector<double> HoldErrors, PredictedErrors;
+    size_t Next = 0; // first recorded sample at or after the time the prediction is for
+    for (size_t i = 0; i < Recorded.size(); i++)
+    {
+        const GazeSample &Sample = Recorded[i];
+        const GazeDirection Predicted = Predictor.Update(Sample);
+        if (!Sample.bValid)
+            continue;
+        const double Target = Sample.TimeMs + LatencyMs;
+        Next = std::max(Next, i);
+        while (Next < Recorded.size() && Recorded[Next].TimeMs < Target)
+            Next++;
+        if (Next >= Recorded.size())
+            break; // the recording ends before the prediction is due
+        // the gaze actually recorded at that time, interpolated between the samples around it
+        const GazeSample &After = Recorded[Next];
+        if (!After.bValid)
+            continue;
+        GazeDirection Truth = After.Dir;
+        if (After.TimeMs > Target)
+        {
+            const GazeSample &Before = Recorded[Next - 1]; // Next > i since Target >= Sample.TimeMs
+            if (!Before.bValid || After.TimeMs - Before.TimeMs > Params.MaxGapMs)
+                continue;
+            const float W = static_cast<float>((Target - Before.TimeMs) / (After.TimeMs - Before.TimeMs));
+            Truth = {Before.Dir.X + W * (After.Dir.X - Before.Dir.X), Before.Dir.Y + W * (After.Dir.Y - Before.Dir.Y),
+                     Before.Dir.Z + W * (After.Dir.Z - Before.Dir.Z)};
+        }
+        HoldErrors.push_back(GazePredictor::AngleBetween(Sample.Dir, Truth));
+        PredictedErrors.push_back(GazePredictor::AngleBetween(Predicted, Truth));
+    }
+    GazePredictionError Result;
+    Result.LatencyMs = LatencyMs;
+    Result.Samples = PredictedErrors.size();
+    MeanAndP95(HoldErrors, Result.HoldMeanDeg, Result.HoldP95Deg);
+    MeanAndP95(PredictedErrors, Result.PredictedMeanDeg, Result.PredictedP95Deg);
+    return Result;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Extrapolates the eye tracker's gaze by LatencyMs (sample to photons) so gaze-driven drawing is not a frame or two
+// behind the eye. Yaw and pitch of the gaze are tracked by an alpha-beta filter (the steady-state Kalman filter of a
+// constant-velocity model) and extrapolated along the filtered velocity. Faster than SaccadeDegPerSec the eye is in a
+// saccade, whose landing point cannot be extrapolated: the raw sample is used and the filter restarts, same as after
+// an invalid sample (blink) or a gap in the samples.
+
+struct GazePredictorParams
+{
+    float LatencyMs = 20.f;            // how far ahead of the latest sample the gaze is predicted
+    float PositionGain = 0.5f;         // alpha: share of the residual trusted (lower is smoother, but lags)
+    float VelocityGain = 0.1f;         // beta: how fast the velocity follows
+    float SaccadeDegPerSec = 150.f;    // sample to sample angular speed above which the eye is in a saccade
+    float MaxExtrapolationDeg = 5.f;   // bound on the distance between the predicted and the filtered gaze
+    float MaxGapMs = 100.f;            // samples further apart restart the filter
+};
+
+struct GazeDirection
+{
+    float X = 1.f; // forward
+    float Y = 0.f; // right
+    float Z = 0.f; // up
+};
+
+struct GazeSample
+{
+    double TimeMs = 0.0; // of the eye tracker (any clock, increasing)
+    GazeDirection Dir;   // need not be normalized
+    bool bValid = true;
+};
+
+class GazePredictor
+{
+  public:
+    explicit GazePredictor(const GazePredictorParams &Params = GazePredictorParams());
+
+    void SetParams(const GazePredictorParams &NewParams); // restarts the filter
+    const GazePredictorParams &GetParams() const
+    {
+        return Params;
+    }
+
+    // the predicted gaze (unit length) LatencyMs after the sample, the sample itself while it cannot be predicted
+    // (saccade, first after a gap), invalid and repeated (same time) samples return the previous prediction
+    const GazeDirection &Update(const GazeSample &Sample);
+    const GazeDirection &GetPredicted() const
+    {
+        return Predicted;
+    }
+    bool IsInSaccade() const
+    {
+        return bInSaccade;
+    }
+
+    uint64_t NumSamples() const
+    {
+        return Samples;
+    }
+    uint64_t NumPredicted() const // samples that were extrapolated
+    {
+        return Extrapolated;
+    }
+    uint64_t NumSaccades() const // saccade onsets
+    {
+        return Saccades;
+    }
+    std::string SummaryString() const;
+
+    // degrees between two directions
+    static float AngleBetween(const GazeDirection &A, const GazeDirection &B);
+
+  private:
+    void Restart(float Yaw, float Pitch, double TimeMs);
+
+    GazePredictorParams Params;
+    GazeDirection Predicted;
+    bool bHasState = false;
+    bool bInSaccade = false;
+    double LastTimeMs = 0.0;
+    float RawYaw = 0.f, RawPitch = 0.f; // (deg) last sample
+    float Yaw = 0.f, Pitch = 0.f;       // (deg) filtered
+    float YawRate = 0.f, PitchRate = 0.f; // (deg/ms) filtered
+    uint64_t Samples = 0;
+    uint64_t Extrapolated = 0;
+    uint64_t Saccades = 0;
+};
+
+// prediction error of a recorded gaze trace replayed through the predictor, against the recorded gaze LatencyMs
+// later (interpolated), next to the error of simply holding the latest sample
+struct GazePredictionError
+{
+    float LatencyMs = 0.f;
+    size_t Samples = 0; // with a valid recorded gaze LatencyMs later
+    double HoldMeanDeg = 0.0;
+    double HoldP95Deg = 0.0;
+    double PredictedMeanDeg = 0.0;
+    double PredictedP95Deg = 0.0;
+};
+
+GazePredictionError EvaluateGazePrediction(const std::vector<GazeSample> &Recorded, GazePredictorParams Params,
+                                           float LatencyMs);
@@ -0,0 +1,190 @@
+#include "HapticSharedControl.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+constexpr double Pi = 3.14159265358979323846;
+
+double Radians(double Deg)
+{
+    return Deg * Pi / 180.0;
+}
+
+double Degrees(double Rad)
+{
+    return Rad * 180.0 / Pi;
+}
+
+double Sign(double X)
+{
+    return (X > 0) - (X < 0);
+}
+
+double PyMod(double A, double B) // python's % (result has the sign of B)
+{
+    const double M = std::fmod(A, B);
+    return (M != 0 && ((M < 0) != (B < 0))) ? M + B : M;
+}
+} // namespace
+
+HapticSharedControl::HapticSharedControl(const HapticControlParams &ParamsIn) : Params(ParamsIn)
+{
+}
+
+void HapticSharedControl::SetTrajectory(const std::vector<double> &Xs, const std::vector<double> &Ys)
+{
+    const size_t N = std::min(Xs.size(), Ys.size());
+    PathX.assign(Xs.begin(), Xs.begin() + N);
+    PathY.assign(Ys.begin(), Ys.begin() + N);
+    TangentAX.resize(N);
+    TangentAY.resize(N);
+    TangentBX.resize(N);
+    TangentBY.resize(N);
+    for (size_t i = 0; i < N; i++)
+    {
+        // central difference inside, one-sided at the ends
+        const size_t From = (i == 0) ? 0 : i - 1;
+        const size_t To = (i + 1 == N) ? i : i + 1;
+        const double DX = PathX[To] - PathX[From];
+        const double DY = PathY[To] - PathY[From];
+        TangentAX[i] = PathX[i] - DX;
+        TangentAY[i] = PathY[i] - DY;
+        TangentBX[i] = PathX[i] + DX;
+        TangentBY[i] = PathY[i] + DY;
+    }
+}
+
+bool HapticSharedControl::LoadTrajectory(const std::string &Path, std::vector<double> &Xs, std::vector<double> &Ys)
+{
+    std::ifstream In(Path);
+    if (!In)
+        return false;
+    Xs.clear();
+    Ys.clear();
+    std::string Line;
+    while (std::getline(In, Line))
+    {
+        Line = Line.substr(0, Line.find('#'));
+        std::replace(Line.begin(), Line.end(), ',', ' ');
+        std::istringstream Fields(Line);
+        double X, Y;
+        if (Fields >> X >> Y)
+        {
+            Xs.push_back(X);
+            Ys.push_back(Y);
+        }
+    }
+    return !Xs.empty();
+}
+
+void HapticSharedControl::TurningCircle(double SteerFLDeg, double SteerFRDeg, double &Radius, double &SteerDeg,
+                                        double &CoRX, double &CoRY) const
+{
+    // "simple" bicycle model of utils.Vehicle.calc_turning_radius, driven by the outer wheel
+    const double OuterDeg = (SteerFLDeg > SteerFRDeg) ? SteerFLDeg : SteerFRDeg;
+    double Steer = Radians(OuterDeg);
+    if (std::fabs(PyMod(Steer, Pi)) < 1e-6)
+        Steer += 1e-6; // avoid dividing by zero
+    const double CoM = Params.Wheelbase * Params.CenterOfMassRatio;
+    const double TanSteer = std::tan(Steer);
+    Radius = std::fabs(std::sqrt(CoM * CoM + (Params.Wheelbase * Params.Wheelbase) / (TanSteer * TanSteer)));
+    const double Delta = std::atan(Params.CenterOfMassRatio * TanSteer);
+    SteerDeg = Degrees(Delta);
+    CoRX = -CoM;
+    CoRY = (std::fabs(Delta) < 1e-6) ? std::numeric_limits<double>::infinity() : CoM / std::tan(Delta);
+}
+
+int HapticSharedControl::ClosestPoint(double X, double Y, double &Dist) const
+{
+    int Best = -1;
+    double BestSq = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < PathX.size(); i++)
+    {
+        const double DX = PathX[i] - X, DY = PathY[i] - Y;
+        const double Sq = DX * DX + DY * DY;
+        if (Sq < BestSq)
+        {
+            BestSq = Sq;
+            Best = static_cast<int>(i);
+        }
+    }
+    Dist = (Best >= 0) ? std::sqrt(BestSq) : 0.0;
+    return Best;
+}
+
+HapticControlOutput HapticSharedControl::Compute(const HapticControlInput &In) const
+{
+    HapticControlOutput Out;
+
+    // 1. steering geometry
+    double CoRX, CoRY;
+    TurningCircle(In.SteerFLDeg, In.SteerFRDeg, Out.TurningRadius, Out.VehicleSteeringDeg, CoRX, CoRY);
+    const double Delta = Radians(Out.VehicleSteeringDeg);
+    const double Theta = Radians(In.SteeringWheelDeg);
+
+    // 2. error of the current position
+    Out.ClosestIdx = ClosestPoint(In.X, In.Y, Out.Error);
+
+    // 3. predicted position after the preview distance (haptic_algo.predict_position)
+    const double Lookahead = Sign(In.Speed) * Params.PreviewDistance;
+    if (std::isinf(CoRY))
+    {
+        // driving straight, the limit of the turning circle (the Python version has no finite result here)
+        Out.PredictedX = In.X + Lookahead * std::cos(Radians(In.YawDeg));
+        Out.PredictedY = In.Y + Lookahead * std::sin(Radians(In.YawDeg));
+        Out.PredictedYawDeg = In.YawDeg;
+    }
+    else
+    {
+        // the Python version works in swapped (y, x) coordinates with the yaw measured from the other axis
+        const double Yaw = Pi / 2 - Radians(In.YawDeg);
+        const double RotatingDir = Sign(std::sin(Delta));
+        const double A = Yaw - Pi / 2;
+        const double CoRWorld0 = std::cos(A) * CoRY - std::sin(A) * CoRX + In.Y;
+        const double CoRWorld1 = std::sin(A) * CoRY + std::cos(A) * CoRX + In.X;
+        const double DeltaPhi = RotatingDir * Lookahead / Out.TurningRadius;
+        const double PredictYaw = Yaw - DeltaPhi;
+        const double Angle = PredictYaw - Delta + RotatingDir * Pi / 2;
+        Out.PredictedY = CoRWorld0 + Out.TurningRadius * std::cos(Angle);
+        Out.PredictedX = CoRWorld1 + Out.TurningRadius * std::sin(Angle);
+        Out.PredictedYawDeg = Degrees(Pi / 2 - PredictYaw);
+    }
+
+    // signed error of the prediction, the side comes from the trajectory tangent (haptic_algo.get_sign_of_error)
+    double PredictedDist = 0.0;
+    const int PredictedIdx = ClosestPoint(Out.PredictedX, Out.PredictedY, PredictedDist);
+    if (PredictedIdx >= 0)
+    {
+        const double AX = TangentAX[PredictedIdx], AY = TangentAY[PredictedIdx];
+        const double Angle = std::atan2(TangentBY[PredictedIdx] - AY, TangentBX[PredictedIdx] - AX) -
+                             std::atan2(Out.PredictedY - AY, Out.PredictedX - AX);
+        Out.PredictedError = Sign(In.Speed) * Sign(std::sin(Angle)) * PredictedDist;
+    }
+
+    // 4. desired steering-wheel angle (preview driver model)
+    double ThetaD;
+    if (!Params.bFirstOrderModel)
+    {
+        ThetaD = Params.Kc * Out.PredictedError + Theta;
+    }
+    else
+    {
+        // one second of the first-order lag at 60 Hz, as in the Python version
+        constexpr int Steps = 60;
+        const double Dt = 1.0 / Steps;
+        ThetaD = Theta;
+        for (int i = 0; i < Steps; i++)
+            ThetaD = (Params.Kc * Out.PredictedError + ((Params.T / Dt) - 1) * ThetaD) * (Dt / Params.T);
+    }
+    Out.DesiredSteeringWheelDeg = Degrees(ThetaD);
+
+    // 5. torque
+    Out.Torque = -(Params.Cs * Out.Error) * (Theta - ThetaD);
+    Out.Coefficient = 1.0 / (1.0 + std::exp(-Params.Cs * Out.Error));
+    return Out;
+}
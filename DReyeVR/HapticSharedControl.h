@@ -0,0 +1,84 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Native port of the haptic shared-control torque (PythonAPI/scripts/HapticSharedControl/haptic_algo.py,
+// HapticSharedControl.calculate_torque) so it runs in the vehicle tick instead of a Python client loop:
+// 1. turning radius and center of rotation from the front wheel angles (bicycle model, utils.Vehicle)
+// 2. distance from the vehicle to the closest point of the reference trajectory, e(t)
+// 3. preview of the vehicle position after the preview distance along its current turning circle, and the signed
+//    distance of that preview to the trajectory, eps(tp)
+// 4. desired steering-wheel angle theta_d = Kc * eps(tp) + theta (or the first-order model with time constant T)
+// 5. torque tau = -(Cs * e(t)) * (theta - theta_d)
+// Units follow the Python version: meters, degrees (yaw as in CARLA), steering-wheel angles in degrees.
+
+struct HapticControlParams
+{
+    double Cs = 0.5;              // torque scale
+    double Kc = 0.5;              // preview gain of the driver model
+    double T = 1.0;               // time constant (s) of the first-order driver model
+    bool bFirstOrderModel = false; // false: "simple" preview model, true: "complex" (uses T)
+    double PreviewDistance = 4.8; // look-ahead (m) along the turning circle
+    double Wheelbase = 3.0;       // (m)
+    double CenterOfMassRatio = 0.45; // of the wheelbase
+};
+
+struct HapticControlInput
+{
+    double X = 0, Y = 0;              // vehicle position (m)
+    double YawDeg = 0;                // vehicle yaw (deg)
+    double SteerFLDeg = 0, SteerFRDeg = 0; // front wheel steering angles (deg)
+    double SteeringWheelDeg = 0;      // steering-wheel angle (deg)
+    double Speed = 0;                 // signed (m/s), negative when reversing
+};
+
+struct HapticControlOutput
+{
+    double Torque = 0;                  // tau_das
+    double Coefficient = 0;             // sigmoid(Cs * e(t))
+    double DesiredSteeringWheelDeg = 0; // theta_d
+    double Error = 0;                   // e(t), unsigned (m)
+    double PredictedError = 0;          // eps(tp), signed (m)
+    double PredictedX = 0, PredictedY = 0, PredictedYawDeg = 0;
+    double TurningRadius = 0;           // (m)
+    double VehicleSteeringDeg = 0;      // effective steering angle of the bicycle model
+    int ClosestIdx = -1;                // trajectory point closest to the vehicle (-1 without a trajectory)
+};
+
+class HapticSharedControl
+{
+  public:
+    explicit HapticSharedControl(const HapticControlParams &Params = HapticControlParams());
+
+    void SetParams(const HapticControlParams &NewParams)
+    {
+        Params = NewParams;
+    }
+    const HapticControlParams &GetParams() const
+    {
+        return Params;
+    }
+
+    // reference trajectory in meters (world X, Y), the tangents are computed here (path_planning.compute_tangents)
+    void SetTrajectory(const std::vector<double> &Xs, const std::vector<double> &Ys);
+    size_t NumTrajectoryPoints() const
+    {
+        return PathX.size();
+    }
+    // one "x, y" point per line (as in PythonAPI/data/paths), '#' starts a comment; false if unreadable
+    static bool LoadTrajectory(const std::string &Path, std::vector<double> &Xs, std::vector<double> &Ys);
+
+    HapticControlOutput Compute(const HapticControlInput &In) const;
+
+    // turning radius (m), effective steering angle (deg) and center of rotation in vehicle coordinates
+    void TurningCircle(double SteerFLDeg, double SteerFRDeg, double &Radius, double &SteerDeg, double &CoRX,
+                       double &CoRY) const;
+
+  private:
+    int ClosestPoint(double X, double Y, double &Dist) const;
+
+    HapticControlParams Params;
+    std::vector<double> PathX, PathY;
+    std::vector<double> TangentAX, TangentAY, TangentBX, TangentBY; // (p1, p2) of each point's tangent
+};
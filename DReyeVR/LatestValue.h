@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer/single-consumer "latest value" slot (triple buffer): the writer never waits for the
+// reader and the reader always gets the most recent complete value, intermediate values are simply overwritten.
+// Used to exchange the wheel state and force commands between the game thread and the wheel-device thread.
+template <typename T> class LatestValue
+{
+  public:
+    // writer thread only
+    void Publish(const T &Value)
+    {
+        Slots[Back].Value = Value;
+        // hand the written slot over and take back whichever slot was shared before
+        const uint8_t Prev = Shared.exchange(static_cast<uint8_t>(Back | NewBit), std::memory_order_acq_rel);
+        Back = Prev & IndexMask;
+    }
+
+    // reader thread only: updates Out and returns true if anything was published since the last call
+    bool Consume(T &Out)
+    {
+        if ((Shared.load(std::memory_order_acquire) & NewBit) == 0)
+            return false;
+        const uint8_t Prev = Shared.exchange(Front, std::memory_order_acq_rel);
+        Front = Prev & IndexMask;
+        Out = Slots[Front].Value;
+        return true;
+    }
+
+  private:
+    static constexpr uint8_t IndexMask = 0x3;
+    static constexpr uint8_t NewBit = 0x4;
+    struct alignas(64) Slot // one cache line each, the two threads never touch the same slot
+    {
+        T Value{};
+    };
+    Slot Slots[3];
+    alignas(64) std::atomic<uint8_t> Shared{1}; // index of the shared slot (+ NewBit if not consumed yet)
+    alignas(64) uint8_t Back = 0;               // writer's slot
+    alignas(64) uint8_t Front = 2;              // reader's slot
+};
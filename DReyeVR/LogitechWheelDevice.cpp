@@ -0,0 +1,129 @@
+#include "LogitechWheelDevice.h"
+
+#if USE_LOGITECH_PLUGIN
+
+#include <string>
+#include <vector>
+
+LogitechWheelDevice::LogitechWheelDevice(int DeviceIdxIn, bool bLogUpdatesIn)
+    : DeviceIdx(DeviceIdxIn), bLogUpdates(bLogUpdatesIn)
+{
+}
+
+bool LogitechWheelDevice::IsConnected() const
+{
+    return LogiIsConnected(DeviceIdx);
+}
+
+bool LogitechWheelDevice::Read(WheelState &Out)
+{
+    if (LogiUpdate() == false) // update the logitech wheel
+    {
+        if (!bUpdateFailing) // once, not on every poll (500 per second on the wheel-device thread)
+            LOG_WARN("Logitech wheel %d failed to update!", DeviceIdx);
+        bUpdateFailing = true;
+        return false;
+    }
+    bUpdateFailing = false;
+    if (!LogiIsConnected(DeviceIdx))
+        return false; // unplugged, the reader finds out through IsConnected
+    const DIJOYSTATE2 *State = LogiGetState(DeviceIdx);
+    if (State == nullptr)
+        return false;
+    if (bLogUpdates)
+        LogLogitechPluginStruct(*State);
+    /// NOTE: obtained these from LogitechWheelInputDevice.cpp:~111
+    // -32768 to 32767. -32768 = all the way to the left. 32767 = all the way to the right.
+    Out.Steering = FMath::Clamp(float(State->lX), -32767.0f, 32767.0f) / 32767.0f; // (-1, 1)
+    // -32768 to 32767. 32767 = pedal not pressed. -32768 = pedal fully pressed.
+    Out.Throttle = fabs(((State->lY - 32767.0f) / (65535.0f))); // (0, 1)
+    // -32768 to 32767. Higher value = less pressure on brake pedal
+    Out.Brake = fabs(((State->lRz - 32767.0f) / (65535.0f))); // (0, 1)
+    Out.POV = State->rgdwPOV[0];
+    for (int i = 0; i < 128; i++)
+        Out.SetButton(i, static_cast<bool>(State->rgbButtons[i]));
+    return true;
+}
+
+void LogitechWheelDevice::ApplyForce(const WheelForce &Force)
+{
+    if (Force.bSpring && LogiHasForceFeedback(DeviceIdx))
+        LogiPlaySpringForce(DeviceIdx, Force.OffsetPercentage, Force.SaturationPercentage, Force.CoefficientPercentage);
+    else
+        LogiStopSpringForce(DeviceIdx);
+}
+
+void LogitechWheelDevice::StopForces()
+{
+    // we only use spring force feedback
+    LogiStopSpringForce(DeviceIdx);
+}
+
+// const std::vector<FString> VarNames = {"rgdwPOV[0]", "rgdwPOV[1]", "rgdwPOV[2]", "rgdwPOV[3]"};
+static const std::vector<FString> VarNames = {                                             // 34 values
+    "lX",           "lY",           "lZ",         "lRz",           "lRy",           "lRz", // variable names
+    "rglSlider[0]", "rglSlider[1]", "rgdwPOV[0]", "rgbButtons[0]", "lVX",           "lVY",           "lVZ",
+    "lVRx",         "lVRy",         "lVRz",       "rglVSlider[0]", "rglVSlider[1]", "lAX",           "lAY",
+    "lAZ",          "lARx",         "lARy",       "lARz",          "rglASlider[0]", "rglASlider[1]", "lFX",
+    "lFY",          "lFZ",          "lFRx",       "lFRy",          "lFRz",          "rglFSlider[0]", "rglFSlider[1]"};
+
+void LogitechWheelDevice::LogLogitechPluginStruct(const DIJOYSTATE2 &Now)
+{
+    if (!bHasOld)
+    {
+        Old = Now; // initializing the Old struct
+        bHasOld = true;
+        return;
+    }
+    const std::vector<int> NowVals = {
+        Now.lX, Now.lY, Now.lZ, Now.lRx, Now.lRy, Now.lRz, Now.rglSlider[0], Now.rglSlider[1],
+        // Converting unsigned int & unsigned char to int
+        int(Now.rgdwPOV[0]), int(Now.rgbButtons[0]), Now.lVX, Now.lVY, Now.lVZ, Now.lVRx, Now.lVRy, Now.lVRz,
+        Now.rglVSlider[0], Now.rglVSlider[1], Now.lAX, Now.lAY, Now.lAZ, Now.lARx, Now.lARy, Now.lARz,
+        Now.rglASlider[0], Now.rglASlider[1], Now.lFX, Now.lFY, Now.lFZ, Now.lFRx, Now.lFRy, Now.lFRz,
+        Now.rglFSlider[0], Now.rglFSlider[1]}; // 32 elements
+    // Getting the (34) values from the old struct
+    const std::vector<int> OldVals = {
+        Old.lX, Old.lY, Old.lZ, Old.lRx, Old.lRy, Old.lRz, Old.rglSlider[0], Old.rglSlider[1],
+        // Converting unsigned int & unsigned char to int
+        int(Old.rgdwPOV[0]), int(Old.rgbButtons[0]), Old.lVX, Old.lVY, Old.lVZ, Old.lVRx, Old.lVRy, Old.lVRz,
+        Old.rglVSlider[0], Old.rglVSlider[1], Old.lAX, Old.lAY, Old.lAZ, Old.lARx, Old.lARy, Old.lARz,
+        Old.rglASlider[0], Old.rglASlider[1], Old.lFX, Old.lFY, Old.lFZ, Old.lFRx, Old.lFRy, Old.lFRz,
+        Old.rglFSlider[0], Old.rglFSlider[1]};
+
+    check(NowVals.size() == OldVals.size() && NowVals.size() == VarNames.size());
+
+    // print any differences (this may run on the wheel-device thread, hence the platform time)
+    bool isDiff = false;
+    for (size_t i = 0; i < NowVals.size(); i++)
+    {
+        if (NowVals[i] != OldVals[i])
+        {
+            if (!isDiff) // only gets triggered at MOST once
+            {
+                LOG("Logging joystick at t=%.3f", FPlatformTime::Seconds());
+                isDiff = true;
+            }
+            LOG("Triggered \"%s\" from %d to %d", *(VarNames[i]), OldVals[i], NowVals[i]);
+        }
+    }
+
+    // also check the 128 rgbButtons array
+    for (size_t i = 0; i < 127; i++)
+    {
+        if (Old.rgbButtons[i] != Now.rgbButtons[i])
+        {
+            if (!isDiff) // only gets triggered at MOST once
+            {
+                LOG("Logging joystick at t=%.3f", FPlatformTime::Seconds());
+                isDiff = true;
+            }
+            LOG("Triggered \"rgbButtons[%d]\" from %d to %d", int(i), int(Old.rgbButtons[i]), int(Now.rgbButtons[i]));
+        }
+    }
+
+    // assign the current joystate into the old one
+    Old = Now;
+}
+
+#endif
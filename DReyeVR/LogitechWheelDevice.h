@@ -0,0 +1,39 @@
+#pragma once
+
+#include "WheelDevice.h" // WheelDevice
+
+#ifndef _WIN32
+// can only use LogitechWheel plugin on Windows! :(
+#undef USE_LOGITECH_PLUGIN
+#define USE_LOGITECH_PLUGIN false
+#endif
+
+#if USE_LOGITECH_PLUGIN
+#include "LogitechSteeringWheelLib.h" // LogitechWheel plugin for hardware integration & force feedback
+
+// WheelDevice of the LogitechWheelPlugin (https://github.com/HARPLab/LogitechWheelPlugin), polled either by the
+// wheel-device thread or once per frame by the DReyeVRPawn. The SDK is not thread-safe: every call (IsConnected
+// included) must come from the thread that reads the device.
+class LogitechWheelDevice : public WheelDevice
+{
+  public:
+    LogitechWheelDevice(int DeviceIdx, bool bLogUpdates);
+
+    bool IsConnected() const override;
+    bool Read(WheelState &Out) override;
+    void ApplyForce(const WheelForce &Force) override;
+    void StopForces() override;
+
+  private:
+    /// NOTE: this is a debug function used to dump all the information we can regarding
+    // the Logitech wheel hardware we used since the exact buttons were not documented in
+    // the repo: https://github.com/HARPLab/LogitechWheelPlugin
+    void LogLogitechPluginStruct(const DIJOYSTATE2 &Now);
+
+    const int DeviceIdx;
+    const bool bLogUpdates;
+    DIJOYSTATE2 Old;       // last state (for LogLogitechPluginStruct)
+    bool bHasOld = false;
+    bool bUpdateFailing = false; // warned about the failing LogiUpdate, until it succeeds again
+};
+#endif
@@ -0,0 +1,91 @@
+#include "MirrorScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+MirrorScheduler::MirrorScheduler(const MirrorSchedulerParams &ParamsIn) : Params(ParamsIn)
+{
+}
+
+int MirrorScheduler::AddMirror(const std::string &Name)
+{
+    Mirror M;
+    M.Name = Name;
+    Mirrors.push_back(M);
+    return static_cast<int>(Mirrors.size()) - 1;
+}
+
+bool MirrorScheduler::Update(float DeltaSeconds, const std::vector<float> &GazeAnglesDeg)
+{
+    // advance the per-second buckets of the last minute
+    Elapsed += std::max(DeltaSeconds, 0.f);
+    const int Second = static_cast<int>(Elapsed) % MinuteBuckets;
+    while (CurrentBucket != Second)
+    {
+        CurrentBucket = (CurrentBucket + 1) % MinuteBuckets;
+        Buckets[CurrentBucket] = 0;
+    }
+
+    bool bChanged = false;
+    for (size_t i = 0; i < Mirrors.size(); i++)
+    {
+        Mirror &M = Mirrors[i];
+        const bool bLooking = i < GazeAnglesDeg.size() && std::fabs(GazeAnglesDeg[i]) <= Params.AttendAngleDeg;
+        M.SinceAttended = bLooking ? 0.f : M.SinceAttended + DeltaSeconds;
+        const float Scale = (M.SinceAttended <= Params.HoldSeconds) ? 1.f : Params.PeripheralScale;
+        bChanged |= (Scale != M.Scale);
+        M.Scale = Scale;
+
+        if (!M.bRendered)
+            continue;
+        TotalRendered++;
+        if (Scale < 1.f)
+        {
+            M.Saved++;
+            TotalSaved++;
+            Buckets[CurrentBucket]++;
+        }
+    }
+    return bChanged;
+}
+
+void MirrorScheduler::SetRendered(int Idx, bool bRendered)
+{
+    if (Idx >= 0 && Idx < static_cast<int>(Mirrors.size()))
+        Mirrors[Idx].bRendered = bRendered;
+}
+
+float MirrorScheduler::GetScale(int Idx) const
+{
+    return (Idx >= 0 && Idx < static_cast<int>(Mirrors.size())) ? Mirrors[Idx].Scale : 1.f;
+}
+
+bool MirrorScheduler::IsAttended(int Idx) const
+{
+    return GetScale(Idx) >= 1.f;
+}
+
+float MirrorScheduler::SavedRendersPerMinute() const
+{
+    uint64_t Sum = 0;
+    for (const uint32_t Count : Buckets)
+        Sum += Count;
+    const double Window = std::min<double>(Elapsed, MinuteBuckets);
+    return Window > 0.0 ? static_cast<float>(Sum * 60.0 / Window) : 0.f;
+}
+
+std::string MirrorScheduler::SummaryString() const
+{
+    char Line[128];
+    std::snprintf(Line, sizeof(Line), "mirror renders saved: %llu of %llu (%.0f in the last minute)",
+                  static_cast<unsigned long long>(TotalSaved), static_cast<unsigned long long>(TotalRendered),
+                  SavedRendersPerMinute());
+    std::string Out = Line;
+    for (const Mirror &M : Mirrors)
+    {
+        std::snprintf(Line, sizeof(Line), ", %s: %llu", M.Name.c_str(), static_cast<unsigned long long>(M.Saved));
+        Out += Line;
+    }
+    return Out;
+}
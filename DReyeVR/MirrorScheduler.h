@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Decides which mirrors get rendered at full resolution from where the driver is looking: a mirror within
+// AttendAngleDeg of the gaze (and for HoldSeconds after the gaze leaves it, so quick glances do not pop) keeps its
+// full ScreenPercentage, every other mirror renders at PeripheralScale of it. Counts the full-resolution renders
+// this saved, out of the mirrors that were rendered at all (see SetRendered). The caller computes the gaze angles.
+
+struct MirrorSchedulerParams
+{
+    float AttendAngleDeg = 25.f; // gaze this close to a mirror's center counts as looking at it
+    float HoldSeconds = 0.5f;    // a mirror stays at full resolution this long after the gaze leaves
+    float PeripheralScale = 0.5f; // of the ScreenPercentage for mirrors not looked at
+};
+
+class MirrorScheduler
+{
+  public:
+    explicit MirrorScheduler(const MirrorSchedulerParams &Params = MirrorSchedulerParams());
+
+    int AddMirror(const std::string &Name); // returns the index for GetScale/Update
+    size_t NumMirrors() const
+    {
+        return Mirrors.size();
+    }
+
+    // one frame, GazeAnglesDeg holds the angle between the gaze and each mirror (in AddMirror order)
+    // returns true if any mirror's scale changed since the last frame
+    bool Update(float DeltaSeconds, const std::vector<float> &GazeAnglesDeg);
+
+    // a mirror that is not rendered (ex. reflection hidden by the quality governor) is still scheduled, so it comes
+    // back at the right resolution, but its frames are not counted
+    void SetRendered(int Mirror, bool bRendered);
+
+    float GetScale(int Mirror) const; // ScreenPercentage scale for this mirror
+    bool IsAttended(int Mirror) const;
+
+    // renders that would have been full resolution without the scheduler
+    uint64_t SavedRenders() const
+    {
+        return TotalSaved;
+    }
+    uint64_t TotalRenders() const
+    {
+        return TotalRendered;
+    }
+    float SavedRendersPerMinute() const; // over the last minute (or less, right after starting)
+    std::string SummaryString() const;
+
+  private:
+    struct Mirror
+    {
+        std::string Name;
+        float SinceAttended = 1e9f; // seconds since the gaze was last on this mirror
+        float Scale = 1.f;
+        bool bRendered = true;
+        uint64_t Saved = 0;
+    };
+    const MirrorSchedulerParams Params;
+    std::vector<Mirror> Mirrors;
+    uint64_t TotalSaved = 0;
+    uint64_t TotalRendered = 0;
+
+    // saved renders per second of the last minute
+    static constexpr int MinuteBuckets = 60;
+    uint32_t Buckets[MinuteBuckets] = {};
+    double Elapsed = 0.0;
+    int CurrentBucket = 0;
+};
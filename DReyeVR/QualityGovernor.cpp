@@ -0,0 +1,90 @@
+#include "QualityGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+
+QualityGovernor::QualityGovernor(const QualityGovernorParams &ParamsIn, std::vector<QualityLevel> LadderIn)
+    : Params(ParamsIn), Ladder(LadderIn.empty() ? DefaultLadder() : std::move(LadderIn))
+{
+    Window.reserve(std::max(Params.WindowFrames, 1));
+}
+
+std::vector<QualityLevel> QualityGovernor::DefaultLadder()
+{
+    std::vector<QualityLevel> L;
+    QualityLevel Q;
+    Q.Name = "Full";
+    L.push_back(Q);
+    Q.Name = "MirrorsHalfRes";
+    Q.MirrorScreenPercentageScale = 0.5f;
+    L.push_back(Q);
+    Q.Name = "NoSideMirrorReflections";
+    Q.bSideMirrorReflections = false;
+    L.push_back(Q);
+    Q.Name = "ShorterDrawDistance";
+    Q.DrawDistance = 250.f;
+    Q.bNonEgoSounds = false;
+    L.push_back(Q);
+    Q.Name = "CameraRes85";
+    Q.CameraScreenPercentageScale = 0.85f;
+    L.push_back(Q);
+    Q.Name = "Minimum";
+    Q.bRearMirrorReflection = false;
+    Q.CameraScreenPercentageScale = 0.7f;
+    Q.DrawDistance = 150.f;
+    L.push_back(Q);
+    return L;
+}
+
+void QualityGovernor::Reset()
+{
+    Window.clear();
+    Level = 0;
+    GoodWindows = 0;
+    Cooldown = 0;
+    LastWindowMs = 0.f;
+}
+
+bool QualityGovernor::Update(float GameThreadMs, float GPUMs)
+{
+    Window.push_back(std::max(GameThreadMs, GPUMs));
+    if (static_cast<int>(Window.size()) < std::max(Params.WindowFrames, 1))
+        return false;
+
+    // percentile (nearest rank) of this window
+    const size_t Rank = static_cast<size_t>(std::ceil(Params.Percentile * Window.size()));
+    const size_t Idx = std::min(Window.size() - 1, Rank > 0 ? Rank - 1 : 0);
+    std::nth_element(Window.begin(), Window.begin() + Idx, Window.end());
+    LastWindowMs = Window[Idx];
+    Window.clear();
+
+    if (Cooldown > 0)
+    {
+        Cooldown--;
+        return false;
+    }
+
+    const int OldLevel = Level;
+    if (LastWindowMs > Params.TargetMs)
+    {
+        GoodWindows = 0;
+        Level = std::min(Level + 1, NumLevels() - 1);
+    }
+    else if (LastWindowMs < Params.TargetMs * Params.UpgradeBelow)
+    {
+        if (++GoodWindows >= Params.UpgradeWindows)
+        {
+            GoodWindows = 0;
+            Level = std::max(Level - 1, 0);
+        }
+    }
+    else
+    {
+        GoodWindows = 0; // close to the target: stay
+    }
+
+    if (Level == OldLevel)
+        return false;
+    Cooldown = Params.CooldownWindows;
+    return true;
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Holds a frame-time target (ex. 11.1 ms for a 90 Hz HMD) by walking a ladder of quality levels: level 0 is full
+// quality and every further level gives up a bit more (mirrors first, then draw distance, ...). The frame cost is the
+// slower of the game thread and the GPU, judged on the 90th percentile of a window of frames. Going down a level
+// takes one bad window, going back up takes several good windows well below the target, and every change is followed
+// by a cooldown, so the quality does not oscillate around the target.
+
+struct QualityLevel
+{
+    std::string Name;
+    float MirrorScreenPercentageScale = 1.f; // of the per-vehicle mirror ScreenPercentage
+    bool bSideMirrorReflections = true;      // planar reflections of the side mirrors
+    bool bRearMirrorReflection = true;       // planar reflection of the rear mirror
+    float CameraScreenPercentageScale = 1.f; // of CameraParams ScreenPercentage
+    float DrawDistance = 0.f;                // m, of the other vehicles, walkers and props (0 is unlimited)
+    bool bNonEgoSounds = true;               // engine sounds of the other vehicles
+};
+
+struct QualityGovernorParams
+{
+    float TargetMs = 11.1f;
+    int WindowFrames = 45;         // frames judged together
+    float Percentile = 0.9f;       // of the window
+    float UpgradeBelow = 0.75f;    // fraction of the target the window needs to stay under to raise quality...
+    int UpgradeWindows = 4;        // ...for this many consecutive windows
+    int CooldownWindows = 2;       // windows ignored after every change
+};
+
+class QualityGovernor
+{
+  public:
+    explicit QualityGovernor(const QualityGovernorParams &Params = QualityGovernorParams(),
+                             std::vector<QualityLevel> Ladder = DefaultLadder());
+
+    // the default ladder, ordered by how little each step is noticed in VR
+    static std::vector<QualityLevel> DefaultLadder();
+
+    // feed one frame, returns true if the level changed (see GetLevel)
+    bool Update(float GameThreadMs, float GPUMs);
+
+    int GetLevel() const
+    {
+        return Level;
+    }
+    const QualityLevel &GetSettings() const
+    {
+        return Ladder[Level];
+    }
+    int NumLevels() const
+    {
+        return static_cast<int>(Ladder.size());
+    }
+    float GetLastWindowMs() const // percentile frame cost of the last complete window
+    {
+        return LastWindowMs;
+    }
+    void Reset(); // back to full quality
+
+  private:
+    const QualityGovernorParams Params;
+    const std::vector<QualityLevel> Ladder;
+    std::vector<float> Window;
+    int Level = 0;
+    int GoodWindows = 0;
+    int Cooldown = 0;
+    float LastWindowMs = 0.f;
+};
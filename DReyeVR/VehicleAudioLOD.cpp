@@ -0,0 +1,91 @@
+#include "VehicleAudioLOD.h"
+
+#include <algorithm>
+#include <cstdio>
+
+VehicleAudioLOD::VehicleAudioLOD(const VehicleAudioLODParams &ParamsIn)
+{
+    SetParams(ParamsIn);
+}
+
+void VehicleAudioLOD::SetParams(const VehicleAudioLODParams &NewParams)
+{
+    Params = NewParams;
+    Params.MaxVoices = std::max(0, Params.MaxVoices);
+    Voices.resize(Params.MaxVoices, 0); // the next update reassigns what no longer fits
+    SinceUpdate = 1e9f;
+}
+
+bool VehicleAudioLOD::ShouldUpdate(float DeltaSeconds)
+{
+    SinceUpdate += DeltaSeconds;
+    if (Params.UpdateRateHz > 0.f && SinceUpdate < 1.f / Params.UpdateRateHz)
+        return false;
+    SinceUpdate = 0.f;
+    return true;
+}
+
+const std::vector<uint32_t> &VehicleAudioLOD::Update(const std::vector<VehicleAudioSource> &Sources)
+{
+    Updates++;
+    SourcesSeen += Sources.size();
+    Previous = Voices;
+
+    // most audible first (vehicles that are already playing get the hysteresis bonus)
+    struct Candidate
+    {
+        float Audibility;
+        uint32_t Id;
+    };
+    std::vector<Candidate> Candidates;
+    Candidates.reserve(Sources.size());
+    for (const VehicleAudioSource &S : Sources)
+    {
+        if (S.Id == 0 || S.Distance > Params.MaxDistance)
+            continue;
+        float Audibility = S.Loudness / std::max(S.Distance, 1.f);
+        if (std::find(Voices.begin(), Voices.end(), S.Id) != Voices.end())
+            Audibility *= Params.Hysteresis;
+        Candidates.push_back({Audibility, S.Id});
+    }
+    const size_t N = std::min(Candidates.size(), Voices.size());
+    std::partial_sort(Candidates.begin(), Candidates.begin() + N, Candidates.end(),
+                      [](const Candidate &A, const Candidate &B) { return A.Audibility > B.Audibility; });
+
+    // keep the slots of the selected vehicles that already play, free the others
+    for (uint32_t &Voice : Voices)
+    {
+        const bool bSelected = std::any_of(Candidates.begin(), Candidates.begin() + N,
+                                           [Voice](const Candidate &C) { return C.Id == Voice; });
+        if (!bSelected)
+            Voice = 0;
+    }
+    // and give the newly selected ones a free slot
+    for (size_t i = 0; i < N; i++)
+    {
+        if (std::find(Voices.begin(), Voices.end(), Candidates[i].Id) != Voices.end())
+            continue;
+        *std::find(Voices.begin(), Voices.end(), 0u) = Candidates[i].Id; // N <= slots, so one is free
+        Starts++;
+    }
+    return Voices;
+}
+
+int VehicleAudioLOD::NumActiveVoices() const
+{
+    return static_cast<int>(Voices.size() - std::count(Voices.begin(), Voices.end(), 0u));
+}
+
+double VehicleAudioLOD::MeanSources() const
+{
+    return Updates == 0 ? 0.0 : static_cast<double>(SourcesSeen) / Updates;
+}
+
+std::string VehicleAudioLOD::SummaryString() const
+{
+    char Line[160];
+    std::snprintf(Line, sizeof(Line), "vehicle audio: %d of %d voices playing, %llu voice starts in %llu updates "
+                  "(%.1f vehicles per update)", NumActiveVoices(), static_cast<int>(Voices.size()),
+                  static_cast<unsigned long long>(Starts), static_cast<unsigned long long>(Updates), MeanSources());
+    return Line;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Decides which non-ego vehicles get one of the MaxVoices pooled engine sounds: the most audible ones (loudness
+// over distance from the listener) within MaxDistance, re-evaluated UpdateRateHz times a second. A vehicle that
+// already has a voice keeps it while it stays within Hysteresis of the others, and keeps the same voice slot, so
+// sounds do not restart or swap back and forth.
+
+struct VehicleAudioLODParams
+{
+    int MaxVoices = 8;          // pooled engine sounds
+    float MaxDistance = 80.f;   // (m) vehicles further away are never heard
+    float UpdateRateHz = 15.f;  // of the selection and the RPM parameters
+    float Hysteresis = 1.25f;   // audibility bonus of vehicles that already have a voice
+};
+
+struct VehicleAudioSource
+{
+    uint32_t Id = 0;       // nonzero, unique among the sources of one update
+    float Distance = 0.f;  // (m) from the listener
+    float Loudness = 1.f;  // relative (eg. from the engine RPM)
+};
+
+class VehicleAudioLOD
+{
+  public:
+    explicit VehicleAudioLOD(const VehicleAudioLODParams &Params = VehicleAudioLODParams());
+
+    void SetParams(const VehicleAudioLODParams &NewParams); // keeps the voices that still fit
+    const VehicleAudioLODParams &GetParams() const
+    {
+        return Params;
+    }
+
+    // true when the next update is due (UpdateRateHz), given the time since the last frame
+    bool ShouldUpdate(float DeltaSeconds);
+
+    // the source Id played by every voice slot (0 for a free slot), at most MaxVoices slots
+    const std::vector<uint32_t> &Update(const std::vector<VehicleAudioSource> &Sources);
+    const std::vector<uint32_t> &GetVoices() const
+    {
+        return Voices;
+    }
+    int NumActiveVoices() const;
+    // the slot plays another vehicle than before the last update, or none anymore (its vehicle left or was
+    // destroyed): whatever it played must be stopped
+    bool SlotChanged(size_t Slot) const
+    {
+        return Slot < Voices.size() && (Slot >= Previous.size() || Voices[Slot] != Previous[Slot]);
+    }
+
+    uint64_t NumUpdates() const
+    {
+        return Updates;
+    }
+    uint64_t NumVoiceStarts() const // a slot started playing another vehicle
+    {
+        return Starts;
+    }
+    double MeanSources() const; // vehicles considered per update
+    std::string SummaryString() const;
+
+  private:
+    VehicleAudioLODParams Params;
+    std::vector<uint32_t> Voices;
+    std::vector<uint32_t> Previous; // the voices before the last update
+    float SinceUpdate = 1e9f; // seconds
+    uint64_t Updates = 0;
+    uint64_t Starts = 0;
+    uint64_t SourcesSeen = 0;
+};
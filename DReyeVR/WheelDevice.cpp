@@ -0,0 +1,99 @@
+#include "WheelDevice.h"
+
+#include <algorithm>
+
+bool SimulatedWheelDevice::Read(WheelState &Out)
+{
+    const Clock::time_point Now = Clock::now();
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Reads++;
+    if (!bConnected)
+        return false;
+    if (bHasRead && Force.bSpring)
+    {
+        // the rim is pulled towards the spring's center
+        const float Dt = std::chrono::duration<float>(Now - LastRead).count();
+        const float Rate = SpringRate * Force.CoefficientPercentage / 100.f;
+        const float Target = Force.OffsetPercentage / 100.f;
+        State.Steering += (Target - State.Steering) * std::min(1.f, Rate * Dt);
+    }
+    LastRead = Now;
+    bHasRead = true;
+    Out = State;
+    if (ReadCostUs > 0)
+    {
+        const Clock::time_point Until = Now + std::chrono::microseconds(ReadCostUs);
+        while (Clock::now() < Until)
+            ;
+    }
+    return true;
+}
+
+void SimulatedWheelDevice::ApplyForce(const WheelForce &NewForce)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Force = NewForce;
+    Forces++;
+}
+
+void SimulatedWheelDevice::StopForces()
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    Force = WheelForce();
+    Forces++;
+}
+
+void SimulatedWheelDevice::SetSteering(float Steering)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    State.Steering = std::max(-1.f, std::min(1.f, Steering));
+}
+
+void SimulatedWheelDevice::SetPedals(float Throttle, float Brake)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    State.Throttle = Throttle;
+    State.Brake = Brake;
+}
+
+void SimulatedWheelDevice::SetButton(int Idx, bool bPressed)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    State.SetButton(Idx, bPressed);
+}
+
+void SimulatedWheelDevice::SetReadCostUs(int Us)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    ReadCostUs = Us;
+}
+
+void SimulatedWheelDevice::SetConnected(bool bConnectedIn)
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    bConnected = bConnectedIn;
+}
+
+float SimulatedWheelDevice::GetSteering() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return State.Steering;
+}
+
+WheelForce SimulatedWheelDevice::GetForce() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Force;
+}
+
+uint64_t SimulatedWheelDevice::NumReads() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Reads;
+}
+
+uint64_t SimulatedWheelDevice::NumForces() const
+{
+    std::lock_guard<std::mutex> Lock(Mutex);
+    return Forces;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+// A steering wheel (with pedals) as seen by the wheel-device thread (see WheelDeviceThread.h): its state is polled
+// and spring forces are applied to it. Implemented by the LogitechWheelPlugin (LogitechWheelDevice.h, Windows only)
+// and by SimulatedWheelDevice for testing without hardware.
+
+struct WheelState
+{
+    float Steering = 0.f; // -1 (all the way left) to 1 (all the way right)
+    float Throttle = 0.f; // 0 to 1
+    float Brake = 0.f;    // 0 to 1
+    uint32_t POV = 0xFFFFFFFF;  // d-pad in hundredths of degrees (0 is up, 9000 is right), 0xFFFFFFFF if released
+    uint64_t Buttons[2] = {0, 0}; // bit i is button i
+    uint64_t Sequence = 0;  // number of the read (by the wheel-device thread), 0 if never read
+    double TimestampS = 0.0; // when it was read (seconds since the thread started)
+
+    bool SameInputs(const WheelState &Other) const // ignoring when/how it was read
+    {
+        return Steering == Other.Steering && Throttle == Other.Throttle && Brake == Other.Brake &&
+               POV == Other.POV && Buttons[0] == Other.Buttons[0] && Buttons[1] == Other.Buttons[1];
+    }
+    bool Button(int Idx) const
+    {
+        return (Idx >= 0 && Idx < 128) && ((Buttons[Idx / 64] >> (Idx % 64)) & 1u);
+    }
+    void SetButton(int Idx, bool bPressed)
+    {
+        if (Idx < 0 || Idx >= 128)
+            return;
+        const uint64_t Bit = uint64_t(1) << (Idx % 64);
+        Buttons[Idx / 64] = bPressed ? (Buttons[Idx / 64] | Bit) : (Buttons[Idx / 64] & ~Bit);
+    }
+};
+
+struct WheelForce
+{
+    bool bSpring = false;          // false stops the spring force
+    int OffsetPercentage = 0;      // "center of the spring force effect" (-100 to 100)
+    int SaturationPercentage = 0;  // "level of saturation... comparable to a magnitude" (0 to 100)
+    int CoefficientPercentage = 0; // "slope of the effect strength increase relative to deflection from Offset"
+
+    bool operator==(const WheelForce &Other) const
+    {
+        return bSpring == Other.bSpring && OffsetPercentage == Other.OffsetPercentage &&
+               SaturationPercentage == Other.SaturationPercentage &&
+               CoefficientPercentage == Other.CoefficientPercentage;
+    }
+    bool operator!=(const WheelForce &Other) const
+    {
+        return !(*this == Other);
+    }
+};
+
+class WheelDevice
+{
+  public:
+    virtual ~WheelDevice() = default;
+    virtual bool IsConnected() const = 0; // from the thread that reads the device (see WheelDeviceThread)
+    virtual bool Read(WheelState &Out) = 0; // false if the device could not be read
+    virtual void ApplyForce(const WheelForce &Force) = 0;
+    virtual void StopForces() = 0;
+};
+
+// a wheel whose rim follows the applied spring force (first order), with scripted pedals/buttons
+class SimulatedWheelDevice : public WheelDevice
+{
+  public:
+    bool IsConnected() const override
+    {
+        std::lock_guard<std::mutex> Lock(Mutex);
+        return bConnected;
+    }
+    bool Read(WheelState &Out) override; // false while unplugged
+    void ApplyForce(const WheelForce &Force) override;
+    void StopForces() override;
+
+    // scripted driver inputs (any thread)
+    void SetSteering(float Steering);
+    void SetPedals(float Throttle, float Brake);
+    void SetButton(int Idx, bool bPressed);
+    void SetReadCostUs(int Us); // busy time of every Read, to emulate a slow device
+    void SetConnected(bool bConnected); // unplug/replug
+
+    // inspection (any thread)
+    float GetSteering() const;
+    WheelForce GetForce() const;
+    uint64_t NumReads() const;
+    uint64_t NumForces() const; // ApplyForce/StopForces calls
+
+    float SpringRate = 20.f; // 1/s at 100% coefficient
+
+  private:
+    using Clock = std::chrono::steady_clock;
+    mutable std::mutex Mutex;
+    WheelState State;
+    WheelForce Force;
+    Clock::time_point LastRead;
+    bool bHasRead = false;
+    int ReadCostUs = 0;
+    bool bConnected = true;
+    uint64_t Reads = 0, Forces = 0;
+};
@@ -0,0 +1,133 @@
+#include "WheelDeviceThread.h"
+
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
+WheelDeviceThread::WheelDeviceThread(WheelDevice &DeviceIn, const WheelThreadParams &ParamsIn)
+    : Device(DeviceIn), Params(ParamsIn)
+{
+}
+
+WheelDeviceThread::~WheelDeviceThread()
+{
+    Stop();
+}
+
+void WheelDeviceThread::Start()
+{
+    if (IsRunning())
+        return;
+    bool bStale;
+    Connection.Consume(bStale); // of an earlier run
+    bDeviceConnected = true;
+    bRunning = true;
+    Thread = std::thread(&WheelDeviceThread::Run, this);
+}
+
+void WheelDeviceThread::Stop()
+{
+    bRunning = false;
+    if (Thread.joinable())
+        Thread.join();
+}
+
+bool WheelDeviceThread::GetLatest(WheelState &Out)
+{
+    Inputs.Consume(LastInput); // keeps the previous state if nothing new was read
+    Out = LastInput;
+    return LastInput.Sequence > 0;
+}
+
+void WheelDeviceThread::Run()
+{
+    using Clock = std::chrono::steady_clock;
+    const Clock::duration Period =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(Params.RateHz, 1.0)));
+    const Clock::duration Spin =
+        std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::micro>(Params.SpinUs));
+    const Clock::time_point Begin = Clock::now();
+    Clock::time_point Next = Begin;
+    Clock::time_point Last = Begin;
+    uint64_t Sequence = 0;
+    bool bFirst = true;
+    WheelForce Applied;
+    bool bApplied = false;
+
+    while (bRunning.load(std::memory_order_relaxed))
+    {
+        const Clock::time_point Now = Clock::now();
+        if (!bFirst)
+        {
+            const uint64_t PeriodNs = std::chrono::duration_cast<std::chrono::nanoseconds>(Now - Last).count();
+            SumPeriodNs.fetch_add(PeriodNs, std::memory_order_relaxed);
+            if (PeriodNs > MaxPeriodNs.load(std::memory_order_relaxed))
+                MaxPeriodNs.store(PeriodNs, std::memory_order_relaxed);
+        }
+        Last = Now;
+        bFirst = false;
+
+        WheelState State;
+        if (Device.Read(State))
+        {
+            State.Sequence = ++Sequence;
+            State.TimestampS = std::chrono::duration<double>(Now - Begin).count();
+            Inputs.Publish(State);
+        }
+        else if (!Device.IsConnected())
+        {
+            Connection.Publish(false); // nothing to poll until the game thread opens the device again
+            break;
+        }
+
+        WheelForce Force;
+        if (Forces.Consume(Force) && (!bApplied || Force != Applied))
+        {
+            Device.ApplyForce(Force);
+            Applied = Force;
+            bApplied = true;
+            ForcesApplied.fetch_add(1, std::memory_order_relaxed);
+        }
+        Iterations.fetch_add(1, std::memory_order_relaxed);
+
+        // wait for the next period: sleep most of it, yield through the rest
+        Next += Period;
+        const Clock::time_point Done = Clock::now();
+        if (Done > Next)
+        {
+            Overruns.fetch_add(1, std::memory_order_relaxed);
+            if (Done - Next > Period)
+                Next = Done; // too far behind: drop the missed periods instead of bursting to catch up
+            continue;
+        }
+        if (Next - Done > Spin)
+            std::this_thread::sleep_for(Next - Done - Spin);
+        while (Clock::now() < Next)
+            std::this_thread::yield();
+    }
+    Device.StopForces();
+}
+
+WheelThreadStats WheelDeviceThread::GetStats() const
+{
+    WheelThreadStats Stats;
+    Stats.Iterations = Iterations.load(std::memory_order_relaxed);
+    Stats.Overruns = Overruns.load(std::memory_order_relaxed);
+    Stats.ForcesApplied = ForcesApplied.load(std::memory_order_relaxed);
+    const uint64_t Periods = Stats.Iterations > 1 ? Stats.Iterations - 1 : 0;
+    Stats.MeanPeriodMs = Periods > 0 ? SumPeriodNs.load(std::memory_order_relaxed) / 1e6 / Periods : 0.0;
+    Stats.MaxPeriodMs = MaxPeriodNs.load(std::memory_order_relaxed) / 1e6;
+    return Stats;
+}
+
+std::string WheelDeviceThread::SummaryString() const
+{
+    const WheelThreadStats Stats = GetStats();
+    std::ostringstream Out;
+    Out.setf(std::ios::fixed);
+    Out.precision(3);
+    Out << "Wheel-device thread: " << Stats.Iterations << " iterations at " << static_cast<int>(Params.RateHz)
+        << " Hz target, mean " << Stats.MeanPeriodMs << " ms (max " << Stats.MaxPeriodMs << " ms), "
+        << Stats.Overruns << " overruns, " << Stats.ForcesApplied << " force updates";
+    return Out.str();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "LatestValue.h"
+#include "WheelDevice.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Polls a WheelDevice and applies its force commands on a dedicated thread at a fixed rate (500-1000 Hz), so the
+// haptics neither follow the VR frame rate nor stall with a slow frame. The game thread reads the latest wheel
+// state and publishes the latest force command through lock-free LatestValue slots; a force is only sent to the
+// device when it changes. While the thread runs it is the only one calling the device (vendor SDKs are not
+// thread-safe), and it stops polling once the device reports it is unplugged (see IsDeviceConnected).
+
+struct WheelThreadParams
+{
+    double RateHz = 500.0; // loop rate
+    double SpinUs = 200.0; // the end of every period is busy-waited (yielding) instead of slept, for accuracy
+};
+
+struct WheelThreadStats
+{
+    uint64_t Iterations = 0;
+    uint64_t Overruns = 0;     // iterations that finished after their deadline
+    uint64_t ForcesApplied = 0; // force commands that were sent to the device
+    double MeanPeriodMs = 0.0;
+    double MaxPeriodMs = 0.0;
+};
+
+class WheelDeviceThread
+{
+  public:
+    WheelDeviceThread(WheelDevice &Device, const WheelThreadParams &Params = WheelThreadParams());
+    ~WheelDeviceThread(); // stops the thread
+
+    void Start();
+    void Stop(); // joins the thread, the forces of the device are stopped
+    bool IsRunning() const
+    {
+        return Thread.joinable();
+    }
+
+    // game thread: the most recent state (false until the device was read once)
+    bool GetLatest(WheelState &Out);
+    // game thread: false once the device was found unplugged (the thread has stopped polling it then)
+    bool IsDeviceConnected()
+    {
+        Connection.Consume(bDeviceConnected);
+        return bDeviceConnected;
+    }
+    // game thread: the force to apply from now on
+    void SetForce(const WheelForce &Force)
+    {
+        Forces.Publish(Force);
+    }
+
+    WheelThreadStats GetStats() const;
+    std::string SummaryString() const;
+
+  private:
+    void Run();
+
+    WheelDevice &Device;
+    const WheelThreadParams Params;
+    std::thread Thread;
+    std::atomic<bool> bRunning{false};
+    LatestValue<WheelState> Inputs; // device thread -> game thread
+    LatestValue<WheelForce> Forces; // game thread -> device thread
+    LatestValue<bool> Connection;   // device thread -> game thread
+    WheelState LastInput;           // game thread's copy of the latest state
+    bool bDeviceConnected = true;   // game thread's copy of the connection
+
+    // written by the device thread only
+    std::atomic<uint64_t> Iterations{0}, Overruns{0}, ForcesApplied{0};
+    std::atomic<uint64_t> SumPeriodNs{0}, MaxPeriodNs{0};
+};
@@ -0,0 +1,69 @@
+#include "WheelInputFilter.h"
+
+#include <cmath>
+
+static bool IsNearlyEqual(float A, float B, float Tolerance)
+{
+    return std::fabs(A - B) <= Tolerance;
+}
+
+void WheelInputFilter::Reset()
+{
+    bPedalsDefaulting = true;
+    SteeringLast = ThrottleLast = BrakeLast = 0.f;
+}
+
+WheelActions WheelInputFilter::Update(const WheelState &State, bool bAutopilot)
+{
+    WheelActions Actions;
+    // weird behaviour: "Pedals will output a value of 0.5 until the wheel/pedals receive any kind of input"
+    // as per https://github.com/HARPLab/LogitechWheelPlugin
+    if (bPedalsDefaulting)
+    {
+        // this bPedalsDefaulting flag is initially set to not send inputs when the pedals are "defaulting", once the
+        // pedals/wheel is used (pressed/turned) once then this flag is ignored (false) for the remainder of the game
+        if (!IsNearlyEqual(State.Steering, 0.f, Threshold) || // wheel is not at 0 (rest)
+            !IsNearlyEqual(State.Throttle, 0.5f, Threshold) || // accel pedal is pressed
+            !IsNearlyEqual(State.Brake, 0.5f, Threshold))      // brake pedal is pressed
+        {
+            bPedalsDefaulting = false;
+        }
+    }
+    else if (bAutopilot && IsNearlyEqual(State.Steering, SteeringLast, Threshold) &&
+             IsNearlyEqual(State.Throttle, ThrottleLast, Threshold) && IsNearlyEqual(State.Brake, BrakeLast, Threshold))
+    {
+        // let the autopilot drive if the user is not putting significant inputs
+        // ie. if their inputs are close enough to what was previously input
+        /// TODO: this system might break down if the autopilot is putting in sufficiently
+        ///       strong inputs, since the autopilot controls might might inadvertently
+        ///       be considered as human-input controls which amplifies the input and
+        ///       causes a positive cycle loop (which would be better avoided)
+    }
+    else
+    {
+        // driver has issued sufficient input to warrant manual takeover (disables autopilot)
+        Actions.bDriverInputs = true;
+        Actions.Steering = State.Steering;
+        Actions.Throttle = State.Throttle;
+        Actions.Brake = State.Brake;
+    }
+    // save the last values for the wheel & pedals
+    SteeringLast = State.Steering;
+    ThrottleLast = State.Throttle;
+    BrakeLast = State.Brake;
+
+    Actions.bABXY_A = State.Button(0);
+    Actions.bABXY_B = State.Button(2);
+    Actions.bABXY_X = State.Button(1);
+    Actions.bABXY_Y = State.Button(3);
+    Actions.bTurnSignalR = State.Button(4);
+    Actions.bTurnSignalL = State.Button(5);
+    // State.Button(23) is the big red button on right side of g923
+    Actions.bDPad_Up = (State.POV == 0);
+    Actions.bDPad_Right = (State.POV == 9000);
+    Actions.bDPad_Down = (State.POV == 18000);
+    Actions.bDPad_Left = (State.POV == 27000);
+    Actions.bPositive = State.Button(19);
+    Actions.bNegative = State.Button(20);
+    return Actions;
+}
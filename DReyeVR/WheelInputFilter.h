@@ -0,0 +1,52 @@
+#pragma once
+
+#include "WheelDevice.h" // WheelState
+
+// What the DReyeVRPawn does with a WheelState, independent of the device it came from: ignore the pedals until
+// they stop "defaulting", let the autopilot keep driving until the driver's inputs change by more than the
+// threshold (manual takeover), and map the buttons/d-pad of the wheel (Logitech G923 layout) to vehicle actions.
+
+struct WheelActions
+{
+    bool bDriverInputs = false; // apply the inputs below (and disable the autopilot)
+    float Steering = 0.f;
+    float Throttle = 0.f;
+    float Brake = 0.f;
+    bool bABXY_A = false, bABXY_B = false, bABXY_X = false, bABXY_Y = false; // any of them holds reverse
+    bool bTurnSignalL = false, bTurnSignalR = false;
+    bool bDPad_Up = false, bDPad_Right = false, bDPad_Down = false, bDPad_Left = false;
+    bool bPositive = false, bNegative = false;
+
+    bool Reverse() const
+    {
+        return bABXY_A || bABXY_B || bABXY_X || bABXY_Y;
+    }
+};
+
+class WheelInputFilter
+{
+  public:
+    explicit WheelInputFilter(float Threshold = 0.02f) : Threshold(Threshold)
+    {
+    }
+
+    void SetThreshold(float NewThreshold)
+    {
+        Threshold = NewThreshold;
+    }
+    bool IsPedalsDefaulting() const
+    {
+        return bPedalsDefaulting;
+    }
+    void Reset();
+
+    WheelActions Update(const WheelState &State, bool bAutopilot);
+
+  private:
+    float Threshold; // change needed to overtake the autopilot
+    // default logi plugin behaviour is to set things to 0.5 for some reason
+    // "Pedals will output a value of 0.5 until the wheel/pedals receive any kind of input."
+    // https://github.com/HARPLab/LogitechWheelPlugin
+    bool bPedalsDefaulting = true;
+    float SteeringLast = 0.f, ThrottleLast = 0.f, BrakeLast = 0.f;
+};
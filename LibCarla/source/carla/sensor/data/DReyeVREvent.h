@@ -155,6 +155,35 @@ class DReyeVREvent : public SensorData
     {
         return InternalData.HoldHandbrake;
     }
+    // haptic shared control
+    bool GetHapticActive() const
+    {
+        return InternalData.HapticActive;
+    }
+    float GetHapticTorque() const
+    {
+        return InternalData.HapticTorque;
+    }
+    float GetHapticCoefficient() const
+    {
+        return InternalData.HapticCoefficient;
+    }
+    float GetHapticDesiredSteeringAngle() const
+    {
+        return InternalData.HapticDesiredSteeringAngle;
+    }
+    float GetHapticError() const
+    {
+        return InternalData.HapticError;
+    }
+    float GetHapticPredictedError() const
+    {
+        return InternalData.HapticPredictedError;
+    }
+    const geom::Vector3D &GetHapticPredictedLocation() const
+    {
+        return InternalData.HapticPredictedLocation;
+    }
 
   private:
     carla::sensor::s11n::DReyeVRSerializer::Data InternalData;
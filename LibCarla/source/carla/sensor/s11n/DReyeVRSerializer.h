@@ -68,6 +68,14 @@ class DReyeVRSerializer
         float Brake;
         bool ToggledReverse;
         bool HoldHandbrake;
+        // haptic shared control
+        bool HapticActive;
+        float HapticTorque;
+        float HapticCoefficient;
+        float HapticDesiredSteeringAngle;
+        float HapticError;
+        float HapticPredictedError;
+        geom::Vector3D HapticPredictedLocation;
 
         MSGPACK_DEFINE_ARRAY(TimestampCarla, TimestampDevice, FrameSequence, // timings
                              CameraLocation, CameraRotation,                 // camera
@@ -75,7 +83,9 @@ class DReyeVRSerializer
                              LGazeDir, LGazeOrigin, LGazeValid, LEyeOpenness, LEyeOpenValid, LPupilPos, LPupilPosValid, LPupilDiameter, // left gaze/eye
                              RGazeDir, RGazeOrigin, RGazeValid, REyeOpenness, REyeOpenValid, RPupilPos, RPupilPosValid, RPupilDiameter, // right gaze/eye
                              FocusActorName, FocusActorPoint, FocusActorDist,         // focus info
-                             Throttle, Steering, Brake, ToggledReverse, HoldHandbrake // user inputs
+                             Throttle, Steering, Brake, ToggledReverse, HoldHandbrake, // user inputs
+                             HapticActive, HapticTorque, HapticCoefficient, HapticDesiredSteeringAngle, HapticError,
+                             HapticPredictedError, HapticPredictedLocation // haptic shared control
         )
     };
 
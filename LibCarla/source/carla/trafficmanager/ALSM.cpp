@@ -1,4 +1,6 @@
 
+#include <algorithm>
+
 #include "boost/pointer_cast.hpp"
 
 #include "carla/client/Actor.h"
@@ -48,46 +50,56 @@ void ALSM::Update() {
 
   bool hybrid_physics_mode = parameters.GetHybridPhysicsMode();
 
-  std::set<ActorId> world_vehicle_ids;
-  std::set<ActorId> world_pedestrian_ids;
-  std::vector<ActorId> unregistered_list_to_be_deleted;
-
-  current_timestamp = world.GetSnapshot().GetTimestamp();
-  ActorList world_actors = world.GetActors();
+  const cc::WorldSnapshot snapshot = world.GetSnapshot();
+  current_timestamp = snapshot.GetTimestamp();
 
-  // Find destroyed actors and perform clean up.
-  const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(world_actors);
-
-  const ActorIdSet &destroyed_registered = destroyed_actors.first;
-  for (const auto &deletion_id: destroyed_registered) {
-    RemoveActor(deletion_id, true);
+  // Reconcile the actor sets only when an actor was spawned or destroyed or the registered
+  // vehicles changed, otherwise the sets and the cached classification are still up to date.
+  ActorId max_actor_id = 0u;
+  for (const auto &actor_snapshot : snapshot) {
+    max_actor_id = std::max(max_actor_id, actor_snapshot.id);
   }
+  const int registered_state = registered_vehicles.GetState();
+  if (snapshot.size() != known_actor_count || max_actor_id != known_max_actor_id
+      || registered_state != known_registered_state) {
+    known_actor_count = snapshot.size();
+    known_max_actor_id = max_actor_id;
+    known_registered_state = registered_state;
+
+    // Find destroyed actors and perform clean up.
+    const ALSM::DestroyeddActors destroyed_actors = IdentifyDestroyedActors(snapshot);
+
+    const ActorIdSet &destroyed_registered = destroyed_actors.first;
+    for (const auto &deletion_id: destroyed_registered) {
+      RemoveActor(deletion_id, true);
+    }
 
-  const ActorIdSet &destroyed_unregistered = destroyed_actors.second;
-  for (auto deletion_id : destroyed_unregistered) {
-    RemoveActor(deletion_id, false);
-  }
+    const ActorIdSet &destroyed_unregistered = destroyed_actors.second;
+    for (auto deletion_id : destroyed_unregistered) {
+      RemoveActor(deletion_id, false);
+    }
 
-  // Invalidate hero actor if it is not alive anymore.
-  if (hero_actors.size() != 0u) {
-    ActorIdSet hero_actors_to_delete;
-    for (auto &hero_actor_info: hero_actors) {
-      if (destroyed_unregistered.find(hero_actor_info.first) != destroyed_unregistered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
+    // Invalidate hero actor if it is not alive anymore.
+    if (hero_actors.size() != 0u) {
+      ActorIdSet hero_actors_to_delete;
+      for (auto &hero_actor_info: hero_actors) {
+        if (destroyed_unregistered.find(hero_actor_info.first) != destroyed_unregistered.end()) {
+          hero_actors_to_delete.insert(hero_actor_info.first);
+        }
+        if (destroyed_registered.find(hero_actor_info.first) != destroyed_registered.end()) {
+          hero_actors_to_delete.insert(hero_actor_info.first);
+        }
       }
-      if (destroyed_registered.find(hero_actor_info.first) != destroyed_registered.end()) {
-        hero_actors_to_delete.insert(hero_actor_info.first);
+
+      for (auto &deletion_id: hero_actors_to_delete) {
+        hero_actors.erase(deletion_id);
       }
     }
 
-    for (auto &deletion_id: hero_actors_to_delete) {
-      hero_actors.erase(deletion_id);
-    }
+    // Scan for new unregistered actors.
+    IdentifyNewActors(snapshot);
   }
 
-  // Scan for new unregistered actors.
-  IdentifyNewActors(world_actors);
-
   // Update dynamic state and static attributes for all registered vehicles.
   ALSM::IdleInfo max_idle_time = std::make_pair(0u, current_timestamp.elapsed_seconds);
   UpdateRegisteredActorsData(hybrid_physics_mode, max_idle_time);
@@ -114,44 +126,67 @@ void ALSM::Update() {
   UpdateUnregisteredActorsData();
 }
 
-void ALSM::IdentifyNewActors(const ActorList &actor_list) {
-  for (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    ActorPtr actor = *iter;
-    ActorId actor_id = actor->GetId();
-    // Identify any new hero vehicle
-    if (actor->GetTypeId().front() == 'v' || actor->GetTypeId().rfind("harplab.dreyevr_vehicle.") == 0) {
-     if (hero_actors.size() == 0u || hero_actors.find(actor_id) == hero_actors.end()) {
-      for (auto&& attribute: actor->GetAttributes()) {
-        if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero") {
-          hero_actors.insert({actor_id, actor});
-        }
-      }
+void ALSM::IdentifyNewActors(const cc::WorldSnapshot &snapshot) {
+  // Fetch and classify only the actors spawned since last reconciliation.
+  std::vector<ActorId> new_actor_ids;
+  for (const auto &actor_snapshot : snapshot) {
+    if (known_actors.find(actor_snapshot.id) == known_actors.end()) {
+      new_actor_ids.push_back(actor_snapshot.id);
     }
   }
+  if (!new_actor_ids.empty()) {
+    ActorList new_actors = world.GetActors(new_actor_ids);
+    for (auto iter = new_actors->begin(); iter != new_actors->end(); ++iter) {
+      known_actors.insert({(*iter)->GetId(), ClassifyActor(*iter)});
+    }
+    if (new_actors->size() != new_actor_ids.size()) {
+      known_actor_count = 0u; // some were not received yet, retry next update
+    }
+  }
+
+  for (const auto &known_actor_info : known_actors) {
+    const ActorId actor_id = known_actor_info.first;
+    const KnownActor &known_actor = known_actor_info.second;
+    // Identify any new hero vehicle
+    if (known_actor.is_hero && hero_actors.find(actor_id) == hero_actors.end()) {
+      hero_actors.insert({actor_id, known_actor.actor});
+    }
     if (!registered_vehicles.Contains(actor_id)
         && unregistered_actors.find(actor_id) == unregistered_actors.end()) {
 
-      unregistered_actors.insert({actor_id, actor});
+      unregistered_actors.insert({actor_id, known_actor.actor});
+    }
+  }
+}
+
+ALSM::KnownActor ALSM::ClassifyActor(const ActorPtr &actor) {
+  KnownActor known_actor {actor, ActorType::Any, false};
+  const std::string &type_id = actor->GetTypeId();
+  if (type_id.front() == 'v' || type_id.rfind("harplab.dreyevr_vehicle.", 0) == 0) { // include DReyeVR vehicle
+    known_actor.type = ActorType::Vehicle;
+    for (auto&& attribute: actor->GetAttributes()) {
+      if (attribute.GetId() == "role_name" && attribute.GetValue() == "hero") {
+        known_actor.is_hero = true;
+        break;
+      }
     }
   }
+  else if (type_id.front() == 'w') {
+    known_actor.type = ActorType::Pedestrian;
+  }
+  return known_actor;
 }
 
-ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list) {
+ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const cc::WorldSnapshot &snapshot) {
 
   ALSM::DestroyeddActors destroyed_actors;
   ActorIdSet &deleted_registered = destroyed_actors.first;
   ActorIdSet &deleted_unregistered = destroyed_actors.second;
 
-  // Building hash set of actors present in current frame.
-  ActorIdSet current_actors;
-  for  (auto iter = actor_list->begin(); iter != actor_list->end(); ++iter) {
-    current_actors.insert((*iter)->GetId());
-  }
-
   // Searching for destroyed registered actors.
   std::vector<ActorId> registered_ids = registered_vehicles.GetIDList();
   for (const ActorId &actor_id : registered_ids) {
-    if (current_actors.find(actor_id) == current_actors.end()) {
+    if (!snapshot.Contains(actor_id)) {
       deleted_registered.insert(actor_id);
     }
   }
@@ -159,12 +194,21 @@ ALSM::DestroyeddActors ALSM::IdentifyDestroyedActors(const ActorList &actor_list
   // Searching for destroyed unregistered actors.
   for (const auto &actor_info: unregistered_actors) {
     const ActorId &actor_id = actor_info.first;
-     if (current_actors.find(actor_id) == current_actors.end()
+     if (!snapshot.Contains(actor_id)
          || registered_vehicles.Contains(actor_id)) {
       deleted_unregistered.insert(actor_id);
     }
   }
 
+  // Forgetting the classification of destroyed actors.
+  for (auto iter = known_actors.begin(); iter != known_actors.end();) {
+    if (!snapshot.Contains(iter->first)) {
+      iter = known_actors.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
   return destroyed_actors;
 }
 
@@ -178,6 +222,20 @@ void ALSM::UpdateRegisteredActorsData(const bool hybrid_physics_mode, ALSM::Idle
   if (is_respawn_vehicles && !hero_actor_present) {
     track_traffic.SetHeroLocation(cg::Location(0,0,0));
   }
+  // One radius query per hero actor over the grid of vehicle locations, instead of testing
+  // every vehicle against every hero actor.
+  vehicles_near_hero.clear();
+  if (hybrid_physics_mode && hero_actor_present) {
+    vehicle_grid.SetCellSize(physics_radius);
+    for (auto &hero_actor_info: hero_actors) {
+      if (simulation_state.ContainsActor(hero_actor_info.first)) {
+        vehicle_grid.ForEachInRadius(simulation_state.GetLocation(hero_actor_info.first), physics_radius,
+                                     [this](const ActorId actor_id) { vehicles_near_hero.insert(actor_id); });
+      }
+    }
+  } else if (vehicle_grid.Size() != 0u) {
+    vehicle_grid.Clear();
+  }
   // Update first the information regarding any hero vehicle.
   for (auto &hero_actor_info: hero_actors){
     if (is_respawn_vehicles) {
@@ -212,16 +270,22 @@ void ALSM::UpdateData(const bool hybrid_physics_mode,
   // Check if current actor is in range of hero actor and enable physics in hybrid mode.
   bool in_range_of_hero_actor = false;
   if (hero_actor_present && hybrid_physics_mode) {
-    for (auto &hero_actor_info: hero_actors) {
-      const ActorId &hero_actor_id =  hero_actor_info.first;
-      if (simulation_state.ContainsActor(hero_actor_id)) {
-        const cg::Location &hero_location = simulation_state.GetLocation(hero_actor_id);
-        if (cg::Math::DistanceSquared(vehicle_location, hero_location) < physics_radius_square) {
-          in_range_of_hero_actor = true;
-          break;
+    if (vehicle_grid.Contains(actor_id)) {
+      in_range_of_hero_actor = vehicles_near_hero.find(actor_id) != vehicles_near_hero.end();
+    } else {
+      // Not in the grid yet, test it against every hero actor.
+      for (auto &hero_actor_info: hero_actors) {
+        const ActorId &hero_actor_id =  hero_actor_info.first;
+        if (simulation_state.ContainsActor(hero_actor_id)) {
+          const cg::Location &hero_location = simulation_state.GetLocation(hero_actor_id);
+          if (cg::Math::DistanceSquared(vehicle_location, hero_location) < physics_radius_square) {
+            in_range_of_hero_actor = true;
+            break;
+          }
         }
       }
     }
+    vehicle_grid.Update(actor_id, vehicle_location);
   }
 
   bool enable_physics = hybrid_physics_mode ? in_range_of_hero_actor : true;
@@ -279,7 +343,8 @@ void ALSM::UpdateUnregisteredActorsData() {
 
     const ActorId actor_id = actor_info.first;
     const ActorPtr actor_ptr = actor_info.second;
-    const std::string type_id = actor_ptr->GetTypeId();
+    const auto known_actor = known_actors.find(actor_id);
+    const ActorType known_type = known_actor != known_actors.end() ? known_actor->second.type : ActorType::Any;
 
     const cg::Transform actor_transform = actor_ptr->GetTransform();
     const cg::Location actor_location = actor_transform.location;
@@ -294,7 +359,7 @@ void ALSM::UpdateUnregisteredActorsData() {
     std::vector<SimpleWaypointPtr> nearest_waypoints;
 
     bool state_entry_not_present = !simulation_state.ContainsActor(actor_id);
-    if (type_id.front() == 'v' || type_id.rfind("harplab.dreyevr_vehicle.") == 0) { // include DReyeVR vehicle
+    if (known_type == ActorType::Vehicle) { // includes DReyeVR vehicle
       auto vehicle_ptr = boost::static_pointer_cast<cc::Vehicle>(actor_ptr);
       kinematic_state.speed_limit = vehicle_ptr->GetSpeedLimit();
 
@@ -322,7 +387,7 @@ void ALSM::UpdateUnregisteredActorsData() {
         nearest_waypoints.push_back(nearest_waypoint);
       }
     }
-    else if (type_id.front() == 'w') {
+    else if (known_type == ActorType::Pedestrian) {
       auto walker_ptr = boost::static_pointer_cast<cc::Walker>(actor_ptr);
 
       if (state_entry_not_present) {
@@ -389,12 +454,19 @@ void ALSM::RemoveActor(const ActorId actor_id, const bool registered_actor) {
 
   track_traffic.DeleteActor(actor_id);
   simulation_state.RemoveActor(actor_id);
+  vehicle_grid.Remove(actor_id);
 }
 
 void ALSM::Reset() {
   unregistered_actors.clear();
   idle_time.clear();
   hero_actors.clear();
+  known_actors.clear();
+  known_actor_count = 0u;
+  known_max_actor_id = 0u;
+  known_registered_state = -1;
+  vehicle_grid.Clear();
+  vehicles_near_hero.clear();
   elapsed_last_actor_destruction = 0.0;
   current_timestamp = world.GetSnapshot().GetTimestamp();
 }
@@ -0,0 +1,139 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <memory>
+
+#include "carla/client/ActorList.h"
+#include "carla/client/Timestamp.h"
+#include "carla/client/World.h"
+#include "carla/client/WorldSnapshot.h"
+#include "carla/Memory.h"
+
+#include "carla/trafficmanager/AtomicActorSet.h"
+#include "carla/trafficmanager/CollisionStage.h"
+#include "carla/trafficmanager/DataStructures.h"
+#include "carla/trafficmanager/InMemoryMap.h"
+#include "carla/trafficmanager/LocalizationStage.h"
+#include "carla/trafficmanager/MotionPlanStage.h"
+#include "carla/trafficmanager/Parameters.h"
+#include "carla/trafficmanager/RandomGenerator.h"
+#include "carla/trafficmanager/SimulationState.h"
+#include "carla/trafficmanager/SpatialHashGrid.h"
+#include "carla/trafficmanager/TrafficLightStage.h"
+#include "carla/trafficmanager/VehicleLightStage.h"
+
+namespace carla {
+namespace traffic_manager {
+
+using namespace cc;
+
+using ActorMap = std::unordered_map<ActorId, ActorPtr>;
+using IdleTimeMap = std::unordered_map<ActorId, double>;
+using LocalMapPtr = std::shared_ptr<InMemoryMap>;
+
+/// ALSM: Agent Lifecycle and State Managerment
+/// This class has functionality to update the local cache of kinematic states
+/// and manage memory and cleanup for varying number of vehicles in the simulation.
+class ALSM {
+
+private:
+  AtomicActorSet &registered_vehicles;
+  // Structure to keep track of duration between simulation steps.
+  ActorMap unregistered_actors;
+  BufferMap &buffer_map;
+  IdleTimeMap idle_time;
+  ActorMap hero_actors;
+  TrackTraffic &track_traffic;
+  std::vector<ActorId>& marked_for_removal;
+  const Parameters &parameters;
+  const cc::World &world;
+  const LocalMapPtr &local_map;
+  SimulationState &simulation_state;
+  LocalizationStage &localization_stage;
+  CollisionStage &collision_stage;
+  TrafficLightStage &traffic_light_stage;
+  MotionPlanStage &motion_plan_stage;
+  VehicleLightStage &vehicle_light_stage;
+  // Time elapsed since last vehicle destruction due to being idle for too long.
+  double elapsed_last_actor_destruction {0.0};
+  cc::Timestamp current_timestamp;
+  std::unordered_map<ActorId, bool> has_physics_enabled;
+  // Random devices.
+  RandomGeneratorMap &random_devices;
+
+  // Every actor of the episode, classified once (type id and role name) when it first appears.
+  struct KnownActor {
+    ActorPtr actor;
+    ActorType type;
+    bool is_hero;
+  };
+  std::unordered_map<ActorId, KnownActor> known_actors;
+  // Fingerprint of the actor set and of the registered vehicles at the last reconciliation.
+  // Actor ids are never reused, so the actor set changed iff its size or its largest id did.
+  size_t known_actor_count {0u};
+  ActorId known_max_actor_id {0u};
+  int known_registered_state {-1};
+  // Locations of the vehicles updated in hybrid physics mode, for radius queries around hero actors.
+  SpatialHashGrid vehicle_grid;
+  // Vehicles within the physics radius of any hero actor, found at the start of the update.
+  ActorIdSet vehicles_near_hero;
+
+  // Updates the duration for each vehicle to be idle.
+  void UpdateIdleTime(std::pair<ActorId, double>& max_idle_time, const ActorId& actor_id);
+
+  // Method to determine if a vehicle is stuck in traffic.
+  bool IsVehicleStuck(const ActorId& actor_id);
+
+  // Method to identify actors newly spawned in the simulation since last reconciliation
+  // and classify them (fetching only those from the episode).
+  void IdentifyNewActors(const cc::WorldSnapshot &snapshot);
+
+  using DestroyeddActors = std::pair<ActorIdSet, ActorIdSet>;
+  // Method to identify actors deleted since last reconciliation.
+  // Arrays of registered and unregistered actors are returned separately.
+  DestroyeddActors IdentifyDestroyedActors(const cc::WorldSnapshot &snapshot);
+
+  // Classifies a newly seen actor.
+  static KnownActor ClassifyActor(const ActorPtr &actor);
+
+  using IdleInfo = std::pair<ActorId, double>;
+  void UpdateRegisteredActorsData(const bool hybrid_physics_mode, IdleInfo &max_idle_time);
+
+  void UpdateData(const bool hybrid_physics_mode, IdleInfo &max_idle_time, const Actor &vehicle,
+                  const bool hero_actor_present, const float physics_radius_square);
+
+  // Method to update information for unregistered actors.
+  void UpdateUnregisteredActorsData();
+
+public:
+  ALSM(AtomicActorSet &registered_vehicles,
+       BufferMap &buffer_map,
+       TrackTraffic &track_traffic,
+       std::vector<ActorId>& marked_for_removal,
+       const Parameters &parameters,
+       const cc::World &world,
+       const LocalMapPtr &local_map,
+       SimulationState &simulation_state,
+       LocalizationStage &localization_stage,
+       CollisionStage &collision_stage,
+       TrafficLightStage &traffic_light_stage,
+       MotionPlanStage &motion_plan_stage,
+       VehicleLightStage &vehicle_light_stage,
+       RandomGeneratorMap &random_devices);
+
+  void Update();
+
+  // Removes an actor from traffic manager and performs clean up of associated data
+  // from various stages tracking the said vehicle.
+  void RemoveActor(const ActorId actor_id, const bool registered_actor);
+
+  void Reset();
+};
+
+} // namespace traffic_manager
+} // namespace carla
@@ -0,0 +1,160 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "carla/geom/Location.h"
+#include "carla/geom/Math.h"
+#include "carla/rpc/ActorId.h"
+
+namespace carla {
+namespace traffic_manager {
+
+namespace cg = carla::geom;
+
+/// Uniform grid over the (x, y) locations of actors. A radius query only visits
+/// the cells overlapping the query circle, so its cost depends on the number of
+/// actors near the query point rather than on the total number of actors.
+class SpatialHashGrid {
+
+public:
+  using ActorId = carla::rpc::ActorId;
+
+  explicit SpatialHashGrid(const float initial_cell_size = 50.0f)
+    : cell_size(ClampCellSize(initial_cell_size)) {}
+
+  /// Re-buckets every actor when the cell size changes.
+  void SetCellSize(const float new_cell_size) {
+    const float clamped = ClampCellSize(new_cell_size);
+    if (clamped == cell_size) {
+      return;
+    }
+    cell_size = clamped;
+    cells.clear();
+    for (auto &entry : actors) {
+      entry.second.cell = CellOf(entry.second.location);
+      cells[entry.second.cell].push_back(entry.first);
+    }
+  }
+
+  float GetCellSize() const {
+    return cell_size;
+  }
+
+  /// Inserts or moves an actor; the buckets are only touched when its cell changes.
+  void Update(const ActorId actor_id, const cg::Location &location) {
+    const CellKey cell = CellOf(location);
+    auto found = actors.find(actor_id);
+    if (found == actors.end()) {
+      actors.insert({actor_id, Entry{cell, location}});
+      cells[cell].push_back(actor_id);
+      return;
+    }
+    found->second.location = location;
+    if (found->second.cell != cell) {
+      RemoveFromCell(found->second.cell, actor_id);
+      found->second.cell = cell;
+      cells[cell].push_back(actor_id);
+    }
+  }
+
+  void Remove(const ActorId actor_id) {
+    auto found = actors.find(actor_id);
+    if (found != actors.end()) {
+      RemoveFromCell(found->second.cell, actor_id);
+      actors.erase(found);
+    }
+  }
+
+  bool Contains(const ActorId actor_id) const {
+    return actors.find(actor_id) != actors.end();
+  }
+
+  size_t Size() const {
+    return actors.size();
+  }
+
+  void Clear() {
+    cells.clear();
+    actors.clear();
+  }
+
+  /// Calls callback(actor_id) for every actor closer than radius to center (3D distance).
+  template <typename Callback>
+  void ForEachInRadius(const cg::Location &center, const float radius, Callback &&callback) const {
+    const float radius_square = radius * radius;
+    const int32_t min_x = CellCoordinate(center.x - radius);
+    const int32_t max_x = CellCoordinate(center.x + radius);
+    const int32_t min_y = CellCoordinate(center.y - radius);
+    const int32_t max_y = CellCoordinate(center.y + radius);
+    for (int32_t x = min_x; x <= max_x; ++x) {
+      for (int32_t y = min_y; y <= max_y; ++y) {
+        auto cell = cells.find(Key(x, y));
+        if (cell == cells.end()) {
+          continue;
+        }
+        for (const ActorId actor_id : cell->second) {
+          if (cg::Math::DistanceSquared(actors.at(actor_id).location, center) < radius_square) {
+            callback(actor_id);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  using CellKey = uint64_t;
+
+  struct Entry {
+    CellKey cell;
+    cg::Location location;
+  };
+
+  static float ClampCellSize(const float value) {
+    return value < 1.0f ? 1.0f : value;
+  }
+
+  int32_t CellCoordinate(const float value) const {
+    return static_cast<int32_t>(std::floor(value / cell_size));
+  }
+
+  static CellKey Key(const int32_t x, const int32_t y) {
+    return (static_cast<CellKey>(static_cast<uint32_t>(x)) << 32u) | static_cast<uint32_t>(y);
+  }
+
+  CellKey CellOf(const cg::Location &location) const {
+    return Key(CellCoordinate(location.x), CellCoordinate(location.y));
+  }
+
+  void RemoveFromCell(const CellKey cell, const ActorId actor_id) {
+    auto found = cells.find(cell);
+    if (found == cells.end()) {
+      return;
+    }
+    std::vector<ActorId> &ids = found->second;
+    auto position = std::find(ids.begin(), ids.end(), actor_id);
+    if (position != ids.end()) {
+      *position = ids.back();
+      ids.pop_back();
+    }
+    if (ids.empty()) {
+      cells.erase(found);
+    }
+  }
+
+  float cell_size;
+  std::unordered_map<CellKey, std::vector<ActorId>> cells;
+  std::unordered_map<ActorId, Entry> actors;
+};
+
+} // namespace traffic_manager
+} // namespace carla
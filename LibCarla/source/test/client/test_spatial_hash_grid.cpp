@@ -0,0 +1,68 @@
+// Copyright (c) 2020 Computer Vision Center (CVC) at the Universitat Autonoma
+// de Barcelona (UAB).
+//
+// This work is licensed under the terms of the MIT license.
+// For a copy, see <https://opensource.org/licenses/MIT>.
+
+#include "test.h"
+
+#include <carla/trafficmanager/SpatialHashGrid.h>
+
+#include <random>
+#include <set>
+
+using carla::traffic_manager::SpatialHashGrid;
+using carla::geom::Location;
+
+static std::set<SpatialHashGrid::ActorId> InRadius(const SpatialHashGrid &grid, const Location &center, float radius) {
+  std::set<SpatialHashGrid::ActorId> result;
+  grid.ForEachInRadius(center, radius, [&](SpatialHashGrid::ActorId id) { result.insert(id); });
+  return result;
+}
+
+TEST(spatial_hash_grid, radius_query) {
+  SpatialHashGrid grid(10.0f);
+  grid.Update(1u, Location(0.0f, 0.0f, 0.0f));
+  grid.Update(2u, Location(9.0f, 0.0f, 0.0f));
+  grid.Update(3u, Location(-11.0f, 0.0f, 0.0f));   // neighbouring cell, out of range
+  grid.Update(4u, Location(0.0f, -25.0f, 0.0f));
+  ASSERT_EQ(grid.Size(), 4u);
+  ASSERT_EQ(InRadius(grid, Location(0.0f, 0.0f, 0.0f), 10.0f), (std::set<SpatialHashGrid::ActorId>{1u, 2u}));
+  ASSERT_EQ(InRadius(grid, Location(0.0f, -20.0f, 0.0f), 10.0f), (std::set<SpatialHashGrid::ActorId>{4u}));
+  ASSERT_TRUE(InRadius(grid, Location(500.0f, 500.0f, 0.0f), 10.0f).empty());
+}
+
+TEST(spatial_hash_grid, move_and_remove) {
+  SpatialHashGrid grid(10.0f);
+  grid.Update(1u, Location(0.0f, 0.0f, 0.0f));
+  grid.Update(1u, Location(100.0f, 0.0f, 0.0f)); // changes cell
+  grid.Update(1u, Location(101.0f, 0.0f, 0.0f)); // same cell
+  ASSERT_EQ(grid.Size(), 1u);
+  ASSERT_TRUE(InRadius(grid, Location(0.0f, 0.0f, 0.0f), 5.0f).empty());
+  ASSERT_EQ(InRadius(grid, Location(100.0f, 0.0f, 0.0f), 5.0f).size(), 1u);
+  grid.Remove(1u);
+  ASSERT_FALSE(grid.Contains(1u));
+  ASSERT_TRUE(InRadius(grid, Location(100.0f, 0.0f, 0.0f), 5.0f).empty());
+}
+
+TEST(spatial_hash_grid, matches_brute_force) {
+  std::mt19937 rng(7u);
+  std::uniform_real_distribution<float> coordinate(-500.0f, 500.0f);
+  SpatialHashGrid grid(30.0f);
+  std::vector<Location> locations;
+  for (SpatialHashGrid::ActorId id = 0u; id < 400u; ++id) {
+    locations.emplace_back(coordinate(rng), coordinate(rng), 0.0f);
+    grid.Update(id, locations.back());
+  }
+  grid.SetCellSize(50.0f); // re-buckets
+  for (int query = 0; query < 20; ++query) {
+    const Location center(coordinate(rng), coordinate(rng), 0.0f);
+    std::set<SpatialHashGrid::ActorId> expected;
+    for (SpatialHashGrid::ActorId id = 0u; id < locations.size(); ++id) {
+      if (carla::geom::Math::DistanceSquared(locations[id], center) < 50.0f * 50.0f) {
+        expected.insert(id);
+      }
+    }
+    ASSERT_EQ(InRadius(grid, center, 50.0f), expected);
+  }
+}
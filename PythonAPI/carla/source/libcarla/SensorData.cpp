@@ -614,6 +614,13 @@ void export_sensor_data() {
       .add_property("brake_input", CALL_RETURNING_COPY(csd::DReyeVREvent, GetBrake))
       .add_property("current_gear_input", CALL_RETURNING_COPY(csd::DReyeVREvent, GetToggledReverse))
       .add_property("handbrake_input", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHandbrake))
+      .add_property("haptic_active", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticActive))
+      .add_property("haptic_torque", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticTorque))
+      .add_property("haptic_coefficient", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticCoefficient))
+      .add_property("haptic_desired_steering_angle", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticDesiredSteeringAngle))
+      .add_property("haptic_error", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticError))
+      .add_property("haptic_predicted_error", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticPredictedError))
+      .add_property("haptic_predicted_location", CALL_RETURNING_COPY(csd::DReyeVREvent, GetHapticPredictedLocation))
       .def(self_ns::str(self_ns::self))
   ;
 }
@@ -0,0 +1,384 @@
+#include "RecordingAnalysis.h"
+#include "Carla/Recorder/DReyeVRRecorder.h" // DReyeVRDataRecorder
+#include "RecordingPackets.h"               // RecordingFrame, RecordingCollision, ...
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+struct PairHash
+{
+    std::size_t operator()(const std::pair<uint32_t, uint32_t> &P) const
+    {
+        return (static_cast<std::size_t>(P.first) << 32) + P.second;
+    }
+};
+
+struct BlockedActorInfo
+{
+    FVector LastPosition;
+    double Duration = 0.0;
+};
+
+void FinalizeFrameTimes(std::vector<double> &FrameTimes, RecordingSummary &Summary)
+{
+    if (FrameTimes.empty())
+        return;
+    double Sum = 0.0;
+    for (double Dt : FrameTimes)
+        Sum += Dt;
+    Summary.FrameTimeMean = Sum / FrameTimes.size();
+    double SqDiff = 0.0;
+    for (double Dt : FrameTimes)
+        SqDiff += (Dt - Summary.FrameTimeMean) * (Dt - Summary.FrameTimeMean);
+    Summary.FrameTimeJitter = std::sqrt(SqDiff / FrameTimes.size());
+    std::sort(FrameTimes.begin(), FrameTimes.end());
+    Summary.FrameTimeMin = FrameTimes.front();
+    Summary.FrameTimeMax = FrameTimes.back();
+    const size_t P99Idx = std::min(FrameTimes.size() - 1, static_cast<size_t>(0.99 * FrameTimes.size()));
+    Summary.FrameTimeP99 = FrameTimes[P99Idx];
+}
+
+std::string EscapeJson(const std::string &In)
+{
+    std::string Out;
+    for (char C : In)
+    {
+        if (C == '"' || C == '\\')
+            Out += '\\';
+        Out += C;
+    }
+    return Out;
+}
+
+std::string QuoteCsv(const std::string &In)
+{
+    // RFC 4180: commas and newlines are safe within quotes, quotes are doubled
+    std::string Out = "\"";
+    for (char C : In)
+    {
+        if (C == '"')
+            Out += '"';
+        Out += C;
+    }
+    return Out + "\"";
+}
+} // namespace
+
+RecordingSummary AnalyzeRecording(const std::string &Filename, const RecordingAnalysisParams &Params)
+{
+    RecordingSummary Summary;
+    Summary.Filename = Filename;
+
+    std::ifstream File(Filename, std::ios::binary);
+    if (!File.is_open())
+    {
+        Summary.Error = "unable to open file";
+        return Summary;
+    }
+
+    File.seekg(0, std::ios::end);
+    const std::streampos FileSize = File.tellg();
+    File.seekg(0, std::ios::beg);
+
+    RecordingInfo Info;
+    Info.Read(File);
+    if (!File || Info.Magic != "CARLA_RECORDER")
+    {
+        Summary.Error = "not a CARLA recorder file";
+        return Summary;
+    }
+    Summary.bValid = true;
+    Summary.Version = Info.Version;
+    Summary.Map = TCHAR_TO_UTF8(*Info.Mapfile);
+
+    RecordingPacketHeader Header;
+    RecordingFrame Frame{0, 0.0, 0.0};
+    RecordingCollision Collision;
+    RecordingEventAdd EventAdd;
+    RecordingPosition Position;
+    uint32_t EventDelId;
+    DReyeVRDataRecorder<DReyeVR::AggregateData> DReyeVRAggData;
+    DReyeVRDataRecorder<DReyeVR::CustomActorData> DReyeVRCustomActorData;
+    DReyeVRDataRecorder<DReyeVR::CustomActorDelta> DReyeVRCustomActorDelta;
+    DReyeVRDataRecorder<DReyeVR::QualityChangeData> DReyeVRQualityData;
+    int QualityLevel = 0;
+
+    std::vector<double> FrameTimes;
+    std::unordered_set<std::pair<uint32_t, uint32_t>, PairHash> OldCollisions, NewCollisions;
+    std::unordered_map<uint32_t, BlockedActorInfo> Actors;
+    size_t GazeValid[3] = {0, 0, 0}; // combined, left, right
+    size_t OpennessValid[2] = {0, 0}; // left, right
+    std::vector<GazeSample> GazeTrace; // on the eye tracker clock
+
+    auto FinishBlocked = [&](BlockedActorInfo &Actor) {
+        if (Actor.Duration >= Params.BlockedMinTime)
+        {
+            Summary.BlockedActors++;
+            Summary.LongestBlocked = std::max(Summary.LongestBlocked, Actor.Duration);
+        }
+        Actor.Duration = 0.0;
+    };
+
+    uint16_t i, Total;
+    while (File)
+    {
+        ReadValue<char>(File, Header.Id);
+        ReadValue<uint32_t>(File, Header.Size);
+        if (!File)
+            break; // clean end of file
+        const std::streampos PacketEnd = File.tellg() + static_cast<std::streamoff>(Header.Size);
+
+        switch (Header.Id)
+        {
+        case static_cast<char>(CarlaRecorderPacketId::FrameStart):
+            ReadValue<RecordingFrame>(File, Frame);
+            Summary.Frames++;
+            // first frame has no meaningful delta
+            if (Summary.Frames > 1)
+                FrameTimes.push_back(Frame.DurationThis);
+            if (QualityLevel > 0)
+                Summary.ReducedQualityTime += Frame.DurationThis;
+            OldCollisions = std::move(NewCollisions);
+            NewCollisions.clear();
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::EventAdd):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                EventAdd.Read(File);
+                Actors[EventAdd.DatabaseId] = BlockedActorInfo{};
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::EventDel):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                ReadValue<uint32_t>(File, EventDelId);
+                auto It = Actors.find(EventDelId);
+                if (It != Actors.end())
+                {
+                    FinishBlocked(It->second);
+                    Actors.erase(It);
+                }
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::Collision):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                Collision.Read(File);
+                const auto Pair = std::make_pair(Collision.DatabaseId1, Collision.DatabaseId2);
+                // a collision continuing from the previous frame is not a new one
+                if (OldCollisions.count(Pair) == 0 && NewCollisions.count(Pair) == 0)
+                {
+                    Summary.Collisions++;
+                    if (Collision.IsActor1Hero || Collision.IsActor2Hero)
+                        Summary.HeroCollisions++;
+                }
+                NewCollisions.insert(Pair);
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::Position):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                ReadValue<RecordingPosition>(File, Position);
+                BlockedActorInfo &Actor = Actors[Position.DatabaseId];
+                if (FVector::Distance(Actor.LastPosition, Position.Location) < Params.BlockedMinDistance)
+                {
+                    Actor.Duration += Frame.DurationThis; // actor stopped
+                }
+                else
+                {
+                    FinishBlocked(Actor); // actor moving
+                    Actor.LastPosition = Position.Location;
+                }
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVR):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                DReyeVRAggData.Read(File);
+                const DReyeVR::AggregateData &Data = DReyeVRAggData.Data;
+                Summary.DReyeVRSamples++;
+                GazeValid[0] += Data.GetGazeValidity(DReyeVR::Gaze::COMBINED);
+                GazeValid[1] += Data.GetGazeValidity(DReyeVR::Gaze::LEFT);
+                GazeValid[2] += Data.GetGazeValidity(DReyeVR::Gaze::RIGHT);
+                OpennessValid[0] += Data.GetEyeOpennessValidity(DReyeVR::Eye::LEFT);
+                OpennessValid[1] += Data.GetEyeOpennessValidity(DReyeVR::Eye::RIGHT);
+                if (!Params.GazeLatenciesMs.empty())
+                {
+                    const FVector &Dir = Data.GetGazeDir();
+                    GazeTrace.push_back({static_cast<double>(Data.GetTimestampDevice()), {Dir.X, Dir.Y, Dir.Z},
+                                         Data.GetGazeValidity()});
+                }
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActor):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                DReyeVRCustomActorData.Read(File);
+                Summary.CustomActorRecords++;
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActorDelta):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                DReyeVRCustomActorDelta.Read(File);
+                Summary.CustomActorRecords++;
+            }
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRConfigFile):
+            Summary.bHasConfigFile = true;
+            break;
+
+        case static_cast<char>(CarlaRecorderPacketId::DReyeVRQuality):
+            ReadValue<uint16_t>(File, Total);
+            for (i = 0; i < Total; ++i)
+            {
+                DReyeVRQualityData.Read(File);
+                QualityLevel = DReyeVRQualityData.Data.Level;
+                Summary.QualityChanges++;
+                Summary.MaxQualityLevel = std::max(Summary.MaxQualityLevel, QualityLevel);
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        // always resynchronize on the packet boundary (also skips everything not handled above)
+        if (!File || PacketEnd > FileSize)
+        {
+            Summary.bTruncated = true;
+            break;
+        }
+        File.seekg(PacketEnd, std::ios::beg);
+    }
+
+    // actors that were still stopped at the end of the recording
+    for (auto &Actor : Actors)
+        FinishBlocked(Actor.second);
+
+    Summary.Duration = Frame.Elapsed;
+    FinalizeFrameTimes(FrameTimes, Summary);
+    if (Summary.DReyeVRSamples > 0)
+    {
+        const double N = static_cast<double>(Summary.DReyeVRSamples);
+        Summary.GazeValidCombined = GazeValid[0] / N;
+        Summary.GazeValidLeft = GazeValid[1] / N;
+        Summary.GazeValidRight = GazeValid[2] / N;
+        Summary.EyeOpennessValidLeft = OpennessValid[0] / N;
+        Summary.EyeOpennessValidRight = OpennessValid[1] / N;
+    }
+    for (float LatencyMs : Params.GazeLatenciesMs)
+        Summary.GazePrediction.push_back(EvaluateGazePrediction(GazeTrace, Params.GazePrediction, LatencyMs));
+    return Summary;
+}
+
+std::string SummaryToJson(const RecordingSummary &S)
+{
+    std::ostringstream Out;
+    Out << std::setprecision(6) << std::fixed;
+    Out << "{\n";
+    Out << "  \"file\": \"" << EscapeJson(S.Filename) << "\",\n";
+    Out << "  \"valid\": " << (S.bValid ? "true" : "false") << ",\n";
+    if (!S.bValid)
+    {
+        Out << "  \"error\": \"" << EscapeJson(S.Error) << "\"\n}\n";
+        return Out.str();
+    }
+    Out << "  \"truncated\": " << (S.bTruncated ? "true" : "false") << ",\n";
+    Out << "  \"version\": " << S.Version << ",\n";
+    Out << "  \"map\": \"" << EscapeJson(S.Map) << "\",\n";
+    Out << "  \"frames\": " << S.Frames << ",\n";
+    Out << "  \"duration\": " << S.Duration << ",\n";
+    Out << "  \"frame_time\": {\"mean\": " << S.FrameTimeMean << ", \"jitter\": " << S.FrameTimeJitter
+        << ", \"min\": " << S.FrameTimeMin << ", \"max\": " << S.FrameTimeMax << ", \"p99\": " << S.FrameTimeP99
+        << "},\n";
+    Out << "  \"collisions\": " << S.Collisions << ",\n";
+    Out << "  \"hero_collisions\": " << S.HeroCollisions << ",\n";
+    Out << "  \"blocked_actors\": " << S.BlockedActors << ",\n";
+    Out << "  \"longest_blocked\": " << S.LongestBlocked << ",\n";
+    Out << "  \"dreyevr\": {\"samples\": " << S.DReyeVRSamples << ", \"gaze_valid_combined\": " << S.GazeValidCombined
+        << ", \"gaze_valid_left\": " << S.GazeValidLeft << ", \"gaze_valid_right\": " << S.GazeValidRight
+        << ", \"eye_openness_valid_left\": " << S.EyeOpennessValidLeft
+        << ", \"eye_openness_valid_right\": " << S.EyeOpennessValidRight
+        << ", \"custom_actor_records\": " << S.CustomActorRecords
+        << ", \"has_config_file\": " << (S.bHasConfigFile ? "true" : "false") << ", \"quality_changes\": " << S.QualityChanges
+        << ", \"max_quality_level\": " << S.MaxQualityLevel << ", \"reduced_quality_time\": " << S.ReducedQualityTime
+        << "}" << (S.GazePrediction.empty() ? "" : ",") << "\n";
+    if (!S.GazePrediction.empty())
+    {
+        Out << "  \"gaze_prediction\": [";
+        for (size_t i = 0; i < S.GazePrediction.size(); i++)
+        {
+            const GazePredictionError &E = S.GazePrediction[i];
+            Out << (i == 0 ? "" : ", ") << "{\"latency_ms\": " << E.LatencyMs << ", \"samples\": " << E.Samples
+                << ", \"hold_mean_deg\": " << E.HoldMeanDeg << ", \"hold_p95_deg\": " << E.HoldP95Deg
+                << ", \"predicted_mean_deg\": " << E.PredictedMeanDeg
+                << ", \"predicted_p95_deg\": " << E.PredictedP95Deg << "}";
+        }
+        Out << "]\n";
+    }
+    Out << "}\n";
+    return Out.str();
+}
+
+std::string SummaryCsvHeader()
+{
+    return "file,valid,truncated,map,frames,duration,frame_time_mean,frame_time_jitter,frame_time_max,"
+           "frame_time_p99,collisions,hero_collisions,blocked_actors,dreyevr_samples,gaze_valid_combined,"
+           "gaze_valid_left,gaze_valid_right,error";
+}
+
+std::string SummaryToCsvRow(const RecordingSummary &S)
+{
+    std::ostringstream Out;
+    Out << std::setprecision(6) << std::fixed;
+    Out << QuoteCsv(S.Filename) << "," << S.bValid << "," << S.bTruncated << "," << QuoteCsv(S.Map) << "," << S.Frames
+        << "," << S.Duration << "," << S.FrameTimeMean << "," << S.FrameTimeJitter << "," << S.FrameTimeMax << ","
+        << S.FrameTimeP99 << "," << S.Collisions << "," << S.HeroCollisions << "," << S.BlockedActors << ","
+        << S.DReyeVRSamples << "," << S.GazeValidCombined << "," << S.GazeValidLeft << "," << S.GazeValidRight << ","
+        << QuoteCsv(S.Error);
+    return Out.str();
+}
+
+std::vector<RecordingSummary> AnalyzeRecordings(const std::vector<std::string> &Filenames,
+                                                const RecordingAnalysisParams &Params, size_t NumWorkers)
+{
+    std::vector<RecordingSummary> Results(Filenames.size());
+    std::atomic<size_t> NextIdx{0};
+    // each worker pulls the next unclaimed file until the list is exhausted
+    auto Worker = [&]() {
+        for (size_t Idx = NextIdx++; Idx < Filenames.size(); Idx = NextIdx++)
+            Results[Idx] = AnalyzeRecording(Filenames[Idx], Params);
+    };
+    NumWorkers = std::max<size_t>(1, std::min(NumWorkers, Filenames.size()));
+    std::vector<std::thread> Workers;
+    for (size_t w = 1; w < NumWorkers; w++)
+        Workers.emplace_back(Worker);
+    Worker(); // calling thread participates too
+    for (std::thread &T : Workers)
+        T.join();
+    return Results;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "DReyeVR/GazePredictor.h" // GazePredictionError
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// offline (no simulator) analysis of a single CARLA/DReyeVR recording, same packet walk as CarlaRecorderQuery
+// but collecting summary statistics rather than printing every event
+
+struct RecordingAnalysisParams
+{
+    // same defaults as CarlaRecorderQuery::QueryBlocked
+    double BlockedMinTime = 30.0;     // seconds an actor must be stationary to count as blocked
+    double BlockedMinDistance = 10.0; // cm an actor must move to count as not blocked
+
+    // replay the recorded combined gaze through the GazePredictor for each of these latencies (none: skipped)
+    std::vector<float> GazeLatenciesMs;
+    GazePredictorParams GazePrediction;
+};
+
+struct RecordingSummary
+{
+    std::string Filename;
+    bool bValid = false;    // false if the file could not be opened or is not a CARLA recording
+    bool bTruncated = false; // a packet ran past the end of the file (ex. simulator crashed mid-recording)
+    std::string Error;
+
+    // general info
+    uint16_t Version = 0;
+    std::string Map;
+    uint64_t Frames = 0;
+    double Duration = 0.0; // seconds
+
+    // frame timing (seconds), jitter is the standard deviation of the per-frame delta
+    double FrameTimeMean = 0.0;
+    double FrameTimeJitter = 0.0;
+    double FrameTimeMin = 0.0;
+    double FrameTimeMax = 0.0;
+    double FrameTimeP99 = 0.0;
+
+    // events
+    size_t Collisions = 0;     // distinct collision starts (same rule as QueryCollisions)
+    size_t HeroCollisions = 0; // ...of which involve the hero (ego) vehicle
+    size_t BlockedActors = 0;  // blocked episodes (same rule as QueryBlocked)
+    double LongestBlocked = 0.0;
+
+    // DReyeVR
+    size_t DReyeVRSamples = 0;
+    double GazeValidCombined = 0.0; // rates in [0, 1]
+    double GazeValidLeft = 0.0;
+    double GazeValidRight = 0.0;
+    double EyeOpennessValidLeft = 0.0;
+    double EyeOpennessValidRight = 0.0;
+    size_t CustomActorRecords = 0; // per actor per frame in older recordings, per change (spawn/update/despawn) now
+    bool bHasConfigFile = false;
+    std::vector<GazePredictionError> GazePrediction; // one per RecordingAnalysisParams::GazeLatenciesMs
+
+    // adaptive rendering quality (QualityGovernor), level 0 is full quality
+    size_t QualityChanges = 0;
+    int MaxQualityLevel = 0;
+    double ReducedQualityTime = 0.0; // seconds spent below full quality
+};
+
+RecordingSummary AnalyzeRecording(const std::string &Filename, const RecordingAnalysisParams &Params);
+
+std::string SummaryToJson(const RecordingSummary &Summary);
+std::string SummaryCsvHeader();
+std::string SummaryToCsvRow(const RecordingSummary &Summary);
+
+// analyze every file on a pool of NumWorkers threads, results are in the same order as Filenames
+std::vector<RecordingSummary> AnalyzeRecordings(const std::vector<std::string> &Filenames,
+                                                const RecordingAnalysisParams &Params, size_t NumWorkers);
@@ -0,0 +1,133 @@
+#pragma once
+
+// On-disk layouts for the stock CARLA recorder packets the analysis needs. The CARLA-side definitions
+// (CarlaRecorderFrames.h, CarlaRecorderCollision.h, ...) drag in the full UE4 actor/episode headers, so
+// we mirror only their serialized layout here. The DReyeVR packets are NOT mirrored, those are read with
+// the real DReyeVRDataRecorder<T> from Carla/Recorder/DReyeVRRecorder.h
+
+#include "Carla/Recorder/CarlaRecorderHelpers.h" // ReadValue, ReadFString, ReadFVector
+#include <cstdint>
+#include <ctime>
+#include <fstream>
+
+#define DREYEVR_PACKET_ID 139
+#define DREYEVR_CUSTOM_ACTOR_PACKET_ID 140
+#define DREYEVR_CONFIG_FILE_PACKET_ID 141
+#define DREYEVR_QUALITY_PACKET_ID 142
+#define DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID 143
+
+// NOTE: must stay in sync with CarlaRecorderPacketId in Carla/Recorder/CarlaRecorder.h
+enum class CarlaRecorderPacketId : uint8_t
+{
+    FrameStart = 0,
+    FrameEnd,
+    EventAdd,
+    EventDel,
+    EventParent,
+    Collision,
+    Position,
+    State,
+    AnimVehicle,
+    AnimWalker,
+    VehicleLight,
+    SceneLight,
+    Kinematics,
+    BoundingBox,
+    PlatformTime,
+    PhysicsControl,
+    TrafficLightTime,
+    TriggerVolume,
+    Weather,
+    DReyeVR = DREYEVR_PACKET_ID,
+    DReyeVRCustomActor = DREYEVR_CUSTOM_ACTOR_PACKET_ID,
+    DReyeVRConfigFile = DREYEVR_CONFIG_FILE_PACKET_ID,
+    DReyeVRQuality = DREYEVR_QUALITY_PACKET_ID,
+    DReyeVRCustomActorDelta = DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID
+};
+
+#pragma pack(push, 1)
+struct RecordingPacketHeader
+{
+    char Id;
+    uint32_t Size;
+};
+
+struct RecordingFrame
+{
+    uint64_t Id;
+    double DurationThis;
+    double Elapsed;
+};
+
+struct RecordingPosition
+{
+    uint32_t DatabaseId;
+    FVector Location;
+    FVector Rotation;
+};
+#pragma pack(pop)
+
+struct RecordingInfo
+{
+    uint16_t Version = 0;
+    FString Magic;
+    std::time_t Date = 0;
+    FString Mapfile;
+
+    void Read(std::ifstream &InFile)
+    {
+        ReadValue<uint16_t>(InFile, Version);
+        ReadFString(InFile, Magic);
+        ReadValue<std::time_t>(InFile, Date);
+        ReadFString(InFile, Mapfile);
+    }
+};
+
+struct RecordingCollision
+{
+    uint32_t Id = 0;
+    uint32_t DatabaseId1 = 0;
+    uint32_t DatabaseId2 = 0;
+    bool IsActor1Hero = false;
+    bool IsActor2Hero = false;
+
+    void Read(std::ifstream &InFile)
+    {
+        ReadValue<uint32_t>(InFile, Id);
+        ReadValue<uint32_t>(InFile, DatabaseId1);
+        ReadValue<uint32_t>(InFile, DatabaseId2);
+        ReadValue<bool>(InFile, IsActor1Hero);
+        ReadValue<bool>(InFile, IsActor2Hero);
+    }
+};
+
+struct RecordingEventAdd
+{
+    uint32_t DatabaseId = 0;
+    uint8_t Type = 0;
+    FVector Location;
+    FVector Rotation;
+    uint32_t DescriptionUId = 0;
+    FString DescriptionId;
+
+    void Read(std::ifstream &InFile)
+    {
+        ReadValue<uint32_t>(InFile, DatabaseId);
+        ReadValue<uint8_t>(InFile, Type);
+        ReadFVector(InFile, Location);
+        ReadFVector(InFile, Rotation);
+        ReadValue<uint32_t>(InFile, DescriptionUId);
+        ReadFString(InFile, DescriptionId);
+        // attributes are not needed for the analysis, but have to be consumed
+        uint16_t Total;
+        ReadValue<uint16_t>(InFile, Total);
+        FString Unused;
+        for (uint16_t i = 0; i < Total; ++i)
+        {
+            uint8_t AttType;
+            ReadValue<uint8_t>(InFile, AttType);
+            ReadFString(InFile, Unused); // attribute id
+            ReadFString(InFile, Unused); // attribute value
+        }
+    }
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "../UE4Stubs.h" // FName, FLinearColor
+
+// CustomActorData::MaterialParamsStruct::Apply is compiled but never called by the standalone tools
+class UMaterialInstanceDynamic
+{
+  public:
+    void SetScalarParameterValue(FName, float)
+    {
+    }
+    void SetVectorParameterValue(FName, const FLinearColor &)
+    {
+    }
+};
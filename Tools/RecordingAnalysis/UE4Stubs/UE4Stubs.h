@@ -0,0 +1,445 @@
+#pragma once
+
+// Minimal stand-ins for the handful of UE4 core types that the recorder serialization code
+// (CarlaRecorderHelpers, DReyeVRRecorder.h, DReyeVRData) touches. This is force-included into every
+// translation unit of the standalone tools (the same role the UE4 PCH plays inside the editor build),
+// so the real recorder sources can be compiled and linked without an Unreal installation.
+//
+// NOTE: only what the serialization + ToString paths (and the DReyeVR/ConfigFile.h parser) need is provided here,
+// this is not a general UE4 shim
+
+#include <algorithm>
+#include <cassert>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#define CARLA_API
+#define CARLAUE4_API
+
+using TCHAR = char;
+#define TEXT(x) x
+// UE4 returns a mutable buffer for these conversions, recorder code relies on that (reinterpret_cast<char *>)
+#define TCHAR_TO_UTF8(x) const_cast<char *>(static_cast<const TCHAR *>(x))
+#define UTF8_TO_TCHAR(x) reinterpret_cast<const TCHAR *>(x)
+#define TCHAR_TO_ANSI(x) TCHAR_TO_UTF8(x)
+
+#define check(expr) assert(expr)
+// a function rather than (expr), so an ensure used as a statement is not an unused value
+inline bool StubEnsure(bool bCondition)
+{
+    return bCondition;
+}
+#define ensure(expr) StubEnsure(expr)
+#define ensureMsgf(expr, ...) StubEnsure(expr)
+// DReyeVR logging (CarlaUE4.h), to stderr
+#define LOG(msg, ...) std::fprintf(stderr, "[LOG] " msg "\n", ##__VA_ARGS__);
+#define LOG_WARN(msg, ...) std::fprintf(stderr, "[WARN] " msg "\n", ##__VA_ARGS__);
+#define LOG_ERROR(msg, ...) std::fprintf(stderr, "[ERROR] " msg "\n", ##__VA_ARGS__);
+
+namespace ESearchCase
+{
+enum Type
+{
+    CaseSensitive,
+    IgnoreCase,
+};
+}
+
+class FString
+{
+  public:
+    FString() = default;
+    FString(const TCHAR *In) : Data(In != nullptr ? In : "")
+    {
+    }
+    FString(const std::string &In) : Data(In)
+    {
+    }
+
+    static FString Printf(const TCHAR *Fmt, ...)
+    {
+        va_list Args, ArgsCopy;
+        va_start(Args, Fmt);
+        va_copy(ArgsCopy, Args);
+        const int Len = std::vsnprintf(nullptr, 0, Fmt, ArgsCopy);
+        va_end(ArgsCopy);
+        std::string Out(Len > 0 ? Len : 0, '\0');
+        if (Len > 0)
+            std::vsnprintf(&Out[0], Out.size() + 1, Fmt, Args);
+        va_end(Args);
+        return FString(Out);
+    }
+
+    const TCHAR *operator*() const
+    {
+        return Data.c_str();
+    }
+    int32_t Len() const
+    {
+        return static_cast<int32_t>(Data.size());
+    }
+    bool IsEmpty() const
+    {
+        return Data.empty();
+    }
+    bool Contains(const FString &Sub) const
+    {
+        return Data.find(Sub.Data) != std::string::npos;
+    }
+    FString &operator+=(const FString &Other)
+    {
+        Data += Other.Data;
+        return *this;
+    }
+    friend FString operator+(const FString &A, const FString &B)
+    {
+        return FString(A.Data + B.Data);
+    }
+    bool operator==(const FString &Other) const
+    {
+        return Data == Other.Data;
+    }
+    bool operator!=(const FString &Other) const
+    {
+        return Data != Other.Data;
+    }
+    bool operator==(const TCHAR *Other) const
+    {
+        return Data == Other;
+    }
+    bool operator!=(const TCHAR *Other) const
+    {
+        return Data != Other;
+    }
+    const std::string &ToStdString() const
+    {
+        return Data;
+    }
+    FString TrimStartAndEnd() const
+    {
+        const size_t Start = Data.find_first_not_of(" \t\r\n");
+        if (Start == std::string::npos)
+            return FString();
+        const size_t End = Data.find_last_not_of(" \t\r\n");
+        return FString(Data.substr(Start, End - Start + 1));
+    }
+    FString TrimQuotes(bool *bQuotesRemoved = nullptr) const
+    {
+        const bool bQuoted = Data.size() >= 2 && Data.front() == '"' && Data.back() == '"';
+        if (bQuotesRemoved != nullptr)
+            *bQuotesRemoved = bQuoted;
+        return bQuoted ? FString(Data.substr(1, Data.size() - 2)) : *this;
+    }
+    bool Equals(const FString &Other, ESearchCase::Type Case = ESearchCase::CaseSensitive) const
+    {
+        if (Case == ESearchCase::CaseSensitive)
+            return Data == Other.Data;
+        return Data.size() == Other.Data.size() &&
+               std::equal(Data.begin(), Data.end(), Other.Data.begin(),
+                          [](char A, char B) { return std::tolower(A) == std::tolower(B); });
+    }
+    bool ToBool() const
+    {
+        return Equals("true", ESearchCase::IgnoreCase) || Equals("yes", ESearchCase::IgnoreCase) ||
+               Equals("on", ESearchCase::IgnoreCase) || std::atoi(Data.c_str()) != 0;
+    }
+
+  private:
+    std::string Data;
+};
+
+class FName
+{
+  public:
+    FName() = default;
+    FName(const TCHAR *In) : Name(In)
+    {
+    }
+    FString ToString() const
+    {
+        return Name;
+    }
+
+  private:
+    FString Name;
+};
+
+class FTCHARToUTF8
+{
+  public:
+    explicit FTCHARToUTF8(const TCHAR *In) : Str(In != nullptr ? In : "")
+    {
+    }
+    int32_t Length() const
+    {
+        return static_cast<int32_t>(Str.size());
+    }
+    const char *Get() const
+    {
+        return Str.c_str();
+    }
+
+  private:
+    std::string Str;
+};
+
+struct FCString
+{
+    static int32_t Atoi(const TCHAR *Str)
+    {
+        return std::atoi(Str);
+    }
+    static float Atof(const TCHAR *Str)
+    {
+        return static_cast<float>(std::atof(Str));
+    }
+    static double Atod(const TCHAR *Str)
+    {
+        return std::atof(Str);
+    }
+};
+
+struct FPaths
+{
+#ifndef DREYEVR_PROJECT_DIR
+#define DREYEVR_PROJECT_DIR "./"
+#endif
+    static FString ProjectDir()
+    {
+        return FString(DREYEVR_PROJECT_DIR); // where Config/ is found
+    }
+    static FString ProjectSavedDir()
+    {
+        return FString("./");
+    }
+    static FString ConvertRelativePathToFull(const FString &Path)
+    {
+        return Path;
+    }
+    static FString Combine(const FString &A)
+    {
+        return A;
+    }
+    template <typename... Rest> static FString Combine(const FString &A, const FString &B, const Rest &...More)
+    {
+        const bool bSlash = !A.IsEmpty() && (*A)[A.Len() - 1] != '/';
+        return Combine(bSlash ? A + "/" + B : A + B, More...);
+    }
+};
+
+// FParse::Value(Source, "X=", Out) as used by the UE4 InitFromString implementations
+inline bool ParseFloatValue(const std::string &Source, const char *Key, float &Out)
+{
+    for (size_t Pos = Source.find(Key); Pos != std::string::npos; Pos = Source.find(Key, Pos + 1))
+    {
+        if (Pos == 0 || !std::isalnum(static_cast<unsigned char>(Source[Pos - 1])))
+        {
+            Out = static_cast<float>(std::atof(Source.c_str() + Pos + std::char_traits<char>::length(Key)));
+            return true;
+        }
+    }
+    return false;
+}
+
+struct FVector
+{
+    float X = 0.f, Y = 0.f, Z = 0.f;
+    FVector() = default;
+    FVector(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ)
+    {
+    }
+    static const FVector ZeroVector;
+    static float Distance(const FVector &A, const FVector &B)
+    {
+        return std::sqrt((A.X - B.X) * (A.X - B.X) + (A.Y - B.Y) * (A.Y - B.Y) + (A.Z - B.Z) * (A.Z - B.Z));
+    }
+    float Size() const
+    {
+        return std::sqrt(X * X + Y * Y + Z * Z);
+    }
+    FVector operator-(const FVector &O) const
+    {
+        return FVector(X - O.X, Y - O.Y, Z - O.Z);
+    }
+    FVector operator+(const FVector &O) const
+    {
+        return FVector(X + O.X, Y + O.Y, Z + O.Z);
+    }
+    FVector operator*(float S) const
+    {
+        return FVector(X * S, Y * S, Z * S);
+    }
+    bool operator==(const FVector &O) const
+    {
+        return X == O.X && Y == O.Y && Z == O.Z;
+    }
+    bool operator!=(const FVector &O) const
+    {
+        return !(*this == O);
+    }
+    FString ToString() const
+    {
+        return FString::Printf(TEXT("X=%3.3f Y=%3.3f Z=%3.3f"), X, Y, Z);
+    }
+    bool InitFromString(const FString &In)
+    {
+        X = Y = Z = 0.f;
+        const bool bX = ParseFloatValue(In.ToStdString(), "X=", X);
+        const bool bY = ParseFloatValue(In.ToStdString(), "Y=", Y);
+        const bool bZ = ParseFloatValue(In.ToStdString(), "Z=", Z);
+        return bX && bY && bZ;
+    }
+};
+inline const FVector FVector::ZeroVector{};
+
+struct FVector2D
+{
+    float X = 0.f, Y = 0.f;
+    FVector2D() = default;
+    FVector2D(float InX, float InY) : X(InX), Y(InY)
+    {
+    }
+    static const FVector2D ZeroVector;
+    FString ToString() const
+    {
+        return FString::Printf(TEXT("X=%3.3f Y=%3.3f"), X, Y);
+    }
+    bool InitFromString(const FString &In)
+    {
+        X = Y = 0.f;
+        const bool bX = ParseFloatValue(In.ToStdString(), "X=", X);
+        const bool bY = ParseFloatValue(In.ToStdString(), "Y=", Y);
+        return bX && bY;
+    }
+};
+inline const FVector2D FVector2D::ZeroVector{};
+
+struct FRotator
+{
+    float Pitch = 0.f, Yaw = 0.f, Roll = 0.f;
+    FRotator() = default;
+    FRotator(float InPitch, float InYaw, float InRoll) : Pitch(InPitch), Yaw(InYaw), Roll(InRoll)
+    {
+    }
+    static const FRotator ZeroRotator;
+    bool operator==(const FRotator &O) const
+    {
+        return Pitch == O.Pitch && Yaw == O.Yaw && Roll == O.Roll;
+    }
+    bool operator!=(const FRotator &O) const
+    {
+        return !(*this == O);
+    }
+    FString ToString() const
+    {
+        return FString::Printf(TEXT("P=%f Y=%f R=%f"), Pitch, Yaw, Roll);
+    }
+    bool InitFromString(const FString &In)
+    {
+        Pitch = Yaw = Roll = 0.f;
+        const bool bP = ParseFloatValue(In.ToStdString(), "P=", Pitch);
+        const bool bY = ParseFloatValue(In.ToStdString(), "Y=", Yaw);
+        const bool bR = ParseFloatValue(In.ToStdString(), "R=", Roll);
+        return bP && bY && bR;
+    }
+};
+inline const FRotator FRotator::ZeroRotator{};
+
+struct FTransform
+{
+    FVector Translation;
+    FRotator Rotation;
+    FVector Scale3D{1.f, 1.f, 1.f};
+    // (translation | rotation | scale), see Config/DReyeVRConfig.ini
+    bool InitFromString(const FString &In)
+    {
+        const std::string &Str = In.ToStdString();
+        const size_t A = Str.find('|');
+        const size_t B = A == std::string::npos ? A : Str.find('|', A + 1);
+        if (B == std::string::npos)
+            return false;
+        return Translation.InitFromString(Str.substr(0, A)) && Rotation.InitFromString(Str.substr(A + 1, B - A - 1)) &&
+               Scale3D.InitFromString(Str.substr(B + 1));
+    }
+};
+
+struct FLinearColor
+{
+    float R = 0.f, G = 0.f, B = 0.f, A = 1.f;
+    FLinearColor() = default;
+    FLinearColor(float InR, float InG, float InB, float InA = 1.f) : R(InR), G(InG), B(InB), A(InA)
+    {
+    }
+    static const FLinearColor Red;
+    friend FLinearColor operator*(float S, const FLinearColor &C)
+    {
+        return FLinearColor(S * C.R, S * C.G, S * C.B, S * C.A);
+    }
+    bool operator==(const FLinearColor &O) const
+    {
+        return R == O.R && G == O.G && B == O.B && A == O.A;
+    }
+    bool operator!=(const FLinearColor &O) const
+    {
+        return !(*this == O);
+    }
+};
+inline const FLinearColor FLinearColor::Red{1.f, 0.f, 0.f, 1.f};
+
+template <typename T> class TArray
+{
+  public:
+    int32_t Num() const
+    {
+        return static_cast<int32_t>(Items.size());
+    }
+    void Add(const T &Item)
+    {
+        Items.push_back(Item);
+    }
+    void Empty()
+    {
+        Items.clear();
+    }
+    typename std::vector<T>::iterator begin()
+    {
+        return Items.begin();
+    }
+    typename std::vector<T>::iterator end()
+    {
+        return Items.end();
+    }
+    typename std::vector<T>::const_iterator begin() const
+    {
+        return Items.begin();
+    }
+    typename std::vector<T>::const_iterator end() const
+    {
+        return Items.end();
+    }
+
+  private:
+    std::vector<T> Items;
+};
+
+// only ever held (never dereferenced) by the recorder data structs
+template <typename T> class TWeakObjectPtr
+{
+  public:
+    bool IsValid() const
+    {
+        return false;
+    }
+    T *Get() const
+    {
+        return nullptr;
+    }
+};
+
+class AActor;
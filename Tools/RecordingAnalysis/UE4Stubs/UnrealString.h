@@ -0,0 +1,3 @@
+#pragma once
+
+#include "UE4Stubs.h" // FString, TCHAR_TO_UTF8, FPaths
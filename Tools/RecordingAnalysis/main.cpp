@@ -0,0 +1,119 @@
+#include "RecordingAnalysis.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+static void PrintUsage(const char *Exe)
+{
+    std::cout << "Usage: " << Exe << " <recording.rec | directory> [options]\n"
+              << "  --jobs N                 number of worker threads (default: hardware concurrency)\n"
+              << "  --out DIR                where to write the summaries (default: next to each recording)\n"
+              << "  --recursive              also search subdirectories for .rec files\n"
+              << "  --blocked-time SECONDS   min stationary time to count an actor as blocked (default 30)\n"
+              << "  --blocked-distance CM    max movement of a blocked actor (default 10)\n"
+              << "  --gaze-latency MS        replay the gaze through the predictor at this latency (repeatable)\n";
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    const fs::path Input = argv[1];
+    fs::path OutDir;
+    bool bRecursive = false;
+    size_t NumWorkers = std::max(1u, std::thread::hardware_concurrency());
+    RecordingAnalysisParams Params;
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string Arg = argv[i];
+        const bool bHasValue = (i + 1 < argc);
+        if (Arg == "--jobs" && bHasValue)
+            NumWorkers = std::strtoul(argv[++i], nullptr, 10);
+        else if (Arg == "--out" && bHasValue)
+            OutDir = argv[++i];
+        else if (Arg == "--recursive")
+            bRecursive = true;
+        else if (Arg == "--blocked-time" && bHasValue)
+            Params.BlockedMinTime = std::strtod(argv[++i], nullptr);
+        else if (Arg == "--blocked-distance" && bHasValue)
+            Params.BlockedMinDistance = std::strtod(argv[++i], nullptr);
+        else if (Arg == "--gaze-latency" && bHasValue)
+            Params.GazeLatenciesMs.push_back(std::strtof(argv[++i], nullptr));
+        else
+        {
+            std::cerr << "Unknown argument: " << Arg << std::endl;
+            PrintUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> Recordings;
+    if (fs::is_directory(Input))
+    {
+        auto AddIfRecording = [&](const fs::directory_entry &Entry) {
+            if (Entry.is_regular_file() && Entry.path().extension() == ".rec")
+                Recordings.push_back(Entry.path().string());
+        };
+        if (bRecursive)
+            for (const auto &Entry : fs::recursive_directory_iterator(Input))
+                AddIfRecording(Entry);
+        else
+            for (const auto &Entry : fs::directory_iterator(Input))
+                AddIfRecording(Entry);
+        std::sort(Recordings.begin(), Recordings.end());
+    }
+    else
+    {
+        Recordings.push_back(Input.string());
+    }
+    if (Recordings.empty())
+    {
+        std::cerr << "No .rec files found in " << Input << std::endl;
+        return 1;
+    }
+
+    std::cout << "Analyzing " << Recordings.size() << " recording(s) with " << NumWorkers << " worker(s)"
+              << std::endl;
+    const std::vector<RecordingSummary> Summaries = AnalyzeRecordings(Recordings, Params, NumWorkers);
+
+    if (!OutDir.empty())
+        fs::create_directories(OutDir);
+    const fs::path CohortDir = OutDir.empty() ? (fs::is_directory(Input) ? Input : Input.parent_path()) : OutDir;
+    std::ofstream Cohort(CohortDir / "recording_summaries.csv");
+    Cohort << SummaryCsvHeader() << "\n";
+
+    int NumInvalid = 0;
+    for (const RecordingSummary &Summary : Summaries)
+    {
+        const fs::path RecPath = Summary.Filename;
+        const fs::path Dir = OutDir.empty() ? RecPath.parent_path() : OutDir;
+        std::ofstream(Dir / (RecPath.stem().string() + ".summary.json")) << SummaryToJson(Summary);
+        Cohort << SummaryToCsvRow(Summary) << "\n";
+
+        if (!Summary.bValid)
+        {
+            NumInvalid++;
+            std::cout << "[FAIL] " << Summary.Filename << ": " << Summary.Error << std::endl;
+            continue;
+        }
+        std::cout << (Summary.bTruncated ? "[TRUNC] " : "[OK] ") << Summary.Filename << ": " << Summary.Frames
+                  << " frames, " << Summary.Duration << "s, jitter " << Summary.FrameTimeJitter * 1000.0 << "ms, "
+                  << Summary.Collisions << " collisions, " << Summary.BlockedActors << " blocked, gaze valid "
+                  << Summary.GazeValidCombined * 100.0 << "%" << std::endl;
+        for (const GazePredictionError &E : Summary.GazePrediction)
+            std::cout << "    gaze " << E.LatencyMs << "ms ahead: " << E.HoldMeanDeg << " deg held, "
+                      << E.PredictedMeanDeg << " deg predicted (mean of " << E.Samples << ")" << std::endl;
+    }
+    return NumInvalid == 0 ? 0 : 2;
+}
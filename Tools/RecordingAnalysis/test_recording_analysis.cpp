@@ -0,0 +1,499 @@
+// writes small synthetic recordings with the real recorder serializers and checks the analysis of them
+
+#include "Carla/Recorder/DReyeVRFrameIndex.h" // DReyeVRFrameIndex
+#include "Carla/Recorder/DReyeVRRecorder.h"   // DReyeVRDataRecorders
+#include "DReyeVR/ConfigFile.h"              // ConfigFile::Fingerprints
+#include "RecordingAnalysis.h"
+#include "RecordingPackets.h"
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <unordered_map>
+
+static void WritePacketHeader(std::ofstream &Out, CarlaRecorderPacketId Id, uint32_t Size)
+{
+    WriteValue<char>(Out, static_cast<char>(Id));
+    WriteValue<uint32_t>(Out, Size);
+}
+
+static void WriteInfo(std::ofstream &Out)
+{
+    WriteValue<uint16_t>(Out, 1);
+    WriteFString(Out, FString("CARLA_RECORDER"));
+    WriteValue<std::time_t>(Out, 0);
+    WriteFString(Out, FString("Town03"));
+}
+
+static void WriteFrame(std::ofstream &Out, uint64_t Id, double Dt, double Elapsed)
+{
+    const RecordingFrame Frame{Id, Dt, Elapsed};
+    WritePacketHeader(Out, CarlaRecorderPacketId::FrameStart, sizeof(Frame));
+    WriteValue<RecordingFrame>(Out, Frame);
+}
+
+static void WriteCollision(std::ofstream &Out, uint32_t A, uint32_t B, bool bAIsHero)
+{
+    WritePacketHeader(Out, CarlaRecorderPacketId::Collision, sizeof(uint16_t) + 3 * sizeof(uint32_t) + 2);
+    WriteValue<uint16_t>(Out, 1);
+    WriteValue<uint32_t>(Out, 0);
+    WriteValue<uint32_t>(Out, A);
+    WriteValue<uint32_t>(Out, B);
+    WriteValue<bool>(Out, bAIsHero);
+    WriteValue<bool>(Out, false);
+}
+
+static void WritePosition(std::ofstream &Out, uint32_t Id, const FVector &Location)
+{
+    const RecordingPosition Position{Id, Location, FVector::ZeroVector};
+    WritePacketHeader(Out, CarlaRecorderPacketId::Position, sizeof(uint16_t) + sizeof(Position));
+    WriteValue<uint16_t>(Out, 1);
+    WriteValue<RecordingPosition>(Out, Position);
+}
+
+static void WriteGaze(std::ofstream &Out, bool bValid, int64_t TimestampDevice = 0,
+                      const FVector &GazeDir = FVector(1.f, 0.f, 0.f))
+{
+    DReyeVR::EyeTracker Eyes;
+    Eyes.TimestampDevice = TimestampDevice;
+    Eyes.Combined.GazeDir = GazeDir;
+    Eyes.Combined.GazeValid = bValid;
+    Eyes.Left.GazeValid = true;
+    DReyeVR::AggregateData Data;
+    Data.Update(0, Eyes, DReyeVR::EgoVariables(), DReyeVR::FocusInfo(), DReyeVR::UserInputs());
+    DReyeVRDataRecorders<DReyeVR::AggregateData, DREYEVR_PACKET_ID> Recorder;
+    Recorder.Add(DReyeVRDataRecorder<DReyeVR::AggregateData>(&Data));
+    Recorder.Write(Out);
+}
+
+static void TestSyntheticRecording()
+{
+    const std::string Filename = "synthetic_test.rec";
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        WriteInfo(Out);
+        for (uint64_t f = 0; f < 10; f++)
+        {
+            // every 5th frame takes twice as long
+            const double Dt = (f % 5 == 4) ? 0.2 : 0.1;
+            WriteFrame(Out, f, Dt, 0.1 * f);
+            if (f == 2 || f == 3) // one continued collision
+                WriteCollision(Out, 1, 2, true);
+            if (f == 7) // one separate collision
+                WriteCollision(Out, 3, 4, false);
+            WritePosition(Out, 5, FVector(100.f, 0.f, 0.f)); // never moves after the first frame
+            WriteGaze(Out, f % 2 == 0);
+            WritePacketHeader(Out, CarlaRecorderPacketId::FrameEnd, 0);
+        }
+    }
+
+    RecordingAnalysisParams Params;
+    Params.BlockedMinTime = 0.5;
+    const RecordingSummary S = AnalyzeRecording(Filename, Params);
+    assert(S.bValid && !S.bTruncated);
+    assert(S.Map == "Town03");
+    assert(S.Frames == 10);
+    assert(Near(S.Duration, 0.9));
+    assert(Near(S.FrameTimeMax, 0.2) && Near(S.FrameTimeMin, 0.1));
+    assert(S.FrameTimeJitter > 0.0);
+    assert(S.Collisions == 2 && S.HeroCollisions == 1);
+    assert(S.BlockedActors == 1);
+    assert(S.DReyeVRSamples == 10);
+    assert(Near(S.GazeValidCombined, 0.5) && Near(S.GazeValidLeft, 1.0) && Near(S.GazeValidRight, 0.0));
+
+    // the pool returns results in input order, regardless of which worker ran them
+    const std::vector<RecordingSummary> All = AnalyzeRecordings({Filename, "missing.rec", Filename}, Params, 3);
+    assert(All.size() == 3 && All[0].bValid && !All[1].bValid && All[2].Frames == 10);
+    std::remove(Filename.c_str());
+}
+
+static void TestTruncatedRecording()
+{
+    const std::string Filename = "truncated_test.rec";
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        WriteInfo(Out);
+        WriteFrame(Out, 0, 0.0, 0.0);
+        WritePacketHeader(Out, CarlaRecorderPacketId::Position, 1000); // claims more bytes than exist
+        WriteValue<uint16_t>(Out, 0);
+    }
+    const RecordingSummary S = AnalyzeRecording(Filename, RecordingAnalysisParams());
+    assert(S.bValid && S.bTruncated && S.Frames == 1);
+    std::remove(Filename.c_str());
+}
+
+static void TestFrameIndex()
+{
+    const std::string Filename = "frame_index_test.rec";
+    std::streamoff Frame5Offset = 0;
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        WriteInfo(Out);
+        for (uint64_t f = 0; f < 10; f++)
+        {
+            if (f == 5)
+                Frame5Offset = Out.tellp();
+            WriteFrame(Out, f, 0.1, 0.1 * f);
+            if (f == 3) // (empty) actor event
+            {
+                WritePacketHeader(Out, CarlaRecorderPacketId::EventAdd, sizeof(uint16_t));
+                WriteValue<uint16_t>(Out, 0);
+            }
+            WriteGaze(Out, true);
+            WritePacketHeader(Out, CarlaRecorderPacketId::FrameEnd, 0);
+        }
+    }
+    std::remove(DReyeVRFrameIndex::GetSidecarFilename(Filename).c_str());
+
+    DReyeVRFrameIndex Index;
+    assert(Index.Load(Filename)); // builds and writes the sidecar
+    assert(Index.Num() == 10);
+    assert(Index[5].Offset == Frame5Offset && Index[5].FrameId == 5);
+    assert(Index.FindFrameAtTime(-1.0) == 0);
+    assert(Index.FindFrameAtTime(0.52) == 5);
+    assert(Index.FindFrameAtTime(100.0) == 9);
+    assert(Index.FindFrameById(7) == 7 && Index.FindFrameById(42) == Index.Num());
+    assert(Index.FindFirstFrameFrom(0.52) == 6 && Index.FindFirstFrameFrom(-1.0) == 0);
+    assert(Index.FindFirstFrameFrom(100.0) == Index.Num());
+    assert(Index[3].bHasEvents && !Index[2].bHasEvents && !Index[4].bHasEvents);
+
+    // a fresh index picks up the sidecar
+    DReyeVRFrameIndex FromSidecar;
+    assert(std::ifstream(DReyeVRFrameIndex::GetSidecarFilename(Filename)).good());
+    assert(FromSidecar.Load(Filename) && FromSidecar.Num() == 10 && FromSidecar[5].Offset == Frame5Offset);
+    assert(FromSidecar[3].bHasEvents && !FromSidecar[5].bHasEvents);
+
+    // appending to the recording invalidates the sidecar
+    {
+        std::ofstream Out(Filename, std::ios::binary | std::ios::app);
+        WriteFrame(Out, 10, 0.1, 1.0);
+    }
+    assert(Index.Load(Filename) && Index.Num() == 11);
+
+    std::remove(DReyeVRFrameIndex::GetSidecarFilename(Filename).c_str());
+    std::remove(Filename.c_str());
+}
+
+static void TestConfigFingerprints()
+{
+    // independent of the order of the entries, the case of the values, and comments
+    const ConfigFile A = ConfigFile::Import("[Replayer]\nFrameWidth=1280\nRecordFrames=True\n[Sound]\nVolume=1.0\n");
+    const ConfigFile B = ConfigFile::Import("[Sound]\nVolume=1.0\n[Replayer]\nRecordFrames=true # on\nFrameWidth=1280\n");
+    const ConfigFile C = ConfigFile::Import("[Replayer]\nFrameWidth=1920\nRecordFrames=true\n[Sound]\nVolume=1.0\n");
+    const auto FA = A.Fingerprints(), FB = B.Fingerprints(), FC = C.Fingerprints();
+    assert(FA.size() == 2 && FA[0].first == "Replayer" && FA[1].first == "Sound");
+    assert(FA == FB && A.IsEqual(B));
+    assert(FA[0].second != FC[0].second && FA[1].second == FC[1].second);
+
+    // stored next to the raw text in the recording
+    const std::string Filename = "config_fingerprint_test.bin";
+    DReyeVR::ConfigFileData Data;
+    Data.Set(A.Export(), FA);
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        Data.Write(Out);
+        WriteFString(Out, FString("old")); // only contents (older recordings), followed by anything else
+        WriteValue<uint32_t>(Out, 0xdeadbeef);
+    }
+    std::ifstream In(Filename, std::ios::binary);
+    DReyeVR::ConfigFileData Read, ReadOld;
+    Read.Read(In);
+    assert(Read.GetFingerprints() == FA && Read.ToString() == Data.ToString());
+    ReadOld.Read(In);
+    assert(ReadOld.GetFingerprints().empty() && ReadOld.ToString() == FString("old"));
+    uint32_t Next = 0;
+    ReadValue<uint32_t>(In, Next);
+    assert(In && Next == 0xdeadbeef);
+    In.close();
+    std::remove(Filename.c_str());
+}
+
+static void TestQualityChanges()
+{
+    const std::string Filename = "quality_test.rec";
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        WriteInfo(Out);
+        for (uint64_t f = 0; f < 6; f++)
+        {
+            WriteFrame(Out, f, 0.1, 0.1 * f);
+            if (f == 1 || f == 4) // down two levels on frame 1, back to full quality on frame 4
+            {
+                DReyeVR::QualityChangeData Change;
+                Change.PrevLevel = (f == 1) ? 0 : 2;
+                Change.Level = (f == 1) ? 2 : 0;
+                Change.LevelName = FString("Test");
+                DReyeVRDataRecorders<DReyeVR::QualityChangeData, DREYEVR_QUALITY_PACKET_ID> Recorder;
+                Recorder.Add(DReyeVRDataRecorder<DReyeVR::QualityChangeData>(&Change));
+                Recorder.Write(Out);
+            }
+            WritePacketHeader(Out, CarlaRecorderPacketId::FrameEnd, 0);
+        }
+    }
+    const RecordingSummary S = AnalyzeRecording(Filename, RecordingAnalysisParams());
+    assert(S.bValid && S.Frames == 6);
+    assert(S.QualityChanges == 2 && S.MaxQualityLevel == 2);
+    assert(Near(S.ReducedQualityTime, 0.3)); // frames 2, 3 and 4 start below full quality
+    std::remove(Filename.c_str());
+}
+
+static void TestCustomActorChanges()
+{
+    using Params = DReyeVR::CustomActorData::MaterialParamsStruct;
+    DReyeVR::CustomActorData A;
+    A.Name = FString("Marker");
+    A.Location = FVector(1.f, 2.f, 3.f);
+    A.MaterialParams.MaterialPath = FString("Mat");
+    DReyeVR::CustomActorData B = A;
+    assert(A == B && A.MaterialParams.DiffMask(B.MaterialParams) == 0);
+
+    B.MaterialParams.Opacity = 0.5f;
+    B.MaterialParams.BaseColor = FLinearColor(0.f, 1.f, 0.f);
+    assert(!(A == B));
+    assert(A.MaterialParams.DiffMask(B.MaterialParams) == (Params::OpacityBit | Params::BaseColorBit));
+
+    B = A;
+    B.Location.Z += 1.f; // same params, different transform
+    assert(!(A == B) && A.MaterialParams.DiffMask(B.MaterialParams) == 0);
+
+    // a frame read back from a recording equals the one written
+    const std::string Filename = "custom_actor_test.bin";
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        A.Write(Out);
+    }
+    DReyeVR::CustomActorData Read;
+    {
+        std::ifstream In(Filename, std::ios::binary);
+        Read.Read(In);
+    }
+    assert(Read == A);
+    std::remove(Filename.c_str());
+}
+
+static void TestCustomActorDeltas()
+{
+    // one static marker for the whole recording, one moving marker that changes color and disappears half way
+    const int NumFrames = 100;
+    auto Actual = [](int Frame, int Actor) {
+        DReyeVR::CustomActorData Data;
+        Data.Name = FString(Actor == 0 ? "Static" : "Moving");
+        Data.MeshPath = FString("Mesh");
+        Data.MaterialParams.MaterialPath = FString("Mat");
+        Data.Scale3D = FVector(1.f, 1.f, 1.f);
+        if (Actor == 1)
+        {
+            Data.Location = FVector(static_cast<float>(Frame), 0.f, 0.f);
+            if (Frame >= 10)
+                Data.MaterialParams.BaseColor = FLinearColor(0.f, 1.f, 0.f);
+        }
+        return Data;
+    };
+    auto IsAlive = [&](int Frame, int Actor) { return Actor == 0 || Frame < NumFrames / 2; };
+
+    const std::string Filename = "custom_actor_delta_test.rec";
+    std::streamoff DeltaBytes = 0;
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        WriteInfo(Out);
+        // same bookkeeping as ACarlaRecorder::AddDReyeVRData
+        std::unordered_map<int, DReyeVR::CustomActorData> Recorded;
+        for (int f = 0; f < NumFrames; f++)
+        {
+            WriteFrame(Out, f, 0.1, 0.1 * f);
+            DReyeVRDataRecorders<DReyeVR::CustomActorDelta, DREYEVR_CUSTOM_ACTOR_DELTA_PACKET_ID> Recorder;
+            DReyeVR::CustomActorDelta Delta;
+            for (int a = 0; a < 2; a++)
+            {
+                auto It = Recorded.find(a);
+                if (!IsAlive(f, a))
+                {
+                    if (It != Recorded.end())
+                    {
+                        Delta.MakeDespawn(a);
+                        Recorder.Add(DReyeVRDataRecorder<DReyeVR::CustomActorDelta>(&Delta));
+                        Recorded.erase(It);
+                    }
+                    continue;
+                }
+                const DReyeVR::CustomActorData Data = Actual(f, a);
+                if (It == Recorded.end())
+                {
+                    Delta.MakeSpawn(a, Data);
+                    Recorded[a] = Data;
+                }
+                else if (Delta.MakeUpdate(a, It->second, Data))
+                {
+                    assert(!DReyeVR::CustomActorDelta::NeedsRespawn(It->second, Data));
+                    It->second = Data;
+                }
+                else
+                {
+                    continue; // unchanged
+                }
+                Recorder.Add(DReyeVRDataRecorder<DReyeVR::CustomActorDelta>(&Delta));
+            }
+            if (Recorder.Num() > 0)
+            {
+                const std::streamoff Start = Out.tellp();
+                Recorder.Write(Out);
+                DeltaBytes += Out.tellp() - Start;
+            }
+            WritePacketHeader(Out, CarlaRecorderPacketId::FrameEnd, 0);
+        }
+    }
+
+    // replay: reconstruct the states the way CarlaReplayer does
+    std::ifstream In(Filename, std::ios::binary);
+    RecordingInfo Info;
+    Info.Read(In);
+    std::unordered_map<uint32_t, DReyeVR::CustomActorData> States;
+    RecordingPacketHeader Header;
+    int Frame = -1;
+    size_t Updates = 0;
+    while (In)
+    {
+        ReadValue<char>(In, Header.Id);
+        ReadValue<uint32_t>(In, Header.Size);
+        if (!In)
+            break;
+        if (Header.Id == static_cast<char>(CarlaRecorderPacketId::FrameStart))
+        {
+            RecordingFrame F;
+            ReadValue<RecordingFrame>(In, F);
+            Frame = static_cast<int>(F.Id);
+        }
+        else if (Header.Id == static_cast<char>(CarlaRecorderPacketId::DReyeVRCustomActorDelta))
+        {
+            uint16_t Total;
+            ReadValue<uint16_t>(In, Total);
+            for (uint16_t i = 0; i < Total; i++)
+            {
+                DReyeVRDataRecorder<DReyeVR::CustomActorDelta> Record;
+                Record.Read(In);
+                if (Record.Data.Type == DReyeVR::CustomActorDelta::Despawn)
+                    States.erase(Record.Data.Id);
+                else
+                    Record.Data.ApplyTo(States[Record.Data.Id]);
+                Updates += (Record.Data.Type == DReyeVR::CustomActorDelta::Update);
+            }
+        }
+        else if (Header.Id == static_cast<char>(CarlaRecorderPacketId::FrameEnd))
+        {
+            for (int a = 0; a < 2; a++)
+            {
+                const auto It = States.find(a);
+                assert((It != States.end()) == IsAlive(Frame, a));
+                assert(It == States.end() || It->second == Actual(Frame, a));
+            }
+        }
+        else
+        {
+            In.seekg(Header.Size, std::ios::cur);
+        }
+    }
+    assert(Frame == NumFrames - 1);
+    assert(Updates == NumFrames / 2 - 1); // only the moving marker, once per frame
+
+    // every actor in every frame (the DReyeVRCustomActor packet) costs far more
+    std::streamoff FullBytes = 0;
+    for (int f = 0; f < NumFrames; f++)
+    {
+        DReyeVRDataRecorders<DReyeVR::CustomActorData, DREYEVR_CUSTOM_ACTOR_PACKET_ID> Recorder;
+        DReyeVR::CustomActorData Data[2] = {Actual(f, 0), Actual(f, 1)};
+        for (int a = 0; a < 2; a++)
+        {
+            if (IsAlive(f, a))
+                Recorder.Add(DReyeVRDataRecorder<DReyeVR::CustomActorData>(&Data[a]));
+        }
+        std::ofstream Out("custom_actor_full_test.rec", std::ios::binary);
+        Recorder.Write(Out);
+        FullBytes += Out.tellp();
+    }
+    assert(DeltaBytes * 4 < FullBytes);
+
+    const RecordingSummary S = AnalyzeRecording(Filename, RecordingAnalysisParams());
+    assert(S.bValid && S.Frames == static_cast<size_t>(NumFrames));
+    assert(S.CustomActorRecords == 2 + Updates + 1); // two spawns, the updates and one despawn
+
+    // the frames with changes cannot be skipped when seeking
+    DReyeVRFrameIndex Index;
+    assert(Index.Load(Filename));
+    assert(Index[0].bHasEvents && Index[1].bHasEvents && !Index[NumFrames - 1].bHasEvents);
+    std::remove(Filename.c_str());
+    std::remove(DReyeVRFrameIndex::GetSidecarFilename(Filename).c_str());
+    std::remove("custom_actor_full_test.rec");
+}
+
+static void TestGazePredictionReplay()
+{
+    const std::string Filename = "gaze_prediction_test.rec";
+    {
+        std::ofstream Out(Filename, std::ios::binary);
+        WriteInfo(Out);
+        // 2 s of a 0.5 Hz, 10 degree pursuit at 90 Hz, with a blink in the middle
+        for (uint64_t f = 0; f < 180; f++)
+        {
+            const double T = f / 90.0;
+            WriteFrame(Out, f, 1.0 / 90.0, T);
+            const float Yaw = 10.f / 57.2957795f * std::sin(3.14159265f * static_cast<float>(T));
+            const bool bBlink = (f >= 90 && f < 99);
+            WriteGaze(Out, !bBlink, static_cast<int64_t>(T * 1000.0), FVector(std::cos(Yaw), std::sin(Yaw), 0.f));
+            WritePacketHeader(Out, CarlaRecorderPacketId::FrameEnd, 0);
+        }
+    }
+    RecordingAnalysisParams Params;
+    Params.GazeLatenciesMs = {11.f, 33.f};
+    const RecordingSummary S = AnalyzeRecording(Filename, Params);
+    assert(S.bValid && S.GazePrediction.size() == 2);
+    // the device timestamps are whole ms, which makes the velocity a bit noisy
+    for (const GazePredictionError &E : S.GazePrediction)
+        assert(E.Samples > 150 && E.PredictedMeanDeg < 0.6 * E.HoldMeanDeg);
+    assert(S.GazePrediction[1].LatencyMs == 33.f && S.GazePrediction[1].HoldMeanDeg > S.GazePrediction[0].HoldMeanDeg);
+    assert(SummaryToJson(S).find("\"gaze_prediction\": [{\"latency_ms\": 11.0") != std::string::npos);
+    // not asked for: not computed
+    assert(AnalyzeRecording(Filename, RecordingAnalysisParams()).GazePrediction.empty());
+    std::remove(Filename.c_str());
+}
+
+static void TestCsvRow()
+{
+    RecordingSummary S;
+    S.Filename = "study/p01, \"run\" 2.rec";
+    S.Map = "Town03";
+    S.Error = "bad packet, stopped";
+    const std::string Row = SummaryToCsvRow(S);
+    // the string fields are quoted with their quotes doubled, the commas inside them do not add columns
+    assert(Row.rfind("\"study/p01, \"\"run\"\" 2.rec\",", 0) == 0);
+    assert(Row.find(",\"Town03\",") != std::string::npos);
+    const std::string Error = ",\"bad packet, stopped\"";
+    assert(Row.size() > Error.size() && Row.compare(Row.size() - Error.size(), Error.size(), Error) == 0);
+    size_t Columns = 1;
+    bool bQuoted = false;
+    for (char C : Row)
+    {
+        if (C == '"')
+            bQuoted = !bQuoted;
+        else if (C == ',' && !bQuoted)
+            Columns++;
+    }
+    const std::string Header = SummaryCsvHeader();
+    assert(Columns == static_cast<size_t>(std::count(Header.begin(), Header.end(), ',')) + 1);
+}
+
+int main()
+{
+    return RunTests("recording analysis", {
+        TestSyntheticRecording,
+        TestTruncatedRecording,
+        TestFrameIndex,
+        TestConfigFingerprints,
+        TestQualityChanges,
+        TestCustomActorChanges,
+        TestCustomActorDeltas,
+        TestGazePredictionReplay,
+        TestCsvRow
+    });
+}
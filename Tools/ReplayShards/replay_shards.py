@@ -0,0 +1,229 @@
+#!/usr/bin/env python
+
+"""
+Sharded (parallel) synchronous replay of one DReyeVR recording across several headless simulator instances.
+
+The recording's frames are split into contiguous shards [start, end). Every shard is replayed frame by frame by its
+own simulator instance (console command `DReyeVRReplayFrames <recording> <start> <end> 1`, which seeks straight to
+the first frame of the shard and quits once the shard is done) so the frame capture of one recording can use several
+GPUs/instances. Finally the per-shard capture indices (<stream>.index.csv, see DReyeVR/FrameStreamSink.h) are merged
+into one index per shader/pose stream that points into the shard directories.
+
+Example:
+    python replay_shards.py /path/to/exp_1.rec --carla ~/carla/Dist/CARLA_Shipping/LinuxNoEditor/CarlaUE4.sh \
+        --frame-dir ~/carla/Dist/CARLA_Shipping/LinuxNoEditor/CarlaUE4/FrameCap --instances 4 --gpus 0,1
+"""
+
+import argparse
+import csv
+import glob
+import os
+import struct
+import subprocess
+import sys
+import time
+
+FRAME_START_PACKET_ID = 0  # CarlaRecorderPacketId::FrameStart
+FRAME_INDEX_MAGIC = b"DREYEVR_FRAMEIDX\x00"  # see Carla/Recorder/DReyeVRFrameIndex.cpp
+FRAME_INDEX_VERSION = 3  # must match FrameIndexVersion
+
+
+def read_fstring(f):
+    # see CarlaRecorderHelpers.cpp::ReadFString (uint16 length + utf-8 bytes)
+    (length,) = struct.unpack("<H", f.read(2))
+    return f.read(length).decode("utf-8", errors="replace")
+
+
+def read_recording_info(f):
+    # see CarlaRecorderInfo (version, magic, date, map)
+    f.read(2)  # version
+    magic = read_fstring(f)
+    if magic != "CARLA_RECORDER":
+        raise ValueError(f"not a CARLA recording (magic: {magic!r})")
+    f.read(8)  # date (time_t)
+    return read_fstring(f)
+
+
+def read_frame_times(recording):
+    """Elapsed time of every frame in the recording (using the frame index sidecar if it is up to date)"""
+    recording_size = os.path.getsize(recording)
+    sidecar = recording + ".frameidx"
+    if os.path.exists(sidecar):
+        with open(sidecar, "rb") as f:
+            header = f.read(len(FRAME_INDEX_MAGIC) + 2 + 8 + 8)
+            magic = header[: len(FRAME_INDEX_MAGIC)]
+            version, size, count = struct.unpack("<HQQ", header[len(FRAME_INDEX_MAGIC) :])
+            if magic == FRAME_INDEX_MAGIC and version == FRAME_INDEX_VERSION and size == recording_size:
+                record = struct.Struct("<QdqB")  # frame id, elapsed, offset, has events
+                data = f.read(count * record.size)
+                return [record.unpack_from(data, i * record.size)[1] for i in range(count)]
+
+    # header-only walk over all the packets
+    times = []
+    with open(recording, "rb") as f:
+        read_recording_info(f)
+        while True:
+            header = f.read(5)
+            if len(header) < 5:
+                break
+            packet_id, size = struct.unpack("<bI", header)
+            if packet_id == FRAME_START_PACKET_ID:
+                body = f.read(size)
+                if len(body) < 24:
+                    break
+                _frame_id, _duration, elapsed = struct.unpack_from("<Qdd", body)
+                times.append(elapsed)
+            else:
+                f.seek(size, os.SEEK_CUR)
+    return times
+
+
+def make_shards(num_frames, num_shards, start=0, end=None):
+    """Split the frames [start, end) into num_shards contiguous [a, b) ranges of (almost) equal size"""
+    end = num_frames if end is None else min(end, num_frames)
+    count = max(end - start, 0)
+    num_shards = max(1, min(num_shards, count))
+    shards = []
+    for i in range(num_shards):
+        a = start + (count * i) // num_shards
+        b = start + (count * (i + 1)) // num_shards
+        if b > a:
+            shards.append((a, b))
+    return shards
+
+
+def instance_command(args, map_name, shard, slot):
+    a, b = shard
+    port = args.base_port + slot * args.port_stride
+    console_cmd = f"DReyeVRReplayFrames {os.path.abspath(args.recording)} {a} {b} 1"
+    cmd = [args.carla, map_name, "-RenderOffScreen", f"-carla-rpc-port={port}"]
+    if args.gpus:
+        cmd.append(f"-graphicsadapter={args.gpus[slot % len(args.gpus)]}")
+    cmd += args.extra_args
+    if os.name == "nt":
+        # Windows passes the command line through as-is, so quote the console command ourselves
+        return subprocess.list2cmdline(cmd) + f' -ExecCmds="{console_cmd}"'
+    # Linux: UE4 re-quotes arguments containing spaces when it rebuilds its command line
+    return cmd + [f"-ExecCmds={console_cmd}"]
+
+
+def run_shards(args, map_name, shards):
+    pending = list(enumerate(shards))
+    running = {}  # slot -> (shard index, process, start time)
+    failed = []
+    while pending or running:
+        for slot in range(args.instances):
+            if slot not in running and pending:
+                idx, shard = pending.pop(0)
+                cmd = instance_command(args, map_name, shard, slot)
+                print(f"[shard {idx}] frames [{shard[0]}, {shard[1]}): {cmd}")
+                if args.dry_run:
+                    continue
+                log = open(os.path.join(args.log_dir, f"shard_{shard[0]}-{shard[1]}.log"), "w")
+                proc = subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT, shell=isinstance(cmd, str))
+                running[slot] = (idx, proc, time.time())
+        for slot, (idx, proc, t0) in list(running.items()):
+            ret = proc.poll()
+            timed_out = args.timeout > 0 and time.time() - t0 > args.timeout
+            if ret is None and not timed_out:
+                continue
+            if timed_out and ret is None:
+                proc.kill()
+                ret = "timeout"
+            print(f"[shard {idx}] finished ({ret}) after {time.time() - t0:.0f}s")
+            if ret != 0:
+                failed.append(shards[idx])
+            del running[slot]
+        if running:
+            time.sleep(1.0)
+    return failed
+
+
+def find_shard_dir(frame_dir, shard):
+    # see AEgoSensor::InitFrameCapture ({date}_frames{start}-{end}), newest first
+    matches = glob.glob(os.path.join(frame_dir, f"*_frames{shard[0]}-{shard[1]}"))
+    return max(matches, key=os.path.getmtime) if matches else None
+
+
+def merge_indices(frame_dir, shards, out_dir):
+    """Concatenate the per-shard <stream>.index.csv files into <out_dir>/<stream>.index.csv"""
+    os.makedirs(out_dir, exist_ok=True)
+    streams = {}  # stream name -> list of rows
+    header = None
+    missing = []
+    for shard in shards:
+        shard_dir = find_shard_dir(frame_dir, shard)
+        if shard_dir is None:
+            missing.append(shard)
+            continue
+        for index_file in sorted(glob.glob(os.path.join(shard_dir, "*.index.csv"))):
+            stream = os.path.basename(index_file)[: -len(".index.csv")]
+            with open(index_file, newline="") as f:
+                reader = csv.reader(f)
+                header = next(reader, header)
+                file_col = header.index("file")
+                for row in reader:
+                    # point to the file relative to the merged index
+                    row[file_col] = os.path.relpath(os.path.join(shard_dir, row[file_col]), out_dir)
+                    streams.setdefault(stream, []).append(row)
+    for stream, rows in streams.items():
+        rows.sort(key=lambda row: int(row[0]))
+        with open(os.path.join(out_dir, f"{stream}.index.csv"), "w", newline="") as f:
+            writer = csv.writer(f, lineterminator="\n")
+            writer.writerow(header)
+            writer.writerows(rows)
+        print(f"merged {len(rows)} frames of stream {stream}")
+    return missing
+
+
+def main():
+    argparser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    argparser.add_argument("recording", help="recording file (as passed to the replayer)")
+    argparser.add_argument("--carla", help="simulator launch script/executable (CarlaUE4.sh or CarlaUE4.exe)")
+    argparser.add_argument("--frame-dir", required=True, help="frame capture directory ([Replayer] FrameDir)")
+    argparser.add_argument("--out", help="directory for the merged indices (default: <frame-dir>/<recording>_merged)")
+    argparser.add_argument("-n", "--instances", type=int, default=2, help="simulator instances running at once")
+    argparser.add_argument("--shards", type=int, default=0, help="number of shards (default: one per instance)")
+    argparser.add_argument("--start", type=int, default=0, help="first frame to render")
+    argparser.add_argument("--end", type=int, default=None, help="frame to stop at (exclusive, default: last)")
+    argparser.add_argument("--base-port", type=int, default=2000, help="rpc port of the first instance")
+    argparser.add_argument("--port-stride", type=int, default=4, help="rpc port spacing between instances")
+    argparser.add_argument("--gpus", default="", help="comma separated graphics adapters to spread instances on")
+    argparser.add_argument("--timeout", type=float, default=0, help="seconds before an instance is killed (0: none)")
+    argparser.add_argument("--log-dir", default=".", help="where the per-shard simulator logs are written")
+    argparser.add_argument("--merge-only", action="store_true", help="only merge the indices of existing shards")
+    argparser.add_argument("--dry-run", action="store_true", help="only print the instance commands")
+    # everything after "--" is passed on to the simulator
+    argv = sys.argv[1:]
+    split = argv.index("--") if "--" in argv else len(argv)
+    args = argparser.parse_args(argv[:split])
+    args.extra_args = argv[split + 1 :]
+    args.gpus = [g for g in args.gpus.split(",") if g]
+
+    with open(args.recording, "rb") as f:
+        map_name = read_recording_info(f)
+    frame_times = read_frame_times(args.recording)
+    shards = make_shards(len(frame_times), args.shards or args.instances, args.start, args.end)
+    print(f"{args.recording}: {len(frame_times)} frames on {map_name}, {len(shards)} shards")
+    if not shards:
+        return 1
+
+    if not args.merge_only:
+        if args.carla is None:
+            argparser.error("--carla is required unless --merge-only")
+        failed = run_shards(args, map_name, shards)
+        if args.dry_run:
+            return 0
+        for shard in failed:
+            print(f"shard [{shard[0]}, {shard[1]}) failed, see its log in {args.log_dir}")
+
+    stem = os.path.splitext(os.path.basename(args.recording))[0]
+    out_dir = args.out or os.path.join(args.frame_dir, f"{stem}_merged")
+    missing = merge_indices(args.frame_dir, shards, out_dir)
+    for shard in missing:
+        print(f"no capture directory for shard [{shard[0]}, {shard[1]}) in {args.frame_dir}")
+    return 1 if missing else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
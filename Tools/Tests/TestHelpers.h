@@ -0,0 +1,21 @@
+#pragma once
+
+// shared by the standalone tests (which check with assert and stop at the first failure)
+
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+
+inline bool Near(double A, double B, double Tol = 1e-6)
+{
+    return std::fabs(A - B) < Tol;
+}
+
+// runs the tests in order and reports once all of them passed
+inline int RunTests(const char *Module, std::initializer_list<void (*)()> Tests)
+{
+    for (void (*Test)() : Tests)
+        Test();
+    std::cout << "all " << Module << " tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,247 @@
+// micro-benchmark of the config lookups: ConfigFile::Get (string conversions, map lookups, and parsing on every call)
+// against pre-resolved ConfigHandles, over the keys of Config/DReyeVRConfig.ini and Config/EgoVehicles/TeslaM3.ini
+//   ./bench_config_file [passes]
+
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "DReyeVR/ConfigFile.h"
+
+using Key = std::pair<const TCHAR *, const TCHAR *>; // section, variable
+
+// the typed keys of each config file (a mix of what the simulator reads)
+static const std::vector<Key> GeneralBools = {
+    {"EgoVehicle", "SpeedometerInMPH"},
+    {"EgoVehicle", "EnableTurnSignalAction"},
+    {"EgoVehicle", "DrawDebugEditor"},
+    {"EgoSensor", "StreamSensorData"},
+    {"EgoSensor", "DrawDebugFocusTrace"},
+    {"VehicleInputs", "InvertMouseY"},
+    {"EgoVehicleHUD", "DrawFPSCounter"},
+    {"EgoVehicleHUD", "DrawFlatReticle"},
+    {"EgoVehicleHUD", "DrawGaze"},
+    {"EgoVehicleHUD", "DrawSpectatorReticle"},
+    {"EgoVehicleHUD", "EnableSpectatorScreen"},
+    {"Game", "AutomaticallySpawnEgo"},
+    {"Game", "DoSpawnEgoVehicleTransform"},
+    {"Replayer", "CameraFollowHMD"},
+    {"Replayer", "UseCarlaSpectator"},
+    {"Replayer", "ReplayInterpolation"},
+    {"Replayer", "RecordFrames"},
+    {"Replayer", "RecordAllShaders"},
+    {"Replayer", "RecordAllPoses"},
+    {"Replayer", "FileFormatJPG"},
+    {"Replayer", "LinearGamma"},
+    {"Replayer", "AsyncFrameCapture"},
+    {"WheelFace", "EnableWheelButtons"},
+    {"WheelFace", "EnableAutopilotIndicator"},
+    {"Hardware", "LogUpdates"},
+    {"VariableRateShading", "Enabled"},
+    {"VariableRateShading", "UsingEyeTracking"},
+};
+static const std::vector<Key> GeneralInts = {
+    {"EgoVehicleHUD", "ReticleSize"},      {"Replayer", "FrameWidth"},         {"Replayer", "FrameHeight"},
+    {"Replayer", "FrameWriterThreads"},    {"Replayer", "FrameWriterMaxMB"},   {"Replayer", "FrameReadbackLatency"},
+    {"Replayer", "FrameStreamFPS"},        {"Hardware", "DeviceIdx"},          {"Hardware", "ForceFeedbackMagnitude"},
+};
+static const std::vector<Key> GeneralFloats = {
+    {"EgoVehicle", "TurnSignalDuration"},      {"CameraParams", "FieldOfView"},
+    {"CameraParams", "ScreenPercentage"},      {"CameraParams", "MotionBlurIntensity"},
+    {"CameraParams", "VignetteIntensity"},     {"CameraParams", "BloomIntensity"},
+    {"CameraParams", "SceneFringeIntensity"},  {"CameraParams", "LensFlareIntensity"},
+    {"CameraParams", "GrainIntensity"},        {"EgoSensor", "MaxTraceLenM"},
+    {"VehicleInputs", "ScaleSteeringDamping"}, {"VehicleInputs", "ScaleThrottleInput"},
+    {"VehicleInputs", "ScaleBrakeInput"},      {"VehicleInputs", "ScaleMouseY"},
+    {"VehicleInputs", "ScaleMouseX"},          {"EgoVehicleHUD", "HUDScaleVR"},
+    {"Sound", "EgoVolumePercent"},             {"Sound", "NonEgoVolumePercent"},
+    {"Sound", "AmbientVolumePercent"},         {"WheelFace", "QuadButtonSpread"},
+    {"WheelFace", "AutopilotIndicatorSize"},   {"Hardware", "DeltaInputThreshold"},
+};
+static const std::vector<Key> GeneralStrings = {
+    {"EgoVehicle", "VehicleType"},     {"Sound", "DefaultEngineRev"},       {"Sound", "DefaultCrashSound"},
+    {"Sound", "DefaultGearShiftSound"}, {"Sound", "DefaultTurnSignalSound"}, {"Replayer", "FrameDir"},
+    {"Replayer", "FrameName"},         {"Replayer", "FrameSink"},           {"CameraPose", "StartingPose"},
+};
+static const std::vector<Key> GeneralVectors = {
+    {"WheelFace", "ABXYLocation"},
+    {"WheelFace", "DpadLocation"},
+    {"WheelFace", "AutopilotIndicatorLoc"},
+};
+static const std::vector<Key> GeneralTransforms = {
+    {"Game", "SpawnEgoVehicleTransform"},
+    {"CameraPose", "Front"},
+    {"CameraPose", "BirdsEyeView"},
+    {"CameraPose", "ThirdPerson"},
+};
+
+static const std::vector<Key> VehicleBools = {
+    {"Dashboard", "SpeedometerEnabled"}, {"Dashboard", "TurnSignalsEnabled"}, {"Dashboard", "GearShifterEnabled"},
+    {"Mirrors", "RearMirrorEnabled"},    {"Mirrors", "LeftMirrorEnabled"},    {"Mirrors", "RightMirrorEnabled"},
+    {"SteeringWheel", "Enabled"},
+};
+static const std::vector<Key> VehicleFloats = {
+    {"Mirrors", "RearScreenPercentage"},     {"Mirrors", "LeftScreenPercentage"},
+    {"Mirrors", "RightScreenPercentage"},    {"SteeringWheel", "MaxSteerAngleDeg"},
+    {"SteeringWheel", "SteeringScale"},
+};
+static const std::vector<Key> VehicleStrings = {{"Blueprint", "Path"}};
+static const std::vector<Key> VehicleVectors = {{"Sounds", "EngineLocn"}, {"SteeringWheel", "InitLocation"}};
+static const std::vector<Key> VehicleRotators = {{"SteeringWheel", "InitRotation"}};
+static const std::vector<Key> VehicleTransforms = {
+    {"CameraPose", "DriversSeat"},          {"Dashboard", "SpeedometerTransform"},
+    {"Dashboard", "TurnSignalsTransform"},  {"Dashboard", "GearShifterTransform"},
+    {"Mirrors", "RearMirrorChassisTransform"}, {"Mirrors", "RearMirrorTransform"},
+    {"Mirrors", "RearReflectionTransform"}, {"Mirrors", "LeftMirrorTransform"},
+    {"Mirrors", "LeftReflectionTransform"}, {"Mirrors", "RightMirrorTransform"},
+    {"Mirrors", "RightReflectionTransform"},
+};
+
+// folds a value into a checksum so neither loop can be optimized away
+static double Sum(bool V)
+{
+    return V ? 1.0 : 0.0;
+}
+static double Sum(int V)
+{
+    return V;
+}
+static double Sum(float V)
+{
+    return V;
+}
+static double Sum(const FString &V)
+{
+    return V.Len();
+}
+static double Sum(const FVector &V)
+{
+    return V.X + V.Y + V.Z;
+}
+static double Sum(const FRotator &V)
+{
+    return V.Pitch + V.Yaw + V.Roll;
+}
+static double Sum(const FTransform &V)
+{
+    return Sum(V.Translation) + Sum(V.Rotation) + Sum(V.Scale3D);
+}
+
+template <typename T> struct TypedKeys
+{
+    TypedKeys(const ConfigFile &Config, const std::vector<Key> &InKeys) : Config(Config), Keys(InKeys)
+    {
+        for (const Key &K : Keys)
+        {
+            Handles.push_back(Config.Register<T>(K.first, K.second));
+            assert(Handles.back().IsFound());
+            // both paths read the same value
+            assert(Sum(Config.Get<T>(K.first, K.second)) == Sum(Handles.back().Get()));
+        }
+    }
+
+    double LookupAll() const
+    {
+        double Checksum = 0.0;
+        for (const Key &K : Keys)
+            Checksum += Sum(Config.Get<T>(K.first, K.second));
+        return Checksum;
+    }
+
+    double ReadAll() const
+    {
+        double Checksum = 0.0;
+        for (const ConfigHandle<T> &Handle : Handles)
+            Checksum += Sum(Handle.Get());
+        return Checksum;
+    }
+
+    const ConfigFile &Config;
+    const std::vector<Key> &Keys;
+    std::vector<ConfigHandle<T>> Handles;
+};
+
+struct AllKeys
+{
+    AllKeys(const ConfigFile &General, const ConfigFile &Vehicle)
+        : GBools(General, GeneralBools), GInts(General, GeneralInts), GFloats(General, GeneralFloats),
+          GStrings(General, GeneralStrings), GVectors(General, GeneralVectors),
+          GTransforms(General, GeneralTransforms), VBools(Vehicle, VehicleBools), VFloats(Vehicle, VehicleFloats),
+          VStrings(Vehicle, VehicleStrings), VVectors(Vehicle, VehicleVectors), VRotators(Vehicle, VehicleRotators),
+          VTransforms(Vehicle, VehicleTransforms)
+    {
+    }
+
+    size_t Num() const
+    {
+        return GBools.Keys.size() + GInts.Keys.size() + GFloats.Keys.size() + GStrings.Keys.size() +
+               GVectors.Keys.size() + GTransforms.Keys.size() + VBools.Keys.size() + VFloats.Keys.size() +
+               VStrings.Keys.size() + VVectors.Keys.size() + VRotators.Keys.size() + VTransforms.Keys.size();
+    }
+
+    template <typename F> double ForEach(F &&Fn) const
+    {
+        return Fn(GBools) + Fn(GInts) + Fn(GFloats) + Fn(GStrings) + Fn(GVectors) + Fn(GTransforms) + Fn(VBools) +
+               Fn(VFloats) + Fn(VStrings) + Fn(VVectors) + Fn(VRotators) + Fn(VTransforms);
+    }
+
+    TypedKeys<bool> GBools;
+    TypedKeys<int> GInts;
+    TypedKeys<float> GFloats;
+    TypedKeys<FString> GStrings;
+    TypedKeys<FVector> GVectors;
+    TypedKeys<FTransform> GTransforms;
+    TypedKeys<bool> VBools;
+    TypedKeys<float> VFloats;
+    TypedKeys<FString> VStrings;
+    TypedKeys<FVector> VVectors;
+    TypedKeys<FRotator> VRotators;
+    TypedKeys<FTransform> VTransforms;
+};
+
+template <typename F> static double TimeNs(int Passes, double &Checksum, F &&Fn)
+{
+    const auto Start = std::chrono::steady_clock::now();
+    for (int i = 0; i < Passes; i++)
+        Checksum += Fn();
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - Start).count();
+}
+
+int main(int argc, char **argv)
+{
+    const int Passes = argc > 1 ? std::max(std::atoi(argv[1]), 1) : 2000;
+    assert(GeneralParams.bIsValid());
+    const ConfigFile VehicleParams(FPaths::Combine(CarlaUE4Path, TEXT("Config/EgoVehicles"), TEXT("TeslaM3.ini")));
+    assert(VehicleParams.bIsValid());
+
+    const AllKeys Keys(GeneralParams, VehicleParams);
+
+    // spot checks of the parsed values
+    assert(GeneralParams.Register<FString>("EgoVehicle", "VehicleType").Get() == "TeslaM3");
+    assert(GeneralParams.Register<int>("Replayer", "FrameWidth").Get() == 1280);
+    const FTransform Seat = VehicleParams.Register<FTransform>("CameraPose", "DriversSeat").Get();
+    assert(Seat.Translation.X == 20.f && Seat.Translation.Y == -40.f && Seat.Translation.Z == 120.f);
+    assert(VehicleParams.Register<FRotator>("SteeringWheel", "InitRotation").Get().Pitch == -10.f);
+    // a missing entry is reported once (here) and the handle holds the default
+    const ConfigHandle<float> Missing = GeneralParams.Register<float>("CameraParams", "NoSuchParam", 1.5f);
+    assert(!Missing.IsFound() && *Missing == 1.5f);
+
+    double LookupChecksum = 0.0, HandleChecksum = 0.0;
+    const double LookupNs = TimeNs(Passes, LookupChecksum, [&] {
+        return Keys.ForEach([](const auto &Typed) { return Typed.LookupAll(); });
+    });
+    const double HandleNs = TimeNs(Passes, HandleChecksum, [&] {
+        return Keys.ForEach([](const auto &Typed) { return Typed.ReadAll(); });
+    });
+    assert(LookupChecksum == HandleChecksum);
+
+    const double NumReads = double(Passes) * Keys.Num();
+    std::cout << Keys.Num() << " keys x " << Passes << " passes" << std::endl
+              << "ConfigFile::Get:    " << LookupNs / NumReads << " ns/read" << std::endl
+              << "ConfigHandle::Get:  " << HandleNs / NumReads << " ns/read" << std::endl
+              << "speedup:            " << LookupNs / std::max(HandleNs, 1.0) << "x" << std::endl;
+    return 0;
+}
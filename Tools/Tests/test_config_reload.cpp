@@ -0,0 +1,79 @@
+// hot reloading of a ConfigFile: rewrite a watched ini and check that handles and subscribers see the new values
+//   ./test_config_reload
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "DReyeVR/ConfigFile.h"
+
+static void WriteIni(const std::string &Path, const std::string &Contents)
+{
+    // write next to the file and rename over it (like most editors do)
+    const std::string Tmp = Path + ".tmp";
+    {
+        std::ofstream Out(Tmp, std::ios::out | std::ios::trunc);
+        Out << Contents;
+    }
+    std::rename(Tmp.c_str(), Path.c_str());
+}
+
+static bool DispatchUntil(const int &Counter, int Expected, int TimeoutMs = 5000)
+{
+    // the game thread calls DispatchReloads once per frame
+    const auto Deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(TimeoutMs);
+    while (Counter < Expected && std::chrono::steady_clock::now() < Deadline)
+    {
+        ConfigFile::DispatchReloads();
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return Counter >= Expected;
+}
+
+int main()
+{
+    const std::string Path = "test_config_reload.ini";
+    WriteIni(Path, "[EgoSensor]\nMaxTraceLenM=100.0\n[Replayer]\nFrameWidth=1280\nFrameHeight=720\n");
+
+    ConfigFile Config(FString(Path.c_str()));
+    const auto TraceLen = Config.Register<float>("EgoSensor", "MaxTraceLenM");
+    const auto Width = Config.Register<int>("Replayer", "FrameWidth");
+    assert(TraceLen.Get() == 100.f && Width.Get() == 1280);
+
+    int SensorCalls = 0, WidthCalls = 0;
+    const int SensorSub = Config.Subscribe({{"EgoSensor", ""}}, [&SensorCalls]() { SensorCalls++; });
+    const int WidthSub = Config.Subscribe({{"Replayer", "FrameWidth"}}, [&WidthCalls]() { WidthCalls++; });
+    assert(FileWatcher::Get()->NumWatched() == 1);
+
+    // only a key of the replayer section (not FrameWidth) changes
+    WriteIni(Path, "[EgoSensor]\nMaxTraceLenM=100.0\n[Replayer]\nFrameWidth=1280\nFrameHeight=1080\n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    ConfigFile::DispatchReloads();
+    assert(SensorCalls == 0 && WidthCalls == 0);
+    assert(Config.Get<int>("Replayer", "FrameHeight") == 1080);
+
+    // both subscriptions are affected
+    WriteIni(Path, "[EgoSensor]\nMaxTraceLenM=50.0\n[Replayer]\nFrameWidth=1920\nFrameHeight=1080\n");
+    const bool bReloaded = DispatchUntil(WidthCalls, 1);
+    assert(bReloaded);
+    assert(SensorCalls == 1 && WidthCalls == 1);
+    assert(TraceLen.Get() == 50.f && Width.Get() == 1920);
+    assert(Config.Get<float>("EgoSensor", "MaxTraceLenM") == 50.f);
+
+    // copies keep the table they were made from, but do not follow the file
+    const ConfigFile Snapshot = Config;
+    Config.Unsubscribe(SensorSub);
+    WriteIni(Path, "[EgoSensor]\nMaxTraceLenM=25.0\n[Replayer]\nFrameWidth=640\nFrameHeight=1080\n");
+    assert(DispatchUntil(WidthCalls, 2));
+    assert(SensorCalls == 1 && Width.Get() == 640 && TraceLen.Get() == 25.f);
+    assert(Snapshot.Get<int>("Replayer", "FrameWidth") == 1920);
+
+    Config.Unsubscribe(WidthSub);
+    assert(FileWatcher::Get()->NumWatched() == 0);
+    std::remove(Path.c_str());
+    std::cout << "config reload: ok" << std::endl;
+    return 0;
+}
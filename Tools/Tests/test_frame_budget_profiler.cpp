@@ -0,0 +1,110 @@
+// per-frame stage timings of the FrameBudgetProfiler: ring wrap-around, percentiles, and the CSV/JSON exports
+
+#include "DReyeVR/FrameBudgetProfiler.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::string ReadAll(const std::string &Path)
+{
+    std::ifstream In(Path);
+    std::ostringstream oss;
+    oss << In.rdbuf();
+    return oss.str();
+}
+
+static void TimedStage()
+{
+    DREYEVR_PROFILE_STAGE(Test_TimedStage);
+}
+
+int main()
+{
+    // the scope macro records into the process-wide instance
+    FrameBudgetProfiler::Get().BeginFrame(0, 11.0);
+    TimedStage();
+    TimedStage();
+    assert(FrameBudgetProfiler::Get().RegisterStage("Test_TimedStage") == 0);
+    assert(FrameBudgetProfiler::Get().Summarize(11.1)[0].Max >= 0.0);
+    DREYEVR_PROFILE_COUNT(Test_Count, 2);
+    assert(FrameBudgetProfiler::Get().SummarizeCounters()[0].Max == 2.0);
+
+    FrameBudgetProfiler Profiler(100);
+    const int A = Profiler.RegisterStage("A");
+    const int B = Profiler.RegisterStage("B");
+    assert(A == 0 && B == 1 && Profiler.RegisterStage("A") == A);
+
+    // nothing is recorded before the first frame
+    Profiler.AddTime(A, 1000.0);
+    assert(Profiler.NumFrames() == 0);
+
+    // 150 frames into a ring of 100: frames 50..149 remain, A takes (frame - 49) ms, B 1 ms (in two parts)
+    for (uint64_t f = 0; f < 150; f++)
+    {
+        Profiler.BeginFrame(f, 11.0);
+        Profiler.AddTime(A, double(f) - 49.0);
+        Profiler.AddTime(B, 0.5);
+        Profiler.AddTime(B, 0.5);
+        Profiler.AddTime(-1, 5.0); // unregistered stage (ignored)
+    }
+    assert(Profiler.NumFrames() == 100);
+
+    const auto Summary = Profiler.Summarize(50.0);
+    assert(Summary.size() == 4 && Summary[0].Name == "A" && Summary[2].Name == "Total" && Summary[3].Name == "Frame");
+    assert(Near(Summary[0].P50, 50.0) && Near(Summary[0].P95, 95.0) && Near(Summary[0].P99, 99.0));
+    assert(Near(Summary[0].Max, 100.0) && Near(Summary[0].Mean, 50.5));
+    assert(Near(Summary[1].P99, 1.0) && Near(Summary[1].Mean, 1.0));
+    assert(Summary[2].OverBudget == 51 && Near(Summary[2].Max, 101.0)); // totals of 51..101 ms
+    assert(Summary[3].OverBudget == 0 && Near(Summary[3].P50, 11.0));
+
+    // oldest frame first
+    const std::string CSV = "frame_budget_test.csv";
+    assert(Profiler.ExportCSV(CSV));
+    std::istringstream Lines(ReadAll(CSV));
+    std::string Header, First;
+    std::getline(Lines, Header);
+    std::getline(Lines, First);
+    assert(Header == "frame,frame_ms,A,B,total_ms");
+    assert(First == "50,11,1,1,2");
+    std::remove(CSV.c_str());
+
+    const std::string JSON = "frame_budget_test.json";
+    assert(Profiler.ExportJSON(JSON, 50.0));
+    const std::string Json = ReadAll(JSON);
+    assert(Json.find("\"stages\": [\"A\", \"B\"]") != std::string::npos);
+    assert(Json.find("\"name\": \"Total\"") != std::string::npos && Json.find("\"frame\": 149") != std::string::npos);
+    std::remove(JSON.c_str());
+
+    // counters are kept per frame next to the stages
+    const int C = Profiler.RegisterCounter("C");
+    assert(C == 0 && Profiler.RegisterCounter("C") == C && Profiler.RegisterStage("C") == 2);
+    for (uint64_t f = 150; f < 250; f++)
+    {
+        Profiler.BeginFrame(f, 11.0);
+        Profiler.AddCount(C, (f % 10 == 0) ? 5 : 0);
+        Profiler.AddCount(-1); // unregistered counter (ignored)
+    }
+    const auto Counters = Profiler.SummarizeCounters();
+    assert(Counters.size() == 1 && Counters[0].Name == "C");
+    assert(Near(Counters[0].Mean, 0.5) && Near(Counters[0].P50, 0.0) && Near(Counters[0].Max, 5.0));
+    assert(Profiler.ExportCSV(CSV));
+    std::istringstream CounterLines(ReadAll(CSV));
+    std::getline(CounterLines, Header);
+    std::getline(CounterLines, First);
+    assert(Header == "frame,frame_ms,A,B,C,total_ms,C");
+    assert(First == "150,11,0,0,0,0,5");
+    std::remove(CSV.c_str());
+
+    Profiler.SetEnabled(false);
+    Profiler.BeginFrame(250, 11.0);
+    assert(Profiler.NumFrames() == 100);
+
+    std::cout << Profiler.SummaryString(50.0);
+    std::cout << "frame budget profiler: ok" << std::endl;
+    return 0;
+}
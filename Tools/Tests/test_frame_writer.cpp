@@ -0,0 +1,312 @@
+// feeds synthetic pixel buffers through the asynchronous frame capture encode/write stage and the stream sinks
+
+#include "DReyeVR/FrameStreamSink.h"
+#include "DReyeVR/FrameWriterPool.h"
+#include "TestHelpers.h"
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+static FramePixelBuffer MakeBuffer(uint32_t W, uint32_t H, uint64_t Idx)
+{
+    FramePixelBuffer Buffer;
+    Buffer.Width = W;
+    Buffer.Height = H;
+    Buffer.FrameIdx = Idx;
+    Buffer.Pixels.resize(4 * static_cast<size_t>(W) * H);
+    for (size_t i = 0; i < Buffer.Pixels.size(); i += 4)
+    {
+        Buffer.Pixels[i + 0] = 10;  // B
+        Buffer.Pixels[i + 1] = 20;  // G
+        Buffer.Pixels[i + 2] = 30;  // R
+        Buffer.Pixels[i + 3] = 0;   // A
+    }
+    return Buffer;
+}
+
+static void TestBoundedInFlight()
+{
+    const size_t FrameBytes = 4 * 64 * 32;
+    const size_t Budget = 3 * FrameBytes;
+    std::atomic<size_t> Encoded{0};
+    std::atomic<size_t> MaxSeenBytes{0};
+    FrameWriterPool *PoolPtr = nullptr;
+    FrameWriterPool Pool(
+        [&](FramePixelBuffer &Buffer) {
+            // a slow disk, so the producer runs into the budget
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            const size_t InFlight = PoolPtr->GetStats().InFlightBytes;
+            size_t Prev = MaxSeenBytes.load();
+            while (InFlight > Prev && !MaxSeenBytes.compare_exchange_weak(Prev, InFlight))
+                ;
+            Encoded++;
+            return Buffer.FrameIdx % 10 != 9; // every 10th buffer fails to encode
+        },
+        2, Budget);
+    PoolPtr = &Pool;
+
+    for (uint64_t i = 0; i < 50; i++)
+    {
+        Pool.Reserve(FrameBytes);
+        Pool.Submit(MakeBuffer(64, 32, i));
+    }
+    Pool.Flush();
+
+    const FrameWriterStats S = Pool.GetStats();
+    assert(Encoded == 50);
+    assert(S.Written == 45 && S.Failed == 5);
+    assert(S.QueueDepth == 0 && S.Encoding == 0 && S.InFlightBytes == 0);
+    assert(S.PeakInFlightBytes <= Budget && MaxSeenBytes <= Budget);
+    assert(S.Stalls > 0); // the producer was throttled
+    assert(S.PeakQueueDepth >= 1);
+}
+
+static void TestReservations()
+{
+    FrameWriterPool Pool([](FramePixelBuffer &) { return true; }, 1, 100);
+    assert(Pool.TryReserve(60));
+    assert(!Pool.TryReserve(60)); // over budget
+    Pool.Release(60);             // readback failed, never submitted
+    assert(Pool.GetStats().InFlightBytes == 0);
+    assert(Pool.TryReserve(500)); // larger than the budget, but nothing else is in flight
+    assert(!Pool.TryReserve(1));
+    Pool.Release(500);
+}
+
+static void TestWritePPM()
+{
+    const std::string Filename = "frame_writer_test.ppm";
+    {
+        FrameWriterPool Pool(&FrameWriterPool::WritePPM, 1, 1 << 20);
+        FramePixelBuffer Buffer = MakeBuffer(3, 2, 0);
+        Buffer.Filename = Filename;
+        Pool.Reserve(Buffer.Bytes());
+        Pool.Submit(std::move(Buffer));
+    } // destructor writes everything still queued
+
+    std::ifstream In(Filename, std::ios::binary);
+    std::stringstream Contents;
+    Contents << In.rdbuf();
+    const std::string Data = Contents.str();
+    const std::string Header = "P6\n3 2\n255\n";
+    assert(Data.size() == Header.size() + 3 * 3 * 2);
+    assert(Data.compare(0, Header.size(), Header) == 0);
+    assert(Data[Header.size() + 0] == 30 && Data[Header.size() + 1] == 20 && Data[Header.size() + 2] == 10);
+    In.close();
+    std::remove(Filename.c_str());
+
+    // missing pixels are rejected instead of reading out of bounds
+    FramePixelBuffer Short = MakeBuffer(3, 2, 0);
+    Short.Height = 4;
+    Short.Filename = Filename;
+    assert(!FrameWriterPool::WritePPM(Short));
+}
+
+static std::string ReadFile(const std::string &Filename)
+{
+    std::ifstream In(Filename, std::ios::binary);
+    std::stringstream Contents;
+    Contents << In.rdbuf();
+    return Contents.str();
+}
+
+static std::vector<std::string> ReadLines(const std::string &Filename)
+{
+    std::ifstream In(Filename);
+    std::vector<std::string> Lines;
+    for (std::string Line; std::getline(In, Line);)
+        Lines.push_back(Line);
+    return Lines;
+}
+
+static void TestY4MStreams()
+{
+    // two shader streams, written by several workers so frames finish out of order
+    const int NumFrames = 20;
+    {
+        FrameStreamSink Sink(".", EFrameSinkFormat::Y4M, 25);
+        FrameWriterPool Pool(
+            [&Sink](FramePixelBuffer &Buffer) {
+                // later frames finish first
+                std::this_thread::sleep_for(std::chrono::microseconds(100 * (NumFrames - Buffer.FrameIdx)));
+                return Sink.Append(Buffer);
+            },
+            4, 1 << 20);
+        for (int i = 0; i < NumFrames; i++)
+        {
+            for (int s = 0; s < 2; s++)
+            {
+                FramePixelBuffer Buffer = MakeBuffer(4, 2, i);
+                Buffer.Stream = "y4m_test_s" + std::to_string(s);
+                Buffer.RecordingFrame = 100 + i;
+                Buffer.RecordingTime = 0.05 * i;
+                Pool.Reserve(Buffer.Bytes());
+                Pool.Submit(std::move(Buffer));
+            }
+        }
+        Pool.Flush();
+        assert(Pool.GetStats().Written == 2 * NumFrames);
+    }
+
+    for (int s = 0; s < 2; s++)
+    {
+        const std::string Name = "y4m_test_s" + std::to_string(s);
+        const std::string Data = ReadFile(Name + ".y4m");
+        const std::string Header = "YUV4MPEG2 W4 H2 F25:1 Ip A1:1 C444\n";
+        const size_t FrameBytes = 3 * 4 * 2;
+        assert(Data.compare(0, Header.size(), Header) == 0);
+        assert(Data.size() == Header.size() + NumFrames * (6 + FrameBytes));
+
+        const std::vector<std::string> Index = ReadLines(FrameStreamSink::GetIndexFilename(".", Name));
+        assert(Index.size() == NumFrames + 1 && Index[0] == FrameStreamSink::IndexHeader());
+        for (int i = 0; i < NumFrames; i++)
+        {
+            // in frame order, pointing right behind each FRAME marker
+            const size_t Offset = Header.size() + i * (6 + FrameBytes) + 6;
+            char Expected[256];
+            std::snprintf(Expected, sizeof(Expected), "%d,%d,%.6f,%s.y4m,%zu,%zu,4,2", i, 100 + i, 0.05 * i,
+                          Name.c_str(), Offset, FrameBytes);
+            assert(Index[i + 1] == Expected);
+            assert(Data.compare(Offset - 6, 6, "FRAME\n") == 0);
+        }
+        // BGR (10, 20, 30) in BT.601 limited range
+        const size_t First = Header.size() + 6;
+        assert(uint8_t(Data[First]) == 35 && uint8_t(Data[First + 8]) == 122 && uint8_t(Data[First + 16]) == 133);
+        std::remove((Name + ".y4m").c_str());
+        std::remove(FrameStreamSink::GetIndexFilename(".", Name).c_str());
+    }
+}
+
+static void TestRawAndDroppedFrames()
+{
+    const std::string Name = "raw_test_s0_p0";
+    {
+        FrameStreamSink Sink(".", EFrameSinkFormat::Raw);
+        for (uint64_t i : {1, 0, 3, 2}) // frame 2 could not be read back
+        {
+            FramePixelBuffer Buffer = MakeBuffer(2, 2, i);
+            Buffer.Stream = Name;
+            if (i == 2)
+                Buffer.Pixels.clear();
+            assert(Sink.Append(Buffer) == (i != 2));
+        }
+        FramePixelBuffer Duplicate = MakeBuffer(2, 2, 1);
+        Duplicate.Stream = Name;
+        assert(!Sink.Append(Duplicate));
+    }
+    assert(ReadFile(Name + ".raw").size() == 3 * 16);
+    const std::vector<std::string> Index = ReadLines(FrameStreamSink::GetIndexFilename(".", Name));
+    assert(Index.size() == 4);
+    assert(Index[1].compare(0, 2, "0,") == 0 && Index[2].compare(0, 2, "1,") == 0);
+    assert(Index[3] == "3,0,0.000000," + Name + ".raw,32,16,2,2");
+    std::remove((Name + ".raw").c_str());
+    std::remove(FrameStreamSink::GetIndexFilename(".", Name).c_str());
+
+    // a replayed frame range starts its streams at the first frame of the range
+    {
+        FrameStreamSink Sink(".", EFrameSinkFormat::Raw, 30, 500);
+        FramePixelBuffer Buffer = MakeBuffer(2, 2, 501);
+        Buffer.Stream = Name;
+        assert(Sink.Append(Buffer));
+        Buffer = MakeBuffer(2, 2, 499); // before the range
+        Buffer.Stream = Name;
+        assert(!Sink.Append(Buffer));
+        assert(ReadFile(Name + ".raw").empty()); // still waiting for frame 500
+        Buffer = MakeBuffer(2, 2, 500);
+        Buffer.Stream = Name;
+        assert(Sink.Append(Buffer));
+    }
+    assert(ReadFile(Name + ".raw").size() == 2 * 16);
+    assert(ReadLines(FrameStreamSink::GetIndexFilename(".", Name))[1].compare(0, 4, "500,") == 0);
+    std::remove((Name + ".raw").c_str());
+    std::remove(FrameStreamSink::GetIndexFilename(".", Name).c_str());
+}
+
+static void TestHeldOutOfOrder()
+{
+    const std::string Name = "held_test_s0_p0";
+    FrameWriterPool Pool(FrameWriterPool::WritePPM, 1, 1 << 20);
+    {
+        FrameStreamSink Sink(".", EFrameSinkFormat::Raw);
+        Sink.SetBudget(&Pool);
+        for (uint64_t i : {2, 1})
+        {
+            FramePixelBuffer Buffer = MakeBuffer(2, 2, i);
+            Buffer.Stream = Name;
+            assert(Sink.Append(Buffer));
+        }
+        // frames 1 and 2 wait for frame 0, in the budget of the pool
+        assert(Pool.GetStats().InFlightBytes == 2 * 16);
+        FramePixelBuffer Buffer = MakeBuffer(2, 2, 0);
+        Buffer.Stream = Name;
+        assert(Sink.Append(Buffer));
+        assert(Pool.GetStats().InFlightBytes == 0);
+
+        // given back when a gap is flushed on close too
+        Buffer = MakeBuffer(2, 2, 4);
+        Buffer.Stream = Name;
+        assert(Sink.Append(Buffer));
+        assert(Pool.GetStats().InFlightBytes == 16);
+        Sink.Close();
+        assert(Pool.GetStats().InFlightBytes == 0);
+    }
+    assert(ReadFile(Name + ".raw").size() == 4 * 16);
+    std::remove((Name + ".raw").c_str());
+    std::remove(FrameStreamSink::GetIndexFilename(".", Name).c_str());
+}
+
+static void TestEncodedPayloads()
+{
+    EFrameSinkFormat Format;
+    assert(ParseFrameSinkFormat("MJPEG", Format) && Format == EFrameSinkFormat::MJPEG);
+    assert(ParseFrameSinkFormat("files", Format) && Format == EFrameSinkFormat::Files);
+    assert(!ParseFrameSinkFormat("avi", Format));
+
+    // MJPEG is a concatenation of the (already encoded) images
+    {
+        FrameStreamSink Sink(".", EFrameSinkFormat::MJPEG);
+        FramePixelBuffer Frame = MakeBuffer(2, 2, 0);
+        Frame.Stream = "mjpeg_test";
+        assert(!Sink.Append(Frame)); // needs an encoder
+        Frame.FrameIdx = 1;
+        assert(Sink.Append(Frame, {'b', 'b'}));
+        Frame.FrameIdx = 0;
+        assert(Sink.Append(Frame, {'a', 'a', 'a'}));
+    }
+    assert(ReadFile("mjpeg_test.mjpeg") == "aaabb");
+    std::vector<std::string> Index = ReadLines(FrameStreamSink::GetIndexFilename(".", "mjpeg_test"));
+    assert(Index.size() == 3 && Index[2] == "1,0,0.000000,mjpeg_test.mjpeg,3,2,2,2");
+    std::remove("mjpeg_test.mjpeg");
+    std::remove(FrameStreamSink::GetIndexFilename(".", "mjpeg_test").c_str());
+
+    // Files keeps one image per frame, but still indexes them
+    {
+        FrameStreamSink Sink(".", EFrameSinkFormat::Files);
+        FramePixelBuffer Frame = MakeBuffer(2, 2, 0);
+        Frame.Stream = "files_test";
+        Frame.Filename = "./files_test_00000.png";
+        assert(Sink.Append(Frame, {'p', 'n', 'g'}));
+    }
+    assert(ReadFile("files_test_00000.png") == "png");
+    Index = ReadLines(FrameStreamSink::GetIndexFilename(".", "files_test"));
+    assert(Index.size() == 2 && Index[1] == "0,0,0.000000,files_test_00000.png,0,3,2,2");
+    std::remove("files_test_00000.png");
+    std::remove(FrameStreamSink::GetIndexFilename(".", "files_test").c_str());
+}
+
+int main()
+{
+    return RunTests("frame writer", {
+        TestBoundedInFlight,
+        TestReservations,
+        TestWritePPM,
+        TestY4MStreams,
+        TestRawAndDroppedFrames,
+        TestHeldOutOfOrder,
+        TestEncodedPayloads
+    });
+}
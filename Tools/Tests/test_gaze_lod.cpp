@@ -0,0 +1,125 @@
+// angular bucketing of the GazeLOD: bucket edges, bounds, hysteresis, released actors and the update rate
+
+#include "DReyeVR/GazeLOD.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <cmath>
+#include <iostream>
+
+static GazeLODParams TestParams()
+{
+    GazeLODParams P;
+    P.MaxDistance = 100.f;
+    P.HysteresisDeg = 2.f;
+    return P;
+}
+
+// an actor Dist m away at Deg degrees to the left of the +X axis
+static GazeLODActor At(uint32_t Id, float Deg, float Dist = 50.f, float Radius = 0.f)
+{
+    const float Rad = Deg / 57.2957795f;
+    return {Id, {Dist * std::cos(Rad), Dist * std::sin(Rad), 0.f}, Radius};
+}
+
+static const GazeVector Eye = {0.f, 0.f, 0.f};
+static const GazeVector Ahead = {1.f, 0.f, 0.f};
+
+static void TestAngles()
+{
+    assert(std::fabs(GazeLOD::AngleTo(Eye, Ahead, {10.f, 10.f, 0.f}, 0.f) - 45.f) < 1e-3f);
+    assert(GazeLOD::AngleTo(Eye, Ahead, {-10.f, 0.f, 0.f}, 0.f) > 179.f); // behind
+    assert(GazeLOD::AngleTo(Eye, Ahead, {1.f, 1.f, 0.f}, 2.f) == 0.f);    // the eye is inside
+    // the edge of a 5 m sphere 10 m away at 45 degrees is 15 degrees off the ray
+    assert(std::fabs(GazeLOD::AngleTo(Eye, Ahead, {7.0710678f, 7.0710678f, 0.f}, 5.f) - 15.f) < 1e-2f);
+}
+
+static void TestBuckets()
+{
+    GazeLOD L(TestParams());
+    const std::vector<GazeLODChange> &Changes =
+        L.Update(Eye, {2.f, 0.f, 0.f}, {At(1, 5.f), At(2, 20.f), At(3, 90.f), At(4, 170.f), At(5, 0.f, 150.f)});
+    assert(Changes.size() == 4); // not the one beyond MaxDistance
+    assert(L.GetBucket(1) == GazeBucket::Foveal && L.GetBucket(2) == GazeBucket::NearPeriphery);
+    assert(L.GetBucket(3) == GazeBucket::FarPeriphery && L.GetBucket(4) == GazeBucket::FarPeriphery);
+    assert(L.GetBucket(5) == GazeBucket::Released);
+    assert(L.NumInBucket(GazeBucket::FarPeriphery) == 2);
+    // a big actor reaches into the fovea although its center is in the periphery
+    L.Update(Eye, Ahead, {At(6, 20.f, 20.f, 5.f)});
+    assert(L.GetBucket(6) == GazeBucket::Foveal);
+    assert(L.GetMinLOD(GazeBucket::Foveal) == 0 && L.GetMinLOD(GazeBucket::FarPeriphery) == 2);
+    assert(L.GetCullScale(GazeBucket::Released) == 1.f);
+}
+
+static void TestChangesOnly()
+{
+    GazeLOD L(TestParams());
+    L.Update(Eye, Ahead, {At(1, 5.f), At(2, 20.f), At(3, 90.f)});
+    // nothing moved: nothing to touch
+    assert(L.Update(Eye, Ahead, {At(1, 5.f), At(2, 20.f), At(3, 90.f)}).empty());
+    // looking at actor 3: it comes in, actor 1 goes out, actor 2 leaves for good
+    const std::vector<GazeLODChange> Changes = L.Update(Eye, {0.f, 1.f, 0.f}, {At(1, 5.f), At(3, 90.f)});
+    assert(Changes.size() == 3);
+    for (const GazeLODChange &C : Changes)
+    {
+        if (C.Id == 1)
+            assert(C.Bucket == GazeBucket::FarPeriphery);
+        else if (C.Id == 2)
+            assert(C.Bucket == GazeBucket::Released);
+        else
+            assert(C.Id == 3 && C.Bucket == GazeBucket::Foveal);
+    }
+    assert(L.NumChanges() == 6 && L.NumUpdates() == 3);
+}
+
+static void TestHysteresis()
+{
+    GazeLOD L(TestParams());
+    L.Update(Eye, Ahead, {At(1, 9.f)});
+    assert(L.GetBucket(1) == GazeBucket::Foveal);
+    // just past the edge: still foveal
+    assert(L.Update(Eye, Ahead, {At(1, 11.f)}).empty());
+    // past the hysteresis: out
+    L.Update(Eye, Ahead, {At(1, 12.5f)});
+    assert(L.GetBucket(1) == GazeBucket::NearPeriphery);
+    // and right back in once within the edge
+    L.Update(Eye, Ahead, {At(1, 9.5f)});
+    assert(L.GetBucket(1) == GazeBucket::Foveal);
+    // an actor seen for the first time gets no hysteresis
+    L.Update(Eye, Ahead, {At(1, 9.5f), At(2, 11.f)});
+    assert(L.GetBucket(2) == GazeBucket::NearPeriphery);
+
+    // nor at the MaxDistance edge: only managed once within it...
+    assert(L.Update(Eye, Ahead, {At(1, 9.5f), At(2, 11.f), At(3, 20.f, 105.f)}).empty());
+    L.Update(Eye, Ahead, {At(1, 9.5f), At(2, 11.f), At(3, 20.f, 99.f)});
+    assert(L.GetBucket(3) == GazeBucket::NearPeriphery);
+    // ...but only released past it by HysteresisDistance
+    assert(L.Update(Eye, Ahead, {At(1, 9.5f), At(2, 11.f), At(3, 20.f, 109.f)}).empty());
+    const std::vector<GazeLODChange> Released = L.Update(Eye, Ahead, {At(1, 9.5f), At(2, 11.f), At(3, 20.f, 111.f)});
+    assert(Released.size() == 1 && Released[0].Id == 3 && Released[0].Bucket == GazeBucket::Released);
+}
+
+static void TestUpdateRateAndParams()
+{
+    GazeLOD L(TestParams()); // 10 Hz
+    assert(L.ShouldUpdate(0.f));
+    int Updates = 0;
+    for (int Frame = 0; Frame < 90; Frame++) // a second at 90 Hz
+        Updates += L.ShouldUpdate(1.f / 90.f) ? 1 : 0;
+    assert(Updates >= 9 && Updates <= 10);
+
+    L.Update(Eye, Ahead, {At(1, 5.f), At(2, 20.f)});
+    GazeLODParams P = TestParams();
+    P.FovealDeg = 40.f; // larger than the near periphery: clamped
+    L.SetParams(P);
+    assert(L.GetParams().NearPeripheryDeg == 40.f);
+    // every actor is reported again after a change of the params
+    assert(L.Update(Eye, Ahead, {At(1, 5.f), At(2, 20.f)}).size() == 2);
+    assert(L.GetBucket(2) == GazeBucket::Foveal);
+    std::cout << L.SummaryString() << std::endl;
+}
+
+int main()
+{
+    return RunTests("gaze LOD", {TestAngles, TestBuckets, TestChangesOnly, TestHysteresis, TestUpdateRateAndParams});
+}
@@ -0,0 +1,152 @@
+// gaze extrapolation of the GazePredictor: pursuit, saccades, blinks, and the replay of a gaze trace against latency
+
+#include "DReyeVR/GazePredictor.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+
+static GazeDirection Dir(float YawDeg, float PitchDeg = 0.f)
+{
+    const float Yaw = YawDeg / 57.2957795f, Pitch = PitchDeg / 57.2957795f;
+    return {std::cos(Pitch) * std::cos(Yaw), std::cos(Pitch) * std::sin(Yaw), std::sin(Pitch)};
+}
+
+static const double SampleMs = 1000.0 / 120.0; // SRanipal rate
+
+static void TestPursuit()
+{
+    GazePredictorParams P;
+    P.LatencyMs = 20.f;
+    GazePredictor G(P);
+    // 20 deg/s to the right and 5 deg/s up: 0.4 deg behind if the sample is held
+    for (int i = 0; i < 120; i++)
+    {
+        const double T = i * SampleMs;
+        G.Update({T, Dir(20.f * T / 1000.f, 5.f * T / 1000.f), true});
+    }
+    const double Now = 119 * SampleMs;
+    const GazeDirection Truth = Dir(20.f * (Now + 20.0) / 1000.f, 5.f * (Now + 20.0) / 1000.f);
+    const GazeDirection Held = Dir(20.f * Now / 1000.f, 5.f * Now / 1000.f);
+    assert(GazePredictor::AngleBetween(G.GetPredicted(), Truth) < 0.02f);
+    assert(GazePredictor::AngleBetween(Held, Truth) > 0.4f);
+    assert(G.NumPredicted() == 119 && G.NumSaccades() == 0 && !G.IsInSaccade());
+    // repeated samples change nothing
+    const GazeDirection Before = G.GetPredicted();
+    G.Update({Now, Dir(0.f), true});
+    assert(GazePredictor::AngleBetween(G.GetPredicted(), Before) == 0.f && G.NumPredicted() == 119);
+}
+
+static void TestSaccade()
+{
+    GazePredictorParams P;
+    P.LatencyMs = 20.f;
+    GazePredictor G(P);
+    double T = 0.0;
+    for (int i = 0; i < 30; i++, T += SampleMs)
+        G.Update({T, Dir(0.f), true});
+    // 12 degrees in 3 samples (about 500 deg/s): the raw sample, no overshoot
+    for (int i = 1; i <= 3; i++, T += SampleMs)
+    {
+        const GazeDirection &Predicted = G.Update({T, Dir(4.f * i), true});
+        assert(G.IsInSaccade());
+        assert(GazePredictor::AngleBetween(Predicted, Dir(4.f * i)) < 1e-3f);
+    }
+    assert(G.NumSaccades() == 1);
+    // fixating again: the velocity starts from zero, nothing flies off past the landing point
+    for (int i = 0; i < 30; i++, T += SampleMs)
+    {
+        const GazeDirection &Predicted = G.Update({T, Dir(12.f), true});
+        assert(!G.IsInSaccade());
+        assert(GazePredictor::AngleBetween(Predicted, Dir(12.f)) < 1e-3f);
+    }
+    assert(G.NumSaccades() == 1);
+}
+
+static void TestBlinksAndGaps()
+{
+    GazePredictorParams P;
+    P.MaxExtrapolationDeg = 1.f;
+    GazePredictor G(P);
+    G.Update({0.0, Dir(0.f), true});
+    G.Update({10.0, Dir(1.f), true}); // 100 deg/s: pursuit
+    const GazeDirection Before = G.GetPredicted();
+    // a blink holds the prediction...
+    G.Update({20.0, {0.f, 0.f, 0.f}, false});
+    assert(GazePredictor::AngleBetween(G.GetPredicted(), Before) == 0.f);
+    // ...and the first sample afterwards is taken as is
+    G.Update({30.0, Dir(-20.f), true});
+    assert(GazePredictor::AngleBetween(G.GetPredicted(), Dir(-20.f)) < 1e-3f && G.NumSaccades() == 0);
+    // as after a gap
+    G.Update({500.0, Dir(30.f), true});
+    assert(GazePredictor::AngleBetween(G.GetPredicted(), Dir(30.f)) < 1e-3f);
+    // the extrapolation is bounded
+    for (int i = 1; i < 10; i++)
+        G.Update({500.0 + i * 10.0, Dir(30.f + i), true});
+    assert(GazePredictor::AngleBetween(G.GetPredicted(), Dir(39.f)) < 1.f + 0.5f);
+    std::cout << G.SummaryString() << std::endl;
+}
+
+// fixations with tracker noise, smooth pursuit of a swinging target, saccades between them and blinks
+static std::vector<GazeSample> SyntheticTrace()
+{
+    std::vector<GazeSample> Trace;
+    uint32_t Seed = 12345;
+    auto Noise = [&Seed]() { // about +-0.05 deg
+        Seed = Seed * 1664525u + 1013904223u;
+        return ((Seed >> 8) / 16777216.f - 0.5f) * 0.1f;
+    };
+    float Yaw = 0.f;
+    double T = 0.0;
+    for (int Cycle = 0; Cycle < 6; Cycle++)
+    {
+        for (int i = 0; i < 36; i++, T += SampleMs) // 300 ms fixation
+            Trace.push_back({T, Dir(Yaw + Noise(), Noise()), true});
+        const double PursuitStart = T;
+        const float PursuitFrom = Yaw;
+        for (int i = 0; i < 120; i++, T += SampleMs) // 1 s of pursuit
+        {
+            const float Seconds = static_cast<float>(T - PursuitStart) / 1000.f;
+            Yaw = PursuitFrom + 8.f * std::sin(2.f * 3.14159265f * 0.5f * Seconds); // 0.5 Hz
+            Trace.push_back({T, Dir(Yaw + Noise(), Noise()), true});
+        }
+        const float SaccadeFrom = Yaw;
+        const float SaccadeTo = (Cycle % 2 == 0) ? -10.f : 10.f;
+        for (int i = 1; i <= 5; i++, T += SampleMs) // 40 ms saccade
+        {
+            Yaw = SaccadeFrom + (SaccadeTo - SaccadeFrom) * i / 5.f;
+            Trace.push_back({T, Dir(Yaw), true});
+        }
+        if (Cycle % 3 == 2)
+            for (int i = 0; i < 12; i++, T += SampleMs) // 100 ms blink
+                Trace.push_back({T, {0.f, 0.f, 0.f}, false});
+    }
+    return Trace;
+}
+
+static void TestReplayAgainstLatency()
+{
+    const std::vector<GazeSample> Trace = SyntheticTrace();
+    double PrevHold = 0.0;
+    std::printf("latency  samples  hold mean/p95 (deg)  predicted mean/p95 (deg)\n");
+    for (float LatencyMs : {10.f, 20.f, 30.f, 50.f})
+    {
+        const GazePredictionError E = EvaluateGazePrediction(Trace, GazePredictorParams(), LatencyMs);
+        std::printf("%5.0f ms  %7zu  %8.3f / %6.3f    %8.3f / %6.3f\n", E.LatencyMs, E.Samples, E.HoldMeanDeg,
+                    E.HoldP95Deg, E.PredictedMeanDeg, E.PredictedP95Deg);
+        assert(E.Samples > Trace.size() / 2);
+        assert(E.HoldMeanDeg > PrevHold); // the older the sample, the further off
+        assert(E.PredictedMeanDeg < E.HoldMeanDeg);
+        PrevHold = E.HoldMeanDeg;
+    }
+    // no latency: nothing to win, the filter only smooths the noise
+    const GazePredictionError None = EvaluateGazePrediction(Trace, GazePredictorParams(), 0.f);
+    assert(None.HoldMeanDeg == 0.0 && None.PredictedMeanDeg < 0.1);
+}
+
+int main()
+{
+    return RunTests("gaze predictor", {TestPursuit, TestSaccade, TestBlinksAndGaps, TestReplayAgainstLatency});
+}
@@ -0,0 +1,202 @@
+// haptic shared-control torque (HapticSharedControl): geometry of the preview, sign of the error and the torque
+
+#include "DReyeVR/ConfigFile.h"
+#include "DReyeVR/HapticSharedControl.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+static constexpr double Pi = 3.14159265358979323846;
+
+// straight reference along +X at Y = 0, one point every 0.5m
+static HapticSharedControl StraightPath(const HapticControlParams &P = HapticControlParams())
+{
+    HapticSharedControl H(P);
+    std::vector<double> Xs, Ys;
+    for (int i = -20; i <= 60; i++)
+    {
+        Xs.push_back(0.5 * i);
+        Ys.push_back(0.0);
+    }
+    H.SetTrajectory(Xs, Ys);
+    assert(H.NumTrajectoryPoints() == 81);
+    return H;
+}
+
+static void TestStraightOffset()
+{
+    const HapticSharedControl H = StraightPath();
+    HapticControlInput In;
+    In.X = 0.0;
+    In.Y = 1.0; // 1m to the right of the path, driving along it
+    In.Speed = 5.0;
+    const HapticControlOutput Out = H.Compute(In);
+    assert(Near(Out.Error, 1.0));
+    assert(Out.ClosestIdx == 20);
+    // no steering: the preview runs straight ahead
+    assert(Near(Out.PredictedX, 4.8) && Near(Out.PredictedY, 1.0) && Near(Out.PredictedYawDeg, 0.0));
+    const double Dist = std::sqrt(0.2 * 0.2 + 1.0);
+    assert(Near(Out.PredictedError, -Dist)); // steer left (negative) to get back
+    assert(Near(Out.DesiredSteeringWheelDeg, 0.5 * -Dist * 180.0 / Pi));
+    // tau = -(Cs * e) * (theta - theta_d)
+    assert(Near(Out.Torque, -0.5 * 1.0 * (0.0 - (-0.5 * Dist))));
+    assert(Near(Out.Coefficient, 1.0 / (1.0 + std::exp(-0.5))));
+
+    // the mirrored case flips the sign, reversing flips it again
+    In.Y = -1.0;
+    assert(Near(H.Compute(In).PredictedError, Dist));
+    In.Speed = -5.0;
+    const HapticControlOutput Back = H.Compute(In);
+    assert(Near(Back.PredictedX, -4.8) && Near(Back.PredictedError, -Dist));
+}
+
+static void TestOnPathNoTorque()
+{
+    const HapticSharedControl H = StraightPath();
+    HapticControlInput In;
+    In.Speed = 5.0;
+    In.SteeringWheelDeg = 30.0; // steering while exactly on the path: e(t) = 0 means no torque
+    const HapticControlOutput Out = H.Compute(In);
+    assert(Near(Out.Error, 0.0) && Near(Out.Torque, 0.0) && Near(Out.Coefficient, 0.5));
+
+    // standing still: the preview does not move and there is no side to the error
+    In.Y = 1.0;
+    In.Speed = 0.0;
+    In.SteeringWheelDeg = 0.0;
+    const HapticControlOutput Still = H.Compute(In);
+    assert(Near(Still.PredictedX, 0.0) && Near(Still.PredictedError, 0.0) && Near(Still.Torque, 0.0));
+}
+
+static void TestTurningCircle()
+{
+    const HapticSharedControl H;
+    double R, Steer, CoRX, CoRY;
+    H.TurningCircle(20.0, 15.0, R, Steer, CoRX, CoRY);
+    const double CoM = 3.0 * 0.45;
+    assert(Near(R, std::sqrt(CoM * CoM + 9.0 / std::pow(std::tan(20.0 * Pi / 180.0), 2))));
+    assert(Near(Steer, std::atan(0.45 * std::tan(20.0 * Pi / 180.0)) * 180.0 / Pi));
+    assert(Near(CoRX, -CoM) && CoRY > 0 && Near(std::hypot(CoRX, CoRY), R));
+
+    H.TurningCircle(0.0, 0.0, R, Steer, CoRX, CoRY);
+    assert(std::isinf(CoRY));
+}
+
+static void TestPreviewOnCircle()
+{
+    const HapticSharedControl H = StraightPath();
+    for (double Yaw : {0.0, 35.0, -120.0})
+    {
+        for (double Wheel : {-25.0, 12.0})
+        {
+            HapticControlInput In;
+            In.X = 3.0;
+            In.Y = -2.0;
+            In.YawDeg = Yaw;
+            In.SteerFLDeg = In.SteerFRDeg = Wheel;
+            In.Speed = 8.0;
+            const HapticControlOutput Out = H.Compute(In);
+
+            // center of rotation in the world (CARLA frame: Y to the right of X)
+            double R, Steer, CoRX, CoRY;
+            H.TurningCircle(Wheel, Wheel, R, Steer, CoRX, CoRY);
+            const double C = std::cos(Yaw * Pi / 180.0), S = std::sin(Yaw * Pi / 180.0);
+            const double WX = In.X + C * CoRX - S * CoRY, WY = In.Y + S * CoRX + C * CoRY;
+            // the vehicle and its preview are on the same circle, PreviewDistance apart along it
+            assert(Near(std::hypot(In.X - WX, In.Y - WY), R));
+            assert(Near(std::hypot(Out.PredictedX - WX, Out.PredictedY - WY), R));
+            const double Turn = (Wheel > 0 ? 1 : -1) * 4.8 / R * 180.0 / Pi;
+            assert(Near(Out.PredictedYawDeg, Yaw + Turn));
+            // the preview is ahead of the vehicle (less than the arc length on the tighter circles)
+            const double Ahead = (Out.PredictedX - In.X) * C + (Out.PredictedY - In.Y) * S;
+            assert(Ahead > 3.0 && Ahead < 4.8 + 1e-9);
+        }
+    }
+}
+
+static void TestNearlyStraightIsContinuous()
+{
+    const HapticSharedControl H = StraightPath();
+    HapticControlInput In;
+    In.Y = 1.0;
+    In.YawDeg = 10.0;
+    In.Speed = 5.0;
+    const HapticControlOutput Straight = H.Compute(In);
+    In.SteerFLDeg = In.SteerFRDeg = 0.001;
+    const HapticControlOutput Slight = H.Compute(In);
+    assert(std::isfinite(Slight.PredictedX) && std::isfinite(Slight.PredictedY));
+    assert(Near(Straight.PredictedX, Slight.PredictedX, 1e-3) && Near(Straight.PredictedY, Slight.PredictedY, 1e-3));
+    assert(Near(Straight.Torque, Slight.Torque, 1e-3));
+}
+
+static void TestFirstOrderModel()
+{
+    HapticControlParams P;
+    P.bFirstOrderModel = true;
+    P.T = 1.0;
+    const HapticSharedControl H = StraightPath(P);
+    HapticControlInput In;
+    In.Y = 1.0;
+    In.Speed = 5.0;
+    const HapticControlOutput Out = H.Compute(In);
+    // one second of the lag towards Kc * eps (starting from theta = 0) at 60Hz: (1 - (1 - dt/T)^60)
+    const double Target = 0.5 * Out.PredictedError * 180.0 / Pi;
+    assert(Near(Out.DesiredSteeringWheelDeg, Target * (1.0 - std::pow(1.0 - 1.0 / 60.0, 60))));
+}
+
+static void TestLoadTrajectory()
+{
+    const char *Path = "haptic_test_path.txt";
+    {
+        std::ofstream F(Path);
+        F << "# reference\n1.5, -2\n\n3 4.25 # trailing\nnot a point\n-1,0\n";
+    }
+    std::vector<double> Xs, Ys;
+    assert(HapticSharedControl::LoadTrajectory(Path, Xs, Ys));
+    assert(Xs.size() == 3 && Ys.size() == 3);
+    assert(Xs[0] == 1.5 && Ys[0] == -2 && Xs[1] == 3 && Ys[1] == 4.25 && Xs[2] == -1 && Ys[2] == 0);
+    std::remove(Path);
+    assert(!HapticSharedControl::LoadTrajectory("does_not_exist.txt", Xs, Ys));
+
+    // without a trajectory nothing pulls on the wheel
+    const HapticSharedControl Empty;
+    HapticControlInput In;
+    In.SteeringWheelDeg = 45.0;
+    In.Speed = 5.0;
+    const HapticControlOutput Out = Empty.Compute(In);
+    assert(Out.ClosestIdx == -1 && Out.Torque == 0.0 && Near(Out.DesiredSteeringWheelDeg, 45.0));
+}
+
+static void TestConfigParams()
+{
+    // read the way AEgoVehicle::ReadConfigVariables does, from the repo's own Config/DReyeVRConfig.ini
+    assert(GeneralParams.bIsValid());
+    HapticControlParams P;
+    P.Cs = P.Kc = P.T = P.PreviewDistance = P.Wheelbase = P.CenterOfMassRatio = -1.0;
+    P.bFirstOrderModel = true;
+    assert(GeneralParams.Get("HapticSharedControl", "Cs", P.Cs));
+    assert(GeneralParams.Get("HapticSharedControl", "Kc", P.Kc));
+    assert(GeneralParams.Get("HapticSharedControl", "T", P.T));
+    assert(GeneralParams.Get("HapticSharedControl", "FirstOrderModel", P.bFirstOrderModel));
+    assert(GeneralParams.Get("HapticSharedControl", "PreviewDistance", P.PreviewDistance));
+    assert(GeneralParams.Get("HapticSharedControl", "Wheelbase", P.Wheelbase));
+    assert(GeneralParams.Get("HapticSharedControl", "CenterOfMassRatio", P.CenterOfMassRatio));
+    assert(P.Cs == 0.5 && P.Kc == 0.5 && P.T == 1.0 && !P.bFirstOrderModel);
+    assert(P.PreviewDistance == 4.8 && P.Wheelbase == 3.0 && P.CenterOfMassRatio == 0.45);
+}
+
+int main()
+{
+    return RunTests("haptic shared control", {
+        TestStraightOffset,
+        TestOnPathNoTorque,
+        TestTurningCircle,
+        TestPreviewOnCircle,
+        TestNearlyStraightIsContinuous,
+        TestFirstOrderModel,
+        TestLoadTrajectory,
+        TestConfigParams
+    });
+}
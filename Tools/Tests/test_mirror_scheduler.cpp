@@ -0,0 +1,87 @@
+// decisions of the MirrorScheduler: which mirror keeps full resolution, the hold after a glance, and the counters
+
+#include "DReyeVR/MirrorScheduler.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <cmath>
+
+static MirrorSchedulerParams TestParams()
+{
+    MirrorSchedulerParams P;
+    P.AttendAngleDeg = 20.f;
+    return P;
+}
+
+static void TestAttendedMirror()
+{
+    MirrorScheduler S(TestParams());
+    const int Rear = S.AddMirror("Rear");
+    const int Left = S.AddMirror("Left");
+    const int Right = S.AddMirror("Right");
+    assert(S.NumMirrors() == 3);
+    // nothing rendered yet: everything at full resolution
+    assert(S.GetScale(Rear) == 1.f && S.GetScale(Left) == 1.f && S.GetScale(Right) == 1.f);
+
+    // looking at the left mirror (the others never looked at)
+    assert(S.Update(0.1f, {60.f, 5.f, 90.f}));
+    assert(S.IsAttended(Left) && !S.IsAttended(Rear) && !S.IsAttended(Right));
+    assert(Near(S.GetScale(Rear), 0.5) && Near(S.GetScale(Right), 0.5));
+    assert(!S.Update(0.1f, {60.f, 5.f, 90.f})); // no change
+    assert(S.SavedRenders() == 4 && S.TotalRenders() == 6);
+
+    // an unknown index is left alone
+    assert(S.GetScale(-1) == 1.f && S.GetScale(7) == 1.f);
+}
+
+static void TestHold()
+{
+    MirrorScheduler S(TestParams());
+    const int Rear = S.AddMirror("Rear");
+    S.Update(0.1f, {0.f});
+    assert(S.IsAttended(Rear));
+    // a glance away shorter than HoldSeconds keeps full resolution
+    for (int i = 0; i < 4; i++)
+        assert(!S.Update(0.1f, {45.f}) && S.IsAttended(Rear));
+    assert(S.Update(0.2f, {45.f}) && !S.IsAttended(Rear));
+    // looking back restores it immediately
+    assert(S.Update(0.1f, {-10.f}) && S.IsAttended(Rear));
+}
+
+static void TestSavedPerMinute()
+{
+    MirrorScheduler S(TestParams());
+    S.AddMirror("Rear");
+    S.AddMirror("Left");
+    // 10 s at 10 Hz looking at neither: 2 saved renders per frame
+    for (int i = 0; i < 100; i++)
+        S.Update(0.1f, {90.f, 90.f});
+    assert(S.SavedRenders() == 200);
+    assert(std::fabs(S.SavedRendersPerMinute() - 1200.f) < 30.f);
+    // only the last minute counts
+    for (int i = 0; i < 700; i++)
+        S.Update(0.1f, {0.f, 0.f});
+    assert(S.SavedRenders() == 200 && S.SavedRendersPerMinute() == 0.f);
+    assert(!S.SummaryString().empty());
+}
+
+static void TestHiddenMirror()
+{
+    MirrorScheduler S(TestParams());
+    const int Rear = S.AddMirror("Rear");
+    const int Left = S.AddMirror("Left");
+    // the left reflection is hidden: still scheduled, but neither rendered nor saved
+    S.SetRendered(Left, false);
+    for (int i = 0; i < 10; i++)
+        S.Update(0.1f, {90.f, 90.f});
+    assert(S.TotalRenders() == 10 && S.SavedRenders() == 10);
+    assert(S.GetScale(Rear) == 0.5f && S.GetScale(Left) == 0.5f);
+    S.SetRendered(Left, true);
+    S.Update(0.1f, {90.f, 0.f});
+    assert(S.TotalRenders() == 12 && S.SavedRenders() == 11 && S.IsAttended(Left));
+}
+
+int main()
+{
+    return RunTests("mirror scheduler", {TestAttendedMirror, TestHold, TestSavedPerMinute, TestHiddenMirror});
+}
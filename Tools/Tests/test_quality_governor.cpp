@@ -0,0 +1,105 @@
+// decisions of the QualityGovernor: immediate downgrade, cooldown, slow upgrade (hysteresis), and the ladder ends
+
+#include "DReyeVR/QualityGovernor.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+
+static QualityGovernorParams TestParams()
+{
+    QualityGovernorParams P;
+    P.TargetMs = 10.f;
+    P.WindowFrames = 10;
+    P.UpgradeWindows = 3;
+    P.CooldownWindows = 1;
+    return P;
+}
+
+// feeds one window of frames, returns whether the level changed on its last frame
+static bool FeedWindow(QualityGovernor &G, float Ms, float GPUMs = 0.f)
+{
+    bool bChanged = false;
+    for (int i = 0; i < 10; i++)
+    {
+        const bool bChangedNow = G.Update(Ms, GPUMs);
+        assert(!bChangedNow || i == 9); // only decided at the end of a window
+        bChanged |= bChangedNow;
+    }
+    return bChanged;
+}
+
+static void TestDowngradeAndCooldown()
+{
+    QualityGovernor G(TestParams());
+    assert(G.GetLevel() == 0 && G.GetSettings().Name == "Full");
+    assert(FeedWindow(G, 12.f) && G.GetLevel() == 1); // one bad window is enough
+    assert(G.GetLastWindowMs() == 12.f);
+    assert(!FeedWindow(G, 12.f) && G.GetLevel() == 1); // cooldown
+    assert(FeedWindow(G, 12.f) && G.GetLevel() == 2);
+
+    // the slower of game thread and GPU counts
+    QualityGovernor H(TestParams());
+    assert(FeedWindow(H, 5.f, 15.f) && H.GetLevel() == 1);
+}
+
+static void TestPercentileIgnoresSpikes()
+{
+    QualityGovernor G(TestParams());
+    // a single hitch per window stays above the 90th percentile
+    for (int w = 0; w < 5; w++)
+        for (int i = 0; i < 10; i++)
+            assert(!G.Update(i == 0 ? 50.f : 9.f, 0.f));
+    assert(G.GetLevel() == 0);
+}
+
+static void TestHysteresis()
+{
+    QualityGovernor G(TestParams());
+    FeedWindow(G, 12.f);
+    assert(G.GetLevel() == 1);
+    FeedWindow(G, 5.f); // cooldown
+    // under the target but not under 75% of it: stays
+    for (int w = 0; w < 10; w++)
+        assert(!FeedWindow(G, 9.f));
+    // needs UpgradeWindows good windows in a row
+    assert(!FeedWindow(G, 5.f) && !FeedWindow(G, 5.f));
+    assert(!FeedWindow(G, 9.f)); // streak broken
+    assert(!FeedWindow(G, 5.f) && !FeedWindow(G, 5.f));
+    assert(FeedWindow(G, 5.f) && G.GetLevel() == 0);
+}
+
+static void TestLadderEnds()
+{
+    QualityGovernor G(TestParams());
+    const int Last = G.NumLevels() - 1;
+    for (int w = 0; w < 4 * G.NumLevels(); w++)
+        FeedWindow(G, 100.f);
+    assert(G.GetLevel() == Last && !FeedWindow(G, 100.f));
+    const QualityLevel &Min = G.GetSettings();
+    assert(!Min.bSideMirrorReflections && !Min.bRearMirrorReflection && !Min.bNonEgoSounds);
+    assert(Min.DrawDistance > 0.f && Min.CameraScreenPercentageScale < 1.f);
+
+    G.Reset();
+    assert(G.GetLevel() == 0);
+    for (int w = 0; w < 10; w++)
+        assert(!FeedWindow(G, 1.f)); // already at full quality
+
+    // a custom ladder
+    QualityLevel A, B;
+    A.Name = "A";
+    B.Name = "B";
+    QualityGovernor C(TestParams(), {A, B});
+    assert(C.NumLevels() == 2);
+    FeedWindow(C, 100.f);
+    assert(C.GetSettings().Name == "B");
+}
+
+int main()
+{
+    return RunTests("quality governor", {
+        TestDowngradeAndCooldown,
+        TestPercentileIgnoresSpikes,
+        TestHysteresis,
+        TestLadderEnds
+    });
+}
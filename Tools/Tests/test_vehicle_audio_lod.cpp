@@ -0,0 +1,117 @@
+// decisions of the VehicleAudioLOD: which vehicles get a pooled engine sound, slot stability, and the update rate
+
+#include "DReyeVR/VehicleAudioLOD.h"
+#include "TestHelpers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+static VehicleAudioLODParams TestParams()
+{
+    VehicleAudioLODParams P;
+    P.MaxVoices = 3;
+    P.MaxDistance = 100.f;
+    P.UpdateRateHz = 10.f;
+    return P;
+}
+
+static bool Plays(const VehicleAudioLOD &L, uint32_t Id)
+{
+    const std::vector<uint32_t> &V = L.GetVoices();
+    return std::find(V.begin(), V.end(), Id) != V.end();
+}
+
+static void TestClosestAndLoudest()
+{
+    VehicleAudioLOD L(TestParams());
+    assert(L.GetVoices().size() == 3 && L.NumActiveVoices() == 0);
+    // equally loud: the closest three, nothing beyond MaxDistance
+    L.Update({{1, 50.f, 1.f}, {2, 5.f, 1.f}, {3, 20.f, 1.f}, {4, 10.f, 1.f}, {5, 200.f, 1.f}});
+    assert(Plays(L, 2) && Plays(L, 3) && Plays(L, 4) && !Plays(L, 1) && !Plays(L, 5));
+    assert(L.NumVoiceStarts() == 3);
+
+    // a loud vehicle further away beats a quiet close one
+    VehicleAudioLOD Loud(TestParams());
+    Loud.Update({{1, 10.f, 0.2f}, {2, 30.f, 1.f}, {3, 12.f, 1.f}, {4, 15.f, 1.f}});
+    assert(Plays(Loud, 2) && Plays(Loud, 3) && Plays(Loud, 4) && !Plays(Loud, 1));
+
+    // fewer vehicles than voices, and all of them leaving
+    VehicleAudioLOD Few(TestParams());
+    Few.Update({{7, 10.f, 1.f}});
+    assert(Few.NumActiveVoices() == 1 && Plays(Few, 7));
+    Few.Update({});
+    assert(Few.NumActiveVoices() == 0);
+}
+
+static void TestStableSlots()
+{
+    VehicleAudioLOD L(TestParams());
+    const std::vector<uint32_t> First = L.Update({{1, 10.f, 1.f}, {2, 20.f, 1.f}, {3, 30.f, 1.f}});
+    // vehicle 4 is only slightly closer than vehicle 3: within the hysteresis, nothing changes
+    const std::vector<uint32_t> Second = L.Update({{1, 10.f, 1.f}, {2, 20.f, 1.f}, {3, 30.f, 1.f}, {4, 28.f, 1.f}});
+    assert(First == Second && L.NumVoiceStarts() == 3);
+    // much closer: it takes over vehicle 3's slot, the others keep theirs (no restart)
+    const std::vector<uint32_t> Third = L.Update({{1, 10.f, 1.f}, {2, 20.f, 1.f}, {3, 30.f, 1.f}, {4, 5.f, 1.f}});
+    for (size_t i = 0; i < Third.size(); i++)
+        assert(First[i] == 3 ? Third[i] == 4 : Third[i] == First[i]);
+    assert(L.NumVoiceStarts() == 4);
+    assert(L.NumUpdates() == 3 && L.MeanSources() > 3.0);
+}
+
+static void TestDestroyedOwner()
+{
+    VehicleAudioLOD L(TestParams());
+    const std::vector<uint32_t> First = L.Update({{1, 10.f, 1.f}, {2, 20.f, 1.f}, {3, 30.f, 1.f}});
+    for (size_t i = 0; i < First.size(); i++)
+        assert(L.SlotChanged(i));
+    // vehicle 2 is destroyed: only its slot changes (freed), so its voice gets stopped
+    const std::vector<uint32_t> Second = L.Update({{1, 10.f, 1.f}, {3, 30.f, 1.f}});
+    for (size_t i = 0; i < Second.size(); i++)
+    {
+        assert(L.SlotChanged(i) == (First[i] == 2));
+        assert(First[i] == 2 ? Second[i] == 0 : Second[i] == First[i]);
+    }
+    // and nothing changes afterwards
+    L.Update({{1, 10.f, 1.f}, {3, 30.f, 1.f}});
+    for (size_t i = 0; i < Second.size(); i++)
+        assert(!L.SlotChanged(i));
+    assert(!L.SlotChanged(Second.size()));
+}
+
+static void TestUpdateRate()
+{
+    VehicleAudioLOD L(TestParams()); // 10 Hz
+    assert(L.ShouldUpdate(0.f)); // right away
+    int Updates = 0;
+    for (int Frame = 0; Frame < 90; Frame++) // a second at 90 Hz
+        Updates += L.ShouldUpdate(1.f / 90.f) ? 1 : 0;
+    assert(Updates >= 9 && Updates <= 10);
+}
+
+static void TestResize()
+{
+    VehicleAudioLOD L(TestParams());
+    L.Update({{1, 10.f, 1.f}, {2, 20.f, 1.f}, {3, 30.f, 1.f}});
+    VehicleAudioLODParams P = TestParams();
+    P.MaxVoices = 1;
+    L.SetParams(P);
+    L.Update({{1, 10.f, 1.f}, {2, 20.f, 1.f}, {3, 30.f, 1.f}});
+    assert(L.GetVoices().size() == 1 && Plays(L, 1));
+    P.MaxVoices = 0;
+    L.SetParams(P);
+    L.Update({{1, 10.f, 1.f}});
+    assert(L.NumActiveVoices() == 0);
+    std::cout << L.SummaryString() << std::endl;
+}
+
+int main()
+{
+    return RunTests("vehicle audio LOD", {
+        TestClosestAndLoudest,
+        TestStableSlots,
+        TestDestroyedOwner,
+        TestUpdateRate,
+        TestResize
+    });
+}
@@ -0,0 +1,162 @@
+// wheel-device thread (WheelDeviceThread) with the simulated wheel: loop rate, overruns, the lock-free exchange of
+// the wheel state and force commands, and unplugging the wheel
+
+#include "DReyeVR/WheelDeviceThread.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+static void SleepMs(int Ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(Ms));
+}
+
+static void TestLatestValue()
+{
+    struct Pair
+    {
+        uint64_t A = 0, B = 0;
+    };
+    LatestValue<Pair> Slot;
+    Pair Out;
+    assert(!Slot.Consume(Out));
+
+    constexpr uint64_t N = 200000;
+    std::thread Producer([&Slot]() {
+        for (uint64_t i = 1; i <= N; i++)
+            Slot.Publish(Pair{i, i});
+    });
+    uint64_t Last = 0, Consumed = 0;
+    while (Last < N)
+    {
+        if (!Slot.Consume(Out))
+            continue;
+        assert(Out.A == Out.B); // never torn
+        assert(Out.A > Last);   // only newer values
+        Last = Out.A;
+        Consumed++;
+    }
+    Producer.join();
+    assert(Consumed >= 1 && Consumed <= N);
+    assert(!Slot.Consume(Out)); // nothing new after the last one
+}
+
+static void TestLoopRate()
+{
+    SimulatedWheelDevice Wheel;
+    WheelThreadParams P;
+    P.RateHz = 1000.0;
+    WheelDeviceThread Thread(Wheel, P);
+    WheelState State;
+    assert(!Thread.GetLatest(State));
+    Thread.Start();
+    assert(Thread.IsRunning());
+    SleepMs(300);
+    Thread.Stop();
+    assert(!Thread.IsRunning());
+
+    const WheelThreadStats Stats = Thread.GetStats();
+    std::cout << Thread.SummaryString() << std::endl;
+    // loose bounds, this runs on shared machines
+    assert(Stats.Iterations > 150 && Stats.Iterations < 330);
+    assert(Stats.MeanPeriodMs > 0.9 && Stats.MeanPeriodMs < 2.0);
+    assert(Wheel.NumReads() == Stats.Iterations);
+    assert(Thread.GetLatest(State) && State.Sequence == Stats.Iterations);
+}
+
+static void TestInputsAndForces()
+{
+    SimulatedWheelDevice Wheel;
+    WheelDeviceThread Thread(Wheel);
+    Thread.Start();
+    Wheel.SetPedals(0.75f, 0.f);
+    Wheel.SetButton(5, true);
+    Wheel.SetButton(70, true);
+    SleepMs(20);
+    WheelState State;
+    assert(Thread.GetLatest(State));
+    assert(State.Throttle == 0.75f && State.Button(5) && State.Button(70) && !State.Button(4));
+    const uint64_t Seq = State.Sequence;
+    SleepMs(20);
+    assert(Thread.GetLatest(State) && State.Sequence > Seq && State.TimestampS > 0.0);
+
+    // the spring pulls the rim to its center, repeating the same command does not reach the device again
+    WheelForce Spring;
+    Spring.bSpring = true;
+    Spring.OffsetPercentage = 50;
+    Spring.SaturationPercentage = 30;
+    Spring.CoefficientPercentage = 100;
+    for (int i = 0; i < 10; i++)
+    {
+        Thread.SetForce(Spring);
+        SleepMs(30);
+    }
+    assert(Wheel.GetForce() == Spring);
+    assert(Thread.GetStats().ForcesApplied == 1 && Wheel.NumForces() == 1);
+    assert(Wheel.GetSteering() > 0.45f && Wheel.GetSteering() <= 0.5f);
+
+    Spring.OffsetPercentage = -20;
+    Thread.SetForce(Spring);
+    SleepMs(20);
+    assert(Thread.GetStats().ForcesApplied == 2 && Wheel.GetForce().OffsetPercentage == -20);
+
+    // stopping the thread releases the wheel
+    Thread.Stop();
+    assert(!Wheel.GetForce().bSpring);
+}
+
+static void TestOverruns()
+{
+    SimulatedWheelDevice Wheel;
+    Wheel.SetReadCostUs(3000); // much slower than the 1ms period
+    WheelThreadParams P;
+    P.RateHz = 1000.0;
+    WheelDeviceThread Thread(Wheel, P);
+    Thread.Start();
+    SleepMs(100);
+    Thread.Stop();
+    const WheelThreadStats Stats = Thread.GetStats();
+    assert(Stats.Iterations > 5 && Stats.Iterations < 40);
+    assert(Stats.Overruns + 1 >= Stats.Iterations);
+    assert(Stats.MeanPeriodMs >= 2.9 && Stats.MaxPeriodMs >= Stats.MeanPeriodMs);
+}
+
+static void TestDisconnect()
+{
+    SimulatedWheelDevice Wheel;
+    WheelThreadParams P;
+    P.RateHz = 1000.0;
+    WheelDeviceThread Thread(Wheel, P);
+    Thread.Start();
+    SleepMs(20);
+    assert(Thread.IsDeviceConnected());
+    Wheel.SetConnected(false);
+    SleepMs(20);
+    assert(!Thread.IsDeviceConnected());
+    // the thread stopped polling the unplugged device
+    const uint64_t Reads = Wheel.NumReads();
+    SleepMs(20);
+    assert(Wheel.NumReads() == Reads);
+    Thread.Stop();
+
+    // and polls again once restarted
+    Wheel.SetConnected(true);
+    Thread.Start();
+    SleepMs(20);
+    assert(Thread.IsDeviceConnected() && Wheel.NumReads() > Reads);
+    Thread.Stop();
+}
+
+int main()
+{
+    return RunTests("wheel device thread", {
+        TestLatestValue,
+        TestLoopRate,
+        TestInputsAndForces,
+        TestOverruns,
+        TestDisconnect
+    });
+}
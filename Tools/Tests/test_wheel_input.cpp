@@ -0,0 +1,223 @@
+// device-independent wheel input path: takeover/button mapping (WheelInputFilter), wheel logs (record and
+// deterministic replay with FileWheelDevice), input-to-actuation latency through the wheel-device thread, and the
+// evdev code mapping
+
+#include "DReyeVR/EvdevWheelDevice.h"
+#include "DReyeVR/FileWheelDevice.h"
+#include "DReyeVR/WheelDeviceThread.h"
+#include "DReyeVR/WheelInputFilter.h"
+#include "TestHelpers.h"
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+
+static WheelState Inputs(float Steering, float Throttle, float Brake)
+{
+    WheelState S;
+    S.Steering = Steering;
+    S.Throttle = Throttle;
+    S.Brake = Brake;
+    return S;
+}
+
+static void TestTakeover()
+{
+    WheelInputFilter Filter(0.02f);
+    // the Logitech plugin reports 0.5 for untouched pedals: ignored until something moves
+    assert(!Filter.Update(Inputs(0.f, 0.5f, 0.5f), false).bDriverInputs);
+    assert(!Filter.Update(Inputs(0.01f, 0.5f, 0.5f), false).bDriverInputs && Filter.IsPedalsDefaulting());
+    assert(!Filter.Update(Inputs(0.f, 0.8f, 0.5f), false).bDriverInputs && !Filter.IsPedalsDefaulting());
+
+    // without the autopilot every update drives
+    WheelActions A = Filter.Update(Inputs(0.2f, 0.8f, 0.f), false);
+    assert(A.bDriverInputs && A.Steering == 0.2f && A.Throttle == 0.8f && A.Brake == 0.f);
+
+    // with the autopilot only a change larger than the threshold takes over
+    assert(!Filter.Update(Inputs(0.21f, 0.8f, 0.f), true).bDriverInputs);
+    assert(!Filter.Update(Inputs(0.22f, 0.81f, 0.f), true).bDriverInputs);
+    assert(Filter.Update(Inputs(0.3f, 0.81f, 0.f), true).bDriverInputs);
+    assert(Filter.Update(Inputs(0.3f, 0.81f, 0.1f), true).bDriverInputs); // brake
+
+    Filter.Reset();
+    assert(Filter.IsPedalsDefaulting());
+}
+
+static void TestButtons()
+{
+    WheelInputFilter Filter;
+    WheelState S = Inputs(0.5f, 0.f, 0.f);
+    S.SetButton(2, true);  // B
+    S.SetButton(5, true);  // left turn signal
+    S.SetButton(20, true); // -
+    S.POV = 9000;
+    const WheelActions A = Filter.Update(S, false);
+    assert(A.bABXY_B && !A.bABXY_A && A.Reverse());
+    assert(A.bTurnSignalL && !A.bTurnSignalR);
+    assert(A.bNegative && !A.bPositive);
+    assert(A.bDPad_Right && !A.bDPad_Up && !A.bDPad_Down && !A.bDPad_Left);
+    S.SetButton(2, false);
+    assert(!S.Button(2) && S.Button(5) && !S.Button(-1) && !S.Button(128));
+    assert(!Filter.Update(S, false).Reverse());
+}
+
+static void TestLogRoundTrip()
+{
+    const char *Path = "wheel_input_test.log";
+    SimulatedWheelDevice Sim;
+    {
+        RecordingWheelDevice Recorder(Sim, Path);
+        assert(Recorder.IsOpen() && Recorder.IsConnected());
+        Sim.SetSteering(-0.25f);
+        Sim.SetPedals(0.125f, 0.75f);
+        Sim.SetButton(70, true);
+        WheelState S;
+        Recorder.SetTime(2.5); // the game time, as the pawn sets it
+        assert(Recorder.Read(S));
+        Recorder.SetTime(3.0);
+        WheelForce F;
+        F.bSpring = true;
+        F.OffsetPercentage = -12;
+        F.SaturationPercentage = 30;
+        F.CoefficientPercentage = 80;
+        Recorder.ApplyForce(F);
+        assert(Sim.GetForce() == F); // passed through
+        Recorder.StopForces();
+    }
+    WheelLog Log;
+    assert(Log.Load(Path));
+    assert(Log.Inputs.size() == 1 && Log.Forces.size() == 2);
+    const WheelState &S = Log.Inputs[0].State;
+    assert(S.Steering == -0.25f && S.Throttle == 0.125f && S.Brake == 0.75f && S.Button(70) && !S.Button(69));
+    assert(S.POV == 0xFFFFFFFF);
+    assert(Log.Forces[0].Force.bSpring && Log.Forces[0].Force.OffsetPercentage == -12);
+    assert(Log.Forces[0].Force.CoefficientPercentage == 80 && !Log.Forces[1].Force.bSpring);
+    assert(Log.Forces[0].TimeS <= Log.Forces[1].TimeS);
+    assert(Log.Inputs[0].TimeS == 2.5 && Log.Forces[0].TimeS == 3.0 && Log.Forces[1].TimeS == 3.0);
+    std::remove(Path);
+    assert(!Log.Load("does_not_exist.log"));
+}
+
+static WheelLog ScriptedLog()
+{
+    // driver holds still for a second (autopilot driving), then steers and brakes
+    WheelLog Log;
+    Log.Inputs.push_back({10.0, Inputs(0.f, 0.f, 0.f)});
+    Log.Inputs.push_back({10.5, Inputs(0.01f, 0.f, 0.f)});
+    Log.Inputs.push_back({11.0, Inputs(0.2f, 0.f, 0.f)});
+    Log.Inputs.push_back({11.5, Inputs(0.2f, 0.f, 0.6f)});
+    return Log;
+}
+
+static void TestDeterministicReplay()
+{
+    FileWheelDevice File(ScriptedLog());
+    assert(File.IsConnected());
+    WheelState S;
+    File.SetTime(0.0); // relative to the first record
+    assert(File.Read(S) && S.Steering == 0.f);
+    File.SetTime(0.75);
+    assert(File.Read(S) && S.Steering == 0.01f);
+    File.SetTime(1.0);
+    assert(File.Read(S) && S.Steering == 0.2f && S.Brake == 0.f);
+    File.SetTime(0.2); // seeking back
+    assert(File.Read(S) && S.Steering == 0.f);
+    assert(!File.Finished());
+    File.SetTime(9.0);
+    assert(File.Read(S) && S.Brake == 0.6f && File.Finished());
+
+    FileWheelDevice Loop(ScriptedLog(), true);
+    Loop.SetTime(1.5 + 0.75); // wraps after 1.5s
+    assert(Loop.Read(S) && S.Steering == 0.01f && !Loop.Finished());
+
+    // headless takeover regression: 90 Hz frames, the driver takes over on the first frame after 1.0s
+    for (int Run = 0; Run < 2; Run++) // and again, with the same result
+    {
+        FileWheelDevice Replay(ScriptedLog());
+        WheelInputFilter Filter;
+        bool bAutopilot = true;
+        int TakeoverFrame = -1;
+        for (int Frame = 0; Frame < 180 && bAutopilot; Frame++)
+        {
+            Replay.SetTime(Frame / 90.0);
+            assert(Replay.Read(S));
+            if (Filter.Update(S, bAutopilot).bDriverInputs)
+            {
+                bAutopilot = false;
+                TakeoverFrame = Frame;
+            }
+        }
+        assert(TakeoverFrame == 90);
+    }
+}
+
+static void TestLatencyThroughThread()
+{
+    // steering changes every 20ms, the "game thread" maps it to a spring force at ~90 Hz
+    WheelLog Log;
+    for (int i = 0; i < 15; i++)
+        Log.Inputs.push_back({i * 0.02, Inputs((i % 2) ? 0.5f : -0.5f, 0.f, 0.f)});
+    FileWheelDevice File(Log);
+    WheelThreadParams P;
+    P.RateHz = 1000.0;
+    WheelDeviceThread Thread(File, P);
+    Thread.Start();
+    WheelInputFilter Filter;
+    const auto Until = std::chrono::steady_clock::now() + std::chrono::milliseconds(400);
+    while (std::chrono::steady_clock::now() < Until)
+    {
+        WheelState S;
+        if (Thread.GetLatest(S))
+        {
+            Filter.Update(S, false);
+            WheelForce F;
+            F.bSpring = true;
+            F.OffsetPercentage = static_cast<int>(S.Steering * 100.f);
+            F.SaturationPercentage = 30;
+            F.CoefficientPercentage = 100;
+            Thread.SetForce(F);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(11));
+    }
+    Thread.Stop();
+    assert(File.Finished());
+    assert(File.NumLatencySamples() > 5);
+    // a changed input reaches the wheel within a couple of game frames
+    assert(File.MeanLatencyMs() > 0.0 && File.MeanLatencyMs() < 40.0);
+    std::printf("input-to-actuation latency: mean %.2f ms, max %.2f ms over %d changes\n", File.MeanLatencyMs(),
+                File.MaxLatencyMs(), int(File.NumLatencySamples()));
+    const std::vector<WheelLogForce> Forces = File.GetAppliedForces();
+    assert(!Forces.empty() && !Forces.back().Force.bSpring); // released when the thread stopped
+}
+
+static void TestEvdevMapping()
+{
+    assert(EvdevWheelDevice::ButtonIndex(0x120) == 0);  // BTN_TRIGGER
+    assert(EvdevWheelDevice::ButtonIndex(0x12f) == 15); // BTN_DEAD
+    assert(EvdevWheelDevice::ButtonIndex(0x2c0) == 16); // BTN_TRIGGER_HAPPY1
+    assert(EvdevWheelDevice::ButtonIndex(0x2c3) == 19);
+    assert(EvdevWheelDevice::ButtonIndex(0x110) == -1); // BTN_LEFT (mouse)
+    assert(EvdevWheelDevice::HatToPOV(0, 0) == 0xFFFFFFFF);
+    assert(EvdevWheelDevice::HatToPOV(0, -1) == 0 && EvdevWheelDevice::HatToPOV(1, 0) == 9000);
+    assert(EvdevWheelDevice::HatToPOV(0, 1) == 18000 && EvdevWheelDevice::HatToPOV(-1, 0) == 27000);
+    assert(EvdevWheelDevice::HatToPOV(1, -1) == 4500);
+
+    EvdevWheelDevice Missing("/dev/input/does-not-exist");
+    WheelState S;
+    assert(!Missing.IsConnected() && !Missing.Read(S));
+    Missing.ApplyForce(WheelForce()); // harmless
+}
+
+int main()
+{
+    return RunTests("wheel input", {
+        TestTakeover,
+        TestButtons,
+        TestLogRoundTrip,
+        TestDeterministicReplay,
+        TestLatencyThroughThread,
+        TestEvdevMapping
+    });
+}